@@ -26,6 +26,11 @@ enum ServerOpcode {
   S2C_BACKCHANNEL = 0x07,
 }
 
+enum ClientOpcode {
+  C2S_SHUTDOWN = 0x00,
+  C2S_SET_UPDATE_RATE = 0x01,
+}
+
 class PacketBuffer {
   private buffer: ArrayBuffer;
   private data: DataView;
@@ -70,7 +75,7 @@ class PacketBuffer {
 }
 
 interface IWebSocket {
-  send(text: string): void;
+  send(data: string | ArrayBuffer): void;
   close(): void;
   onmessage: ((ev: MessageEvent) => any) | null;
   onclose: ((ev: CloseEvent) => any) | null;
@@ -80,6 +85,7 @@ interface IWebSocket {
 class Conduit {
   private socket: IWebSocket;
   private jsonBuffer: string = "";
+  private waveIds: Map<number, string> = new Map();
 
   onConsoleOutput: (data: string) => void = console.log;
   onAddWave: (path: string, value: string) => void = () => {};
@@ -133,6 +139,7 @@ class Conduit {
         this.onRestartSim?.();
         break;
       case ServerOpcode.S2C_QUIT_SIM:
+        this.waveIds.clear();
         this.onQuitSim?.();
         break;
       case ServerOpcode.S2C_NEXT_TIME_STEP:
@@ -148,8 +155,10 @@ class Conduit {
   }
 
   private parseAddWave(packet: PacketBuffer) {
+    const id = packet.unpackU32();
     const path = packet.unpackString();
     const value = packet.unpackString();
+    this.waveIds.set(id, path);
     this.onAddWave(path, value);
   }
 
@@ -166,9 +175,19 @@ class Conduit {
   }
 
   private parseSignalUpdate(packet: PacketBuffer) {
-    const path = packet.unpackString();
-    const value = packet.unpackString();
-    this.onSignalUpdate(path, value);
+    packet.unpackU64();   // Time of last change in the batch
+    const count = packet.unpackU32();
+
+    for (let i = 0; i < count; i++) {
+      const id = packet.unpackU32();
+      const value = packet.unpackString();
+
+      const path = this.waveIds.get(id);
+      if (path === undefined)
+        console.warn("skipping update for unknown signal ID " + id);
+      else
+        this.onSignalUpdate(path, value);
+    }
   }
 
   private parseBackchannel(packet: PacketBuffer) {
@@ -194,6 +213,16 @@ class Conduit {
     this.socket.send(script);
   }
 
+  public setUpdateRate(window: bigint, minInterval: number) {
+    const buffer = new ArrayBuffer(13);
+    const data = new DataView(buffer);
+    data.setUint8(0, ClientOpcode.C2S_SET_UPDATE_RATE);
+    data.setUint32(1, Number(window >> 32n));
+    data.setUint32(5, Number(window & 0xffffffffn));
+    data.setUint32(9, minInterval);
+    this.socket.send(buffer);
+  }
+
   public close() {
     this.socket.close();
   }
@@ -46,8 +46,8 @@ class BrowserWebSocket {
     });
   }
 
-  send(text: string) {
-    this.socket.send(text);
+  send(data: string | ArrayBuffer) {
+    this.socket.send(data);
   }
 
   close() {
@@ -55,6 +55,71 @@ class BrowserWebSocket {
   }
 }
 
+class FakeWebSocket {
+  sent: (string | ArrayBuffer)[] = [];
+
+  onmessage: ((ev: { data: string | ArrayBuffer }) => any) | null = null;
+  onclose: ((ev: {[key: string]: any}) => any) | null = null;
+  onopen: ((ev: object) => any) | null = null;
+
+  send(data: string | ArrayBuffer) {
+    this.sent.push(data);
+  }
+
+  close() {
+    this.onclose?.({});
+  }
+
+  receive(bytes: number[]) {
+    this.onmessage?.({ data: new Uint8Array(bytes).buffer });
+  }
+}
+
+function packString(str: string): number[] {
+  const bytes = Array.from(new TextEncoder().encode(str));
+  return [bytes.length >> 8, bytes.length & 0xff, ...bytes];
+}
+
+test("signal updates", () => {
+  const ws = new FakeWebSocket();
+  const c = new Conduit(ws);
+
+  const added: string[][] = [];
+  c.onAddWave = (path, value) => { added.push([path, value]); };
+
+  const updates: string[][] = [];
+  c.onSignalUpdate = (path, value) => { updates.push([path, value]); };
+
+  ws.receive([0x00, 0, 0, 0, 0, ...packString("/top/a"), ...packString("0")]);
+  ws.receive([0x00, 0, 0, 0, 1, ...packString("/top/b"), ...packString("1")]);
+
+  expect(added).toStrictEqual([["/top/a", "0"], ["/top/b", "1"]]);
+
+  ws.receive([0x01, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 2,
+              0, 0, 0, 1, ...packString("0"),
+              0, 0, 0, 0, ...packString("1")]);
+
+  expect(updates).toStrictEqual([["/top/b", "0"], ["/top/a", "1"]]);
+
+  // Signal IDs are forgotten when the simulation is unloaded
+  ws.receive([0x05]);
+  ws.receive([0x01, 0, 0, 0, 0, 0, 0, 0, 20, 0, 0, 0, 1,
+              0, 0, 0, 0, ...packString("0")]);
+
+  expect(updates.length).toBe(2);
+});
+
+test("set update rate", () => {
+  const ws = new FakeWebSocket();
+  const c = new Conduit(ws);
+
+  c.setUpdateRate(0x123456789an, 50);
+
+  expect(ws.sent.length).toBe(1);
+  expect(Array.from(new Uint8Array(ws.sent[0] as ArrayBuffer))).toStrictEqual(
+    [0x01, 0, 0, 0, 0x12, 0x34, 0x56, 0x78, 0x9a, 0, 0, 0, 50]);
+});
+
 test("sanity", (done) => {
   const ws = new BrowserWebSocket("ws://localhost:8888");
   const c = new Conduit(ws);
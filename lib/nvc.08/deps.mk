@@ -4,6 +4,10 @@ lib/nvc.08/NVC.IEEE_SUPPORT-body: lib/std.08/STD.STANDARD lib/nvc.08/NVC.IEEE_SU
 
 lib/nvc.08/NVC.IEEE_SUPPORT: lib/std.08/STD.STANDARD lib/ieee.08/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc.08/ieee_support.vhd
 
+lib/nvc.08/NVC.MEM_UTIL-body: lib/std.08/STD.STANDARD lib/nvc.08/NVC.MEM_UTIL lib/ieee.08/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc/mem_util-body.vhd
+
+lib/nvc.08/NVC.MEM_UTIL: lib/std.08/STD.STANDARD lib/ieee.08/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc/mem_util.vhd
+
 lib/nvc.08/NVC.POLYFILL: lib/std.08/STD.STANDARD $(top_srcdir)/lib/nvc.08/polyfill.vhd
 
 lib/nvc.08/NVC.PSL_SUPPORT-body: lib/std.08/STD.STANDARD lib/nvc.08/NVC.PSL_SUPPORT lib/ieee.08/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc/psl_support-body.vhd
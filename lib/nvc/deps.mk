@@ -1,5 +1,9 @@
 # Generated by nvc 1.13-devel
 
+lib/nvc/NVC.MEM_UTIL-body: lib/std/STD.STANDARD lib/nvc/NVC.MEM_UTIL lib/ieee/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc/mem_util-body.vhd
+
+lib/nvc/NVC.MEM_UTIL: lib/std/STD.STANDARD lib/ieee/IEEE.STD_LOGIC_1164 $(top_srcdir)/lib/nvc/mem_util.vhd
+
 lib/nvc/NVC.POLYFILL-body: lib/std/STD.STANDARD lib/nvc/NVC.POLYFILL $(top_srcdir)/lib/nvc/polyfill-body.vhd
 
 lib/nvc/NVC.POLYFILL: lib/std/STD.STANDARD $(top_srcdir)/lib/nvc/polyfill.vhd
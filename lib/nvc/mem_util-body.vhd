@@ -0,0 +1,43 @@
+-------------------------------------------------------------------------------
+--  Copyright (C) 2024  Nick Gasson
+--
+--  Licensed under the Apache License, Version 2.0 (the "License");
+--  you may not use this file except in compliance with the License.
+--  You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--  Unless required by applicable law or agreed to in writing, software
+--  distributed under the License is distributed on an "AS IS" BASIS,
+--  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--  See the License for the specific language governing permissions and
+--  limitations under the License.
+-------------------------------------------------------------------------------
+
+package body mem_util is
+
+    procedure read_mem_impl (file_name  : in string;
+                             mem        : inout std_ulogic_vector;
+                             word_width : in positive;
+                             radix      : in positive) is
+    begin
+        -- Has native implementation
+    end procedure;
+
+    attribute foreign of read_mem_impl : procedure is "INTERNAL _nvc_read_mem";
+
+    procedure read_mem_hex (file_name  : in string;
+                            mem        : inout std_ulogic_vector;
+                            word_width : in positive) is
+    begin
+        read_mem_impl(file_name, mem, word_width, 16);
+    end procedure;
+
+    procedure read_mem_bin (file_name  : in string;
+                            mem        : inout std_ulogic_vector;
+                            word_width : in positive) is
+    begin
+        read_mem_impl(file_name, mem, word_width, 2);
+    end procedure;
+
+end package body;
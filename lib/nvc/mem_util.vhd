@@ -0,0 +1,38 @@
+-------------------------------------------------------------------------------
+--  Copyright (C) 2024  Nick Gasson
+--
+--  Licensed under the Apache License, Version 2.0 (the "License");
+--  you may not use this file except in compliance with the License.
+--  You may obtain a copy of the License at
+--
+--     http://www.apache.org/licenses/LICENSE-2.0
+--
+--  Unless required by applicable law or agreed to in writing, software
+--  distributed under the License is distributed on an "AS IS" BASIS,
+--  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+--  See the License for the specific language governing permissions and
+--  limitations under the License.
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- This package provides fast loading of memory contents from files
+-------------------------------------------------------------------------------
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+package mem_util is
+
+    -- Load a file in the format accepted by the Verilog $readmemh and
+    -- $readmemb system tasks into MEM which holds consecutive words of
+    -- WORD_WIDTH elements starting from the left.  Words not present in
+    -- the file are left unchanged.
+    procedure read_mem_hex (file_name  : in string;
+                            mem        : inout std_ulogic_vector;
+                            word_width : in positive);
+
+    procedure read_mem_bin (file_name  : in string;
+                            mem        : inout std_ulogic_vector;
+                            word_width : in positive);
+
+end package;
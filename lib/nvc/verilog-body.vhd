@@ -492,4 +492,16 @@ package body verilog is
     begin
         -- Has native implementation
     end procedure;
+
+    procedure sys_readmemh (filename : string; mem : inout t_packed_logic;
+                            start, finish : t_int64) is
+    begin
+        -- Has native implementation
+    end procedure;
+
+    procedure sys_readmemb (filename : string; mem : inout t_packed_logic;
+                            start, finish : t_int64) is
+    begin
+        -- Has native implementation
+    end procedure;
 end package body;
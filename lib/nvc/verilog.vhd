@@ -102,8 +102,16 @@ package verilog is
     procedure sys_display (format : string);
     procedure sys_write (format : string);
 
+    -- A negative START or FINISH selects the default address
+    procedure sys_readmemh (filename : string; mem : inout t_packed_logic;
+                            start, finish : t_int64);
+    procedure sys_readmemb (filename : string; mem : inout t_packed_logic;
+                            start, finish : t_int64);
+
     attribute foreign of sys_finish : procedure is "INTERNAL __nvc_sys_finish";
     attribute foreign of sys_write : procedure is "INTERNAL __nvc_sys_write";
     attribute foreign of sys_display : procedure is "INTERNAL __nvc_sys_display";
+    attribute foreign of sys_readmemh : procedure is "INTERNAL __nvc_sys_readmemh";
+    attribute foreign of sys_readmemb : procedure is "INTERNAL __nvc_sys_readmemb";
 
 end package;
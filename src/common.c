@@ -1123,6 +1123,8 @@ void intern_strings(void)
    id_cache[W_INSTANCE_NAME]   = ident_new("instance_name");
    id_cache[W_PATH_NAME]       = ident_new("path_name");
    id_cache[W_DOLLAR_TIME]     = ident_new("$time");
+   id_cache[W_DOLLAR_READMEMH] = ident_new("$readmemh");
+   id_cache[W_DOLLAR_READMEMB] = ident_new("$readmemb");
    id_cache[W_VITAL]           = ident_new("VITAL");
 
    id_cache[W_IEEE_LOGIC_VECTOR] =
@@ -1130,6 +1132,8 @@ void intern_strings(void)
    id_cache[W_IEEE_ULOGIC_VECTOR] =
       ident_new("IEEE.STD_LOGIC_1164.STD_ULOGIC_VECTOR");
 
+   id_cache[W_NVC_VERILOG_LOGIC] = ident_new("NVC.VERILOG.T_LOGIC");
+
    id_cache[W_NUMERIC_STD_UNSIGNED] = ident_new("IEEE.NUMERIC_STD_UNSIGNED");
    id_cache[W_NUMERIC_BIT_UNSIGNED] = ident_new("IEEE.NUMERIC_BIT_UNSIGNED");
 
@@ -2499,7 +2503,7 @@ void analyse_file(const char *file, jit_t *jit, unit_registry_t *ur)
 
    case SOURCE_SDF:
       {
-         sdf_file_t *sdf_file = sdf_parse(file, 0);
+         sdf_file_t *sdf_file = sdf_parse(file, S_F_MIN_MAX_SPEC_ALL);
          progress("analysed SDF file: %s", file);
 
          if (sdf_file != NULL) {
@@ -247,10 +247,13 @@ typedef enum {
    W_VITAL,
    W_NEVER_WAITS,
    W_NVC_VERILOG,
+   W_NVC_VERILOG_LOGIC,
    W_SHAPE,
    W_INSTANCE_NAME,
    W_PATH_NAME,
    W_DOLLAR_TIME,
+   W_DOLLAR_READMEMH,
+   W_DOLLAR_READMEMB,
    W_OP_AND,
    W_OP_OR,
    W_OP_NAND,
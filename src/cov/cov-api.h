@@ -187,6 +187,8 @@ typedef enum {
    COVER_MASK_TOGGLE_INCLUDE_MEMS         = (1 << 10),
    COVER_MASK_EXCLUDE_UNREACHABLE         = (1 << 11),
    COVER_MASK_FSM_NO_DEFAULT_ENUMS        = (1 << 12),
+   COVER_MASK_BYTE_COUNTERS               = (1 << 13),
+   COVER_MASK_BIT_COUNTERS                = (1 << 14),
    COVER_MASK_DONT_PRINT_COVERED          = (1 << 16),
    COVER_MASK_DONT_PRINT_UNCOVERED        = (1 << 17),
    COVER_MASK_DONT_PRINT_EXCLUDED         = (1 << 18)
@@ -197,6 +199,7 @@ typedef enum {
                         | COVER_MASK_STATE | COVER_MASK_FUNCTIONAL)
 
 cover_data_t *cover_data_init(cover_mask_t mask, int array_limit);
+unsigned cover_counter_bits(cover_data_t *data);
 bool cover_enabled(cover_data_t *data, cover_mask_t mask);
 
 unsigned cover_count_items(cover_data_t *data);
@@ -208,6 +211,7 @@ cover_data_t *cover_read_items(fbuf_t *f, uint32_t pre_mask);
 fbuf_t *cover_open_lib_file(tree_t top, fbuf_mode_t mode, bool check_null);
 
 void cover_merge_items(fbuf_t *f, cover_data_t *data);
+void cover_merge_data(cover_data_t *data, cover_data_t *other);
 
 //
 // Spec and exclude file handling
@@ -222,7 +226,8 @@ void cover_load_exclude_file(const char *path, cover_data_t *data);
 // Report generation and export
 //
 
-void cover_report(const char *path, cover_data_t *data, int item_limit);
+void cover_report(const char *path, cover_data_t *data, int item_limit,
+                  bool incremental);
 void cover_export_cobertura(cover_data_t *data, FILE *f,
                             const char *relative);
 void cover_export_xml(cover_data_t *data, FILE *f, const char *relative);
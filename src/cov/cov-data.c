@@ -19,6 +19,7 @@
 #include "array.h"
 #include "cov/cov-api.h"
 #include "cov/cov-data.h"
+#include "hash.h"
 #include "ident.h"
 #include "lib.h"
 #include "object.h"
@@ -862,6 +863,16 @@ cover_data_t *cover_data_init(cover_mask_t mask, int array_limit)
    return data;
 }
 
+unsigned cover_counter_bits(cover_data_t *data)
+{
+   if (data->mask & COVER_MASK_BIT_COUNTERS)
+      return 1;
+   else if (data->mask & COVER_MASK_BYTE_COUNTERS)
+      return 8;
+   else
+      return 32;
+}
+
 bool cover_enabled(cover_data_t *data, cover_mask_t mask)
 {
    return data != NULL && (data->mask & mask);
@@ -1053,8 +1064,9 @@ static void cover_read_one_item(fbuf_t *f, loc_rd_ctx_t *loc_rd,
       item->func_name = ident_read(ident_ctx);
 }
 
-static cover_scope_t *cover_read_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
-                                       loc_rd_ctx_t *loc_ctx)
+static cover_scope_t *cover_read_scope_header(fbuf_t *f,
+                                              ident_rd_ctx_t ident_ctx,
+                                              loc_rd_ctx_t *loc_ctx)
 {
    cover_scope_t *s = xcalloc(sizeof(cover_scope_t));
    s->type = fbuf_get_uint(f);
@@ -1066,6 +1078,13 @@ static cover_scope_t *cover_read_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
    if (s->type == CSCOPE_INSTANCE)
       s->block_name = ident_read(ident_ctx);
 
+   return s;
+}
+
+static cover_scope_t *cover_read_scope_body(fbuf_t *f, ident_rd_ctx_t ident_ctx,
+                                            loc_rd_ctx_t *loc_ctx,
+                                            cover_scope_t *s)
+{
    const int nitems = fbuf_get_uint(f);
    for (int i = 0; i < nitems; i++) {
       cover_item_t new;
@@ -1079,7 +1098,9 @@ static cover_scope_t *cover_read_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
       switch (ctrl) {
       case CTRL_PUSH_SCOPE:
          {
-            cover_scope_t *child = cover_read_scope(f, ident_ctx, loc_ctx);
+            cover_scope_t *child =
+               cover_read_scope_header(f, ident_ctx, loc_ctx);
+            cover_read_scope_body(f, ident_ctx, loc_ctx, child);
             APUSH(s->children, child);
          }
          break;
@@ -1091,6 +1112,13 @@ static cover_scope_t *cover_read_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
    }
 }
 
+static cover_scope_t *cover_read_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
+                                       loc_rd_ctx_t *loc_ctx)
+{
+   cover_scope_t *s = cover_read_scope_header(f, ident_ctx, loc_ctx);
+   return cover_read_scope_body(f, ident_ctx, loc_ctx, s);
+}
+
 cover_data_t *cover_read_items(fbuf_t *f, uint32_t pre_mask)
 {
    cover_data_t *data = xcalloc(sizeof(cover_data_t));
@@ -1121,50 +1149,178 @@ cover_data_t *cover_read_items(fbuf_t *f, uint32_t pre_mask)
    return data;
 }
 
-static void cover_merge_scope(cover_scope_t *old_s, cover_scope_t *new_s)
+typedef struct {
+   cover_scope_t *scope;
+   hash_t        *index;
+   int           *chain;
+} item_map_t;
+
+static inline const void *cover_hier_key(ident_t hier)
 {
+   static const char null_key;
+   return hier ?: (const void *)&null_key;
+}
 
-   for (int i = 0; i < new_s->items.count; i++) {
-      cover_item_t *new = AREF(new_s->items, i);
+static void item_map_init(item_map_t *map, cover_scope_t *s, int nnew)
+{
+   // Index the existing items by hierarchical path: items sharing a
+   // path differ only in their flags so each chain is short.  Chains
+   // are in ascending index order so the first match is the same as
+   // a linear search.
+   const int maxitems = s->items.count + nnew;
+
+   map->scope = s;
+   map->chain = xmalloc_array(MAX(maxitems, 1), sizeof(int));
+   map->index = hash_new(MAX(maxitems * 2, 16));
+
+   for (int j = s->items.count - 1; j >= 0; j--) {
+      const void *key = cover_hier_key(AREF(s->items, j)->hier);
+      map->chain[j] = (intptr_t)hash_get(map->index, key) - 1;
+      hash_put(map->index, key, (void *)(intptr_t)(j + 1));
+   }
+}
+
+static void item_map_free(item_map_t *map)
+{
+   hash_free(map->index);
+   free(map->chain);
+}
+
+static void item_map_merge(item_map_t *map, const cover_item_t *new)
+{
+   cover_scope_t *s = map->scope;
+   const void *key = cover_hier_key(new->hier);
 
-      bool found = false;
-      for (int j = 0; j < old_s->items.count; j++) {
-         cover_item_t *old = AREF(old_s->items, j);
+   // Compare based on hierarchical path, each
+   // coverage item has unique hierarchical name
+   const int head = (intptr_t)hash_get(map->index, key) - 1;
 
-         // Compare based on hierarchical path, each
-         // coverage item has unique hierarchical name
-         if (new->hier == old->hier && (new->flags == old->flags)) {
-            assert(new->kind == old->kind);
+   for (int j = head; j >= 0; j = map->chain[j]) {
+      cover_item_t *old = AREF(s->items, j);
+      if (new->flags == old->flags) {
+         assert(new->kind == old->kind);
 #ifdef COVER_DEBUG_MERGE
-            printf("Merging coverage item: %s\n", istr(old->hier));
+         printf("Merging coverage item: %s\n", istr(old->hier));
 #endif
-            cover_merge_one_item(old, new->data);
-
-            found = true;
-            break;
-         }
+         cover_merge_one_item(old, new->data);
+         return;
       }
+   }
+
+   // Append the new item to the common scope: it cannot match any
+   // existing item so it can go at the front of the chain
+   const int pos = s->items.count;
+   APUSH(s->items, *new);
 
-      // Append the new item to the common scope
-      if (!found)
-         APUSH(old_s->items, *new);
+   map->chain[pos] = head;
+   hash_put(map->index, key, (void *)(intptr_t)(pos + 1));
+}
+
+static hash_t *cover_index_children(cover_scope_t *s)
+{
+   hash_t *h = hash_new(MAX(s->children.count * 2, 16));
+
+   for (int j = s->children.count - 1; j >= 0; j--) {
+      cover_scope_t *c = s->children.items[j];
+      hash_put(h, cover_hier_key(c->name), c);
    }
 
+   return h;
+}
+
+static void cover_merge_scope(cover_scope_t *old_s, cover_scope_t *new_s)
+{
+   item_map_t map;
+   item_map_init(&map, old_s, new_s->items.count);
+
+   for (int i = 0; i < new_s->items.count; i++)
+      item_map_merge(&map, AREF(new_s->items, i));
+
+   item_map_free(&map);
+
+   hash_t *children = cover_index_children(old_s);
+
    for (int i = 0; i < new_s->children.count; i++) {
       cover_scope_t *new_c = new_s->children.items[i];
-      bool found = false;
-      for (int j = 0; j < old_s->children.count; j++) {
-         cover_scope_t *old_c = old_s->children.items[j];
-         if (new_c->name == old_c->name) {
-            cover_merge_scope(old_c, new_c);
-            found = true;
-            break;
-         }
-      }
+      const void *key = cover_hier_key(new_c->name);
 
-      if (!found)
+      cover_scope_t *old_c = hash_get(children, key);
+      if (old_c != NULL)
+         cover_merge_scope(old_c, new_c);
+      else {
          APUSH(old_s->children, new_c);
+         hash_put(children, key, new_c);
+      }
+   }
+
+   hash_free(children);
+}
+
+static void cover_stream_scope(fbuf_t *f, ident_rd_ctx_t ident_ctx,
+                               loc_rd_ctx_t *loc_ctx, cover_scope_t *old_s)
+{
+   // Merge the body of a scope directly from the database file into
+   // OLD_S: only child scopes that do not already exist are read
+   // into memory
+
+   const int nitems = fbuf_get_uint(f);
+
+   item_map_t map;
+   item_map_init(&map, old_s, nitems);
+
+   for (int i = 0; i < nitems; i++) {
+      cover_item_t new;
+      cover_read_one_item(f, loc_ctx, ident_ctx, &new);
+      item_map_merge(&map, &new);
    }
+
+   item_map_free(&map);
+
+   hash_t *children = cover_index_children(old_s);
+
+   for (;;) {
+      const uint8_t ctrl = read_u8(f);
+      switch (ctrl) {
+      case CTRL_PUSH_SCOPE:
+         {
+            cover_scope_t *new_c =
+               cover_read_scope_header(f, ident_ctx, loc_ctx);
+            const void *key = cover_hier_key(new_c->name);
+
+            cover_scope_t *old_c = hash_get(children, key);
+            if (old_c != NULL) {
+               cover_stream_scope(f, ident_ctx, loc_ctx, old_c);
+               free(new_c);
+            }
+            else {
+               cover_read_scope_body(f, ident_ctx, loc_ctx, new_c);
+               APUSH(old_s->children, new_c);
+               hash_put(children, key, new_c);
+            }
+         }
+         break;
+      case CTRL_POP_SCOPE:
+         hash_free(children);
+         return;
+      default:
+         fatal_trace("invalid control word %x in cover db", ctrl);
+      }
+   }
+}
+
+void cover_merge_data(cover_data_t *data, cover_data_t *other)
+{
+   // The header of the database merged last takes precedence
+   data->mask        = other->mask;
+   data->array_limit = other->array_limit;
+   data->next_tag    = other->next_tag;
+
+   if (data->root_scope == NULL)
+      data->root_scope = other->root_scope;
+   else if (other->root_scope != NULL)
+      cover_merge_scope(data->root_scope, other->root_scope);
+
+   free(other);
 }
 
 void cover_merge_items(fbuf_t *f, cover_data_t *data)
@@ -1182,8 +1338,10 @@ void cover_merge_items(fbuf_t *f, cover_data_t *data)
       switch (ctrl) {
       case CTRL_PUSH_SCOPE:
          {
-            cover_scope_t *new = cover_read_scope(f, ident_ctx, loc_rd);
-            cover_merge_scope(data->root_scope, new);
+            cover_scope_t *new =
+               cover_read_scope_header(f, ident_ctx, loc_rd);
+            cover_stream_scope(f, ident_ctx, loc_rd, data->root_scope);
+            free(new);
          }
          break;
       case CTRL_END_OF_FILE:
@@ -22,7 +22,9 @@
 #include "ident.h"
 #include "lib.h"
 #include "option.h"
+#include "thread.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -79,6 +81,7 @@ typedef struct {
    unsigned      n_lines;
    unsigned      alloc_lines;
    bool          valid;
+   uint64_t      checksum;
 } cover_file_t;
 
 struct _cover_report_ctx {
@@ -95,6 +98,27 @@ struct _cover_report_ctx {
    int                  lvl;
 };
 
+typedef struct _cover_page cover_page_t;
+
+typedef A(cover_page_t *) page_list_t;
+
+struct _cover_page {
+   cover_report_ctx_t  ctx;
+   cover_scope_t      *scope;
+   cover_file_t       *src;
+   page_list_t         children;
+   int                 skipped;
+   uint64_t            checksum;
+};
+
+typedef struct {
+   const char  *dir;
+   const char  *timestamp;
+   hash_t      *checksums;
+   page_list_t  pages;
+   unsigned     written;
+} cover_rpt_state_t;
+
 typedef enum {
    PAIR_UNCOVERED    = 0,
    PAIR_EXCLUDED     = 1,
@@ -102,24 +126,26 @@ typedef enum {
    PAIR_LAST         = 3
 } cov_pair_kind_t;
 
-#define INIT_CHAIN(ctx, name)                                           \
-   ctx->name.hits = xcalloc_array(1024, sizeof(cover_pair_t));          \
-   ctx->name.miss = xcalloc_array(1024, sizeof(cover_pair_t));          \
-   ctx->name.excl = xcalloc_array(1024, sizeof(cover_pair_t));          \
-   ctx->name.alloc_hits = 1024;                                         \
-   ctx->name.alloc_miss = 1024;                                         \
-   ctx->name.alloc_excl = 1024;                                         \
+#define FREE_CHAIN(ctx, name)                                           \
+   free(ctx->name.hits);                                                \
+   free(ctx->name.miss);                                                \
+   free(ctx->name.excl);                                                \
 
 #define COV_RPT_TITLE "NVC code coverage report"
+#define CHECKSUM_FILE ".checksums"
 
-static void cover_report_children(cover_report_ctx_t *ctx,
-                                  cover_scope_t *s, const char *dir,
-                                  FILE *summf, int *skipped);
+static void cover_report_children(cover_page_t *page, cover_scope_t *s,
+                                  cover_rpt_state_t *state);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Report generation
 ///////////////////////////////////////////////////////////////////////////////
 
+static inline uint64_t cover_checksum_mix(uint64_t h, uint64_t value)
+{
+   return mix_bits_64(h ^ value) + UINT64_C(0x9e3779b97f4a7c15);
+}
+
 static void cover_append_line(cover_file_t *f, const char *buf)
 {
    if (f->n_lines == f->alloc_lines) {
@@ -130,6 +156,9 @@ static void cover_append_line(cover_file_t *f, const char *buf)
    cover_line_t *l = &(f->lines[(f->n_lines)++]);
    l->text = xstrdup(buf);
    l->len  = strlen(buf);
+
+   for (size_t i = 0; i < l->len; i++)
+      f->checksum = cover_checksum_mix(f->checksum, (uint8_t)buf[i]);
 }
 
 static cover_file_t *cover_file_for_scope(cover_scope_t *s)
@@ -154,6 +183,7 @@ static cover_file_t *cover_file_for_scope(cover_scope_t *s)
    f->alloc_lines = 1024;
    f->lines       = xmalloc_array(f->alloc_lines, sizeof(cover_line_t));
    f->valid       = false;
+   f->checksum    = 0;
 
    shash_put(files, name, f);
 
@@ -322,14 +352,13 @@ static void cover_print_navigation_tree(FILE *f, cover_report_ctx_t *ctx,
 
 }
 
-static void cover_print_file_and_inst(FILE *f, cover_report_ctx_t *ctx,
+static void cover_print_file_and_inst(FILE *f, cover_file_t *src,
                                       cover_scope_t *s)
 {
    fprintf(f, "<h2 style=\"margin-left: " MARGIN_LEFT ";\">\n");
    fprintf(f, "   Instance:&nbsp;%s\n", istr(s->hier));
    fprintf(f, "</h2>\n\n");
 
-   cover_file_t *src = cover_file_for_scope(s);
    fprintf(f, "<h2 style=\"margin-left: " MARGIN_LEFT ";\">\n");
    if (src != NULL)
       fprintf(f, "   File:&nbsp; <a href=\"../../%s\">../../%s</a>\n",
@@ -379,14 +408,11 @@ static void cover_print_hierarchy_footer(FILE *f)
    fprintf(f, "</table>\n\n");
 }
 
-static void cover_print_timestamp(FILE *f)
+static void cover_print_timestamp(FILE *f, const char *timestamp)
 {
-   time_t t;
-   time(&t);
-
    fprintf(f, "<footer>");
    fprintf(f, "   <p> NVC version: %s </p>\n", PACKAGE_VERSION);
-   fprintf(f, "   <p> Generated on: %s </p>\n", ctime(&t));
+   fprintf(f, "   <p> Generated on: %s </p>\n", timestamp);
    fprintf(f, "</footer>\n");
 
    fprintf(f, "</body>\n");
@@ -485,23 +511,43 @@ static void cover_print_hierarchy_summary(FILE *f, cover_report_ctx_t *ctx, iden
       else
          notef("     functional:    N.A.");
    }
-   else if (opt_get_int(OPT_VERBOSE) && !flat) {
-
-      cover_rpt_buf_t *new = xcalloc(sizeof(cover_rpt_buf_t));
-      new->tb = tb_new();
-      new->prev = ctx->data->rpt_buf;
-      ctx->data->rpt_buf = new;
-
-      tb_printf(new->tb,
-         "%*s %-*s %10.1f %% (%d/%d)  %10.1f %% (%d/%d) %10.1f %% (%d/%d) "
-         "%10.1f %% (%d/%d) %10.1f %% (%d/%d)",
-         ctx->lvl, "", 50-ctx->lvl, istr(ident_rfrom(hier, '.')),
-         perc_stmt, stats->hit_stmts, stats->total_stmts,
-         perc_branch, stats->hit_branches, stats->total_branches,
-         perc_toggle, stats->hit_toggles, stats->total_toggles,
-         perc_expr, stats->hit_expressions, stats->total_expressions,
-         perc_state, stats->hit_states, stats->total_states);
-   }
+}
+
+static void cover_report_verbose(cover_report_ctx_t *ctx, ident_t hier)
+{
+   cover_stats_t *stats = &(ctx->nested_stats);
+
+   float perc_stmt = 0.0f;
+   float perc_branch = 0.0f;
+   float perc_toggle = 0.0f;
+   float perc_expr = 0.0f;
+   float perc_state = 0.0f;
+
+   if (stats->total_stmts > 0)
+      perc_stmt = 100.0 * ((float)stats->hit_stmts) / stats->total_stmts;
+   if (stats->total_branches > 0)
+      perc_branch = 100.0 * ((float)stats->hit_branches) / stats->total_branches;
+   if (stats->total_toggles > 0)
+      perc_toggle = 100.0 * ((float)stats->hit_toggles) / stats->total_toggles;
+   if (stats->total_expressions > 0)
+      perc_expr = 100.0 * ((float)stats->hit_expressions) / stats->total_expressions;
+   if (stats->total_states > 0)
+      perc_state = 100.0 * ((float)stats->hit_states) / stats->total_states;
+
+   cover_rpt_buf_t *new = xcalloc(sizeof(cover_rpt_buf_t));
+   new->tb = tb_new();
+   new->prev = ctx->data->rpt_buf;
+   ctx->data->rpt_buf = new;
+
+   tb_printf(new->tb,
+      "%*s %-*s %10.1f %% (%d/%d)  %10.1f %% (%d/%d) %10.1f %% (%d/%d) "
+      "%10.1f %% (%d/%d) %10.1f %% (%d/%d)",
+      ctx->lvl, "", 50-ctx->lvl, istr(ident_rfrom(hier, '.')),
+      perc_stmt, stats->hit_stmts, stats->total_stmts,
+      perc_branch, stats->hit_branches, stats->total_branches,
+      perc_toggle, stats->hit_toggles, stats->total_toggles,
+      perc_expr, stats->hit_expressions, stats->total_expressions,
+      perc_state, stats->hit_states, stats->total_states);
 }
 
 static inline void cover_print_char(FILE *f, char c)
@@ -1082,7 +1128,7 @@ static bool cover_bin_unreachable(cover_report_ctx_t *ctx, cover_item_t *item)
 #define CHAIN_APPEND(chn, type, first_chn_item, curr_item, curr_line)            \
       do {                                                                       \
          if (chn->n_##type == chn->alloc_##type) {                               \
-            chn->alloc_##type *= 2;                                              \
+            chn->alloc_##type = MAX(chn->alloc_##type * 2, 64);                  \
             chn->type = xrealloc_array(chn->type , chn->alloc_##type ,           \
                                        sizeof(cover_pair_t));                    \
          }                                                                       \
@@ -1213,10 +1259,12 @@ static int cover_append_item_to_chain(cover_report_ctx_t *ctx, cover_item_t *fir
    return n_steps;
 }
 
-static void cover_report_scope(cover_report_ctx_t *ctx,
-                               cover_scope_t *s, const char *dir,
-                               FILE *summf, int *skipped)
+
+static void cover_report_scope(cover_page_t *page, cover_scope_t *s,
+                               cover_rpt_state_t *state)
 {
+   cover_report_ctx_t *ctx = &(page->ctx);
+
    for (int i = 0; i < s->items.count;) {
       int step = 1;
       cover_item_t *item = &(s->items.items[i]);
@@ -1238,7 +1286,8 @@ static void cover_report_scope(cover_report_ctx_t *ctx,
       case COV_ITEM_STATE:
       case COV_ITEM_EXPRESSION:
       case COV_ITEM_FUNCTIONAL:
-         step = cover_append_item_to_chain(ctx, item, line, limit, skipped);
+         step = cover_append_item_to_chain(ctx, item, line, limit,
+                                           &(page->skipped));
          break;
 
       default:
@@ -1249,35 +1298,182 @@ static void cover_report_scope(cover_report_ctx_t *ctx,
       i += step;
    }
 
-   cover_report_children(ctx, s, dir, summf, skipped);
+   cover_report_children(page, s, state);
+}
+
+static uint64_t cover_checksum_str(uint64_t h, const char *str)
+{
+   for (const char *p = str; *p; p++)
+      h = cover_checksum_mix(h, (uint8_t)*p);
+
+   return cover_checksum_mix(h, 0);
+}
+
+static uint64_t cover_checksum_stats(uint64_t h, const cover_stats_t *stats)
+{
+   const unsigned *counts = (const unsigned *)stats;
+   for (int i = 0; i < sizeof(cover_stats_t) / sizeof(unsigned); i++)
+      h = cover_checksum_mix(h, counts[i]);
+
+   return h;
+}
+
+static uint64_t cover_checksum_loc(uint64_t h, const loc_t *loc)
+{
+   h = cover_checksum_mix(h, loc->first_line);
+   h = cover_checksum_mix(h, loc->first_column);
+   h = cover_checksum_mix(h, loc->line_delta);
+   return cover_checksum_mix(h, loc->column_delta);
+}
+
+static uint64_t cover_checksum_pairs(uint64_t h, const cover_pair_t *pairs,
+                                     int count)
+{
+   h = cover_checksum_mix(h, count);
+
+   for (int i = 0; i < count; i++) {
+      const cover_item_t *item = pairs[i].item;
+      h = cover_checksum_mix(h, item->kind);
+      h = cover_checksum_mix(h, item->data);
+      h = cover_checksum_mix(h, item->flags);
+      h = cover_checksum_mix(h, item->consecutive);
+      h = cover_checksum_mix(h, item->metadata);
+      h = cover_checksum_mix(h, item->source);
+      h = cover_checksum_loc(h, &(item->loc));
+      h = cover_checksum_loc(h, &(item->loc_lhs));
+      h = cover_checksum_loc(h, &(item->loc_rhs));
+      h = cover_checksum_str(h, istr(item->hier));
+
+      if (item->func_name != NULL)
+         h = cover_checksum_str(h, istr(item->func_name));
+   }
+
+   return h;
+}
+
+static uint64_t cover_checksum_chain(uint64_t h, const cover_chain_t *chn)
+{
+   h = cover_checksum_pairs(h, chn->hits, chn->n_hits);
+   h = cover_checksum_pairs(h, chn->miss, chn->n_miss);
+   return cover_checksum_pairs(h, chn->excl, chn->n_excl);
+}
+
+static uint64_t cover_page_checksum(cover_page_t *page)
+{
+   // Everything that is written to the page apart from the timestamp
+   // should contribute to the checksum
+   cover_report_ctx_t *ctx = &(page->ctx);
+
+   uint64_t h = cover_checksum_str(0, PACKAGE_VERSION);
+   h = cover_checksum_mix(h, ctx->data->mask);
+   h = cover_checksum_mix(h, ctx->data->report_item_limit);
+   h = cover_checksum_str(h, istr(page->scope->hier));
+
+   if (page->src != NULL) {
+      h = cover_checksum_str(h, page->src->name);
+      h = cover_checksum_mix(h, page->src->checksum);
+   }
+
+   for (int i = 0; i < page->children.count; i++) {
+      cover_page_t *child = page->children.items[i];
+      h = cover_checksum_str(h, istr(child->scope->hier));
+      h = cover_checksum_stats(h, &(child->ctx.nested_stats));
+   }
+
+   h = cover_checksum_stats(h, &(ctx->flat_stats));
+   h = cover_checksum_mix(h, page->skipped);
+
+   h = cover_checksum_chain(h, &(ctx->ch_stmt));
+   h = cover_checksum_chain(h, &(ctx->ch_branch));
+   h = cover_checksum_chain(h, &(ctx->ch_toggle));
+   h = cover_checksum_chain(h, &(ctx->ch_expression));
+   h = cover_checksum_chain(h, &(ctx->ch_state));
+   return cover_checksum_chain(h, &(ctx->ch_functional));
+}
+
+static cover_page_t *cover_report_hierarchy(cover_report_ctx_t *parent,
+                                            cover_data_t *data,
+                                            cover_scope_t *s,
+                                            cover_rpt_state_t *state)
+{
+   // Collect the coverage items and statistics for this page and all
+   // its sub-instances: the HTML is written later in parallel
+   cover_page_t *page = xcalloc(sizeof(cover_page_t));
+   page->scope = s;
+   page->src   = cover_file_for_scope(s);
+
+   page->ctx.parent = parent;
+   page->ctx.data   = data;
+   page->ctx.lvl    = parent ? parent->lvl + 2 : 0;
+
+   cover_report_children(page, s, state);
+
+   page->checksum = cover_page_checksum(page);
+
+   APUSH(state->pages, page);
+   return page;
+}
+
+static void cover_report_children(cover_page_t *page, cover_scope_t *s,
+                                  cover_rpt_state_t *state)
+{
+   cover_report_ctx_t *ctx = &(page->ctx);
+
+   for (int i = 0; i < s->children.count; i++) {
+      cover_scope_t *it = s->children.items[i];
+      if (it->type == CSCOPE_INSTANCE) {
+         // Collect coverage of sub-block
+         cover_page_t *sub = cover_report_hierarchy(ctx, ctx->data, it, state);
+         APUSH(page->children, sub);
+
+         cover_report_ctx_t *sub_ctx = &(sub->ctx);
+
+         if (opt_get_int(OPT_VERBOSE))
+            cover_report_verbose(sub_ctx, it->hier);
+
+         // Add coverage from sub-hierarchies
+         ctx->nested_stats.hit_stmts += sub_ctx->nested_stats.hit_stmts;
+         ctx->nested_stats.total_stmts += sub_ctx->nested_stats.total_stmts;
+         ctx->nested_stats.hit_branches += sub_ctx->nested_stats.hit_branches;
+         ctx->nested_stats.total_branches += sub_ctx->nested_stats.total_branches;
+         ctx->nested_stats.hit_toggles += sub_ctx->nested_stats.hit_toggles;
+         ctx->nested_stats.total_toggles += sub_ctx->nested_stats.total_toggles;
+         ctx->nested_stats.hit_expressions += sub_ctx->nested_stats.hit_expressions;
+         ctx->nested_stats.total_expressions += sub_ctx->nested_stats.total_expressions;
+         ctx->nested_stats.hit_states += sub_ctx->nested_stats.hit_states;
+         ctx->nested_stats.total_states += sub_ctx->nested_stats.total_states;
+      }
+      else
+         cover_report_scope(page, it, state);
+   }
 }
 
-static void cover_report_hierarchy(cover_report_ctx_t *ctx,
-                                   cover_scope_t *s, const char *dir)
+static void cover_write_page(void *context, void *arg)
 {
-   char *hier LOCAL = xasprintf("%s/%s.html", dir, istr(s->hier));
+   cover_rpt_state_t *state = context;
+   cover_page_t *page = arg;
+   cover_report_ctx_t *ctx = &(page->ctx);
+   cover_scope_t *s = page->scope;
+
+   char *hier LOCAL = xasprintf("%s/%s.html", state->dir, istr(s->hier));
 
    // TODO: Handle escaped identifiers in hierarchy path!
    FILE *f = fopen(hier, "w");
    if (f == NULL)
       fatal("failed to open report file: %s\n", hier);
 
-   INIT_CHAIN(ctx, ch_stmt);
-   INIT_CHAIN(ctx, ch_branch);
-   INIT_CHAIN(ctx, ch_toggle);
-   INIT_CHAIN(ctx, ch_expression);
-   INIT_CHAIN(ctx, ch_state);
-   INIT_CHAIN(ctx, ch_functional);
-
    cover_print_html_header(f);
    cover_print_navigation_tree(f, ctx, s);
-   cover_print_file_and_inst(f, ctx, s);
+   cover_print_file_and_inst(f, page->src, s);
 
    fprintf(f, "<h2 style=\"margin-left: " MARGIN_LEFT ";\">\n  Sub-instances:\n</h2>\n\n");
    cover_print_hierarchy_header(f, "sub_inst_table");
 
-   int skipped = 0;
-   cover_report_children(ctx, s, dir, f, &skipped);
+   for (int i = 0; i < page->children.count; i++) {
+      cover_page_t *child = page->children.items[i];
+      cover_print_hierarchy_summary(f, &(child->ctx), child->scope->hier,
+                                    false, false, false);
+   }
 
    cover_print_hierarchy_footer(f);
 
@@ -1287,52 +1483,102 @@ static void cover_report_hierarchy(cover_report_ctx_t *ctx,
    cover_print_hierarchy_footer(f);
 
    fprintf(f, "<h2 style=\"margin-left: " MARGIN_LEFT ";\">\n  Details:\n</h2>\n\n");
-   if (skipped)
+   if (page->skipped)
       fprintf(f, "<h3 style=\"margin-left: " MARGIN_LEFT ";\">The limit of "
                  "printed items was reached (%d). Total %d items are not "
-                 "displayed.</h3>\n\n", ctx->data->report_item_limit, skipped);
+                 "displayed.</h3>\n\n", ctx->data->report_item_limit,
+              page->skipped);
    cover_print_hierarchy_guts(f, ctx);
-   cover_print_timestamp(f);
+   cover_print_timestamp(f, state->timestamp);
 
    fclose(f);
+
+   relaxed_add(&state->written, 1);
 }
 
-static void cover_report_children(cover_report_ctx_t *ctx,
-                                  cover_scope_t *s, const char *dir,
-                                  FILE *summf, int *skipped)
+static bool cover_page_unchanged(cover_rpt_state_t *state, cover_page_t *page)
 {
-   for (int i = 0; i < s->children.count; i++) {
-      cover_scope_t *it = s->children.items[i];
-      if (it->type == CSCOPE_INSTANCE) {
-         // Collect coverage of sub-block
-         cover_report_ctx_t sub_ctx = {};
-         sub_ctx.parent = ctx;
-         sub_ctx.data = ctx->data;
-         sub_ctx.lvl = ctx->lvl + 2;
+   if (state->checksums == NULL)
+      return false;
 
-         cover_report_hierarchy(&sub_ctx, it, dir);
+   const uint64_t *old = hash_get(state->checksums, page->scope->hier);
+   if (old == NULL || *old != page->checksum)
+      return false;
 
-         cover_print_hierarchy_summary(summf, &sub_ctx,
-                                       it->hier, false, false, false);
+   // The page may have been deleted since the last report
+   char *path LOCAL = xasprintf("%s/%s.html", state->dir,
+                                istr(page->scope->hier));
+   file_info_t info;
+   return get_file_info(path, &info);
+}
 
-         // Add coverage from sub-hierarchies
-         ctx->nested_stats.hit_stmts += sub_ctx.nested_stats.hit_stmts;
-         ctx->nested_stats.total_stmts += sub_ctx.nested_stats.total_stmts;
-         ctx->nested_stats.hit_branches += sub_ctx.nested_stats.hit_branches;
-         ctx->nested_stats.total_branches += sub_ctx.nested_stats.total_branches;
-         ctx->nested_stats.hit_toggles += sub_ctx.nested_stats.hit_toggles;
-         ctx->nested_stats.total_toggles += sub_ctx.nested_stats.total_toggles;
-         ctx->nested_stats.hit_expressions += sub_ctx.nested_stats.hit_expressions;
-         ctx->nested_stats.total_expressions += sub_ctx.nested_stats.total_expressions;
-         ctx->nested_stats.hit_states += sub_ctx.nested_stats.hit_states;
-         ctx->nested_stats.total_states += sub_ctx.nested_stats.total_states;
-      }
-      else
-         cover_report_scope(ctx, it, dir, summf, skipped);
+static hash_t *cover_read_checksums(const char *dir)
+{
+   char *fname LOCAL = xasprintf("%s/" CHECKSUM_FILE, dir);
+   FILE *f = fopen(fname, "r");
+   if (f == NULL)
+      return NULL;
+
+   hash_t *h = hash_new(256);
+
+   char *line = NULL;
+   size_t linesz = 0;
+   ssize_t len;
+   while ((len = getline(&line, &linesz, f)) != -1) {
+      if (len > 0 && line[len - 1] == '\n')
+         line[--len] = '\0';
+
+      char *eptr;
+      const uint64_t sum = strtoull(line, &eptr, 16);
+      if (*eptr != ' ')
+         continue;
+
+      uint64_t *value = xmalloc(sizeof(uint64_t));
+      *value = sum;
+
+      // Hierarchy names are unique so the key is never replaced
+      hash_put(h, ident_new(eptr + 1), value);
    }
+
+   free(line);
+   fclose(f);
+
+   return h;
 }
 
-void cover_report(const char *path, cover_data_t *data, int item_limit)
+static void cover_write_checksums(cover_rpt_state_t *state)
+{
+   char *fname LOCAL = xasprintf("%s/" CHECKSUM_FILE, state->dir);
+   FILE *f = fopen(fname, "w");
+   if (f == NULL)
+      fatal_errno("cannot create %s", fname);
+
+   for (int i = 0; i < state->pages.count; i++) {
+      cover_page_t *page = state->pages.items[i];
+      fprintf(f, "%016"PRIx64" %s\n", page->checksum,
+              istr(page->scope->hier));
+   }
+
+   fclose(f);
+}
+
+static void cover_free_page(cover_page_t *page)
+{
+   cover_report_ctx_t *ctx = &(page->ctx);
+
+   FREE_CHAIN(ctx, ch_stmt);
+   FREE_CHAIN(ctx, ch_branch);
+   FREE_CHAIN(ctx, ch_toggle);
+   FREE_CHAIN(ctx, ch_expression);
+   FREE_CHAIN(ctx, ch_state);
+   FREE_CHAIN(ctx, ch_functional);
+
+   ACLEAR(page->children);
+   free(page);
+}
+
+void cover_report(const char *path, cover_data_t *data, int item_limit,
+                  bool incremental)
 {
    char *subdir LOCAL = xasprintf("%s/hier", path);
    make_dir(path);
@@ -1364,25 +1610,58 @@ void cover_report(const char *path, cover_data_t *data, int item_limit)
    notef("Code coverage report folder: %s.", path);
    notef("%s", tb_get(tb));
 
-   char *top LOCAL = xasprintf("%s/index.html", path);
-   FILE *f = fopen(top, "w");
+   // The result of ctime is in a static buffer which is not safe to
+   // use from the worker threads
+   time_t t;
+   time(&t);
+   char *timestamp LOCAL = xstrdup(ctime(&t));
 
-   cover_print_html_header(f);
-   cover_print_hierarchy_header(f, "inst_table");
+   cover_rpt_state_t state = {
+      .dir       = subdir,
+      .timestamp = timestamp,
+      .checksums = incremental ? cover_read_checksums(subdir) : NULL,
+   };
 
+   data->report_item_limit = item_limit;
+
+   // Source files are loaded into a shared cache while collecting the
+   // items for each page and are only read by the worker threads
+   page_list_t top_pages = AINIT;
    for (int i = 0; i < data->root_scope->children.count; i++) {
       cover_scope_t *child = AGET(data->root_scope->children, i);
-      cover_report_ctx_t top_ctx = {};
+      APUSH(top_pages, cover_report_hierarchy(NULL, data, child, &state));
+   }
+
+   workq_t *wq = workq_new(&state);
+
+   for (int i = 0; i < state.pages.count; i++) {
+      cover_page_t *page = state.pages.items[i];
+      if (!cover_page_unchanged(&state, page))
+         workq_do(wq, cover_write_page, page);
+   }
+
+   workq_start(wq);
+   workq_drain(wq);
+   workq_free(wq);
+
+   if (incremental)
+      notef("Regenerated %u of %u hierarchy pages.", state.written,
+            state.pages.count);
+
+   char *top LOCAL = xasprintf("%s/index.html", path);
+   FILE *f = fopen(top, "w");
 
-      top_ctx.data = data;
-      data->report_item_limit = item_limit;
+   cover_print_html_header(f);
+   cover_print_hierarchy_header(f, "inst_table");
 
-      cover_report_hierarchy(&top_ctx, child, subdir);
-      cover_print_hierarchy_summary(f, &top_ctx, child->hier, true, true, false);
+   for (int i = 0; i < top_pages.count; i++) {
+      cover_page_t *page = top_pages.items[i];
+      cover_print_hierarchy_summary(f, &(page->ctx), page->scope->hier,
+                                    true, true, false);
    }
 
    cover_print_hierarchy_footer(f);
-   cover_print_timestamp(f);
+   cover_print_timestamp(f, timestamp);
 
    if (opt_get_int(OPT_VERBOSE)) {
       notef("Coverage for sub-hierarchies:");
@@ -1399,4 +1678,22 @@ void cover_report(const char *path, cover_data_t *data, int item_limit)
    }
 
    fclose(f);
+
+   cover_write_checksums(&state);
+
+   if (state.checksums != NULL) {
+      const void *key;
+      void *value;
+      hash_iter_t it = HASH_BEGIN;
+      while (hash_iter(state.checksums, &it, &key, &value))
+         free(value);
+
+      hash_free(state.checksums);
+   }
+
+   for (int i = 0; i < state.pages.count; i++)
+      cover_free_page(state.pages.items[i]);
+
+   ACLEAR(state.pages);
+   ACLEAR(top_pages);
 }
@@ -94,6 +94,9 @@ struct _debug_unwinder {
 
 static debug_unwinder_t *unwinders = NULL;
 
+// The various DWARF libraries do not seem to be thread-safe
+static nvc_lock_t platform_lock = 0;
+
 static void di_lru_reuse_frame(debug_frame_t *frame, uintptr_t pc)
 {
    free((char *)frame->module);
@@ -901,9 +904,7 @@ static inline void debug_walk_frames(debug_info_t *di)
 __attribute__((noinline))
 debug_info_t *debug_capture(void)
 {
-   // The various DWARF libraries do not seem to be thread-safe
-   static nvc_lock_t lock;
-   SCOPED_LOCK(lock);
+   SCOPED_LOCK(platform_lock);
 
    debug_info_t *di = xcalloc(sizeof(debug_info_t));
    debug_walk_frames(di);
@@ -953,11 +954,18 @@ void debug_remove_unwinder(void *start)
    fatal_trace("no unwinder registered for %p", start);
 }
 
-const char *debug_symbol_name(void *addr)
+const debug_frame_t *debug_lookup_frame(uintptr_t pc)
 {
+   SCOPED_LOCK(platform_lock);
+
    debug_frame_t *frame;
-   if (!di_lru_get((uintptr_t)addr, &frame))
-      platform_fill_frame((uintptr_t)addr, frame);
+   if (!di_lru_get(pc, &frame) && !custom_fill_frame(pc, frame))
+      platform_fill_frame(pc, frame);
 
-   return frame->symbol;
+   return frame;
+}
+
+const char *debug_symbol_name(void *addr)
+{
+   return debug_lookup_frame((uintptr_t)addr)->symbol;
 }
@@ -66,6 +66,7 @@ void debug_add_unwinder(void *start, size_t len, debug_unwind_fn_t fn,
                         void *context);
 void debug_remove_unwinder(void *start);
 
+const debug_frame_t *debug_lookup_frame(uintptr_t pc);
 const char *debug_symbol_name(void *addr);
 
 #endif   // _DEBUG_H
@@ -1097,6 +1097,12 @@ void diag_set_consumer(diag_consumer_t fn, void *context)
    consumer_ctx = context;
 }
 
+diag_consumer_t diag_get_consumer(void **context)
+{
+   *context = consumer_ctx;
+   return consumer_fn;
+}
+
 const char *diag_get_text(diag_t *d)
 {
    return tb_get(d->msg);
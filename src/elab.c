@@ -30,6 +30,7 @@
 #include "option.h"
 #include "phase.h"
 #include "psl/psl-phase.h"
+#include "sdf/sdf-util.h"
 #include "thread.h"
 #include "type.h"
 #include "vlog/vlog-defs.h"
@@ -40,6 +41,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
 #define MAX_DEPTH 127    // Limited by vcode type indexes
@@ -1200,11 +1202,92 @@ static tree_t elab_find_generic_override(tree_t g, const elab_ctx_t *ctx)
    return value;
 }
 
+static sdf_cell_t *elab_sdf_cell(tree_t unit, const elab_ctx_t *ctx)
+{
+   // SDF instance paths are relative to the top-level unit
+   ident_t hier = NULL;
+   for (const elab_ctx_t *e = ctx; e->inst; e = e->parent) {
+      if (e->inst != e->parent->inst)   // Component and its binding
+         hier = ident_prefix(tree_ident(e->inst), hier, '.');
+   }
+
+   ident_t celltype = ident_rfrom(tree_ident(unit), '.');
+
+   // VHDL names are not case sensitive but SDF names are so try the
+   // conventional lower case spelling first
+   sdf_cell_t *cell = sdf_find_cell(ctx->sdf, ident_downcase(celltype),
+                                    hier ? ident_downcase(hier) : NULL);
+   if (cell == NULL)
+      cell = sdf_find_cell(ctx->sdf, celltype, hier);
+
+   return cell;
+}
+
+static tree_t elab_sdf_delay(tree_t g, const sdf_cell_t *cell)
+{
+   // Back-annotate VITAL style tpd_<input>_<output> and tipd_<input>
+   // generics with a scalar time type from absolute IOPATH and PORT
+   // delays using the first value in each list
+   type_t type = tree_type(g);
+   if (!type_is_physical(type)
+       || !type_eq(type_base_recur(type), std_type(NULL, STD_TIME)))
+      return NULL;
+
+   const char *name = istr(tree_ident(g));
+   int64_t value = SDF_NO_VALUE;
+
+   LOCAL_TEXT_BUF tb = tb_new();
+   for (int i = 0; i < cell->delays.count; i++) {
+      const sdf_delay_t *d = &(cell->delays.items[i]);
+      if (!(d->flags & S_F_VALUE_ABSOLUTE) || d->nvalues == 0)
+         continue;
+
+      tb_rewind(tb);
+      switch (d->kind) {
+      case S_DELAY_IOPATH:
+         tb_printf(tb, "tpd_%s_%s", istr(d->from), istr(d->to));
+         break;
+      case S_DELAY_PORT:
+         tb_printf(tb, "tipd_%s", istr(d->to));
+         break;
+      default:
+         continue;
+      }
+
+      if (strcasecmp(tb_get(tb), name) != 0)
+         continue;
+
+      // Only the value selected by the min:typ:max option is stored
+      const sdf_value_t *v = &(cell->values.items[d->first]);
+      if (v->typ != SDF_NO_VALUE)
+         value = v->typ;
+      else if (v->min != SDF_NO_VALUE)
+         value = v->min;
+      else if (v->max != SDF_NO_VALUE)
+         value = v->max;
+   }
+
+   if (value == SDF_NO_VALUE)
+      return NULL;
+
+   tree_t result = tree_new(T_LITERAL);
+   tree_set_subkind(result, L_PHYSICAL);
+   tree_set_type(result, type);
+   tree_set_ival(result, value);
+   tree_set_loc(result, tree_loc(g));
+
+   return result;
+}
+
 static void elab_generics(tree_t entity, tree_t bind, elab_ctx_t *ctx)
 {
    const int ngenerics = tree_generics(entity);
    const int ngenmaps = tree_genmaps(bind);
 
+   sdf_cell_t *cell = NULL;
+   if (ctx->sdf != NULL && ngenerics > 0)
+      cell = elab_sdf_cell(entity, ctx);
+
    for (int i = 0; i < ngenerics; i++) {
       tree_t g = tree_generic(entity, i);
       tree_add_generic(ctx->out, g);
@@ -1224,6 +1307,9 @@ static void elab_generics(tree_t entity, tree_t bind, elab_ctx_t *ctx)
       }
 
       tree_t override = elab_find_generic_override(g, ctx);
+      if (override == NULL && cell != NULL)
+         override = elab_sdf_delay(g, cell);
+
       if (override != NULL) {
          map = tree_new(T_PARAM);
          tree_set_subkind(map, P_POS);
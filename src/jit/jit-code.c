@@ -95,13 +95,20 @@ typedef struct {
    code_comment_t *comments;
 } code_debug_t;
 
+typedef struct {
+   uint8_t *addr;
+   ident_t  name;
+} code_symbol_t;
+
 typedef struct _code_span {
-   code_cache_t *owner;
-   code_span_t  *next;
-   ident_t       name;
-   uint8_t      *base;
-   void         *entry;
-   size_t        size;
+   code_cache_t  *owner;
+   code_span_t   *next;
+   ident_t        name;
+   uint8_t       *base;
+   void          *entry;
+   size_t         size;
+   code_symbol_t *symbols;
+   unsigned       nsymbols;
 #ifdef DEBUG
    code_debug_t  debug;
 #endif
@@ -114,6 +121,13 @@ typedef struct _patch_list {
    code_patch_fn_t  fn;
 } patch_list_t;
 
+typedef struct _export_list {
+   export_list_t  *next;
+   ident_t         name;
+   void           *addr;
+   jit_entry_fn_t *entry;
+} export_list_t;
+
 typedef struct _code_page {
    code_cache_t *owner;
    code_page_t  *next;
@@ -138,6 +152,22 @@ typedef struct _code_cache {
 static void code_disassemble(code_span_t *span, uintptr_t mark,
                              struct cpu_state *cpu);
 
+static const code_symbol_t *code_span_symbol(code_span_t *span,
+                                             const uint8_t *pc)
+{
+   // Spans containing several functions have their entry points sorted
+   // by address: the first covers anything before the second
+   const unsigned nsymbols = load_acquire(&span->nsymbols);
+   if (nsymbols == 0)
+      return NULL;
+
+   const code_symbol_t *sym = &(span->symbols[0]);
+   for (int i = 1; i < nsymbols && span->symbols[i].addr <= pc; i++)
+      sym = &(span->symbols[i]);
+
+   return sym;
+}
+
 static void code_cache_unwinder(uintptr_t addr, debug_frame_t *frame,
                                 void *context)
 {
@@ -146,9 +176,16 @@ static void code_cache_unwinder(uintptr_t addr, debug_frame_t *frame,
    const uint8_t *pc = (uint8_t *)addr;
    for (code_span_t *span = code->spans; span; span = span->next) {
       if (pc >= span->base && pc < span->base + span->size) {
+         const code_symbol_t *sym = code_span_symbol(span, pc);
          frame->kind = FRAME_VHDL;
-         frame->disp = pc - span->base;
-         frame->symbol = istr(span->name);
+         if (sym != NULL && pc >= sym->addr) {
+            frame->disp = pc - sym->addr;
+            frame->symbol = istr(sym->name);
+         }
+         else {
+            frame->disp = pc - span->base;
+            frame->symbol = istr(sym ? sym->name : span->name);
+         }
       }
    }
 }
@@ -271,6 +308,7 @@ void code_cache_free(code_cache_t *code)
 
    for (code_span_t *it = code->spans, *tmp; it; it = tmp) {
       tmp = it->next;
+      free(it->symbols);
       free(it);
    }
 
@@ -421,8 +459,19 @@ static void code_write_perf_map(code_span_t *span)
          debugf("writing perf map to %s", fname);
    }
 
-   fprintf(span->owner->perfmap, "%p 0x%zx %s\n", span->base, span->size,
-           istr(span->name));
+   if (span->nsymbols == 0)
+      fprintf(span->owner->perfmap, "%p 0x%zx %s\n", span->base, span->size,
+              istr(span->name));
+
+   for (int i = 0; i < span->nsymbols; i++) {
+      uint8_t *start = i == 0 ? span->base : span->symbols[i].addr;
+      uint8_t *end = i + 1 < span->nsymbols
+         ? span->symbols[i + 1].addr : span->base + span->size;
+
+      fprintf(span->owner->perfmap, "%p 0x%tx %s\n", start, end - start,
+              istr(span->symbols[i].name));
+   }
+
    fflush(span->owner->perfmap);
 }
 
@@ -483,6 +532,89 @@ code_blob_t *code_blob_new(code_cache_t *code, ident_t name, size_t hint)
    return blob;
 }
 
+static void code_free_exports(code_blob_t *blob)
+{
+   for (export_list_t *it = blob->exports, *tmp; it; it = tmp) {
+      tmp = it->next;
+      free(it);
+   }
+   blob->exports = NULL;
+}
+
+void code_blob_export(code_blob_t *blob, ident_t name, jit_entry_fn_t *entry)
+{
+   // Additional function in the same object whose address is stored
+   // to ENTRY when the blob is finalised
+   export_list_t *e = xcalloc(sizeof(export_list_t));
+   e->next  = blob->exports;
+   e->name  = name;
+   e->entry = entry;
+
+   blob->exports = e;
+}
+
+static void *code_blob_lookup(code_blob_t *blob, const char *name)
+{
+   if (icmp(blob->span->name, name))
+      return blob->span->entry;
+
+   for (export_list_t *it = blob->exports; it; it = it->next) {
+      if (icmp(it->name, name))
+         return it->addr;
+   }
+
+   return NULL;
+}
+
+static int code_symbol_cmp(const void *a, const void *b)
+{
+   const code_symbol_t *sa = a, *sb = b;
+   return sa->addr < sb->addr ? -1 : (sa->addr > sb->addr ? 1 : 0);
+}
+
+static void code_blob_add_symbols(code_blob_t *blob)
+{
+   // Record where each function in the blob starts so the unwinder
+   // and perf map do not attribute every PC to the first function
+   code_span_t *span = blob->span;
+
+   int count = 1;
+   for (export_list_t *it = blob->exports; it; it = it->next)
+      count++;
+
+   code_symbol_t *symbols = xcalloc_array(count, sizeof(code_symbol_t));
+   symbols[0].addr = span->entry;
+   symbols[0].name = span->name;
+
+   int pos = 1;
+   for (export_list_t *it = blob->exports; it; it = it->next, pos++) {
+      symbols[pos].addr = it->addr;
+      symbols[pos].name = it->name;
+   }
+
+   qsort(symbols, count, sizeof(code_symbol_t), code_symbol_cmp);
+
+   span->symbols = symbols;
+   store_release(&span->nsymbols, count);
+}
+
+static bool code_blob_define(code_blob_t *blob, const char *name, void *addr)
+{
+   if (icmp(blob->span->name, name)) {
+      blob->span->entry = addr;
+      return true;
+   }
+
+   for (export_list_t *it = blob->exports; it; it = it->next) {
+      if (icmp(it->name, name)) {
+         it->addr = addr;
+         return true;
+      }
+   }
+
+   return false;
+}
+
 void code_blob_finalise(code_blob_t *blob, jit_entry_fn_t *entry)
 {
    code_span_t *span = blob->span;
@@ -500,6 +632,7 @@ void code_blob_finalise(code_blob_t *blob, jit_entry_fn_t *entry)
       // Return all the memory
       freespan->size = freespan->base - span->base;
       freespan->base = span->base;
+      code_free_exports(blob);
       free(blob);
       return;
    }
@@ -522,6 +655,19 @@ void code_blob_finalise(code_blob_t *blob, jit_entry_fn_t *entry)
 
    store_release(entry, (jit_entry_fn_t)span->entry);
 
+   for (export_list_t *it = blob->exports; it; it = it->next) {
+      if (it->addr == NULL)
+         fatal_trace("missing symbol %s in %s", istr(it->name),
+                     istr(span->name));
+
+      store_release(it->entry, (jit_entry_fn_t)it->addr);
+   }
+
+   if (blob->exports != NULL)
+      code_blob_add_symbols(blob);
+
+   code_free_exports(blob);
+
    DEBUG_ONLY(relaxed_add(&span->owner->used, span->size));
    free(blob);
 
@@ -813,8 +959,8 @@ static void code_load_pe(code_blob_t *blob, const void *data, size_t size)
          else
             ptr = ffi_find_symbol(NULL, name);
 
-         if (ptr == NULL && icmp(blob->span->name, name))
-            ptr = blob->span->base;
+         if (ptr == NULL)
+            ptr = code_blob_lookup(blob, name);
 
          if (ptr == NULL)
             fatal_trace("failed to resolve symbol %s", name);
@@ -859,10 +1005,9 @@ static void code_load_pe(code_blob_t *blob, const void *data, size_t size)
          continue;
       else if ((sym->Type >> 4) != IMAGE_SYM_DTYPE_FUNCTION)
          continue;
-      else if (icmp(blob->span->name, strtab + sym->N.Name.Long)) {
-         blob->span->entry = load_addr[sym->SectionNumber - 1] + sym->Value;
-         break;
-      }
+      else
+         code_blob_define(blob, strtab + sym->N.Name.Long,
+                          load_addr[sym->SectionNumber - 1] + sym->Value);
    }
 }
 #elif defined __APPLE__
@@ -939,10 +1084,10 @@ static void code_load_macho(code_blob_t *blob, const void *data, size_t size)
                + rel->r_symbolnum * sizeof(struct nlist_64);
             name = data + symtab->stroff + nl->n_un.n_strx;
 
-            if (nl->n_type & N_EXT) {
-               if (icmp(blob->span->name, name + 1))
-                  ptr = blob->span->base;
-               else if ((ptr = ffi_find_symbol(NULL, name + 1)) == NULL)
+            if ((nl->n_type & N_EXT) && nl->n_sect != NO_SECT)
+               ptr = load_addr[nl->n_sect - 1] + nl->n_value;
+            else if (nl->n_type & N_EXT) {
+               if ((ptr = ffi_find_symbol(NULL, name + 1)) == NULL)
                   fatal_trace("failed to resolve symbol %s", name + 1);
             }
             else if (nl->n_sect != NO_SECT)
@@ -1030,10 +1175,9 @@ static void code_load_macho(code_blob_t *blob, const void *data, size_t size)
          continue;
 
       const char *name = data + symtab->stroff + sym->n_un.n_strx;
-      if (name[0] == '_' && icmp(blob->span->name, name + 1)) {
-         blob->span->entry = load_addr[sym->n_sect - 1] + sym->n_value;
-         break;
-      }
+      if (name[0] == '_')
+         code_blob_define(blob, name + 1,
+                          load_addr[sym->n_sect - 1] + sym->n_value);
    }
 }
 #elif !defined __MINGW32__
@@ -1084,15 +1228,15 @@ static void code_load_elf(code_blob_t *blob, const void *data, size_t size)
 
             if (ELF64_ST_TYPE(sym->st_info) != STT_FUNC)
                continue;
-            else if (!icmp(blob->span->name, strtab + sym->st_name))
+            else if (sym->st_shndx == SHN_UNDEF
+                     || sym->st_shndx >= ehdr->e_shnum)
                continue;
-            else if (load_addr[sym->st_shndx] == NULL)
+            else if (load_addr[sym->st_shndx] != NULL)
+               code_blob_define(blob, strtab + sym->st_name,
+                                load_addr[sym->st_shndx] + sym->st_value);
+            else if (code_blob_define(blob, strtab + sym->st_name, NULL))
                fatal_trace("missing section %d for symbol %s", sym->st_shndx,
                            strtab + sym->st_name);
-            else {
-               blob->span->entry = load_addr[sym->st_shndx] + sym->st_value;
-               break;
-            }
          }
          break;
 
@@ -1128,23 +1272,29 @@ static void code_load_elf(code_blob_t *blob, const void *data, size_t size)
          const Elf64_Sym *sym = data + symtab->sh_offset
             + ELF64_R_SYM(r->r_info) * symtab->sh_entsize;
 
+         const char *name = strtab + sym->st_name;
+         const bool defined = sym->st_shndx != SHN_UNDEF
+            && sym->st_shndx < ehdr->e_shnum;
+
          char *ptr = NULL;
          switch (ELF64_ST_TYPE(sym->st_info)) {
          case STT_NOTYPE:
          case STT_FUNC:
-            ptr = ffi_find_symbol(NULL, strtab + sym->st_name);
+            // Calls between functions in the same object including
+            // references to itself and to OSR entry points
+            if (defined && load_addr[sym->st_shndx] != NULL)
+               ptr = load_addr[sym->st_shndx] + sym->st_value;
+            else if ((ptr = code_blob_lookup(blob, name)) == NULL)
+               ptr = ffi_find_symbol(NULL, name);
             break;
          case STT_SECTION:
             ptr = load_addr[sym->st_shndx];
             break;
          }
 
-         if (ptr == NULL && icmp(blob->span->name, strtab + sym->st_name))
-            ptr = (char *)blob->span->base;
-
          if (ptr == NULL)
             fatal_trace("cannot resolve symbol %s type %d",
-                        strtab + sym->st_name, ELF64_ST_TYPE(sym->st_info));
+                        name, ELF64_ST_TYPE(sym->st_info));
 
          ptr += r->r_addend;
 
@@ -1182,7 +1332,7 @@ static void code_load_elf(code_blob_t *blob, const void *data, size_t size)
             blob->span->size = blob->wptr - blob->span->base;
             code_disassemble(blob->span, (uintptr_t)patch, NULL);
             fatal_trace("cannot handle relocation type %ld for symbol %s",
-                        ELF64_R_TYPE(r->r_info), strtab + sym->st_name);
+                        ELF64_R_TYPE(r->r_info), name);
          }
       }
    }
@@ -53,12 +53,29 @@
 #define FUNC_HASH_SZ    1024
 #define FUNC_LIST_SZ    512
 #define COMPILE_TIMEOUT 100000
+#define CGEN_BATCH_SIZE 8
+
+typedef struct {
+   jit_func_t *func;
+   uint64_t    enqueued;
+} cgen_request_t;
+
+typedef struct {
+   unsigned compiled;
+   unsigned batches;
+   uint64_t total_us;
+   uint64_t max_us;
+} cgen_stats_t;
 
 typedef struct _jit_tier {
-   jit_tier_t    *next;
-   int            threshold;
-   jit_plugin_t   plugin;
-   void          *context;
+   jit_tier_t        *next;
+   int                threshold;
+   jit_plugin_t       plugin;
+   void              *context;
+   nvc_lock_t         lock;
+   A(cgen_request_t)  queue;
+   int                workers;
+   cgen_stats_t       stats;
 } jit_tier_t;
 
 typedef struct {
@@ -103,8 +120,9 @@ typedef struct _jit {
    func_array_t    *funcs;
    unsigned         next_handle;
    nvc_lock_t       lock;
-   int32_t         *cover_mem;
+   uint8_t         *cover_mem;
    unsigned         cover_ntags;
+   unsigned         cover_bits;
    jit_irq_fn_t     interrupt;
    void            *interrupt_ctx;
    unit_registry_t *registry;
@@ -155,6 +173,7 @@ jit_t *jit_new(unit_registry_t *ur)
    j->index       = chash_new(FUNC_HASH_SZ);
    j->mspace      = mspace_new(opt_get_size(OPT_HEAP_SIZE));
    j->exit_status = INT_MIN;
+   j->cover_bits  = 32;
 
    j->funcs = xcalloc_flex(sizeof(func_array_t),
                            FUNC_LIST_SZ, sizeof(jit_func_t *));
@@ -178,6 +197,20 @@ static void jit_free_func(jit_func_t *f)
    free(f);
 }
 
+static void jit_print_cgen_stats(jit_t *j)
+{
+   for (jit_tier_t *it = j->tiers; it; it = it->next) {
+      const cgen_stats_t *s = &(it->stats);
+      if (s->compiled == 0 && it->queue.count == 0)
+         continue;
+
+      const unsigned avg_ms = s->compiled ? s->total_us / s->compiled / 1000 : 0;
+      notef("JIT compiled:%u batches:%u latency avg:%ums max:%ums "
+            "abandoned:%u", s->compiled, s->batches, avg_ms,
+            (unsigned)(s->max_us / 1000), it->queue.count);
+   }
+}
+
 void jit_free(jit_t *j)
 {
    store_release(&j->shutdown, true);
@@ -201,9 +234,13 @@ void jit_free(jit_t *j)
 
    free(j->cover_mem);
 
+   if (opt_get_int(OPT_RT_STATS))
+      jit_print_cgen_stats(j);
+
    for (jit_tier_t *it = j->tiers, *tmp; it; it = tmp) {
       tmp = it->next;
       (*it->plugin.cleanup)(it->context);
+      ACLEAR(it->queue);
       free(it);
    }
 
@@ -280,13 +317,14 @@ static jit_handle_t jit_lazy_compile_locked(jit_t *j, ident_t name)
       jit_bind_intrinsic(name) ?: (descr ? descr->entry : jit_interp);
 
    f = xcalloc(sizeof(jit_func_t));
-   f->name      = name;
-   f->state     = descr ? JIT_FUNC_COMPILING : JIT_FUNC_PLACEHOLDER;
-   f->jit       = j;
-   f->handle    = j->next_handle++;
-   f->next_tier = j->tiers;
-   f->hotness   = f->next_tier ? f->next_tier->threshold : 0;
-   f->entry     = entry;
+   f->name       = name;
+   f->state      = descr ? JIT_FUNC_COMPILING : JIT_FUNC_PLACEHOLDER;
+   f->jit        = j;
+   f->handle     = j->next_handle++;
+   f->next_tier  = j->tiers;
+   f->hotness    = f->next_tier ? f->next_tier->threshold : 0;
+   f->entry      = entry;
+   f->osr_target = JIT_LABEL_INVALID;
 
    // Install now to allow circular references in relocations
    jit_install(j, f);
@@ -1006,13 +1044,96 @@ bool jit_exit_status(jit_t *j, int *status)
       return false;
 }
 
-static void jit_async_cgen(void *context, void *arg)
+static int jit_take_requests(jit_tier_t *tier, cgen_request_t *batch)
 {
-   jit_func_t *f = context;
-   jit_tier_t *tier = arg;
+   assert_lock_held(&tier->lock);
 
-   if (!load_acquire(&f->jit->shutdown))
-      (*tier->plugin.cgen)(f->jit, f->handle, tier->context);
+   // Functions called most often while waiting in the queue are
+   // compiled first
+   int count = 0;
+   for (; count < CGEN_BATCH_SIZE && tier->queue.count > 0; count++) {
+      int best = 0;
+      unsigned max = 0;
+      for (int i = 0; i < tier->queue.count; i++) {
+         jit_func_t *f = tier->queue.items[i].func;
+         const unsigned hotness = relaxed_load(&f->hotness);
+         if (hotness > max) {
+            best = i;
+            max = hotness;
+         }
+      }
+
+      batch[count] = tier->queue.items[best];
+      tier->queue.items[best] = APOP(tier->queue);
+
+      relaxed_store(&batch[count].func->queued, false);
+   }
+
+   return count;
+}
+
+static void jit_cgen_worker(void *context, void *arg)
+{
+   jit_tier_t *tier = context;
+   jit_t *j = arg;
+
+   for (;;) {
+      cgen_request_t batch[CGEN_BATCH_SIZE];
+      int count;
+      {
+         SCOPED_LOCK(tier->lock);
+
+         if (tier->queue.count == 0 || load_acquire(&j->shutdown)) {
+            tier->workers--;
+            return;
+         }
+
+         count = jit_take_requests(tier, batch);
+      }
+
+      if (tier->plugin.cgen_batch != NULL) {
+         jit_handle_t handles[CGEN_BATCH_SIZE];
+         for (int i = 0; i < count; i++)
+            handles[i] = batch[i].func->handle;
+
+         (*tier->plugin.cgen_batch)(j, handles, count, tier->context);
+      }
+      else {
+         for (int i = 0; i < count; i++)
+            (*tier->plugin.cgen)(j, batch[i].func->handle, tier->context);
+      }
+
+      const uint64_t now = get_timestamp_us();
+
+      SCOPED_LOCK(tier->lock);
+
+      for (int i = 0; i < count; i++) {
+         const uint64_t latency = now - batch[i].enqueued;
+         tier->stats.total_us += latency;
+         tier->stats.max_us = MAX(tier->stats.max_us, latency);
+      }
+
+      tier->stats.compiled += count;
+      tier->stats.batches++;
+   }
+}
+
+static void jit_enqueue_cgen(jit_func_t *f, jit_tier_t *tier)
+{
+   const cgen_request_t req = {
+      .func     = f,
+      .enqueued = get_timestamp_us(),
+   };
+
+   SCOPED_LOCK(tier->lock);
+
+   APUSH(tier->queue, req);
+   relaxed_store(&f->queued, true);
+
+   if (tier->workers < MAX(1, opt_get_int(OPT_JIT_THREADS))) {
+      tier->workers++;
+      async_do(jit_cgen_worker, tier, f->jit);
+   }
 }
 
 void jit_tier_up(jit_func_t *f)
@@ -1020,13 +1141,29 @@ void jit_tier_up(jit_func_t *f)
    assert(f->hotness <= 0);
    assert(f->next_tier != NULL);
 
-   if (opt_get_int(OPT_JIT_ASYNC))
-      async_do(jit_async_cgen, f, f->next_tier);
-   else
-      (f->next_tier->plugin.cgen)(f->jit, f->handle, f->next_tier->context);
+   jit_tier_t *tier = f->next_tier;
 
    f->hotness   = 0;
    f->next_tier = NULL;
+
+   if (opt_get_int(OPT_JIT_ASYNC))
+      jit_enqueue_cgen(f, tier);
+   else
+      (*tier->plugin.cgen)(f->jit, f->handle, tier->context);
+}
+
+void jit_tier_up_osr(jit_func_t *f, jit_label_t target)
+{
+   // Called by the interpreter when a loop has executed many times
+   // without returning: the code generator may additionally emit an
+   // entry point for the loop header at TARGET
+   if (!atomic_cas(&f->osr_target, JIT_LABEL_INVALID, target))
+      return;   // Already requested by another thread
+
+   f->hotness = 0;
+
+   if (f->next_tier != NULL)
+      jit_tier_up(f);
 }
 
 void jit_add_tier(jit_t *j, int threshold, const jit_plugin_t *plugin)
@@ -1074,13 +1211,14 @@ jit_handle_t jit_assemble(jit_t *j, ident_t name, const char *text)
 
    f = xcalloc(sizeof(jit_func_t));
 
-   f->name      = name;
-   f->state     = JIT_FUNC_READY;
-   f->jit       = j;
-   f->handle    = j->next_handle++;
-   f->next_tier = j->tiers;
-   f->hotness   = f->next_tier ? f->next_tier->threshold : 0;
-   f->entry     = jit_interp;
+   f->name       = name;
+   f->state      = JIT_FUNC_READY;
+   f->jit        = j;
+   f->handle     = j->next_handle++;
+   f->next_tier  = j->tiers;
+   f->hotness    = f->next_tier ? f->next_tier->threshold : 0;
+   f->entry      = jit_interp;
+   f->osr_target = JIT_LABEL_INVALID;
 
    jit_install(j, f);
 
@@ -1136,6 +1274,7 @@ jit_handle_t jit_assemble(jit_t *j, ident_t name, const char *text)
       { "$LALLOC", MACRO_LALLOC, 1, 1 },
       { "$BZERO",  MACRO_BZERO,  1, 1 },
       { "$MEMSET", MACRO_MEMSET, 1, 2 },
+      { "$REEXEC", MACRO_REEXEC, 0, 0 },
       { "$EXP",    MACRO_EXP,    1, 2 },
       { "$FEXP",   MACRO_FEXP,   1, 2 },
    };
@@ -1394,22 +1533,43 @@ bool jit_will_abort(jit_ir_t *ir)
       return ir->op == J_TRAP;
 }
 
-int32_t *jit_get_cover_mem(jit_t *j, int mintags)
+void jit_set_cover_bits(jit_t *j, unsigned bits)
+{
+   assert(bits == 1 || bits == 8 || bits == 32);
+   assert(j->cover_mem == NULL || j->cover_bits == bits);
+
+   j->cover_bits = bits;
+}
+
+unsigned jit_get_cover_bits(jit_t *j)
+{
+   return j->cover_bits;
+}
+
+void *jit_get_cover_mem(jit_t *j, int mintags)
 {
    if (mintags > j->cover_ntags) {
-      j->cover_mem = xrealloc_array(j->cover_mem, mintags, sizeof(int32_t));
-      memset(j->cover_mem + j->cover_ntags, '\0',
-             (mintags - j->cover_ntags) * sizeof(int32_t));
+      // Narrow counters are packed so round up to a whole byte
+      const size_t oldsz = (j->cover_ntags * j->cover_bits + 7) / 8;
+      const size_t newsz = (mintags * j->cover_bits + 7) / 8;
+
+      j->cover_mem = xrealloc(j->cover_mem, newsz);
+      memset(j->cover_mem + oldsz, '\0', newsz - oldsz);
       j->cover_ntags = mintags;
    }
 
    return j->cover_mem;
 }
 
-int32_t *jit_get_cover_ptr(jit_t *j, jit_value_t addr)
+void *jit_get_cover_ptr(jit_t *j, jit_value_t addr)
 {
    assert(addr.kind == JIT_ADDR_COVER);
-   int32_t *base = jit_get_cover_mem(j, addr.int64 + 1);
+
+   // The address is a byte offset into the packed counter array
+   const int nbits = (addr.int64 + 1) * 8;
+   const int mintags = (nbits + j->cover_bits - 1) / j->cover_bits;
+
+   uint8_t *base = jit_get_cover_mem(j, mintags);
    assert(base != NULL);
    return base + addr.int64;
 }
@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,8 +46,13 @@ typedef struct _jit_interp {
    mspace_t      *mspace;
    jit_anchor_t  *anchor;
    tlab_t        *tlab;
+   unsigned       backedges;
 } jit_interp_t;
 
+// Number of loop iterations in a single call before requesting
+// compiled code that can be entered at the loop header
+#define OSR_THRESHOLD 1000
+
 #ifdef DEBUG
 #define JIT_ASSERT(expr) do {                                      \
       if (unlikely(!(expr))) {                                     \
@@ -596,24 +602,56 @@ static void interp_branch_to(jit_interp_t *state, jit_value_t label)
    JIT_ASSERT(state->pc < state->func->nirs);
 }
 
-static void interp_jump(jit_interp_t *state, jit_ir_t *ir)
+static bool interp_back_edge(jit_interp_t *state, jit_label_t target)
+{
+   if (likely(state->backedges < OSR_THRESHOLD)) {
+      state->backedges++;
+      return false;
+   }
+
+   jit_func_t *f = state->func;
+
+   // The OSR target and entry point may be written by another thread
+   // requesting or completing compilation of this function
+   jit_osr_fn_t osr = load_acquire(&f->osr_entry);
+   if (osr != NULL && atomic_load(&f->osr_target) == target) {
+      // Continue the rest of this call in compiled code which uses the
+      // interpreter's frame for stack allocations
+      (*osr)(f, state->anchor->caller, state->args, state->tlab,
+             state->regs, state->frame, state->flags);
+      return true;
+   }
+   else if (f->next_tier != NULL
+            && atomic_load(&f->osr_target) == JIT_LABEL_INVALID)
+      jit_tier_up_osr(f, target);
+
+   return false;
+}
+
+static bool interp_jump(jit_interp_t *state, jit_ir_t *ir)
 {
    switch (ir->cc) {
    case JIT_CC_NONE:
-      interp_branch_to(state, ir->arg1);
       break;
    case JIT_CC_T:
-      if (state->flags)
-         interp_branch_to(state, ir->arg1);
+      if (!state->flags)
+         return false;
       break;
    case JIT_CC_F:
-      if (!state->flags)
-         interp_branch_to(state, ir->arg1);
+      if (state->flags)
+         return false;
       break;
    default:
       interp_dump(state);
       fatal_trace("unhandled jump condition code");
    }
+
+   interp_branch_to(state, ir->arg1);
+
+   if (state->pc <= ir - state->func->irbuf)
+      return interp_back_edge(state, state->pc);
+   else
+      return false;
 }
 
 static void interp_trap(jit_interp_t *state, jit_ir_t *ir)
@@ -959,7 +997,8 @@ static void interp_loop(jit_interp_t *state)
          interp_cset(state, ir);
          break;
       case J_JUMP:
-         interp_jump(state, ir);
+         if (interp_jump(state, ir))
+            return;   // Finished in compiled code
          break;
       case J_TRAP:
          interp_trap(state, ir);
@@ -1069,6 +1108,13 @@ void jit_interp(jit_func_t *f, jit_anchor_t *caller, jit_scalar_t *args,
 
    if (f->next_tier && --(f->hotness) <= 0)
       jit_tier_up(f);
+   else if (unlikely(relaxed_load(&f->queued))) {
+      // Priority in the compile queue: lost updates from concurrent
+      // calls do not matter here
+      const unsigned hotness = relaxed_load(&f->hotness);
+      if (hotness < UINT_MAX)
+         relaxed_store(&f->hotness, hotness + 1);
+   }
 
    jit_anchor_t anchor = {
       .caller    = caller,
@@ -124,7 +124,31 @@ static const uint8_t or_table[16][16] = {
    {    _U, _X, _X, _1, _X, _X, _X, _1, _X   },  // | - |
 };
 
-#if defined HAVE_SSE41 || defined HAVE_NEON
+__attribute__((aligned(16)))
+static const uint8_t not_table[16] = {
+   _U, _X, _1, _0, _X, _X, _1, _0, _X, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static const bool match_table[16][16] = {
+   // ---------------------------------------------------
+   // |  U  X  0  1  Z  W  L  H  -                  |   |
+   // ---------------------------------------------------
+   {     0, 0, 0, 0, 0, 0, 0, 0, 1   },          // | U |
+   {     0, 0, 0, 0, 0, 0, 0, 0, 1   },          // | X |
+   {     0, 0, 1, 0, 0, 0, 1, 0, 1   },          // | 0 |
+   {     0, 0, 0, 1, 0, 0, 0, 1, 1   },          // | 1 |
+   {     0, 0, 0, 0, 0, 0, 0, 0, 1   },          // | Z |
+   {     0, 0, 0, 0, 0, 0, 0, 0, 1   },          // | W |
+   {     0, 0, 1, 0, 0, 0, 1, 0, 1   },          // | L |
+   {     0, 0, 0, 1, 0, 0, 0, 1, 1   },          // | H |
+   {     1, 1, 1, 1, 1, 1, 1, 1, 1   },          // | - |
+};
+
+#define LENGTH_MSG(op)                                                  \
+   "STD_LOGIC_1164.\"" op "\": arguments of overloaded '" op "' "        \
+   "operator are not of the same length"
+
+#if defined HAVE_SSE41 || defined HAVE_NEON || defined HAVE_AVX2
 
 // Compressed lookup tables for vectorised intrinsics.  Note the
 // vectorised intrinsics all rely on being able to read up to
@@ -181,8 +205,78 @@ static const uint8_t small_xor_table[4][4] = {
 };
 
 __attribute__((aligned(16)))
-static const uint8_t lane_iota[16] = {
-   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+static const uint8_t small_nand_table[4][4] = {
+   // -----------------------------
+   // |  U   X   0   1        |   |
+   // -----------------------------
+   {    _U, _U, _1, _U },  // | U |
+   {    _U, _X, _1, _X },  // | X |
+   {    _1, _1, _1, _1 },  // | 0 |
+   {    _U, _X, _1, _0 },  // | 1 |
+};
+
+__attribute__((aligned(16)))
+static const uint8_t small_nor_table[4][4] = {
+   // -----------------------------
+   // |  U   X   0   1        |   |
+   // -----------------------------
+   {    _U, _U, _U, _0 },  // | U |
+   {    _U, _X, _X, _0 },  // | X |
+   {    _U, _X, _1, _0 },  // | 0 |
+   {    _0, _0, _0, _0 },  // | 1 |
+};
+
+__attribute__((aligned(16)))
+static const uint8_t small_xnor_table[4][4] = {
+   // -----------------------------
+   // |  U   X   0   1        |   |
+   // -----------------------------
+   {    _U, _U, _U, _U },  // | U |
+   {    _U, _X, _X, _X },  // | X |
+   {    _U, _X, _1, _0 },  // | 0 |
+   {    _U, _X, _0, _1 },  // | 1 |
+};
+
+// STD_MATCH compresses each element to one of 0/L, 1/H, '-', or any
+// other value which never matches
+
+__attribute__((aligned(16)))
+static const uint8_t compress_match_left[16] = {
+   2,    2,    0,    1,
+   2,    2,    0,    1,
+   3,    0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff,
+};
+
+__attribute__((aligned(16)))
+static const uint8_t compress_match_right[16] = {
+   2 << 2, 2 << 2, 0 << 2, 1 << 2,
+   2 << 2, 2 << 2, 0 << 2, 1 << 2,
+   3 << 2, 0xff,   0xff,   0xff,
+   0xff,   0xff,   0xff,   0xff,
+};
+
+__attribute__((aligned(16)))
+static const uint8_t small_mismatch_table[4][4] = {
+   // ----------------------------------
+   // |  0     1     ?     -       |   |
+   // ----------------------------------
+   {    0x00, 0xff, 0xff, 0x00 },  // | 0 |
+   {    0xff, 0x00, 0xff, 0x00 },  // | 1 |
+   {    0xff, 0xff, 0xff, 0x00 },  // | ? |
+   {    0x00, 0x00, 0x00, 0x00 },  // | - |
+};
+
+__attribute__((aligned(16)))
+static const uint8_t cvt_to_01[16] = {
+   0xff, 0xff, _0,   _1,   0xff, 0xff, _0,   _1,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+__attribute__((aligned(32)))
+static const uint8_t lane_iota[32] = {
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+   16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
 };
 
 #endif
@@ -295,6 +389,31 @@ static inline void __invert_bits(const uint8_t *input, int size,
    }
 }
 
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static void std_to_x01_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = args[3].integer ^ (args[3].integer >> 63);
+   const uint8_t *input = args[1].pointer;
+
+   uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(size, 32), 16);
+
+   __m256i lookup =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)cvt_to_x01));
+
+   for (int pos = 0; pos < size; pos += 32) {
+      __m256i in = _mm256_loadu_si256((const __m256i *)(input + pos));
+      __m256i out = _mm256_shuffle_epi8(lookup, in);
+      _mm256_storeu_si256((__m256i *)(result + pos), out);
+   }
+
+   args[0].pointer = result;
+   args[1].integer = size - 1;
+   args[2].integer = ~size;
+}
+#endif
+
 #ifdef HAVE_SSE41
 __attribute__((target("sse4.1")))
 static void std_to_x01_sse41(jit_func_t *func, jit_anchor_t *anchor,
@@ -383,6 +502,60 @@ static inline uint8_t *__to_01(tlab_t *tlab, const uint8_t *input,
    }
 }
 
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static void ieee_to_01_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = args[3].integer ^ (args[3].integer >> 63);
+   const uint8_t *input = args[1].pointer;
+   const uint8_t xmap = args[4].integer;
+
+   if (size == 0) {
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.TO_01: null detected, returning NAU");
+
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+      return;
+   }
+
+   const uint32_t mark = __tlab_mark(tlab);
+   uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(size, 32), 16);
+
+   __m256i lookup =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)cvt_to_01));
+   __m256i iota = _mm256_load_si256((const __m256i *)lane_iota);
+   __m256i bad = _mm256_setzero_si256();
+   __m256i changed = _mm256_setzero_si256();
+
+   for (int pos = 0; pos < size; pos += 32) {
+      __m256i valid = _mm256_cmpgt_epi8(_mm256_set1_epi8(MIN(size - pos, 32)),
+                                        iota);
+      __m256i in = _mm256_loadu_si256((const __m256i *)(input + pos));
+      __m256i out = _mm256_shuffle_epi8(lookup, in);
+      __m256i inv = _mm256_cmpeq_epi8(out, _mm256_set1_epi8(0xff));
+      __m256i diff = _mm256_xor_si256(in, out);
+      bad = _mm256_or_si256(bad, _mm256_and_si256(inv, valid));
+      changed = _mm256_or_si256(changed, _mm256_and_si256(diff, valid));
+      _mm256_storeu_si256((__m256i *)(result + pos), out);
+   }
+
+   if (!_mm256_testz_si256(bad, bad))
+      memset(result, xmap, size);
+   else if (_mm256_testz_si256(changed, changed)) {
+      // Input is already all '0' and '1'
+      __tlab_restore(tlab, mark);
+      result = (uint8_t *)input;
+   }
+
+   args[0].pointer = result;
+   args[1].integer = size - 1;
+   args[2].integer = ~size;
+}
+#endif
+
 static void ieee_to_01(jit_func_t *func, jit_anchor_t *anchor,
                        jit_scalar_t *args, tlab_t *tlab)
 {
@@ -835,6 +1008,129 @@ static void ieee_mul_signed(jit_func_t *func, jit_anchor_t *anchor,
    }
 }
 
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static void __std_binary_avx2(const uint8_t *left, const uint8_t *right,
+                              uint8_t *result, int size,
+                              const uint8_t table[4][4])
+{
+   // Each 128-bit lane of VPSHUFB does an independent lookup so the
+   // compressed tables are duplicated in both halves.  TLAB memory is
+   // only guaranteed to be 16-byte aligned hence the unaligned stores.
+   __m256i left_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)compress_left));
+   __m256i right_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)compress_right));
+   __m256i op_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)table));
+
+   for (int pos = 0; pos < size; pos += 32) {
+      __m256i left1  = _mm256_loadu_si256((const __m256i *)(left + pos));
+      __m256i right1 = _mm256_loadu_si256((const __m256i *)(right + pos));
+      __m256i left2  = _mm256_shuffle_epi8(left_tbl, left1);
+      __m256i right2 = _mm256_shuffle_epi8(right_tbl, right1);
+      __m256i comb   = _mm256_or_si256(left2, right2);
+      __m256i out    = _mm256_shuffle_epi8(op_tbl, comb);
+      _mm256_storeu_si256((__m256i *)(result + pos), out);
+   }
+}
+
+__attribute__((target("avx2")))
+static void __std_logic_binary_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                    jit_scalar_t *args, tlab_t *tlab,
+                                    const uint8_t table[4][4],
+                                    const char *msg)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   if (unlikely(lsize != rsize))
+      __ieee_failure(func, anchor, msg);
+   else {
+      uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(lsize, 32), 16);
+
+      __std_binary_avx2(left, right, result, lsize, table);
+
+      args[0].pointer = result;
+      args[1].integer = 1;
+      args[2].integer = lsize;
+   }
+}
+
+__attribute__((target("avx2")))
+static void ieee_and_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                 jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_and_table,
+                           LENGTH_MSG("and"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_or_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_or_table,
+                           LENGTH_MSG("or"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_xor_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                 jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_xor_table,
+                           LENGTH_MSG("xor"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_nand_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                  jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_nand_table,
+                           LENGTH_MSG("nand"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_nor_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                 jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_nor_table,
+                           LENGTH_MSG("nor"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_xnor_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                  jit_scalar_t *args, tlab_t *tlab)
+{
+   __std_logic_binary_avx2(func, anchor, args, tlab, small_xnor_table,
+                           LENGTH_MSG("xnor"));
+}
+
+__attribute__((target("avx2")))
+static void ieee_not_vector_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                 jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
+
+   uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(size, 32), 16);
+
+   __m256i lookup =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)not_table));
+
+   for (int pos = 0; pos < size; pos += 32) {
+      __m256i in = _mm256_loadu_si256((const __m256i *)(input + pos));
+      __m256i out = _mm256_shuffle_epi8(lookup, in);
+      _mm256_storeu_si256((__m256i *)(result + pos), out);
+   }
+
+   args[0].pointer = result;
+   args[1].integer = 1;
+   args[2].integer = size;
+}
+#endif
+
 #ifdef HAVE_SSE41
 __attribute__((target("sse4.1")))
 static void ieee_and_vector_sse41(jit_func_t *func, jit_anchor_t *anchor,
@@ -1123,108 +1419,1014 @@ static void std_xor_vector(jit_func_t *func, jit_anchor_t *anchor,
    }
 }
 
-static void ieee_to_unsigned(jit_func_t *func, jit_anchor_t *anchor,
-                             jit_scalar_t *args, tlab_t *tlab)
+#ifdef HAVE_SSE41
+__attribute__((target("sse4.1")))
+static void __std_logic_binary_sse41(jit_func_t *func, jit_anchor_t *anchor,
+                                     jit_scalar_t *args, tlab_t *tlab,
+                                     const uint8_t table[4][4],
+                                     const char *msg)
 {
-   const int64_t size = args[2].integer;
-   uint64_t arg = args[1].integer;
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
 
-   if (size < 1) {
-      args[0].pointer = NULL;
-      args[1].integer = 0;
-      args[2].integer = -1;
-   }
+   if (unlikely(lsize != rsize))
+      __ieee_failure(func, anchor, msg);
    else {
-      args[0].pointer = __to_unsigned(func, anchor, tlab, arg, size);
-      args[1].integer = size - 1;
-      args[2].integer = ~size;
-   }
-}
-
-static void ieee_to_signed(jit_func_t *func, jit_anchor_t *anchor,
-                           jit_scalar_t *args, tlab_t *tlab)
-{
-   const int64_t size = args[2].integer;
-   int64_t arg = args[1].integer;
+      uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(lsize, 16), 16);
 
-   if (size < 1) {
-      args[0].pointer = NULL;
-      args[1].integer = 0;
-      args[2].integer = -1;
-   }
-   else {
-      const int roundup = (size + 7) & ~7;
-      uint8_t *result = __tlab_alloc(tlab, roundup, 8), last = 0;
-      for (int pos = roundup - 8; pos >= 0; pos -= 8, arg >>= 8)
-         __spread_bits(result + pos, (last = (arg & 0xff)));
+      __m128i left_tbl  = _mm_load_si128((const __m128i *)compress_left);
+      __m128i right_tbl = _mm_load_si128((const __m128i *)compress_right);
+      __m128i op_tbl    = _mm_load_si128((const __m128i *)table);
 
-      const uint8_t spill_mask = ~((1 << (8 - roundup + size)) - 1);
-      if (unlikely((arg != 0 && arg != -1)
-                   || (arg == 0 && result[roundup - size] == _1)
-                   || (arg == -1 && result[roundup - size] == _0)
-                   || (arg == 0 && (last & spill_mask) != 0)
-                   || (arg == -1 && (last & spill_mask) != spill_mask)))
-         __ieee_warn(func, anchor, "NUMERIC_STD.TO_SIGNED: vector truncated");
+      for (int pos = 0; pos < lsize; pos += 16) {
+         __m128i left1  = _mm_loadu_si128((const __m128i *)(left + pos));
+         __m128i right1 = _mm_loadu_si128((const __m128i *)(right + pos));
+         __m128i left2  = _mm_shuffle_epi8(left_tbl, left1);
+         __m128i right2 = _mm_shuffle_epi8(right_tbl, right1);
+         __m128i comb   = _mm_or_si128(left2, right2);
+         __m128i out    = _mm_shuffle_epi8(op_tbl, comb);
+         _mm_store_si128((__m128i *)(result + pos), out);
+      }
 
-      args[0].pointer = result + roundup - size;
-      args[1].integer = size - 1;
-      args[2].integer = ~size;
+      args[0].pointer = result;
+      args[1].integer = 1;
+      args[2].integer = lsize;
    }
 }
 
-__attribute__((always_inline))
-static inline bool __is_x(uint8_t arg)
+__attribute__((target("sse4.1")))
+static void ieee_nand_vector_sse41(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
 {
-   return arg == _U || arg == _X || arg == _Z || arg == _W || arg == _DC;
+   __std_logic_binary_sse41(func, anchor, args, tlab, small_nand_table,
+                            LENGTH_MSG("nand"));
 }
 
-__attribute__((always_inline))
-static inline void __make_binary(jit_func_t *func, jit_anchor_t *anchor,
-                                 tlab_t *tlab, const uint8_t *input,
-                                 uint8_t *result, int size)
+__attribute__((target("sse4.1")))
+static void ieee_nor_vector_sse41(jit_func_t *func, jit_anchor_t *anchor,
+                                  jit_scalar_t *args, tlab_t *tlab)
 {
-   static const uint8_t tbl_BINARY[] = { _X, _X, _0, _1, _X, _X, _0, _1, _X };
-
-   for (int i = 0; i < size; i++) {
-      if (unlikely(__is_x(input[i]))) {
-         __ieee_warn(func, anchor, "There is an 'U'|'X'|'W'|'Z'|'-' in an "
-                     "arithmetic operand, the result will be 'X'(es).");
-         memset(result, _X, size);
-         break;
-      }
-
-      result[i] = tbl_BINARY[input[i]];
-   }
+   __std_logic_binary_sse41(func, anchor, args, tlab, small_nor_table,
+                            LENGTH_MSG("nor"));
 }
 
-__attribute__((cold, noreturn, noinline))
-static void __synopsys_failure(jit_func_t *func, jit_anchor_t *caller,
-                               jit_scalar_t *args, tlab_t *tlab)
+__attribute__((target("sse4.1")))
+static void ieee_xnor_vector_sse41(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
 {
-   // Synopsys subprograms handle edge cases poorly: punt to the
-   // interpreter to generate the error message
-   func->entry = jit_interp;
-   jit_interp(func, caller, args, tlab);
-   fatal_trace("should not return here");
+   __std_logic_binary_sse41(func, anchor, args, tlab, small_xnor_table,
+                            LENGTH_MSG("xnor"));
 }
 
-__attribute__((always_inline))
-static inline const uint8_t *__conv_unsigned(jit_func_t *func,
-                                             jit_anchor_t *anchor,
-                                             tlab_t *tlab,
-                                             const void *input,
-                                             int oldsize, int size)
+__attribute__((target("sse4.1")))
+static void ieee_not_vector_sse41(jit_func_t *func, jit_anchor_t *anchor,
+                                  jit_scalar_t *args, tlab_t *tlab)
 {
-   assert(size > 0);
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
 
-   if (oldsize == size && __all_01(input, oldsize))
-      return input;
+   uint8_t *result = __tlab_alloc(tlab, ALIGN_UP(size, 16), 16);
 
-   const int maxsize = MAX(oldsize, size);
-   const int pad = size - oldsize;
-   uint8_t *result = __tlab_alloc(tlab, maxsize, 8);
+   __m128i lookup = _mm_load_si128((const __m128i *)not_table);
 
-   __make_binary(func, anchor, tlab, input, result + pad, oldsize);
+   for (int pos = 0; pos < size; pos += 16) {
+      __m128i in = _mm_loadu_si128((const __m128i *)(input + pos));
+      __m128i out = _mm_shuffle_epi8(lookup, in);
+      _mm_store_si128((__m128i *)(result + pos), out);
+   }
+
+   args[0].pointer = result;
+   args[1].integer = 1;
+   args[2].integer = size;
+}
+#endif
+
+static void ieee_nand_vector(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   if (unlikely(lsize != rsize))
+      __ieee_failure(func, anchor, LENGTH_MSG("nand"));
+   else {
+      uint8_t *result = __tlab_alloc(tlab, lsize, 8);
+
+      for (int pos = 0; pos < lsize; pos++)
+         result[pos] = not_table[and_table[left[pos]][right[pos]]];
+
+      args[0].pointer = result;
+      args[1].integer = 1;
+      args[2].integer = lsize;
+   }
+}
+
+static void ieee_nor_vector(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   if (unlikely(lsize != rsize))
+      __ieee_failure(func, anchor, LENGTH_MSG("nor"));
+   else {
+      uint8_t *result = __tlab_alloc(tlab, lsize, 8);
+
+      for (int pos = 0; pos < lsize; pos++)
+         result[pos] = not_table[or_table[left[pos]][right[pos]]];
+
+      args[0].pointer = result;
+      args[1].integer = 1;
+      args[2].integer = lsize;
+   }
+}
+
+static void ieee_xnor_vector(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   if (unlikely(lsize != rsize))
+      __ieee_failure(func, anchor, LENGTH_MSG("xnor"));
+   else {
+      uint8_t *result = __tlab_alloc(tlab, lsize, 8);
+
+      for (int pos = 0; pos < lsize; pos++)
+         result[pos] = not_table[xor_table[left[pos]][right[pos]]];
+
+      args[0].pointer = result;
+      args[1].integer = 1;
+      args[2].integer = lsize;
+   }
+}
+
+static void ieee_not_vector(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
+
+   uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+   for (int pos = 0; pos < size; pos++)
+      result[pos] = not_table[input[pos]];
+
+   args[0].pointer = result;
+   args[1].integer = 1;
+   args[2].integer = size;
+}
+
+static void ieee_to_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   const int64_t size = args[2].integer;
+   uint64_t arg = args[1].integer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      args[0].pointer = __to_unsigned(func, anchor, tlab, arg, size);
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+static void ieee_to_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   const int64_t size = args[2].integer;
+   int64_t arg = args[1].integer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      const int roundup = (size + 7) & ~7;
+      uint8_t *result = __tlab_alloc(tlab, roundup, 8), last = 0;
+      for (int pos = roundup - 8; pos >= 0; pos -= 8, arg >>= 8)
+         __spread_bits(result + pos, (last = (arg & 0xff)));
+
+      const uint8_t spill_mask = ~((1 << (8 - roundup + size)) - 1);
+      if (unlikely((arg != 0 && arg != -1)
+                   || (arg == 0 && result[roundup - size] == _1)
+                   || (arg == -1 && result[roundup - size] == _0)
+                   || (arg == 0 && (last & spill_mask) != 0)
+                   || (arg == -1 && (last & spill_mask) != spill_mask)))
+         __ieee_warn(func, anchor, "NUMERIC_STD.TO_SIGNED: vector truncated");
+
+      args[0].pointer = result + roundup - size;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+__attribute__((cold, noinline))
+static void __ieee_fallback(jit_func_t *func, jit_anchor_t *caller,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   // Cases where the VHDL implementation raises an error are rare so
+   // punt to the interpreter to report them with the correct context
+   func->entry = jit_interp;
+   jit_interp(func, caller, args, tlab);
+}
+
+#define NULL_ARG_MSG(op, result)                                        \
+   "NUMERIC_STD.\"" op "\": null argument detected, returning " result
+
+#define METAVALUE_MSG(op, result)                                       \
+   "NUMERIC_STD.\"" op "\": metavalue detected, returning " result
+
+__attribute__((always_inline))
+static inline int __ieee_compare_01(const uint8_t *left, int lsize,
+                                    const uint8_t *right, int rsize,
+                                    bool is_signed)
+{
+   // Both arguments contain only '0' and '1' which sort in numeric
+   // order as bytes so after extending the shorter argument this is
+   // just a lexicographic comparison
+   if (is_signed && left[0] != right[0])
+      return left[0] == _1 ? -1 : 1;
+
+   const uint8_t fill = is_signed ? left[0] : _0;
+
+   for (; lsize > rsize; left++, lsize--) {
+      if (*left != fill)
+         return *left > fill ? 1 : -1;
+   }
+
+   for (; rsize > lsize; right++, rsize--) {
+      if (*right != fill)
+         return fill > *right ? 1 : -1;
+   }
+
+   const int cmp = memcmp(left, right, lsize);
+   return (cmp > 0) - (cmp < 0);
+}
+
+__attribute__((always_inline))
+static inline bool __ieee_compare(jit_func_t *func, jit_anchor_t *anchor,
+                                  jit_scalar_t *args, tlab_t *tlab,
+                                  bool is_signed, const char *null_msg,
+                                  const char *meta_msg, int *cmp)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   const uint8_t *left = args[1].pointer;
+   const uint8_t *right = args[4].pointer;
+
+   if (lsize < 1 || rsize < 1) {
+      __ieee_warn(func, anchor, null_msg);
+      return false;
+   }
+
+   const uint32_t mark = __tlab_mark(tlab);
+
+   left = __to_01(tlab, left, lsize, _X);
+   right = __to_01(tlab, right, rsize, _X);
+
+   const bool valid = left[0] != _X && right[0] != _X;
+   if (valid)
+      *cmp = __ieee_compare_01(left, lsize, right, rsize, is_signed);
+
+   __tlab_restore(tlab, mark);
+
+   if (!valid)
+      __ieee_warn(func, anchor, meta_msg);
+
+   return valid;
+}
+
+static void ieee_lt_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, false,
+                                    NULL_ARG_MSG("<", "FALSE"),
+                                    METAVALUE_MSG("<", "FALSE"), &cmp)
+      && cmp < 0;
+}
+
+static void ieee_lt_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, true,
+                                    NULL_ARG_MSG("<", "FALSE"),
+                                    METAVALUE_MSG("<", "FALSE"), &cmp)
+      && cmp < 0;
+}
+
+static void ieee_le_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, false,
+                                    NULL_ARG_MSG("<=", "FALSE"),
+                                    METAVALUE_MSG("<=", "FALSE"), &cmp)
+      && cmp <= 0;
+}
+
+static void ieee_le_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, true,
+                                    NULL_ARG_MSG("<=", "FALSE"),
+                                    METAVALUE_MSG("<=", "FALSE"), &cmp)
+      && cmp <= 0;
+}
+
+static void ieee_gt_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, false,
+                                    NULL_ARG_MSG(">", "FALSE"),
+                                    METAVALUE_MSG(">", "FALSE"), &cmp)
+      && cmp > 0;
+}
+
+static void ieee_gt_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, true,
+                                    NULL_ARG_MSG(">", "FALSE"),
+                                    METAVALUE_MSG(">", "FALSE"), &cmp)
+      && cmp > 0;
+}
+
+static void ieee_ge_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, false,
+                                    NULL_ARG_MSG(">=", "FALSE"),
+                                    METAVALUE_MSG(">=", "FALSE"), &cmp)
+      && cmp >= 0;
+}
+
+static void ieee_ge_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, true,
+                                    NULL_ARG_MSG(">=", "FALSE"),
+                                    METAVALUE_MSG(">=", "FALSE"), &cmp)
+      && cmp >= 0;
+}
+
+static void ieee_eq_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, false,
+                                    NULL_ARG_MSG("=", "FALSE"),
+                                    METAVALUE_MSG("=", "FALSE"), &cmp)
+      && cmp == 0;
+}
+
+static void ieee_eq_signed(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = __ieee_compare(func, anchor, args, tlab, true,
+                                    NULL_ARG_MSG("=", "FALSE"),
+                                    METAVALUE_MSG("=", "FALSE"), &cmp)
+      && cmp == 0;
+}
+
+static void ieee_neq_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                              jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = !__ieee_compare(func, anchor, args, tlab, false,
+                                     NULL_ARG_MSG("/=", "TRUE"),
+                                     METAVALUE_MSG("/=", "TRUE"), &cmp)
+      || cmp != 0;
+}
+
+static void ieee_neq_signed(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   int cmp;
+   args[0].integer = !__ieee_compare(func, anchor, args, tlab, true,
+                                     NULL_ARG_MSG("/=", "TRUE"),
+                                     METAVALUE_MSG("/=", "TRUE"), &cmp)
+      || cmp != 0;
+}
+
+static void ieee_shift_left(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const int64_t count = args[4].integer;
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+      const int shift = MIN(count, size);
+      memcpy(result, input + shift, size - shift);
+      memset(result + size - shift, _0, shift);
+
+      args[0].pointer = result;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+static void ieee_shift_right_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                                      jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const int64_t count = args[4].integer;
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+      const int shift = MIN(count, size);
+      memset(result, _0, shift);
+      memcpy(result + shift, input, size - shift);
+
+      args[0].pointer = result;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+static void ieee_shift_right_signed(jit_func_t *func, jit_anchor_t *anchor,
+                                    jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const int64_t count = args[4].integer;
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else if (size == 1 || count == 0) {
+      // XSRA returns the argument unchanged including its bounds
+      args[0].pointer = args[1].pointer;
+      args[1].integer = args[2].integer;
+      args[2].integer = args[3].integer;
+   }
+   else {
+      uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+      const int shift = MIN(count, size - 1);
+      memset(result, input[0], shift);
+      memcpy(result + shift, input, size - shift);
+
+      args[0].pointer = result;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+static void ieee_rotate_left(jit_func_t *func, jit_anchor_t *anchor,
+                             jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const int64_t count = args[4].integer;
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+      const int shift = count % size;
+      memcpy(result, input + shift, size - shift);
+      memcpy(result + size - shift, input, shift);
+
+      args[0].pointer = result;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+static void ieee_rotate_right(jit_func_t *func, jit_anchor_t *anchor,
+                              jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const int64_t count = args[4].integer;
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+   }
+   else {
+      uint8_t *result = __tlab_alloc(tlab, size, 8);
+
+      const int shift = count % size;
+      memcpy(result, input + size - shift, shift);
+      memcpy(result + shift, input, size - shift);
+
+      args[0].pointer = result;
+      args[1].integer = size - 1;
+      args[2].integer = ~size;
+   }
+}
+
+__attribute__((always_inline))
+static inline void __pack_words(const uint8_t *input, int size,
+                                uint64_t *words, int nwords)
+{
+   // Pack a vector of '0' and '1' with the most significant element
+   // first into little-endian 64-bit words
+   memset(words, 0, nwords * sizeof(uint64_t));
+
+   int pos = size - 8, bit = 0;
+   for (; pos >= 0; pos -= 8, bit += 8)
+      words[bit / 64] |= (uint64_t)__pack_low_bits(input + pos) << (bit % 64);
+
+   for (pos += 7; pos >= 0; pos--, bit++)
+      words[bit / 64] |= (uint64_t)(input[pos] & 1) << (bit % 64);
+}
+
+__attribute__((always_inline))
+static inline void __unpack_words(const uint64_t *words, int size,
+                                  uint8_t *result)
+{
+   int pos = size - 8, bit = 0;
+   for (; pos >= 0; pos -= 8, bit += 8)
+      __spread_bits(result + pos, words[bit / 64] >> (bit % 64));
+
+   for (pos += 7; pos >= 0; pos--, bit++)
+      result[pos] = ((words[bit / 64] >> (bit % 64)) & 1) | 0x02;
+}
+
+__attribute__((always_inline))
+static inline bool __words_zero(const uint64_t *words, int nwords)
+{
+   for (int i = 0; i < nwords; i++) {
+      if (words[i] != 0)
+         return false;
+   }
+
+   return true;
+}
+
+__attribute__((always_inline))
+static inline bool __words_less(const uint64_t *left, const uint64_t *right,
+                                int nwords)
+{
+   for (int i = nwords - 1; i >= 0; i--) {
+      if (left[i] != right[i])
+         return left[i] < right[i];
+   }
+
+   return false;
+}
+
+__attribute__((always_inline))
+static inline void __words_sub(uint64_t *result, const uint64_t *left,
+                               const uint64_t *right, int nwords)
+{
+   uint64_t borrow = 0;
+   for (int i = 0; i < nwords; i++) {
+      const uint64_t l = left[i], r = right[i];
+      result[i] = l - r - borrow;
+      borrow = (l < r) || (l == r && borrow);
+   }
+}
+
+__attribute__((always_inline))
+static inline void __words_negate(uint64_t *words, int nwords, int nbits)
+{
+   uint64_t carry = 1;
+   for (int i = 0; i < nwords; i++) {
+      words[i] = ~words[i] + carry;
+      carry = carry && words[i] == 0;
+   }
+
+   // Clear the sign extension above the original width
+   const int full = nbits / 64;
+   if (full < nwords) {
+      words[full] &= (UINT64_C(1) << (nbits % 64)) - 1;
+      memset(words + full + 1, 0, (nwords - full - 1) * sizeof(uint64_t));
+   }
+}
+
+static void __packed_divmod(const uint64_t *num, int nbits,
+                            const uint64_t *den, int nwords,
+                            uint64_t *quot, uint64_t *rem)
+{
+   memset(quot, 0, ((nbits + 63) / 64) * sizeof(uint64_t));
+   memset(rem, 0, nwords * sizeof(uint64_t));
+
+   if (nbits <= 64 && nwords == 1) {
+      quot[0] = num[0] / den[0];
+      rem[0] = num[0] % den[0];
+      return;
+   }
+
+   // Restoring long division one bit at a time: REM needs one more
+   // bit than the divisor to hold the partial remainder before the
+   // subtraction
+   for (int i = nbits - 1; i >= 0; i--) {
+      uint64_t carry = (num[i / 64] >> (i % 64)) & 1;
+      for (int j = 0; j < nwords; j++) {
+         const uint64_t next = rem[j] >> 63;
+         rem[j] = (rem[j] << 1) | carry;
+         carry = next;
+      }
+
+      if (!__words_less(rem, den, nwords)) {
+         __words_sub(rem, rem, den, nwords);
+         quot[i / 64] |= UINT64_C(1) << (i % 64);
+      }
+   }
+}
+
+typedef enum {
+   IEEE_DIV, IEEE_MOD, IEEE_REM
+} ieee_div_op_t;
+
+__attribute__((always_inline))
+static inline void __ieee_divide(jit_func_t *func, jit_anchor_t *anchor,
+                                 jit_scalar_t *args, tlab_t *tlab,
+                                 bool is_signed, ieee_div_op_t op)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   const uint8_t *left = args[1].pointer;
+   const uint8_t *right = args[4].pointer;
+
+   if (lsize < 1 || rsize < 1) {
+      args[0].pointer = NULL;
+      args[1].integer = 0;
+      args[2].integer = -1;
+      return;
+   }
+
+   // The quotient has the length of the dividend and the remainder
+   // the length of the divisor
+   const int size = op == IEEE_DIV ? lsize : rsize;
+   uint8_t *result = __tlab_alloc(tlab, size, 8);
+   const uint32_t mark = __tlab_mark(tlab);
+
+   const uint8_t *xl = __to_01(tlab, left, lsize, _X);
+   const uint8_t *xr = __to_01(tlab, right, rsize, _X);
+
+   if (xl[0] == _X || xr[0] == _X)
+      memset(result, _X, size);
+   else {
+      const int lwords = (lsize + 63) / 64;
+      const int rwords = (rsize + 64) / 64;
+
+      uint64_t *num = __tlab_alloc(tlab, lwords * sizeof(uint64_t), 8);
+      uint64_t *quot = __tlab_alloc(tlab, lwords * sizeof(uint64_t), 8);
+      uint64_t *den = __tlab_alloc(tlab, rwords * sizeof(uint64_t), 8);
+      uint64_t *rem = __tlab_alloc(tlab, rwords * sizeof(uint64_t), 8);
+
+      __pack_words(xl, lsize, num, lwords);
+      __pack_words(xr, rsize, den, rwords);
+
+      const bool lneg = is_signed && xl[0] == _1;
+      const bool rneg = is_signed && xr[0] == _1;
+
+      if (lneg)
+         __words_negate(num, lwords, lsize);
+      if (rneg)
+         __words_negate(den, rwords, rsize);
+
+      if (unlikely(__words_zero(den, rwords))) {
+         __tlab_restore(tlab, mark);
+         __ieee_fallback(func, anchor, args, tlab);
+         return;
+      }
+
+      __packed_divmod(num, lsize, den, rwords, quot, rem);
+
+      switch (op) {
+      case IEEE_DIV:
+         if (lneg != rneg)
+            __words_negate(quot, lwords, lsize);
+         __unpack_words(quot, size, result);
+         break;
+      case IEEE_MOD:
+         // The VHDL tests the sign of the original argument here
+         // rather than the result of TO_01
+         if (rneg && left[0] == _1)
+            __words_negate(rem, rwords, rsize);
+         else if (rneg && !__words_zero(rem, rwords))
+            __words_sub(rem, rem, den, rwords);
+         else if (is_signed && left[0] == _1 && !__words_zero(rem, rwords))
+            __words_sub(rem, den, rem, rwords);
+         __unpack_words(rem, size, result);
+         break;
+      case IEEE_REM:
+         if (lneg)
+            __words_negate(rem, rwords, rsize);
+         __unpack_words(rem, size, result);
+         break;
+      }
+   }
+
+   __tlab_restore(tlab, mark);
+
+   args[0].pointer = result;
+   args[1].integer = size - 1;
+   args[2].integer = ~size;
+}
+
+static void ieee_div_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                              jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_divide(func, anchor, args, tlab, false, IEEE_DIV);
+}
+
+static void ieee_div_signed(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_divide(func, anchor, args, tlab, true, IEEE_DIV);
+}
+
+static void ieee_mod_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                              jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_divide(func, anchor, args, tlab, false, IEEE_MOD);
+}
+
+static void ieee_mod_signed(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_divide(func, anchor, args, tlab, true, IEEE_MOD);
+}
+
+static void ieee_rem_signed(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_divide(func, anchor, args, tlab, true, IEEE_REM);
+}
+
+static void ieee_to_integer_unsigned(jit_func_t *func, jit_anchor_t *anchor,
+                                     jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.TO_INTEGER: null detected, returning 0");
+      args[0].integer = 0;
+      return;
+   }
+
+   const uint32_t mark = __tlab_mark(tlab);
+   const uint8_t *xarg = __to_01(tlab, input, size, _X);
+
+   if (xarg[0] == _X) {
+      __tlab_restore(tlab, mark);
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.TO_INTEGER: metavalue detected, returning 0");
+      args[0].integer = 0;
+      return;
+   }
+
+   // A '1' above bit 30 overflows NATURAL which is an error in the
+   // VHDL implementation
+   const int skip = MAX(size - 31, 0);
+   if (unlikely(skip > 0 && memchr(xarg, _1, skip) != NULL)) {
+      __tlab_restore(tlab, mark);
+      __ieee_fallback(func, anchor, args, tlab);
+      return;
+   }
+
+   uint64_t value;
+   __pack_words(xarg + skip, size - skip, &value, 1);
+
+   __tlab_restore(tlab, mark);
+
+   args[0].integer = value;
+}
+
+static void ieee_to_integer_signed(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
+
+   if (size < 1) {
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.TO_INTEGER: null detected, returning 0");
+      args[0].integer = 0;
+      return;
+   }
+
+   const uint32_t mark = __tlab_mark(tlab);
+   const uint8_t *xarg = __to_01(tlab, input, size, _X);
+
+   if (xarg[0] == _X) {
+      __tlab_restore(tlab, mark);
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.TO_INTEGER: metavalue detected, returning 0");
+      args[0].integer = 0;
+      return;
+   }
+
+   // Everything above bit 31 must be a copy of the sign bit for the
+   // result to fit in INTEGER
+   const int skip = MAX(size - 32, 0);
+   for (int i = 0; i < skip; i++) {
+      if (unlikely(xarg[i] != xarg[skip])) {
+         __tlab_restore(tlab, mark);
+         __ieee_fallback(func, anchor, args, tlab);
+         return;
+      }
+   }
+
+   const int width = size - skip;
+
+   uint64_t bits;
+   __pack_words(xarg + skip, width, &bits, 1);
+
+   __tlab_restore(tlab, mark);
+
+   args[0].integer = (int64_t)(bits << (64 - width)) >> (64 - width);
+}
+
+__attribute__((always_inline))
+static inline void __to_radix_string(const uint8_t *input, int size,
+                                     int bits, uint8_t pad, char *result)
+{
+   static const char digits[] = "0123456789ABCDEF";
+   static const uint8_t tbl_X01Z[] = { _X, _X, _0, _1, _Z, _X, _0, _1, _X };
+
+   int digit = (size + bits - 1) / bits - 1, pos = size - bits;
+
+   if (bits == 4) {
+      // Convert two hex digits at a time from a packed byte while the
+      // input is all '0' or '1'
+      for (; pos >= 4; digit -= 2, pos -= 8) {
+         const uint64_t u64 = unaligned_load(input + pos - 4, uint64_t);
+         if (!IS_01(u64))
+            break;
+
+         const uint8_t byte = __pack_low_bits(input + pos - 4);
+         result[digit - 1] = digits[byte >> 4];
+         result[digit] = digits[byte & 0xf];
+      }
+   }
+
+   for (; digit >= 0; digit--, pos -= bits) {
+      int value = 0, nz = 0, nx = 0;
+      for (int i = pos; i < pos + bits; i++) {
+         const uint8_t elt = tbl_X01Z[i < 0 ? pad : input[i]];
+         value = (value << 1) | (elt == _1);
+         nz += (elt == _Z);
+         nx += (elt == _X);
+      }
+
+      if (nz == bits)
+         result[digit] = 'Z';
+      else if (nz > 0 || nx > 0)
+         result[digit] = 'X';
+      else
+         result[digit] = digits[value];
+   }
+}
+
+__attribute__((always_inline))
+static inline void __ieee_radix_string(jit_func_t *func, jit_anchor_t *anchor,
+                                       jit_scalar_t *args, tlab_t *tlab,
+                                       int bits, bool is_signed)
+{
+   const int size = ffi_array_length(args[3].integer);
+   const uint8_t *input = args[1].pointer;
+
+   if (unlikely(size < 1)) {
+      // Reading VALUE'LEFT of a null vector is an index error
+      __ieee_fallback(func, anchor, args, tlab);
+      return;
+   }
+
+   // Signed values are padded with the sign bit, otherwise with 'Z' if
+   // the leftmost element is 'Z' and '0' if not
+   uint8_t pad = input[0];
+   if (!is_signed && pad != _Z)
+      pad = _0;
+
+   const int ndigits = (size + bits - 1) / bits;
+   char *result = __tlab_alloc(tlab, ndigits, 8);
+   __to_radix_string(input, size, bits, pad, result);
+
+   args[0].pointer = result;
+   args[1].integer = 1;
+   args[2].integer = ndigits;
+}
+
+static void ieee_to_hstring(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_radix_string(func, anchor, args, tlab, 4, false);
+}
+
+static void ieee_to_hstring_signed(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_radix_string(func, anchor, args, tlab, 4, true);
+}
+
+static void ieee_to_ostring(jit_func_t *func, jit_anchor_t *anchor,
+                            jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_radix_string(func, anchor, args, tlab, 3, false);
+}
+
+static void ieee_to_ostring_signed(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
+{
+   __ieee_radix_string(func, anchor, args, tlab, 3, true);
+}
+
+__attribute__((always_inline))
+static inline bool __is_x(uint8_t arg)
+{
+   return arg == _U || arg == _X || arg == _Z || arg == _W || arg == _DC;
+}
+
+__attribute__((always_inline))
+static inline void __make_binary(jit_func_t *func, jit_anchor_t *anchor,
+                                 tlab_t *tlab, const uint8_t *input,
+                                 uint8_t *result, int size)
+{
+   static const uint8_t tbl_BINARY[] = { _X, _X, _0, _1, _X, _X, _0, _1, _X };
+
+   for (int i = 0; i < size; i++) {
+      if (unlikely(__is_x(input[i]))) {
+         __ieee_warn(func, anchor, "There is an 'U'|'X'|'W'|'Z'|'-' in an "
+                     "arithmetic operand, the result will be 'X'(es).");
+         memset(result, _X, size);
+         break;
+      }
+
+      result[i] = tbl_BINARY[input[i]];
+   }
+}
+
+__attribute__((cold, noreturn, noinline))
+static void __synopsys_failure(jit_func_t *func, jit_anchor_t *caller,
+                               jit_scalar_t *args, tlab_t *tlab)
+{
+   // Synopsys subprograms handle edge cases poorly: punt to the
+   // interpreter to generate the error message
+   func->entry = jit_interp;
+   jit_interp(func, caller, args, tlab);
+   fatal_trace("should not return here");
+}
+
+__attribute__((always_inline))
+static inline const uint8_t *__conv_unsigned(jit_func_t *func,
+                                             jit_anchor_t *anchor,
+                                             tlab_t *tlab,
+                                             const void *input,
+                                             int oldsize, int size)
+{
+   assert(size > 0);
+
+   if (oldsize == size && __all_01(input, oldsize))
+      return input;
+
+   const int maxsize = MAX(oldsize, size);
+   const int pad = size - oldsize;
+   uint8_t *result = __tlab_alloc(tlab, maxsize, 8);
+
+   __make_binary(func, anchor, tlab, input, result + pad, oldsize);
 
    if (unlikely(result[pad] == _X))
       memset(result, _X, size);
@@ -1509,6 +2711,44 @@ static void synopsys_eql_signed(jit_func_t *func, jit_anchor_t *anchor,
    __tlab_restore(tlab, mark);
 }
 
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static void byte_vector_equal_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                   jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   args[0].integer = 0;
+
+   if (lsize != rsize)
+      return;
+
+   int pos = 0;
+   for (; pos + 31 < lsize; pos += 32) {
+      __m256i left1  = _mm256_loadu_si256((const __m256i *)(left + pos));
+      __m256i right1 = _mm256_loadu_si256((const __m256i *)(right + pos));
+      __m256i xor    = _mm256_xor_si256(left1, right1);
+      if (!_mm256_testz_si256(xor, xor))
+         return;
+   }
+
+   if (pos < lsize) {
+      __m256i iota   = _mm256_load_si256((const __m256i *)lane_iota);
+      __m256i mask   = _mm256_cmpgt_epi8(_mm256_set1_epi8(lsize - pos), iota);
+      __m256i left1  = _mm256_loadu_si256((const __m256i *)(left + pos));
+      __m256i right1 = _mm256_loadu_si256((const __m256i *)(right + pos));
+      __m256i xor    = _mm256_xor_si256(left1, right1);
+      if (!_mm256_testz_si256(xor, mask))
+         return;
+   }
+
+   args[0].integer = 1;
+}
+#endif
+
 #ifdef HAVE_SSE41
 __attribute__((target("sse4.1")))
 static void byte_vector_equal_sse41(jit_func_t *func, jit_anchor_t *anchor,
@@ -1600,6 +2840,95 @@ static void byte_vector_equal(jit_func_t *func, jit_anchor_t *anchor,
    args[0].integer = (lsize == rsize) && (memcmp(left, right, lsize) == 0);
 }
 
+static bool __std_match_length(jit_func_t *func, jit_anchor_t *anchor,
+                               int lsize, int rsize)
+{
+   if (lsize < 1 || rsize < 1) {
+      __ieee_warn(func, anchor,
+                  "NUMERIC_STD.STD_MATCH: null detected, returning FALSE");
+      return false;
+   }
+   else if (lsize != rsize) {
+      __ieee_warn(func, anchor, "NUMERIC_STD.STD_MATCH: L'LENGTH /= "
+                  "R'LENGTH, returning FALSE");
+      return false;
+   }
+   else
+      return true;
+}
+
+#ifdef HAVE_AVX2
+__attribute__((target("avx2")))
+static void ieee_std_match_avx2(jit_func_t *func, jit_anchor_t *anchor,
+                                jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   args[0].integer = 0;
+
+   if (!__std_match_length(func, anchor, lsize, rsize))
+      return;
+
+   __m256i left_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)compress_match_left));
+   __m256i right_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)compress_match_right));
+   __m256i miss_tbl = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)small_mismatch_table));
+
+   int pos = 0;
+   for (; pos + 31 < lsize; pos += 32) {
+      __m256i left1  = _mm256_loadu_si256((const __m256i *)(left + pos));
+      __m256i right1 = _mm256_loadu_si256((const __m256i *)(right + pos));
+      __m256i left2  = _mm256_shuffle_epi8(left_tbl, left1);
+      __m256i right2 = _mm256_shuffle_epi8(right_tbl, right1);
+      __m256i comb   = _mm256_or_si256(left2, right2);
+      __m256i miss   = _mm256_shuffle_epi8(miss_tbl, comb);
+      if (!_mm256_testz_si256(miss, miss))
+         return;
+   }
+
+   if (pos < lsize) {
+      __m256i iota   = _mm256_load_si256((const __m256i *)lane_iota);
+      __m256i mask   = _mm256_cmpgt_epi8(_mm256_set1_epi8(lsize - pos), iota);
+      __m256i left1  = _mm256_loadu_si256((const __m256i *)(left + pos));
+      __m256i right1 = _mm256_loadu_si256((const __m256i *)(right + pos));
+      __m256i left2  = _mm256_shuffle_epi8(left_tbl, left1);
+      __m256i right2 = _mm256_shuffle_epi8(right_tbl, right1);
+      __m256i comb   = _mm256_or_si256(left2, right2);
+      __m256i miss   = _mm256_shuffle_epi8(miss_tbl, comb);
+      if (!_mm256_testz_si256(miss, mask))
+         return;
+   }
+
+   args[0].integer = 1;
+}
+#endif
+
+static void ieee_std_match(jit_func_t *func, jit_anchor_t *anchor,
+                           jit_scalar_t *args, tlab_t *tlab)
+{
+   const int lsize = ffi_array_length(args[3].integer);
+   const int rsize = ffi_array_length(args[6].integer);
+   uint8_t *left = args[1].pointer;
+   uint8_t *right = args[4].pointer;
+
+   args[0].integer = 0;
+
+   if (!__std_match_length(func, anchor, lsize, rsize))
+      return;
+
+   for (int pos = 0; pos < lsize; pos++) {
+      if (!match_table[left[pos]][right[pos]])
+         return;
+   }
+
+   args[0].integer = 1;
+}
+
 static void ieee_math_sin(jit_func_t *func, jit_anchor_t *anchor,
                           jit_scalar_t *args, tlab_t *tlab)
 {
@@ -1731,12 +3060,22 @@ static jit_intrinsic_t intrinsic_list[] = {
    { NS "\"*\"(" UU UU ")" UU, ieee_mul_unsigned },
    { NS "\"*\"(" S S ")" S, ieee_mul_signed },
    { NS "\"*\"(" US US ")" US, ieee_mul_signed },
+#ifdef HAVE_AVX2
+   { SL "TO_X01(V)V", std_to_x01_avx2, CPU_AVX2 },
+   { SL "TO_X01(Y)Y", std_to_x01_avx2, CPU_AVX2 },
+#endif
 #ifdef HAVE_SSE41
    { SL "TO_X01(V)V", std_to_x01_sse41, CPU_SSE41 },
    { SL "TO_X01(Y)Y", std_to_x01_sse41, CPU_SSE41 },
 #endif
    { SL "TO_X01(V)V", std_to_x01 },
    { SL "TO_X01(Y)Y", std_to_x01 },
+#ifdef HAVE_AVX2
+   { NS "TO_01(" U "L)" U, ieee_to_01_avx2, CPU_AVX2 },
+   { NS "TO_01(" UU "U)" UU, ieee_to_01_avx2, CPU_AVX2 },
+   { NS "TO_01(" S "L)" U, ieee_to_01_avx2, CPU_AVX2 },
+   { NS "TO_01(" US "U)" UU, ieee_to_01_avx2, CPU_AVX2 },
+#endif
    { NS "TO_01(" U "L)" U, ieee_to_01 },
    { NS "TO_01(" UU "U)" UU, ieee_to_01 },
    { NS "TO_01(" S "L)" U, ieee_to_01 },
@@ -1745,6 +3084,10 @@ static jit_intrinsic_t intrinsic_list[] = {
    { NS "RESIZE(" UU "N)" UU, ieee_resize_unsigned },
    { NS "RESIZE(" S "N)" S, ieee_resize_signed },
    { NS "RESIZE(" US "N)" US, ieee_resize_signed },
+#ifdef HAVE_AVX2
+   { SL "\"and\"(VV)V", ieee_and_vector_avx2, CPU_AVX2 },
+   { SL "\"and\"(YY)Y", ieee_and_vector_avx2, CPU_AVX2 },
+#endif
 #ifdef HAVE_SSE41
    { SL "\"and\"(VV)V", ieee_and_vector_sse41, CPU_SSE41 },
    { SL "\"and\"(YY)Y", ieee_and_vector_sse41, CPU_SSE41 },
@@ -1755,6 +3098,10 @@ static jit_intrinsic_t intrinsic_list[] = {
 #endif
    { SL "\"and\"(VV)V", ieee_and_vector },
    { SL "\"and\"(YY)Y", ieee_and_vector },
+#ifdef HAVE_AVX2
+   { SL "\"or\"(VV)V", ieee_or_vector_avx2, CPU_AVX2 },
+   { SL "\"or\"(YY)Y", ieee_or_vector_avx2, CPU_AVX2 },
+#endif
 #ifdef HAVE_SSE41
    { SL "\"or\"(VV)V", ieee_or_vector_sse41, CPU_SSE41 },
    { SL "\"or\"(YY)Y", ieee_or_vector_sse41, CPU_SSE41 },
@@ -1765,20 +3112,132 @@ static jit_intrinsic_t intrinsic_list[] = {
 #endif
    { SL "\"or\"(VV)V", ieee_or_vector },
    { SL "\"or\"(YY)Y", ieee_or_vector },
+#ifdef HAVE_AVX2
+   { SL "\"xor\"(VV)V", ieee_xor_vector_avx2, CPU_AVX2 },
+   { SL "\"xor\"(YY)Y", ieee_xor_vector_avx2, CPU_AVX2 },
+#endif
 #ifdef HAVE_SSE41
    { SL "\"xor\"(VV)V", ieee_xor_vector_sse41, CPU_SSE41 },
    { SL "\"xor\"(YY)Y", ieee_xor_vector_sse41, CPU_SSE41 },
 #endif
 #ifdef HAVE_NEON
-   { SL "\"neon\"(VV)V", ieee_xor_vector_neon, CPU_NEON },
-   { SL "\"neon\"(YY)Y", ieee_xor_vector_neon, CPU_NEON },
+   { SL "\"xor\"(VV)V", ieee_xor_vector_neon, CPU_NEON },
+   { SL "\"xor\"(YY)Y", ieee_xor_vector_neon, CPU_NEON },
 #endif
    { SL "\"xor\"(VV)V", std_xor_vector },
    { SL "\"xor\"(YY)Y", std_xor_vector },
+#ifdef HAVE_AVX2
+   { SL "\"nand\"(VV)V", ieee_nand_vector_avx2, CPU_AVX2 },
+   { SL "\"nand\"(YY)Y", ieee_nand_vector_avx2, CPU_AVX2 },
+#endif
+#ifdef HAVE_SSE41
+   { SL "\"nand\"(VV)V", ieee_nand_vector_sse41, CPU_SSE41 },
+   { SL "\"nand\"(YY)Y", ieee_nand_vector_sse41, CPU_SSE41 },
+#endif
+   { SL "\"nand\"(VV)V", ieee_nand_vector },
+   { SL "\"nand\"(YY)Y", ieee_nand_vector },
+#ifdef HAVE_AVX2
+   { SL "\"nor\"(VV)V", ieee_nor_vector_avx2, CPU_AVX2 },
+   { SL "\"nor\"(YY)Y", ieee_nor_vector_avx2, CPU_AVX2 },
+#endif
+#ifdef HAVE_SSE41
+   { SL "\"nor\"(VV)V", ieee_nor_vector_sse41, CPU_SSE41 },
+   { SL "\"nor\"(YY)Y", ieee_nor_vector_sse41, CPU_SSE41 },
+#endif
+   { SL "\"nor\"(VV)V", ieee_nor_vector },
+   { SL "\"nor\"(YY)Y", ieee_nor_vector },
+#ifdef HAVE_AVX2
+   { SL "\"xnor\"(VV)V", ieee_xnor_vector_avx2, CPU_AVX2 },
+   { SL "\"xnor\"(YY)Y", ieee_xnor_vector_avx2, CPU_AVX2 },
+#endif
+#ifdef HAVE_SSE41
+   { SL "\"xnor\"(VV)V", ieee_xnor_vector_sse41, CPU_SSE41 },
+   { SL "\"xnor\"(YY)Y", ieee_xnor_vector_sse41, CPU_SSE41 },
+#endif
+   { SL "\"xnor\"(VV)V", ieee_xnor_vector },
+   { SL "\"xnor\"(YY)Y", ieee_xnor_vector },
+#ifdef HAVE_AVX2
+   { SL "\"not\"(V)V", ieee_not_vector_avx2, CPU_AVX2 },
+   { SL "\"not\"(Y)Y", ieee_not_vector_avx2, CPU_AVX2 },
+#endif
+#ifdef HAVE_SSE41
+   { SL "\"not\"(V)V", ieee_not_vector_sse41, CPU_SSE41 },
+   { SL "\"not\"(Y)Y", ieee_not_vector_sse41, CPU_SSE41 },
+#endif
+   { SL "\"not\"(V)V", ieee_not_vector },
+   { SL "\"not\"(Y)Y", ieee_not_vector },
    { NS "TO_UNSIGNED(NN)" U, ieee_to_unsigned },
    { NS "TO_UNSIGNED(NN)" UU, ieee_to_unsigned },
    { NS "TO_SIGNED(IN)" S, ieee_to_signed },
    { NS "TO_SIGNED(IN)" US, ieee_to_signed },
+   { NS "\"<\"(" U U ")B", ieee_lt_unsigned },
+   { NS "\"<\"(" UU UU ")B", ieee_lt_unsigned },
+   { NS "\"<\"(" S S ")B", ieee_lt_signed },
+   { NS "\"<\"(" US US ")B", ieee_lt_signed },
+   { NS "\"<=\"(" U U ")B", ieee_le_unsigned },
+   { NS "\"<=\"(" UU UU ")B", ieee_le_unsigned },
+   { NS "\"<=\"(" S S ")B", ieee_le_signed },
+   { NS "\"<=\"(" US US ")B", ieee_le_signed },
+   { NS "\">\"(" U U ")B", ieee_gt_unsigned },
+   { NS "\">\"(" UU UU ")B", ieee_gt_unsigned },
+   { NS "\">\"(" S S ")B", ieee_gt_signed },
+   { NS "\">\"(" US US ")B", ieee_gt_signed },
+   { NS "\">=\"(" U U ")B", ieee_ge_unsigned },
+   { NS "\">=\"(" UU UU ")B", ieee_ge_unsigned },
+   { NS "\">=\"(" S S ")B", ieee_ge_signed },
+   { NS "\">=\"(" US US ")B", ieee_ge_signed },
+   { NS "\"=\"(" U U ")B", ieee_eq_unsigned },
+   { NS "\"=\"(" UU UU ")B", ieee_eq_unsigned },
+   { NS "\"=\"(" S S ")B", ieee_eq_signed },
+   { NS "\"=\"(" US US ")B", ieee_eq_signed },
+   { NS "\"/=\"(" U U ")B", ieee_neq_unsigned },
+   { NS "\"/=\"(" UU UU ")B", ieee_neq_unsigned },
+   { NS "\"/=\"(" S S ")B", ieee_neq_signed },
+   { NS "\"/=\"(" US US ")B", ieee_neq_signed },
+   { NS "\"/\"(" U U ")" U, ieee_div_unsigned },
+   { NS "\"/\"(" UU UU ")" UU, ieee_div_unsigned },
+   { NS "\"/\"(" S S ")" S, ieee_div_signed },
+   { NS "\"/\"(" US US ")" US, ieee_div_signed },
+   { NS "\"mod\"(" U U ")" U, ieee_mod_unsigned },
+   { NS "\"mod\"(" UU UU ")" UU, ieee_mod_unsigned },
+   { NS "\"mod\"(" S S ")" S, ieee_mod_signed },
+   { NS "\"mod\"(" US US ")" US, ieee_mod_signed },
+   { NS "\"rem\"(" U U ")" U, ieee_mod_unsigned },
+   { NS "\"rem\"(" UU UU ")" UU, ieee_mod_unsigned },
+   { NS "\"rem\"(" S S ")" S, ieee_rem_signed },
+   { NS "\"rem\"(" US US ")" US, ieee_rem_signed },
+   { NS "SHIFT_LEFT(" U "N)" U, ieee_shift_left },
+   { NS "SHIFT_LEFT(" UU "N)" UU, ieee_shift_left },
+   { NS "SHIFT_LEFT(" S "N)" S, ieee_shift_left },
+   { NS "SHIFT_LEFT(" US "N)" US, ieee_shift_left },
+   { NS "SHIFT_RIGHT(" U "N)" U, ieee_shift_right_unsigned },
+   { NS "SHIFT_RIGHT(" UU "N)" UU, ieee_shift_right_unsigned },
+   { NS "SHIFT_RIGHT(" S "N)" S, ieee_shift_right_signed },
+   { NS "SHIFT_RIGHT(" US "N)" US, ieee_shift_right_signed },
+   { NS "ROTATE_LEFT(" U "N)" U, ieee_rotate_left },
+   { NS "ROTATE_LEFT(" UU "N)" UU, ieee_rotate_left },
+   { NS "ROTATE_LEFT(" S "N)" S, ieee_rotate_left },
+   { NS "ROTATE_LEFT(" US "N)" US, ieee_rotate_left },
+   { NS "ROTATE_RIGHT(" U "N)" U, ieee_rotate_right },
+   { NS "ROTATE_RIGHT(" UU "N)" UU, ieee_rotate_right },
+   { NS "ROTATE_RIGHT(" S "N)" S, ieee_rotate_right },
+   { NS "ROTATE_RIGHT(" US "N)" US, ieee_rotate_right },
+   { NS "TO_INTEGER(" U ")N", ieee_to_integer_unsigned },
+   { NS "TO_INTEGER(" UU ")N", ieee_to_integer_unsigned },
+   { NS "TO_INTEGER(" S ")I", ieee_to_integer_signed },
+   { NS "TO_INTEGER(" US ")I", ieee_to_integer_signed },
+   { NS "TO_HSTRING(" UU ")S", ieee_to_hstring },
+   { NS "TO_HSTRING(" US ")S", ieee_to_hstring_signed },
+   { NS "TO_OSTRING(" UU ")S", ieee_to_ostring },
+   { NS "TO_OSTRING(" US ")S", ieee_to_ostring_signed },
+   { SL "TO_HSTRING(Y)S", ieee_to_hstring },
+   { SL "TO_OSTRING(Y)S", ieee_to_ostring },
+#ifdef HAVE_AVX2
+   { SL "\"=\"(VV)B$predef", byte_vector_equal_avx2, CPU_AVX2 },
+   { SL "\"=\"(YY)B$predef", byte_vector_equal_avx2, CPU_AVX2 },
+   { ST "\"=\"(QQ)B$predef", byte_vector_equal_avx2, CPU_AVX2 },
+   { ST "\"=\"(SS)B$predef", byte_vector_equal_avx2, CPU_AVX2 },
+#endif
 #ifdef HAVE_SSE41
    { SL "\"=\"(VV)B$predef", byte_vector_equal_sse41, CPU_SSE41 },
    { SL "\"=\"(YY)B$predef", byte_vector_equal_sse41, CPU_SSE41 },
@@ -1795,6 +3254,20 @@ static jit_intrinsic_t intrinsic_list[] = {
    { SL "\"=\"(YY)B$predef", byte_vector_equal },
    { ST "\"=\"(QQ)B$predef", byte_vector_equal },
    { ST "\"=\"(SS)B$predef", byte_vector_equal },
+#ifdef HAVE_AVX2
+   { NS "STD_MATCH(" U U ")B", ieee_std_match_avx2, CPU_AVX2 },
+   { NS "STD_MATCH(" UU UU ")B", ieee_std_match_avx2, CPU_AVX2 },
+   { NS "STD_MATCH(" S S ")B", ieee_std_match_avx2, CPU_AVX2 },
+   { NS "STD_MATCH(" US US ")B", ieee_std_match_avx2, CPU_AVX2 },
+   { NS "STD_MATCH(VV)B", ieee_std_match_avx2, CPU_AVX2 },
+   { NS "STD_MATCH(YY)B", ieee_std_match_avx2, CPU_AVX2 },
+#endif
+   { NS "STD_MATCH(" U U ")B", ieee_std_match },
+   { NS "STD_MATCH(" UU UU ")B", ieee_std_match },
+   { NS "STD_MATCH(" S S ")B", ieee_std_match },
+   { NS "STD_MATCH(" US US ")B", ieee_std_match },
+   { NS "STD_MATCH(VV)B", ieee_std_match },
+   { NS "STD_MATCH(YY)B", ieee_std_match },
    { MR "SIN(R)R", ieee_math_sin },
    { MR "COS(R)R", ieee_math_cos },
    { MR "LOG(R)R", ieee_math_log },
@@ -1853,14 +3326,16 @@ jit_entry_fn_t jit_bind_intrinsic(ident_t name)
          const bool want_intrinsics = !!opt_get_int(OPT_JIT_INTRINSICS);
 
 #if __SANITIZE_ADDRESS__
-         const bool want_vector = false;   // Reads past end of input (benign)
+         const int vector_level = 0;   // Reads past end of input (benign)
 #else
-         const bool want_vector = !!opt_get_int(OPT_VECTOR_INTRINSICS);
+         const int vector_level = opt_get_int(OPT_VECTOR_INTRINSICS);
 #endif
+         const bool want_vector = vector_level > 0;
 
          cpu_feature_t mask = 0;
 #if HAVE_AVX2
-         if (want_vector && __builtin_cpu_supports("avx2"))
+         // NVC_VECTOR_INTRINSICS=1 restricts to 128-bit vectors
+         if (vector_level > 1 && __builtin_cpu_supports("avx2"))
             mask |= CPU_AVX2;
 #endif
 #ifdef HAVE_SSE41
@@ -158,11 +158,11 @@ static jit_value_t jit_addr_from_value(jit_value_t value, int32_t disp)
    }
 }
 
-static jit_value_t jit_addr_from_cover_tag(uint32_t tag)
+static jit_value_t jit_addr_from_cover_offset(uint32_t offset)
 {
    return (jit_value_t){
       .kind = JIT_ADDR_COVER,
-      .int64 = tag,
+      .int64 = offset,
    };
 }
 
@@ -3303,9 +3303,30 @@ static void irgen_op_driving_value(jit_irgen_t *g, int op)
 static void irgen_op_cover_increment(jit_irgen_t *g, int op)
 {
    uint32_t tag = vcode_get_tag(op);
-   jit_value_t mem = jit_addr_from_cover_tag(tag);
 
-   macro_sadd(g, JIT_SZ_32, mem, jit_value_from_int64(1));
+   switch (jit_get_cover_bits(g->func->jit)) {
+   case 1:
+      {
+         // Only record whether the item was ever hit
+         jit_value_t mem = jit_addr_from_cover_offset(tag / 8);
+         jit_value_t cur = j_uload(g, JIT_SZ_8, mem);
+         jit_value_t bit = jit_value_from_int64(1 << (tag % 8));
+         j_store(g, JIT_SZ_8, j_or(g, cur, bit), mem);
+      }
+      break;
+   case 8:
+      {
+         jit_value_t mem = jit_addr_from_cover_offset(tag);
+         macro_sadd(g, JIT_SZ_8, mem, jit_value_from_int64(1));
+      }
+      break;
+   default:
+      {
+         jit_value_t mem = jit_addr_from_cover_offset(tag * 4);
+         macro_sadd(g, JIT_SZ_32, mem, jit_value_from_int64(1));
+      }
+      break;
+   }
 }
 
 static void irgen_op_cover_toggle(jit_irgen_t *g, int op)
@@ -4242,9 +4263,19 @@ void jit_irgen(jit_func_t *f)
    g->labels = NULL;
 
    if (kind != VCODE_UNIT_THUNK) {
+      if (opt_get_int(OPT_JIT_INLINE)) {
+         // Compiling callees may select a different vcode unit
+         vcode_state_t state;
+         vcode_state_save(&state);
+         jit_do_inline(f);
+         vcode_state_restore(&state);
+      }
+
       jit_do_mem2reg(f);
       jit_do_lvn(f);
       jit_do_cprop(f);
+      jit_do_vrp(f);
+      jit_do_licm(f);
       jit_do_dce(f);
       jit_delete_nops(f);
       jit_free_cfg(f);
@@ -64,6 +64,7 @@ typedef enum {
    LLVM_PAIR_I64_I1,
 
    LLVM_ENTRY_FN,
+   LLVM_OSR_FN,
    LLVM_ANCHOR,
    LLVM_TLAB,
    LLVM_AOT_RELOC,
@@ -204,6 +205,7 @@ typedef struct _cgen_func {
    LLVMValueRef     irpos;
    LLVMValueRef     tlab;
    LLVMValueRef     anchor;
+   LLVMValueRef     frame;
    LLVMValueRef     cpool;
    LLVMTypeRef      cpool_type;
    LLVMValueRef     descr;
@@ -218,6 +220,7 @@ typedef struct _cgen_func {
    bit_mask_t       ptr_mask;
    cgen_mode_t      mode;
    cgen_reloc_t    *relocs;
+   jit_label_t      osr_target;
 } cgen_func_t;
 
 typedef enum {
@@ -384,6 +387,27 @@ static void llvm_register_types(llvm_obj_t *obj)
                                                    false);
    }
 
+   {
+      LLVMTypeRef atypes[] = {
+         obj->types[LLVM_PTR],    // Function
+         obj->types[LLVM_PTR],    // Anchor
+#ifdef LLVM_HAS_OPAQUE_POINTERS
+         obj->types[LLVM_PTR],    // Arguments
+         obj->types[LLVM_PTR],    // TLAB pointer
+         obj->types[LLVM_PTR],    // Interpreter registers
+#else
+         LLVMPointerType(obj->types[LLVM_INT64], 0),
+         LLVMPointerType(obj->types[LLVM_TLAB], 0),
+         LLVMPointerType(obj->types[LLVM_INT64], 0),
+#endif
+         obj->types[LLVM_PTR],    // Interpreter frame
+         obj->types[LLVM_INT32],  // Flags
+      };
+      obj->types[LLVM_OSR_FN] = LLVMFunctionType(obj->types[LLVM_VOID],
+                                                 atypes, ARRAY_LEN(atypes),
+                                                 false);
+   }
+
    {
       LLVMTypeRef fields[] = {
          obj->types[LLVM_INT32],   // Kind
@@ -1228,7 +1252,7 @@ static LLVMValueRef cgen_get_value(llvm_obj_t *obj, cgen_block_t *cgb,
          LLVMValueRef indexes[] = {
             llvm_intptr(obj, value.int64)
          };
-         return LLVMBuildGEP2(obj->builder, obj->types[LLVM_INT32],
+         return LLVMBuildGEP2(obj->builder, obj->types[LLVM_INT8],
                               base, indexes, 1, "");
       }
       else
@@ -2164,6 +2188,18 @@ static void cgen_macro_lalloc(llvm_obj_t *obj, cgen_block_t *cgb, jit_ir_t *ir)
 
 static void cgen_macro_salloc(llvm_obj_t *obj, cgen_block_t *cgb, jit_ir_t *ir)
 {
+   if (cgb->func->frame != NULL) {
+      // Entered from the interpreter which has already allocated the
+      // frame and may have pointers to it in live registers
+      LLVMValueRef indexes[] = { llvm_intptr(obj, ir->arg1.int64) };
+      LLVMValueRef ptr = LLVMBuildInBoundsGEP2(obj->builder,
+                                               obj->types[LLVM_INT8],
+                                               cgb->func->frame, indexes,
+                                               ARRAY_LEN(indexes), "");
+      cgen_pointer_result(obj, cgb, ir, ptr);
+      return;
+   }
+
    LLVMBasicBlockRef old_bb = LLVMGetInsertBlock(obj->builder);
    LLVMBasicBlockRef first_bb = LLVMGetFirstBasicBlock(cgb->func->llvmfn);
    LLVMPositionBuilderAtEnd(obj->builder, first_bb);
@@ -2880,9 +2916,64 @@ static void cgen_reexecute_guard(llvm_obj_t *obj, cgen_func_t *func,
    LLVMPositionBuilderAtEnd(obj->builder, cont_bb);
 }
 
+static void cgen_osr_entry(llvm_obj_t *obj, cgen_func_t *func,
+                           cgen_block_t *target)
+{
+   // Load the registers and flags live on entry to the loop header
+   // from the interpreter state and add them as an extra incoming edge
+   // to its phi nodes
+
+   LLVMBasicBlockRef entry_bb = LLVMGetInsertBlock(obj->builder);
+
+   if (mask_test(&target->source->livein, func->source->nregs)) {
+      assert(LLVMIsAPHINode(target->inflags));
+
+      LLVMValueRef flags_arg = LLVMGetParam(func->llvmfn, 6);
+      LLVMValueRef flags = LLVMBuildICmp(obj->builder, LLVMIntNE, flags_arg,
+                                         llvm_int32(obj, 0), "FLAGS");
+      LLVMAddIncoming(target->inflags, &flags, &entry_bb, 1);
+   }
+
+   LLVMValueRef regs_arg = LLVMGetParam(func->llvmfn, 4);
+   LLVMSetValueName(regs_arg, "regs");
+
+   for (int j = 0; j < func->source->nregs; j++) {
+      if (!mask_test(&target->source->livein, j))
+         continue;
+
+      assert(LLVMIsAPHINode(target->inregs[j]));
+
+      llvm_type_t type =
+         mask_test(&func->ptr_mask, j) ? LLVM_PTR : LLVM_INT64;
+
+      LLVMValueRef indexes[] = { llvm_intptr(obj, j) };
+      LLVMValueRef ptr = LLVMBuildInBoundsGEP2(obj->builder,
+                                               obj->types[LLVM_INT64],
+                                               regs_arg, indexes,
+                                               ARRAY_LEN(indexes), "");
+#ifdef LLVM_HAS_OPAQUE_POINTERS
+      LLVMValueRef cast = ptr;
+#else
+      LLVMTypeRef ptr_type = LLVMPointerType(obj->types[type], 0);
+      LLVMValueRef cast = LLVMBuildPointerCast(obj->builder, ptr, ptr_type, "");
+#endif
+
+      LLVMValueRef value = LLVMBuildLoad2(obj->builder, obj->types[type],
+                                          cast, cgen_reg_name(j));
+      LLVMSetAlignment(value, sizeof(int64_t));
+
+      LLVMAddIncoming(target->inregs[j], &value, &entry_bb, 1);
+   }
+
+   LLVMBuildBr(obj->builder, target->bbref);
+}
+
 static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
 {
-   func->llvmfn = llvm_add_fn(obj, func->name, obj->types[LLVM_ENTRY_FN]);
+   const bool osr = func->osr_target != JIT_LABEL_INVALID;
+
+   llvm_type_t fntype = osr ? LLVM_OSR_FN : LLVM_ENTRY_FN;
+   func->llvmfn = llvm_add_fn(obj, func->name, obj->types[fntype]);
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_NOUNWIND, -1);
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_UWTABLE, -1);
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_DLLEXPORT, -1);
@@ -2893,6 +2984,9 @@ static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_NONNULL, 3);
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_NOALIAS, 4);
 
+   if (osr)
+      llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_READONLY, 5);
+
 #ifdef PRESERVE_FRAME_POINTER
    llvm_add_func_attr(obj, func->llvmfn, FUNC_ATTR_PRESERVE_FP, -1);
 #endif
@@ -2943,13 +3037,26 @@ static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
    func->tlab = LLVMGetParam(func->llvmfn, 3);
    LLVMSetValueName(func->tlab, "tlab");
 
+   if (osr) {
+      func->frame = LLVMGetParam(func->llvmfn, 5);
+      LLVMSetValueName(func->frame, "frame");
+   }
+
    cgen_frame_anchor(obj, func);
    cgen_cache_args(obj, func);
 
    jit_cfg_t *cfg = func->cfg = jit_get_cfg(func->source);
-   cgen_reexecute_guard(obj, func, cfg);
+   if (!osr)
+      cgen_reexecute_guard(obj, func, cfg);
    cgen_basic_blocks(obj, func, cfg);
 
+   cgen_block_t *osr_cgb = NULL;
+   if (osr) {
+      jit_block_t *bb = jit_block_for(cfg, func->osr_target);
+      assert(bb->first == func->osr_target);
+      osr_cgb = &(func->blocks[bb - cfg->blocks]);
+   }
+
    entry_bb = LLVMGetInsertBlock(obj->builder);
 
    cgen_pointer_mask(func);
@@ -2963,8 +3070,10 @@ static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
       if (i == cgb->source->first) {
          LLVMPositionBuilderAtEnd(obj->builder, cgb->bbref);
 
+         // The loop header for on-stack replacement has an additional
+         // predecessor so always needs phi instructions
          cgen_block_t *dom = NULL;
-         if (cgb->source->in.count == 1)
+         if (cgb->source->in.count == 1 && cgb != osr_cgb)
             dom = &(func->blocks[jit_get_edge(&cgb->source->in, 0)]);
 
          cgb->inflags = zero_flag;
@@ -3066,6 +3175,13 @@ static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
       }
    }
 
+   LLVMPositionBuilderAtEnd(obj->builder, entry_bb);
+
+   if (osr_cgb != NULL)
+      cgen_osr_entry(obj, func, osr_cgb);
+   else
+      LLVMBuildBr(obj->builder, func->blocks[0].bbref);
+
    for (int i = 0; i < cfg->nblocks; i++) {
       cgen_block_t *cgb = &(func->blocks[i]);
       free(cgb->inregs);
@@ -3073,9 +3189,6 @@ static void cgen_function(llvm_obj_t *obj, cgen_func_t *func)
       cgb->inregs = cgb->outregs = NULL;
    }
 
-   LLVMPositionBuilderAtEnd(obj->builder, entry_bb);
-   LLVMBuildBr(obj->builder, func->blocks[0].bbref);
-
    jit_free_cfg(func->source);
    func->cfg = cfg = NULL;
 
@@ -3366,19 +3479,61 @@ static void *jit_llvm_init(jit_t *jit)
    return state;
 }
 
-static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
+static void jit_llvm_cgen_batch(jit_t *j, const jit_handle_t *handles,
+                                int count, void *context)
 {
    llvm_jit_state_t *state = context;
 
-   jit_func_t *f = jit_get_func(j, handle);
+   const uint64_t start_us = get_timestamp_us();
+
+   // Each function may also have an entry point for on-stack
+   // replacement so there are at most twice as many LLVM functions
+   cgen_func_t *funcs LOCAL = xcalloc_array(count * 2, sizeof(cgen_func_t));
+   jit_entry_fn_t **entries LOCAL =
+      xcalloc_array(count * 2, sizeof(jit_entry_fn_t *));
+   ident_t *names LOCAL = xcalloc_array(count * 2, sizeof(ident_t));
+   int nfuncs = 0;
+
+   for (int i = 0; i < count; i++) {
+      jit_func_t *f = jit_get_func(j, handles[i]);
 
 #ifdef DEBUG
-   const char *only = getenv("NVC_JIT_ONLY");
-   if (only != NULL && !icmp(f->name, only))
-      return;
+      const char *only = getenv("NVC_JIT_ONLY");
+      if (only != NULL && !icmp(f->name, only))
+         continue;
 #endif
 
-   const uint64_t start_us = get_timestamp_us();
+      LOCAL_TEXT_BUF tb = tb_new();
+      tb_istr(tb, f->name);
+
+      names[nfuncs] = f->name;
+      entries[nfuncs] = &(f->entry);
+      funcs[nfuncs++] = (cgen_func_t){
+         .name       = tb_claim(tb),
+         .source     = f,
+         .mode       = CGEN_JIT,
+         .osr_target = JIT_LABEL_INVALID,
+      };
+
+      const jit_label_t osr_target = atomic_load(&f->osr_target);
+      if (osr_target != JIT_LABEL_INVALID) {
+         // The interpreter is stuck in a long-running loop so also
+         // generate an entry point that resumes from the loop header
+         ident_t osr_name = ident_prefix(f->name, ident_new("osr"), '$');
+
+         names[nfuncs] = osr_name;
+         entries[nfuncs] = (jit_entry_fn_t *)&(f->osr_entry);
+         funcs[nfuncs++] = (cgen_func_t){
+            .name       = xstrdup(istr(osr_name)),
+            .source     = f,
+            .mode       = CGEN_JIT,
+            .osr_target = osr_target,
+         };
+      }
+   }
+
+   if (nfuncs == 0)
+      return;
 
    LLVMTargetMachineRef tm = llvm_target_machine(LLVMRelocDefault,
                                                  JIT_CODE_MODEL);
@@ -3388,10 +3543,8 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
       .target  = tm,
    };
 
-   LOCAL_TEXT_BUF tb = tb_new();
-   tb_istr(tb, f->name);
-
-   obj.module    = LLVMModuleCreateWithNameInContext(tb_get(tb), obj.context);
+   obj.module    = LLVMModuleCreateWithNameInContext(funcs[0].name,
+                                                     obj.context);
    obj.builder   = LLVMCreateBuilderInContext(obj.context);
    obj.data_ref  = LLVMCreateTargetDataLayout(tm);
 
@@ -3401,13 +3554,8 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
 
    llvm_register_types(&obj);
 
-   cgen_func_t func = {
-      .name   = tb_claim(tb),
-      .source = f,
-      .mode   = CGEN_JIT,
-   };
-
-   cgen_function(&obj, &func);
+   for (int i = 0; i < nfuncs; i++)
+      cgen_function(&obj, &(funcs[i]));
 
    llvm_obj_finalise(&obj, LLVM_O0);
 
@@ -3419,22 +3567,24 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
 
    const size_t objsz = LLVMGetBufferSize(buf);
 
-   code_blob_t *blob = code_blob_new(state->code, f->name, objsz);
-   if (blob == NULL)
-      return;
+   code_blob_t *blob = code_blob_new(state->code, names[0], objsz);
+   if (blob != NULL) {
+      const uint8_t *base = blob->wptr;
+      const void *entry_addr = blob->wptr;
 
-   const uint8_t *base = blob->wptr;
-   const void *entry_addr = blob->wptr;
+      for (int i = 1; i < nfuncs; i++)
+         code_blob_export(blob, names[i], entries[i]);
 
-   code_load_object(blob, LLVMGetBufferStart(buf), objsz);
+      code_load_object(blob, LLVMGetBufferStart(buf), objsz);
 
-   const size_t size = blob->wptr - base;
-   code_blob_finalise(blob, &(f->entry));
+      const size_t size = blob->wptr - base;
+      code_blob_finalise(blob, entries[0]);
 
-   if (opt_get_int(OPT_JIT_LOG)) {
-      const uint64_t end_us = get_timestamp_us();
-      debugf("%s at %p [%zu bytes in %"PRIi64" us]", func.name,
-             entry_addr, size, end_us - start_us);
+      if (opt_get_int(OPT_JIT_LOG)) {
+         const uint64_t end_us = get_timestamp_us();
+         debugf("%s at %p [%d functions, %zu bytes in %"PRIi64" us]",
+                funcs[0].name, entry_addr, nfuncs, size, end_us - start_us);
+      }
    }
 
    LLVMDisposeMemoryBuffer(buf);
@@ -3443,7 +3593,14 @@ static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
    LLVMDisposeBuilder(obj.builder);
    DWARF_ONLY(LLVMDisposeDIBuilder(obj.debuginfo));
    LLVMContextDispose(obj.context);
-   free(func.name);
+
+   for (int i = 0; i < nfuncs; i++)
+      free(funcs[i].name);
+}
+
+static void jit_llvm_cgen(jit_t *j, jit_handle_t handle, void *context)
+{
+   jit_llvm_cgen_batch(j, &handle, 1, context);
 }
 
 static void jit_llvm_cleanup(void *context)
@@ -3454,11 +3611,17 @@ static void jit_llvm_cleanup(void *context)
 }
 
 static const jit_plugin_t jit_llvm = {
-   .init    = jit_llvm_init,
-   .cgen    = jit_llvm_cgen,
-   .cleanup = jit_llvm_cleanup
+   .init       = jit_llvm_init,
+   .cgen       = jit_llvm_cgen,
+   .cgen_batch = jit_llvm_cgen_batch,
+   .cleanup    = jit_llvm_cleanup
 };
 
+const jit_plugin_t *jit_get_llvm_plugin(void)
+{
+   return &jit_llvm;
+}
+
 void jit_register_llvm_plugin(jit_t *j)
 {
    const int threshold = opt_get_int(OPT_JIT_THRESHOLD);
@@ -3531,9 +3694,10 @@ void llvm_aot_compile(llvm_obj_t *obj, jit_t *j, jit_handle_t handle)
    LOCAL_TEXT_BUF tb = safe_symbol(f->name);
 
    cgen_func_t func = {
-      .name   = tb_claim(tb),
-      .source = f,
-      .mode   = CGEN_AOT,
+      .name       = tb_claim(tb),
+      .source     = f,
+      .mode       = CGEN_AOT,
+      .osr_target = JIT_LABEL_INVALID,
    };
 
    cgen_function(obj, &func);
@@ -22,6 +22,7 @@
 #include "jit/jit.h"
 
 void jit_register_llvm_plugin(jit_t *j);
+const jit_plugin_t *jit_get_llvm_plugin(void);
 
 typedef struct _llvm_obj llvm_obj_t;
 
@@ -1273,13 +1273,1620 @@ void jit_do_mem2reg(jit_func_t *f)
    f->framesz = newsize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Inlining of small leaf functions
+
+#define INLINE_MAX_IRS    40
+#define INLINE_MAX_GROWTH 4
+#define INLINE_MAX_REGS   16384
+
+static __thread int inline_depth = 0;
+
+static bool inline_value_ok(jit_value_t value)
+{
+   switch (value.kind) {
+   case JIT_ADDR_CPOOL:   // Would need to merge constant pools
+   case JIT_VALUE_VPOS:
+      return false;
+   default:
+      return true;
+   }
+}
+
+static bool inline_callee_ok(jit_func_t *caller, jit_func_t *callee)
+{
+   if (callee == caller)
+      return false;
+
+   const func_state_t state = load_acquire(&(callee->state));
+   if (state == JIT_FUNC_PLACEHOLDER && inline_depth == 0) {
+      // Compile the callee now but never wait for a function being
+      // compiled by another thread as that might be our caller
+      inline_depth++;
+      jit_fill_irbuf(callee);
+      inline_depth--;
+   }
+   else if (state != JIT_FUNC_READY)
+      return false;
+
+   if (load_acquire(&(callee->state)) != JIT_FUNC_READY)
+      return false;
+   else if (callee->irbuf == NULL || callee->nirs > INLINE_MAX_IRS)
+      return false;
+   else if (callee->framesz > 0 || callee->cpoolsz > 0)
+      return false;
+
+   for (int i = 0; i < callee->nirs; i++) {
+      const jit_ir_t *ir = &(callee->irbuf[i]);
+      switch (ir->op) {
+      case J_CALL:
+      case MACRO_EXIT:
+      case MACRO_GALLOC:
+      case MACRO_LALLOC:
+      case MACRO_SALLOC:
+      case MACRO_TRIM:
+      case MACRO_GETPRIV:
+      case MACRO_PUTPRIV:
+      case MACRO_REEXEC:
+         // These need the callee's own anchor or frame
+         return false;
+      case J_DEBUG:
+         break;
+      default:
+         if (!inline_value_ok(ir->arg1) || !inline_value_ok(ir->arg2))
+            return false;
+      }
+   }
+
+   return true;
+}
+
+static void inline_remap_value(jit_value_t *value, jit_reg_t regbase,
+                               const jit_label_t *labels)
+{
+   switch (value->kind) {
+   case JIT_VALUE_REG:
+   case JIT_ADDR_REG:
+      value->reg += regbase;
+      break;
+   case JIT_VALUE_LABEL:
+      value->label = labels[value->label];
+      break;
+   default:
+      break;
+   }
+}
+
+static bool inline_find_send(jit_func_t *f, int call, int nth,
+                             jit_value_t *value)
+{
+   // Look for the value the caller sent in argument slot NTH in the
+   // same basic block as the call
+   for (int i = call - 1; i >= 0; i--) {
+      const jit_ir_t *ir = &(f->irbuf[i]);
+      if (ir->op == J_SEND && ir->arg1.int64 == nth) {
+         if (ir->arg2.kind != JIT_VALUE_REG && ir->arg2.kind != JIT_VALUE_INT64
+             && ir->arg2.kind != JIT_VALUE_DOUBLE)
+            return false;
+         else if (ir->arg2.kind == JIT_VALUE_REG) {
+            for (int j = i + 1; j < call; j++) {
+               if (f->irbuf[j].result == ir->arg2.reg)
+                  return false;
+            }
+         }
+
+         *value = ir->arg2;
+         return true;
+      }
+      else if (ir->target || cfg_is_terminator(f, (jit_ir_t *)ir))
+         return false;
+      else if (ir->op == J_CALL || ir->op == MACRO_EXIT)
+         return false;
+   }
+
+   return false;
+}
+
+static void inline_one_call(jit_func_t *f, int call, jit_func_t *callee)
+{
+   const int nirs = f->nirs + callee->nirs;
+   jit_ir_t *irbuf = xmalloc_array(nirs, sizeof(jit_ir_t));
+
+   // Instruction indexes after the call shift by the callee size minus
+   // the call instruction itself which is replaced
+   jit_label_t *map LOCAL = xmalloc_array(f->nirs + 1, sizeof(jit_label_t));
+   for (int i = 0; i <= f->nirs; i++)
+      map[i] = i <= call ? i : i + callee->nirs - 1;
+
+   jit_label_t *inner LOCAL = xmalloc_array(callee->nirs, sizeof(jit_label_t));
+   for (int i = 0; i < callee->nirs; i++)
+      inner[i] = call + i;
+
+   const jit_label_t cont = call + callee->nirs;
+   const jit_reg_t regbase = f->nregs;
+
+   memcpy(irbuf, f->irbuf, call * sizeof(jit_ir_t));
+
+   // Arguments received at the start of the callee can be copied
+   // directly from the registers the caller sent
+   bool entry = true;
+
+   for (int i = 0; i < callee->nirs; i++) {
+      jit_ir_t *ir = &(irbuf[call + i]);
+      *ir = callee->irbuf[i];
+
+      if (ir->target)
+         entry = false;
+
+      if (ir->op == J_DEBUG) {
+         lvn_convert_nop(ir);
+         continue;
+      }
+      else if (ir->op == J_RET) {
+         ir->op         = J_JUMP;
+         ir->size       = JIT_SZ_UNSPEC;
+         ir->cc         = JIT_CC_NONE;
+         ir->arg1.kind  = JIT_VALUE_LABEL;
+         ir->arg1.label = cont;
+         ir->arg2.kind  = JIT_VALUE_INVALID;
+         entry = false;
+         continue;
+      }
+      else if (ir->op == J_SEND)
+         entry = false;
+
+      inline_remap_value(&ir->arg1, regbase, inner);
+      inline_remap_value(&ir->arg2, regbase, inner);
+
+      if (ir->result != JIT_REG_INVALID)
+         ir->result += regbase;
+
+      jit_value_t value;
+      if (entry && ir->op == J_RECV
+          && inline_find_send(f, call, ir->arg1.int64, &value)) {
+         ir->op        = J_MOV;
+         ir->arg1      = value;
+         ir->arg2.kind = JIT_VALUE_INVALID;
+      }
+
+      if (cfg_is_terminator(callee, &(callee->irbuf[i])))
+         entry = false;
+   }
+
+   irbuf[call].target |= f->irbuf[call].target;
+
+   for (int i = call + 1; i < f->nirs; i++)
+      irbuf[map[i]] = f->irbuf[i];
+
+   irbuf[cont].target = 1;
+
+   for (int i = 0; i < nirs - 1; i++) {
+      if (i >= call && i < cont)
+         continue;
+
+      jit_ir_t *ir = &(irbuf[i]);
+      if (ir->arg1.kind == JIT_VALUE_LABEL)
+         ir->arg1.label = map[ir->arg1.label];
+      if (ir->arg2.kind == JIT_VALUE_LABEL)
+         ir->arg2.label = map[ir->arg2.label];
+   }
+
+   free(f->irbuf);
+   f->irbuf = irbuf;
+   f->nirs  = nirs - 1;
+   f->nregs += callee->nregs;
+}
+
+void jit_do_inline(jit_func_t *f)
+{
+   const int limit = MAX(f->nirs * INLINE_MAX_GROWTH, 256);
+
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if (ir->op != J_CALL || ir->arg1.handle == JIT_HANDLE_INVALID)
+         continue;
+      else if (i + 1 == f->nirs)
+         break;
+
+      jit_func_t *callee = jit_get_func(f->jit, ir->arg1.handle);
+      if (!inline_callee_ok(f, callee))
+         continue;
+      else if (f->nirs + callee->nirs > limit)
+         break;
+      else if (f->nregs + callee->nregs > INLINE_MAX_REGS)
+         break;
+
+      inline_one_call(f, i, callee);
+
+      // Skip over the inlined body: the callee has no calls
+      i += callee->nirs - 1;
+   }
+
+   jit_free_cfg(f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Value range propagation and check elimination
+
+#define VRP_MAX_CELLS   (1 << 20)
+#define VRP_WIDEN_AFTER 2
+
+typedef struct {
+   int64_t low;
+   int64_t high;
+} vrp_range_t;
+
+typedef enum {
+   VRP_MAYBE, VRP_ALWAYS, VRP_NEVER
+} vrp_test_t;
+
+typedef struct {
+   jit_func_t     *func;
+   jit_cfg_t      *cfg;
+   vrp_range_t    *entry;
+   vrp_range_t    *cur;
+   vrp_range_t    *saved;
+   unsigned       *visits;
+   bool           *reached;
+   bool           *pending;
+   const jit_ir_t *cmp;
+   const jit_ir_t *ccmp;
+   bool            changed;
+} vrp_state_t;
+
+static const vrp_range_t vrp_top = { INT64_MIN, INT64_MAX };
+
+static inline bool vrp_is_top(vrp_range_t r)
+{
+   return r.low == INT64_MIN && r.high == INT64_MAX;
+}
+
+static inline bool vrp_within(vrp_range_t r, vrp_range_t limit)
+{
+   return r.low >= limit.low && r.high <= limit.high;
+}
+
+static vrp_range_t vrp_of(vrp_state_t *rs, jit_value_t value)
+{
+   switch (value.kind) {
+   case JIT_VALUE_INT64:
+      return (vrp_range_t){ value.int64, value.int64 };
+   case JIT_VALUE_REG:
+      return rs->cur[value.reg];
+   default:
+      return vrp_top;
+   }
+}
+
+static vrp_range_t vrp_for_size(jit_size_t size, bool is_unsigned)
+{
+   switch (size) {
+   case JIT_SZ_8:
+      return is_unsigned ? (vrp_range_t){ 0, UINT8_MAX }
+         : (vrp_range_t){ INT8_MIN, INT8_MAX };
+   case JIT_SZ_16:
+      return is_unsigned ? (vrp_range_t){ 0, UINT16_MAX }
+         : (vrp_range_t){ INT16_MIN, INT16_MAX };
+   case JIT_SZ_32:
+      return is_unsigned ? (vrp_range_t){ 0, UINT32_MAX }
+         : (vrp_range_t){ INT32_MIN, INT32_MAX };
+   default:
+      // Unsigned 64-bit values above INT64_MAX wrap to negative here
+      return vrp_top;
+   }
+}
+
+static vrp_range_t vrp_add(vrp_range_t a, vrp_range_t b)
+{
+   vrp_range_t r;
+   if (__builtin_add_overflow(a.low, b.low, &r.low)
+       || __builtin_add_overflow(a.high, b.high, &r.high))
+      return vrp_top;
+   else
+      return r;
+}
+
+static vrp_range_t vrp_sub(vrp_range_t a, vrp_range_t b)
+{
+   vrp_range_t r;
+   if (__builtin_sub_overflow(a.low, b.high, &r.low)
+       || __builtin_sub_overflow(a.high, b.low, &r.high))
+      return vrp_top;
+   else
+      return r;
+}
+
+static vrp_range_t vrp_mul(vrp_range_t a, vrp_range_t b)
+{
+   int64_t p[4];
+   if (__builtin_mul_overflow(a.low, b.low, &p[0])
+       || __builtin_mul_overflow(a.low, b.high, &p[1])
+       || __builtin_mul_overflow(a.high, b.low, &p[2])
+       || __builtin_mul_overflow(a.high, b.high, &p[3]))
+      return vrp_top;
+
+   vrp_range_t r = { p[0], p[0] };
+   for (int i = 1; i < 4; i++) {
+      r.low = MIN(r.low, p[i]);
+      r.high = MAX(r.high, p[i]);
+   }
+
+   return r;
+}
+
+static vrp_range_t vrp_arith(jit_op_t op, vrp_range_t a, vrp_range_t b)
+{
+   switch (op) {
+   case J_ADD: return vrp_add(a, b);
+   case J_SUB: return vrp_sub(a, b);
+   case J_MUL: return vrp_mul(a, b);
+   default: return vrp_top;
+   }
+}
+
+static bool vrp_no_overflow(vrp_state_t *rs, const jit_ir_t *ir)
+{
+   if (ir->cc != JIT_CC_O && ir->cc != JIT_CC_C)
+      return false;
+   else if (ir->size == JIT_SZ_UNSPEC)
+      return false;
+
+   const vrp_range_t a = vrp_of(rs, ir->arg1);
+   const vrp_range_t b = vrp_of(rs, ir->arg2);
+   const vrp_range_t r = vrp_arith(ir->op, a, b);
+
+   if (vrp_is_top(r))
+      return false;
+
+   // The sized operation sign or zero extends its result so it is only
+   // equivalent to a plain 64-bit operation if the operands also fit
+   vrp_range_t limit = vrp_for_size(ir->size, ir->cc == JIT_CC_C);
+   if (ir->cc == JIT_CC_C && ir->size == JIT_SZ_64) {
+      // There is no 64-bit unsigned range but a carry is impossible if
+      // everything is non-negative
+      limit.low = 0;
+   }
+
+   return vrp_within(a, limit) && vrp_within(b, limit)
+      && vrp_within(r, limit);
+}
+
+static vrp_test_t vrp_test(vrp_state_t *rs, jit_cc_t cc,
+                          jit_value_t lhs, jit_value_t rhs)
+{
+   vrp_range_t a = vrp_of(rs, lhs), b = vrp_of(rs, rhs);
+
+   switch (cc) {
+   case JIT_CC_GT:
+   case JIT_CC_GE:
+      {
+         const vrp_range_t tmp = a;
+         a = b;
+         b = tmp;
+         cc = (cc == JIT_CC_GT) ? JIT_CC_LT : JIT_CC_LE;
+      }
+      break;
+   default:
+      break;
+   }
+
+   switch (cc) {
+   case JIT_CC_EQ:
+   case JIT_CC_NE:
+      {
+         const bool same = a.low == a.high && b.low == b.high
+            && a.low == b.low;
+         const bool disjoint = a.high < b.low || b.high < a.low;
+
+         if (same)
+            return cc == JIT_CC_EQ ? VRP_ALWAYS : VRP_NEVER;
+         else if (disjoint)
+            return cc == JIT_CC_EQ ? VRP_NEVER : VRP_ALWAYS;
+         else
+            return VRP_MAYBE;
+      }
+   case JIT_CC_LT:
+      if (a.high < b.low)
+         return VRP_ALWAYS;
+      else if (a.low >= b.high)
+         return VRP_NEVER;
+      else
+         return VRP_MAYBE;
+   case JIT_CC_LE:
+      if (a.high <= b.low)
+         return VRP_ALWAYS;
+      else if (a.low > b.high)
+         return VRP_NEVER;
+      else
+         return VRP_MAYBE;
+   default:
+      return VRP_MAYBE;
+   }
+}
+
+static jit_cc_t vrp_negate(jit_cc_t cc)
+{
+   switch (cc) {
+   case JIT_CC_EQ: return JIT_CC_NE;
+   case JIT_CC_NE: return JIT_CC_EQ;
+   case JIT_CC_LT: return JIT_CC_GE;
+   case JIT_CC_GE: return JIT_CC_LT;
+   case JIT_CC_GT: return JIT_CC_LE;
+   case JIT_CC_LE: return JIT_CC_GT;
+   default: return JIT_CC_NONE;
+   }
+}
+
+static void vrp_refine(vrp_state_t *rs, jit_cc_t cc,
+                       jit_value_t lhs, jit_value_t rhs)
+{
+   vrp_range_t a = vrp_of(rs, lhs), b = vrp_of(rs, rhs);
+
+   switch (cc) {
+   case JIT_CC_EQ:
+      a.low = b.low = MAX(a.low, b.low);
+      a.high = b.high = MIN(a.high, b.high);
+      break;
+   case JIT_CC_LT:
+      if (b.high > INT64_MIN)
+         a.high = MIN(a.high, b.high - 1);
+      if (a.low < INT64_MAX)
+         b.low = MAX(b.low, a.low + 1);
+      break;
+   case JIT_CC_LE:
+      a.high = MIN(a.high, b.high);
+      b.low = MAX(b.low, a.low);
+      break;
+   case JIT_CC_GT:
+      vrp_refine(rs, JIT_CC_LT, rhs, lhs);
+      return;
+   case JIT_CC_GE:
+      vrp_refine(rs, JIT_CC_LE, rhs, lhs);
+      return;
+   default:
+      return;
+   }
+
+   // An empty range means the edge is infeasible which the caller
+   // should already have checked with vrp_test
+   if (lhs.kind == JIT_VALUE_REG && a.low <= a.high)
+      rs->cur[lhs.reg] = a;
+   if (rhs.kind == JIT_VALUE_REG && b.low <= b.high)
+      rs->cur[rhs.reg] = b;
+}
+
+static bool vrp_feasible(vrp_state_t *rs, bool flags)
+{
+   const jit_ir_t *cmp = rs->cmp, *ccmp = rs->ccmp;
+
+   if (cmp == NULL)
+      return true;
+
+   const vrp_test_t t1 = vrp_test(rs, cmp->cc, cmp->arg1, cmp->arg2);
+   const vrp_test_t t2 = ccmp == NULL ? VRP_ALWAYS
+      : vrp_test(rs, ccmp->cc, ccmp->arg1, ccmp->arg2);
+
+   if (flags)
+      return t1 != VRP_NEVER && t2 != VRP_NEVER;
+   else
+      return t1 != VRP_ALWAYS || t2 != VRP_ALWAYS;
+}
+
+static void vrp_assume(vrp_state_t *rs, bool flags)
+{
+   const jit_ir_t *cmp = rs->cmp, *ccmp = rs->ccmp;
+
+   if (cmp == NULL)
+      return;
+   else if (flags) {
+      vrp_refine(rs, cmp->cc, cmp->arg1, cmp->arg2);
+      if (ccmp != NULL)
+         vrp_refine(rs, ccmp->cc, ccmp->arg1, ccmp->arg2);
+   }
+   else if (ccmp == NULL)
+      vrp_refine(rs, vrp_negate(cmp->cc), cmp->arg1, cmp->arg2);
+}
+
+static bool vrp_uses_reg(const jit_ir_t *ir, jit_reg_t reg)
+{
+   return (ir->arg1.kind == JIT_VALUE_REG && ir->arg1.reg == reg)
+      || (ir->arg2.kind == JIT_VALUE_REG && ir->arg2.reg == reg);
+}
+
+static void vrp_transfer(vrp_state_t *rs, const jit_ir_t *ir)
+{
+   if (ir->op == J_CMP) {
+      rs->cmp = ir;
+      rs->ccmp = NULL;
+   }
+   else if (ir->op == J_CCMP && rs->cmp != NULL && rs->ccmp == NULL)
+      rs->ccmp = ir;
+   else if (jit_writes_flags((jit_ir_t *)ir))
+      rs->cmp = rs->ccmp = NULL;
+
+   if (!cfg_writes_result((jit_ir_t *)ir))
+      return;
+
+   const vrp_range_t a = vrp_of(rs, ir->arg1);
+   const vrp_range_t b = vrp_of(rs, ir->arg2);
+
+   vrp_range_t r = vrp_top;
+   switch (ir->op) {
+   case J_MOV:
+      r = a;
+      break;
+   case J_ADD:
+   case J_SUB:
+   case J_MUL:
+      if (ir->cc == JIT_CC_O || ir->cc == JIT_CC_C) {
+         // Execution only continues if the operation did not overflow
+         const vrp_range_t limit = vrp_for_size(ir->size, ir->cc == JIT_CC_C);
+         r = vrp_arith(ir->op, a, b);
+         if (!vrp_within(r, limit))
+            r = limit;
+      }
+      else if (ir->size == JIT_SZ_UNSPEC)
+         r = vrp_arith(ir->op, a, b);
+      break;
+   case J_NEG:
+      if (a.low > INT64_MIN)
+         r = (vrp_range_t){ -a.high, -a.low };
+      break;
+   case J_CSET:
+      r = (vrp_range_t){ 0, 1 };
+      break;
+   case J_CSEL:
+      r = (vrp_range_t){ MIN(a.low, b.low), MAX(a.high, b.high) };
+      break;
+   case J_CLAMP:
+      r = (vrp_range_t){ MAX(a.low, 0), MAX(a.high, 0) };
+      break;
+   case J_LOAD:
+      r = vrp_for_size(ir->size, false);
+      break;
+   case J_ULOAD:
+      r = vrp_for_size(ir->size, true);
+      break;
+   case J_AND:
+      if (a.low >= 0 && b.low >= 0)
+         r = (vrp_range_t){ 0, MIN(a.high, b.high) };
+      else if (a.low >= 0)
+         r = (vrp_range_t){ 0, a.high };
+      else if (b.low >= 0)
+         r = (vrp_range_t){ 0, b.high };
+      break;
+   case J_ASR:
+      if (b.low == b.high && b.low >= 0 && b.low < 64)
+         r = (vrp_range_t){ a.low >> b.low, a.high >> b.low };
+      break;
+   case J_REM:
+      if (b.low > 0) {
+         const int64_t max = b.high - 1;
+         if (a.low >= 0)
+            r = (vrp_range_t){ 0, MIN(a.high, max) };
+         else
+            r = (vrp_range_t){ -max, max };
+      }
+      break;
+   default:
+      break;
+   }
+
+   rs->cur[ir->result] = r;
+
+   // Flags no longer describe the register if it was overwritten
+   if (rs->cmp != NULL && vrp_uses_reg(rs->cmp, ir->result))
+      rs->cmp = rs->ccmp = NULL;
+   else if (rs->ccmp != NULL && vrp_uses_reg(rs->ccmp, ir->result))
+      rs->cmp = rs->ccmp = NULL;
+}
+
+static void vrp_merge(vrp_state_t *rs, int from, int to)
+{
+   const int nregs = rs->func->nregs;
+   vrp_range_t *dest = rs->entry + (size_t)to * nregs;
+
+   if (!rs->reached[to]) {
+      memcpy(dest, rs->cur, nregs * sizeof(vrp_range_t));
+      rs->reached[to] = true;
+      rs->pending[to] = true;
+      rs->changed = true;
+      return;
+   }
+
+   // Every cycle contains at least one backwards edge so widening only
+   // on those edges is enough to guarantee termination
+   const bool widen = to <= from && ++(rs->visits[to]) > VRP_WIDEN_AFTER;
+
+   bool changed = false;
+   for (int i = 0; i < nregs; i++) {
+      if (rs->cur[i].low < dest[i].low) {
+         dest[i].low = widen ? INT64_MIN : rs->cur[i].low;
+         changed = true;
+      }
+
+      if (rs->cur[i].high > dest[i].high) {
+         dest[i].high = widen ? INT64_MAX : rs->cur[i].high;
+         changed = true;
+      }
+   }
+
+   if (changed) {
+      rs->pending[to] = true;
+      rs->changed = true;
+   }
+}
+
+static void vrp_visit_block(vrp_state_t *rs, int bi)
+{
+   jit_func_t *f = rs->func;
+   jit_block_t *b = &(rs->cfg->blocks[bi]);
+
+   memcpy(rs->cur, rs->entry + (size_t)bi * f->nregs,
+          f->nregs * sizeof(vrp_range_t));
+
+   rs->cmp = rs->ccmp = NULL;
+
+   for (int i = b->first; i <= b->last; i++)
+      vrp_transfer(rs, &(f->irbuf[i]));
+
+   const jit_ir_t *last = &(f->irbuf[b->last]);
+   if (last->op == J_JUMP && (last->cc == JIT_CC_T || last->cc == JIT_CC_F)) {
+      const int taken = jit_block_for(rs->cfg, last->arg1.label) - rs->cfg->blocks;
+      const bool flags = (last->cc == JIT_CC_T);
+
+      memcpy(rs->saved, rs->cur, f->nregs * sizeof(vrp_range_t));
+
+      if (vrp_feasible(rs, flags)) {
+         vrp_assume(rs, flags);
+         vrp_merge(rs, bi, taken);
+         memcpy(rs->cur, rs->saved, f->nregs * sizeof(vrp_range_t));
+      }
+
+      if (bi + 1 < rs->cfg->nblocks && vrp_feasible(rs, !flags)) {
+         vrp_assume(rs, !flags);
+         vrp_merge(rs, bi, bi + 1);
+      }
+   }
+   else {
+      for (int i = 0; i < b->out.count; i++)
+         vrp_merge(rs, bi, jit_get_edge(&b->out, i));
+   }
+}
+
+static void vrp_kill_fallthrough(jit_func_t *f, int pos)
+{
+   // Code after an unconditional jump is unreachable until the next
+   // branch target
+   for (int i = pos + 1; i < f->nirs && !f->irbuf[i].target; i++)
+      lvn_convert_nop(&(f->irbuf[i]));
+}
+
+static bool vrp_rewrite_block(vrp_state_t *rs, int bi)
+{
+   jit_func_t *f = rs->func;
+   jit_block_t *b = &(rs->cfg->blocks[bi]);
+
+   memcpy(rs->cur, rs->entry + (size_t)bi * f->nregs,
+          f->nregs * sizeof(vrp_range_t));
+
+   rs->cmp = rs->ccmp = NULL;
+
+   bool no_overflow = false;
+   for (int i = b->first; i <= b->last; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+
+      if (ir->op == J_JUMP && no_overflow) {
+         // Flags were set by an arithmetic operation that cannot overflow
+         jit_ir_t *arith = ir - 1;
+         arith->cc   = JIT_CC_NONE;
+         arith->size = JIT_SZ_UNSPEC;
+
+         if (ir->cc == JIT_CC_F) {
+            ir->cc = JIT_CC_NONE;
+            vrp_kill_fallthrough(f, i);
+         }
+         else
+            lvn_convert_nop(ir);
+
+         return true;
+      }
+      else if (ir->op == J_JUMP && i == b->last
+               && (ir->cc == JIT_CC_T || ir->cc == JIT_CC_F)) {
+         const bool flags = (ir->cc == JIT_CC_T);
+         if (!vrp_feasible(rs, !flags)) {
+            ir->cc = JIT_CC_NONE;
+            vrp_kill_fallthrough(f, i);
+            return true;
+         }
+         else if (!vrp_feasible(rs, flags)) {
+            lvn_convert_nop(ir);
+            return true;
+         }
+      }
+
+      // Only rewrite if the flags are consumed by the conditional jump
+      // at the end of this block
+      const jit_ir_t *next = ir + 1;
+      no_overflow = (ir->op == J_ADD || ir->op == J_SUB || ir->op == J_MUL)
+         && i + 1 == b->last && next->op == J_JUMP
+         && (next->cc == JIT_CC_T || next->cc == JIT_CC_F)
+         && vrp_no_overflow(rs, ir);
+
+      vrp_transfer(rs, ir);
+   }
+
+   return false;
+}
+
+void jit_do_vrp(jit_func_t *f)
+{
+   if (f->nregs == 0)
+      return;
+
+   jit_cfg_t *cfg = jit_get_cfg(f);
+
+   const size_t ncells = (size_t)cfg->nblocks * f->nregs;
+   if (ncells > VRP_MAX_CELLS)
+      return;
+
+   vrp_state_t rs = {
+      .func = f,
+      .cfg  = cfg,
+   };
+
+   rs.entry   = xmalloc_array(ncells, sizeof(vrp_range_t));
+   rs.cur     = xmalloc_array(f->nregs, sizeof(vrp_range_t));
+   rs.saved   = xmalloc_array(f->nregs, sizeof(vrp_range_t));
+   rs.visits  = xcalloc_array(cfg->nblocks, sizeof(unsigned));
+   rs.reached = xcalloc_array(cfg->nblocks, sizeof(bool));
+   rs.pending = xcalloc_array(cfg->nblocks, sizeof(bool));
+
+   for (int i = 0; i < f->nregs; i++)
+      rs.entry[i] = vrp_top;
+
+   rs.reached[0] = rs.pending[0] = true;
+
+   do {
+      rs.changed = false;
+
+      for (int i = 0; i < cfg->nblocks; i++) {
+         if (rs.pending[i]) {
+            rs.pending[i] = false;
+            vrp_visit_block(&rs, i);
+         }
+      }
+   } while (rs.changed);
+
+   bool modified = false;
+   for (int i = 0; i < cfg->nblocks; i++) {
+      if (rs.reached[i])
+         modified |= vrp_rewrite_block(&rs, i);
+   }
+
+   free(rs.entry);
+   free(rs.cur);
+   free(rs.saved);
+   free(rs.visits);
+   free(rs.reached);
+   free(rs.pending);
+
+   if (modified)
+      jit_free_cfg(f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dominators and natural loops
+
+typedef struct {
+   int        *idom;
+   int        *order;
+   int        *rpo;
+   int         nreachable;
+} dom_info_t;
+
+typedef struct {
+   int         header;
+   int         nblocks;
+   bit_mask_t  body;
+} loop_info_t;
+
+typedef A(loop_info_t) loop_list_t;
+
+static void dom_dfs(jit_cfg_t *cfg, int bi, bool *visited, int *post,
+                    int *count)
+{
+   // Blocks are visited in layout order and most functions are shallow
+   // but use an explicit stack anyway to avoid overflow
+   int *stack LOCAL = xmalloc_array(cfg->nblocks, sizeof(int));
+   int *next LOCAL = xcalloc_array(cfg->nblocks, sizeof(int));
+   int sp = 0;
+
+   stack[sp++] = bi;
+   visited[bi] = true;
+
+   while (sp > 0) {
+      const int top = stack[sp - 1];
+      jit_block_t *b = &(cfg->blocks[top]);
+
+      if (next[top] < b->out.count) {
+         const int succ = jit_get_edge(&b->out, next[top]++);
+         if (!visited[succ]) {
+            visited[succ] = true;
+            stack[sp++] = succ;
+         }
+      }
+      else {
+         post[top] = (*count)++;
+         sp--;
+      }
+   }
+}
+
+static int dom_intersect(const dom_info_t *di, int a, int b)
+{
+   while (a != b) {
+      while (di->order[a] < di->order[b])
+         a = di->idom[a];
+      while (di->order[b] < di->order[a])
+         b = di->idom[b];
+   }
+
+   return a;
+}
+
+static void dom_compute(jit_cfg_t *cfg, dom_info_t *di)
+{
+   // Algorithm from "A Simple, Fast Dominance Algorithm" by Cooper,
+   // Harvey, and Kennedy using postorder numbers to walk the tree
+   const int nb = cfg->nblocks;
+
+   di->idom  = xmalloc_array(nb, sizeof(int));
+   di->order = xmalloc_array(nb, sizeof(int));
+   di->rpo   = xmalloc_array(nb, sizeof(int));
+
+   bool *visited LOCAL = xcalloc_array(nb, sizeof(bool));
+
+   int count = 0;
+   for (int i = 0; i < nb; i++)
+      di->order[i] = -1;
+   dom_dfs(cfg, 0, visited, di->order, &count);
+
+   di->nreachable = count;
+   for (int i = 0; i < nb; i++) {
+      di->idom[i] = -1;
+      if (di->order[i] >= 0)
+         di->rpo[count - 1 - di->order[i]] = i;
+   }
+
+   di->idom[0] = 0;
+
+   for (bool changed = true; changed; ) {
+      changed = false;
+      for (int i = 1; i < di->nreachable; i++) {
+         const int bi = di->rpo[i];
+         jit_block_t *b = &(cfg->blocks[bi]);
+
+         int new = -1;
+         for (int j = 0; j < b->in.count; j++) {
+            const int pred = jit_get_edge(&b->in, j);
+            if (di->idom[pred] == -1)
+               continue;
+            else if (new == -1)
+               new = pred;
+            else
+               new = dom_intersect(di, pred, new);
+         }
+
+         if (new != -1 && di->idom[bi] != new) {
+            di->idom[bi] = new;
+            changed = true;
+         }
+      }
+   }
+}
+
+static void dom_free(dom_info_t *di)
+{
+   free(di->idom);
+   free(di->order);
+   free(di->rpo);
+}
+
+static bool dom_dominates(const dom_info_t *di, int a, int b)
+{
+   if (di->idom[b] == -1)
+      return false;
+
+   while (b != a && b != 0)
+      b = di->idom[b];
+
+   return b == a;
+}
+
+static int loop_size_cmp(const void *a, const void *b)
+{
+   return ((const loop_info_t *)a)->nblocks
+      - ((const loop_info_t *)b)->nblocks;
+}
+
+static void loop_find_all(jit_cfg_t *cfg, const dom_info_t *di,
+                          loop_list_t *loops)
+{
+   int *stack LOCAL = xmalloc_array(cfg->nblocks, sizeof(int));
+
+   for (int i = 0; i < di->nreachable; i++) {
+      const int bi = di->rpo[i];
+      jit_block_t *b = &(cfg->blocks[bi]);
+
+      for (int j = 0; j < b->out.count; j++) {
+         const int header = jit_get_edge(&b->out, j);
+         if (!dom_dominates(di, header, bi))
+            continue;
+
+         // Back edge to the loop header: merge loops with the same
+         // header into a single loop
+         loop_info_t *loop = NULL;
+         for (int k = 0; k < loops->count; k++) {
+            if (loops->items[k].header == header)
+               loop = &(loops->items[k]);
+         }
+
+         if (loop == NULL) {
+            loop_info_t new = { .header = header, .nblocks = 1 };
+            mask_init(&new.body, cfg->nblocks);
+            mask_set(&new.body, header);
+            APUSH(*loops, new);
+            loop = &(loops->items[loops->count - 1]);
+         }
+
+         int sp = 0;
+         if (!mask_test(&loop->body, bi)) {
+            mask_set(&loop->body, bi);
+            loop->nblocks++;
+            stack[sp++] = bi;
+         }
+
+         while (sp > 0) {
+            jit_block_t *x = &(cfg->blocks[stack[--sp]]);
+            for (int k = 0; k < x->in.count; k++) {
+               const int pred = jit_get_edge(&x->in, k);
+               if (di->idom[pred] != -1 && !mask_test(&loop->body, pred)) {
+                  mask_set(&loop->body, pred);
+                  loop->nblocks++;
+                  stack[sp++] = pred;
+               }
+            }
+         }
+      }
+   }
+
+   // Visit inner loops before the loops that enclose them
+   if (loops->count > 1)
+      qsort(loops->items, loops->count, sizeof(loop_info_t), loop_size_cmp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Loop invariant code motion and strength reduction
+
+#define LICM_MAX_ROUNDS 16
+
+typedef struct {
+   jit_reg_t basic;
+   int64_t   scale;
+   bool      reduce;
+   bool      keep;
+   jit_reg_t init;
+} licm_iv_t;
+
+typedef struct {
+   jit_func_t        *func;
+   jit_cfg_t         *cfg;
+   const dom_info_t  *dom;
+   const loop_info_t *loop;
+   int               *ndefs;
+   bit_mask_t         defined;
+   bit_mask_t         invariant;
+   A(int)             hoist;
+   A(int)             derived;
+   licm_iv_t         *ivs;
+   int64_t           *step;
+   int               *ivdef;
+} licm_state_t;
+
+static bool licm_value_invariant(licm_state_t *ls, jit_value_t value)
+{
+   switch (value.kind) {
+   case JIT_VALUE_REG:
+   case JIT_ADDR_REG:
+      return mask_test(&ls->invariant, value.reg);
+   case JIT_VALUE_INVALID:
+   case JIT_VALUE_INT64:
+   case JIT_VALUE_DOUBLE:
+   case JIT_ADDR_ABS:
+   case JIT_ADDR_CPOOL:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static bool licm_is_pure(jit_ir_t *ir)
+{
+   if (ir->cc != JIT_CC_NONE)
+      return false;
+
+   switch (ir->op) {
+   case J_ADD:
+   case J_SUB:
+   case J_MUL:
+   case J_AND:
+   case J_OR:
+   case J_XOR:
+   case J_SHL:
+   case J_ASR:
+   case J_NOT:
+   case J_NEG:
+   case J_LEA:
+   case J_CLAMP:
+   case J_FADD:
+   case J_FSUB:
+   case J_FMUL:
+   case J_FDIV:
+   case J_FNEG:
+   case J_SCVTF:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static bool licm_writes_memory(jit_ir_t *ir)
+{
+   switch (ir->op) {
+   case J_STORE:
+   case J_CALL:
+   case MACRO_COPY:
+   case MACRO_MOVE:
+   case MACRO_BZERO:
+   case MACRO_MEMSET:
+   case MACRO_PUTPRIV:
+   case MACRO_REEXEC:
+      return true;
+   case MACRO_EXIT:
+      return !jit_will_abort(ir);
+   default:
+      return false;
+   }
+}
+
+static bool licm_block_exits(licm_state_t *ls, jit_block_t *b)
+{
+   if (b->returns || b->aborts)
+      return true;
+
+   for (int i = 0; i < b->out.count; i++) {
+      if (!mask_test(&ls->loop->body, jit_get_edge(&b->out, i)))
+         return true;
+   }
+
+   return false;
+}
+
+static bool licm_can_speculate(licm_state_t *ls, int bi)
+{
+   // A load may only be hoisted if it would have been executed on
+   // every path through the loop body before leaving the loop
+   for (int i = 0; i < ls->cfg->nblocks; i++) {
+      if (!mask_test(&ls->loop->body, i))
+         continue;
+      else if (!licm_block_exits(ls, &(ls->cfg->blocks[i])))
+         continue;
+      else if (!dom_dominates(ls->dom, bi, i))
+         return false;
+   }
+
+   return true;
+}
+
+static bool licm_candidate(licm_state_t *ls, jit_ir_t *ir)
+{
+   if (ir->result == JIT_REG_INVALID || !cfg_writes_result(ir))
+      return false;
+   else if (ls->ndefs[ir->result] != 1)
+      return false;
+
+   jit_block_t *header = &(ls->cfg->blocks[ls->loop->header]);
+   return !mask_test(&header->livein, ir->result);
+}
+
+static void licm_find_invariant(licm_state_t *ls)
+{
+   jit_func_t *f = ls->func;
+   jit_cfg_t *cfg = ls->cfg;
+
+   bool stores = false;
+   for (int i = 0; i < cfg->nblocks; i++) {
+      if (!mask_test(&ls->loop->body, i))
+         continue;
+
+      jit_block_t *b = &(cfg->blocks[i]);
+      for (int j = b->first; j <= b->last; j++) {
+         jit_ir_t *ir = &(f->irbuf[j]);
+         if (cfg_writes_result(ir))
+            mask_set(&ls->defined, ir->result);
+         stores |= licm_writes_memory(ir);
+      }
+   }
+
+   for (int i = 0; i < f->nregs; i++) {
+      if (!mask_test(&ls->defined, i))
+         mask_set(&ls->invariant, i);
+   }
+
+   for (bool changed = true; changed; ) {
+      changed = false;
+
+      for (int i = 0; i < cfg->nblocks; i++) {
+         if (!mask_test(&ls->loop->body, i))
+            continue;
+
+         jit_block_t *b = &(cfg->blocks[i]);
+         for (int j = b->first; j <= b->last; j++) {
+            jit_ir_t *ir = &(f->irbuf[j]);
+            if (!licm_candidate(ls, ir))
+               continue;
+            else if (mask_test(&ls->invariant, ir->result))
+               continue;
+            else if (!licm_value_invariant(ls, ir->arg1))
+               continue;
+            else if (!licm_value_invariant(ls, ir->arg2))
+               continue;
+
+            if (ir->op == J_LOAD || ir->op == J_ULOAD) {
+               if (stores || !licm_can_speculate(ls, i))
+                  continue;
+            }
+            else if (!licm_is_pure(ir))
+               continue;
+
+            mask_set(&ls->invariant, ir->result);
+            APUSH(ls->hoist, j);
+            changed = true;
+         }
+      }
+   }
+}
+
+static bool licm_is_iv(licm_state_t *ls, jit_value_t value)
+{
+   return value.kind == JIT_VALUE_REG
+      && ls->ivs[value.reg].basic != JIT_REG_INVALID;
+}
+
+static void licm_find_basic_ivs(licm_state_t *ls)
+{
+   jit_func_t *f = ls->func;
+   jit_cfg_t *cfg = ls->cfg;
+
+   int *count LOCAL = xcalloc_array(f->nregs, sizeof(int));
+
+   for (int i = 0; i < cfg->nblocks; i++) {
+      if (!mask_test(&ls->loop->body, i))
+         continue;
+
+      jit_block_t *b = &(cfg->blocks[i]);
+      for (int j = b->first; j <= b->last; j++) {
+         jit_ir_t *ir = &(f->irbuf[j]);
+         if (!cfg_writes_result(ir))
+            continue;
+
+         count[ir->result]++;
+
+         if (ir->cc != JIT_CC_NONE || ir->size != JIT_SZ_UNSPEC)
+            continue;
+         else if (ir->op != J_ADD && ir->op != J_SUB)
+            continue;
+         else if (ir->arg1.kind != JIT_VALUE_REG
+                  || ir->arg1.reg != ir->result)
+            continue;
+         else if (ir->arg2.kind != JIT_VALUE_INT64)
+            continue;
+
+         const int64_t step = ir->arg2.int64;
+         if (ir->op == J_SUB && step == INT64_MIN)
+            continue;
+
+         ls->step[ir->result] = ir->op == J_ADD ? step : -step;
+         ls->ivdef[ir->result] = j;
+      }
+   }
+
+   for (int i = 0; i < f->nregs; i++) {
+      if (count[i] == 1 && ls->ivdef[i] != -1) {
+         ls->ivs[i].basic = i;
+         ls->ivs[i].scale = 1;
+      }
+      else
+         ls->ivdef[i] = -1;
+   }
+}
+
+static void licm_find_derived_ivs(licm_state_t *ls)
+{
+   jit_func_t *f = ls->func;
+   jit_cfg_t *cfg = ls->cfg;
+
+   for (bool changed = true; changed; ) {
+      changed = false;
+
+      for (int i = 0; i < cfg->nblocks; i++) {
+         if (!mask_test(&ls->loop->body, i))
+            continue;
+
+         jit_block_t *b = &(cfg->blocks[i]);
+         for (int j = b->first; j <= b->last; j++) {
+            jit_ir_t *ir = &(f->irbuf[j]);
+            if (!licm_candidate(ls, ir))
+               continue;
+            else if (ir->cc != JIT_CC_NONE || ir->size != JIT_SZ_UNSPEC)
+               continue;
+            else if (ls->ivs[ir->result].basic != JIT_REG_INVALID)
+               continue;
+            else if (mask_test(&ls->invariant, ir->result))
+               continue;
+
+            // Each derived value is an affine function of a single
+            // basic induction variable
+            const bool iv1 = licm_is_iv(ls, ir->arg1);
+            const bool iv2 = licm_is_iv(ls, ir->arg2);
+            const licm_iv_t *src = NULL;
+            int64_t scale = 0;
+            bool reduce = false;
+
+            switch (ir->op) {
+            case J_ADD:
+               if (iv1 && licm_value_invariant(ls, ir->arg2))
+                  src = &(ls->ivs[ir->arg1.reg]), scale = src->scale;
+               else if (iv2 && licm_value_invariant(ls, ir->arg1))
+                  src = &(ls->ivs[ir->arg2.reg]), scale = src->scale;
+               break;
+            case J_SUB:
+               if (iv1 && licm_value_invariant(ls, ir->arg2))
+                  src = &(ls->ivs[ir->arg1.reg]), scale = src->scale;
+               else if (iv2 && licm_value_invariant(ls, ir->arg1)
+                        && ls->ivs[ir->arg2.reg].scale != INT64_MIN)
+                  src = &(ls->ivs[ir->arg2.reg]), scale = -src->scale;
+               break;
+            case J_MUL:
+               if (iv1 && ir->arg2.kind == JIT_VALUE_INT64)
+                  src = &(ls->ivs[ir->arg1.reg]), scale = ir->arg2.int64;
+               else if (iv2 && ir->arg1.kind == JIT_VALUE_INT64)
+                  src = &(ls->ivs[ir->arg2.reg]), scale = ir->arg1.int64;
+               if (src && __builtin_mul_overflow(src->scale, scale, &scale))
+                  src = NULL;
+               reduce = true;
+               break;
+            case J_SHL:
+               if (iv1 && ir->arg2.kind == JIT_VALUE_INT64
+                   && ir->arg2.int64 >= 0 && ir->arg2.int64 < 32) {
+                  src = &(ls->ivs[ir->arg1.reg]);
+                  if (__builtin_mul_overflow(src->scale,
+                                             INT64_C(1) << ir->arg2.int64,
+                                             &scale))
+                     src = NULL;
+               }
+               reduce = true;
+               break;
+            case J_LEA:
+               if (ir->arg1.kind == JIT_ADDR_REG
+                   && ls->ivs[ir->arg1.reg].basic != JIT_REG_INVALID)
+                  src = &(ls->ivs[ir->arg1.reg]), scale = src->scale;
+               break;
+            default:
+               break;
+            }
+
+            if (src == NULL)
+               continue;
+
+            licm_iv_t *iv = &(ls->ivs[ir->result]);
+            iv->basic  = src->basic;
+            iv->scale  = scale;
+            iv->reduce = reduce || src->reduce;
+
+            APUSH(ls->derived, j);
+            changed = true;
+         }
+      }
+   }
+}
+
+static bool licm_falls_through(licm_state_t *ls, int bi)
+{
+   jit_block_t *b = &(ls->cfg->blocks[bi]);
+   if (b->returns || b->aborts)
+      return false;
+
+   jit_ir_t *last = &(ls->func->irbuf[b->last]);
+   if (last->op == J_JUMP && last->cc == JIT_CC_NONE)
+      return false;
+
+   for (int i = 0; i < b->out.count; i++) {
+      if (jit_get_edge(&b->out, i) == bi + 1)
+         return true;
+   }
+
+   return false;
+}
+
+static void licm_remap_value(licm_state_t *ls, jit_value_t *value)
+{
+   if (value->kind != JIT_VALUE_REG && value->kind != JIT_ADDR_REG)
+      return;
+
+   const licm_iv_t *iv = &(ls->ivs[value->reg]);
+   if (iv->basic != JIT_REG_INVALID && iv->basic != value->reg)
+      value->reg = iv->init;
+}
+
+static bool licm_transform(licm_state_t *ls)
+{
+   jit_func_t *f = ls->func;
+
+   // Only reduce derived values whose computation includes a multiply
+   // or shift and whose per iteration step is representable
+   for (int i = 0; i < ls->derived.count; i++) {
+      jit_ir_t *ir = &(f->irbuf[ls->derived.items[i]]);
+      licm_iv_t *iv = &(ls->ivs[ir->result]);
+
+      int64_t delta;
+      if (__builtin_mul_overflow(ls->step[iv->basic], iv->scale, &delta))
+         iv->reduce = false;
+
+      iv->init = f->nregs + i;
+   }
+
+   // Intermediate values that only feed other reduced values do not
+   // need to be updated inside the loop
+   bool *used LOCAL = xcalloc_array(f->nregs, sizeof(bool));
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(f->irbuf[i]);
+      if (cfg_writes_result(ir) && ls->ivs[ir->result].reduce)
+         continue;
+
+      if (ir->arg1.kind == JIT_VALUE_REG || ir->arg1.kind == JIT_ADDR_REG)
+         used[ir->arg1.reg] = true;
+      if (ir->arg2.kind == JIT_VALUE_REG || ir->arg2.kind == JIT_ADDR_REG)
+         used[ir->arg2.reg] = true;
+      if (cfg_reads_result(ir))
+         used[ir->result] = true;
+   }
+
+   int nreduced = 0;
+   for (int i = 0; i < ls->derived.count; i++) {
+      jit_ir_t *ir = &(f->irbuf[ls->derived.items[i]]);
+      licm_iv_t *iv = &(ls->ivs[ir->result]);
+      iv->keep = iv->reduce && used[ir->result];
+      nreduced += iv->keep;
+   }
+
+   if (ls->hoist.count == 0 && nreduced == 0)
+      return false;
+
+   jit_block_t *header = &(ls->cfg->blocks[ls->loop->header]);
+
+   // The preheader is placed physically before the header so if the
+   // previous block is part of the loop it must jump over it
+   const bool jump_over = mask_test(&ls->loop->body, ls->loop->header - 1)
+      && licm_falls_through(ls, ls->loop->header - 1);
+
+   const int nirs = f->nirs + ls->hoist.count + ls->derived.count
+      + nreduced + jump_over;
+   jit_ir_t *irbuf = xcalloc_array(nirs, sizeof(jit_ir_t));
+   jit_label_t *map LOCAL = xmalloc_array(f->nirs, sizeof(jit_label_t));
+
+   int wptr = 0, prehead = -1, jumppos = -1;
+   for (int i = 0; i < f->nirs; i++) {
+      if (i == header->first) {
+         if (jump_over) {
+            jit_ir_t *ir = &(irbuf[(jumppos = wptr++)]);
+            ir->op        = J_JUMP;
+            ir->size      = JIT_SZ_UNSPEC;
+            ir->cc        = JIT_CC_NONE;
+            ir->result    = JIT_REG_INVALID;
+            ir->arg1.kind = JIT_VALUE_LABEL;
+            ir->arg2.kind = JIT_VALUE_INVALID;
+         }
+
+         // Build a new preheader on the edges entering the loop
+         prehead = wptr;
+
+         for (int j = 0; j < ls->hoist.count; j++) {
+            jit_ir_t *ir = &(irbuf[wptr++]);
+            *ir = f->irbuf[ls->hoist.items[j]];
+            ir->target = 0;
+         }
+
+         for (int j = 0; j < ls->derived.count; j++) {
+            jit_ir_t *ir = &(irbuf[wptr++]);
+            *ir = f->irbuf[ls->derived.items[j]];
+            ir->target = 0;
+            ir->result = ls->ivs[ir->result].init;
+            licm_remap_value(ls, &ir->arg1);
+            licm_remap_value(ls, &ir->arg2);
+         }
+
+         irbuf[prehead].target = f->irbuf[i].target;
+      }
+
+      map[i] = wptr;
+
+      jit_ir_t *ir = &(irbuf[wptr++]);
+      *ir = f->irbuf[i];
+
+      if (ir->result != JIT_REG_INVALID && cfg_writes_result(ir)) {
+         licm_iv_t *iv = &(ls->ivs[ir->result]);
+         if (mask_test(&ls->defined, ir->result)
+             && mask_test(&ls->invariant, ir->result))
+            lvn_convert_nop(ir);
+         else if (iv->basic != JIT_REG_INVALID && iv->basic != ir->result
+                  && iv->keep) {
+            ir->op        = J_MOV;
+            ir->arg1.kind = JIT_VALUE_REG;
+            ir->arg1.reg  = iv->init;
+            ir->arg2.kind = JIT_VALUE_INVALID;
+         }
+         else if (ls->ivdef[ir->result] == i) {
+            // Advance every reduced value derived from this variable
+            for (int j = 0; j < ls->derived.count; j++) {
+               const jit_reg_t reg = f->irbuf[ls->derived.items[j]].result;
+               const licm_iv_t *div = &(ls->ivs[reg]);
+               if (div->basic != ir->result || !div->keep)
+                  continue;
+
+               jit_ir_t *inc = &(irbuf[wptr++]);
+               inc->op          = J_ADD;
+               inc->size        = JIT_SZ_UNSPEC;
+               inc->cc          = JIT_CC_NONE;
+               inc->result      = div->init;
+               inc->arg1.kind   = JIT_VALUE_REG;
+               inc->arg1.reg    = div->init;
+               inc->arg2.kind   = JIT_VALUE_INT64;
+               inc->arg2.int64  = ls->step[ir->result] * div->scale;
+            }
+         }
+      }
+   }
+
+   assert(prehead != -1);
+   assert(wptr <= nirs);
+
+   irbuf[map[header->first]].target = 1;
+
+   if (jumppos != -1)
+      irbuf[jumppos].arg1.label = map[header->first];
+
+   for (int i = 0; i < f->nirs; i++) {
+      jit_ir_t *ir = &(irbuf[map[i]]);
+      jit_block_t *b = jit_block_for(ls->cfg, i);
+      const bool inside = mask_test(&ls->loop->body, b - ls->cfg->blocks);
+
+      jit_value_t *args[] = { &ir->arg1, &ir->arg2 };
+      for (int j = 0; j < ARRAY_LEN(args); j++) {
+         if (args[j]->kind != JIT_VALUE_LABEL)
+            continue;
+         else if (args[j]->label == header->first && !inside)
+            args[j]->label = prehead;   // Enter via the preheader
+         else
+            args[j]->label = map[args[j]->label];
+      }
+   }
+
+   free(f->irbuf);
+   f->irbuf  = irbuf;
+   f->nirs   = wptr;
+   f->nregs += ls->derived.count;
+
+   return true;
+}
+
+static bool licm_loop(jit_func_t *f, jit_cfg_t *cfg, const dom_info_t *di,
+                      const loop_info_t *loop, int *ndefs)
+{
+   if (loop->header == 0)
+      return false;   // Function entry block receives arguments
+   else if (f->nregs + f->nirs >= JIT_REG_INVALID)
+      return false;
+
+   licm_state_t ls = {
+      .func  = f,
+      .cfg   = cfg,
+      .dom   = di,
+      .loop  = loop,
+      .ndefs = ndefs,
+   };
+
+   mask_init(&ls.defined, f->nregs);
+   mask_init(&ls.invariant, f->nregs);
+
+   ls.ivs   = xmalloc_array(f->nregs, sizeof(licm_iv_t));
+   ls.step  = xcalloc_array(f->nregs, sizeof(int64_t));
+   ls.ivdef = xmalloc_array(f->nregs, sizeof(int));
+
+   for (int i = 0; i < f->nregs; i++) {
+      ls.ivs[i].basic = JIT_REG_INVALID;
+      ls.ivs[i].reduce = false;
+      ls.ivs[i].keep = false;
+      ls.ivdef[i] = -1;
+   }
+
+   licm_find_invariant(&ls);
+   licm_find_basic_ivs(&ls);
+   licm_find_derived_ivs(&ls);
+
+   const bool changed = licm_transform(&ls);
+
+   mask_free(&ls.defined);
+   mask_free(&ls.invariant);
+   ACLEAR(ls.hoist);
+   ACLEAR(ls.derived);
+   free(ls.ivs);
+   free(ls.step);
+   free(ls.ivdef);
+
+   return changed;
+}
+
+void jit_do_licm(jit_func_t *f)
+{
+   for (int round = 0; round < LICM_MAX_ROUNDS; round++) {
+      jit_cfg_t *cfg = jit_get_cfg(f);
+      if (cfg->nblocks < 2)
+         return;
+
+      dom_info_t di;
+      dom_compute(cfg, &di);
+
+      loop_list_t loops = AINIT;
+      loop_find_all(cfg, &di, &loops);
+
+      int *ndefs LOCAL = xcalloc_array(f->nregs, sizeof(int));
+      for (int i = 0; i < f->nirs; i++) {
+         jit_ir_t *ir = &(f->irbuf[i]);
+         if (cfg_writes_result(ir))
+            ndefs[ir->result]++;
+      }
+
+      bool changed = false;
+      for (int i = 0; i < loops.count && !changed; i++)
+         changed = licm_loop(f, cfg, &di, &(loops.items[i]), ndefs);
+
+      for (int i = 0; i < loops.count; i++)
+         mask_free(&(loops.items[i].body));
+      ACLEAR(loops);
+
+      dom_free(&di);
+      jit_free_cfg(f);
+
+      if (!changed)
+         break;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Register allocation
 
+#define LSCAN_LOOP_SHIFT 3
+#define LSCAN_MAX_SHIFT  24
+
 typedef struct {
    jit_reg_t   reg;
    unsigned    first;
    unsigned    last;
+   unsigned    weight;
+   jit_reg_t   hint;
+   bool        crosscall;
 } lscan_interval_t;
 
 static void lscan_grow_range(jit_reg_t reg, lscan_interval_t *li, int pos)
@@ -1289,8 +2896,32 @@ static void lscan_grow_range(jit_reg_t reg, lscan_interval_t *li, int pos)
    li[reg].last = MAX(li[reg].last, pos);
 }
 
+static void lscan_add_use(jit_reg_t reg, lscan_interval_t *li, int pos,
+                          unsigned weight)
+{
+   lscan_grow_range(reg, li, pos);
+   li[reg].weight += weight;
+}
+
+static bool lscan_is_call(jit_ir_t *ir)
+{
+   // Operations that are implemented as a call into the runtime or
+   // another function where only callee-saved registers are preserved
+   switch (ir->op) {
+   case J_CALL:
+   case MACRO_EXIT:
+   case MACRO_GALLOC:
+   case MACRO_LALLOC:
+   case MACRO_FEXP:
+      return true;
+   default:
+      return false;
+   }
+}
+
 static void lscan_walk_cfg(jit_func_t *f, jit_cfg_t *cfg, int bi,
-                           lscan_interval_t *li, bit_mask_t *visited)
+                           lscan_interval_t *li, bit_mask_t *visited,
+                           const int *depth)
 {
    if (mask_test(visited, bi))
       return;
@@ -1299,6 +2930,11 @@ static void lscan_walk_cfg(jit_func_t *f, jit_cfg_t *cfg, int bi,
 
    jit_block_t *b = &(cfg->blocks[bi]);
 
+   // Uses inside loops are weighted more heavily when choosing which
+   // interval to spill
+   const unsigned weight =
+      1u << MIN(depth[bi] * LSCAN_LOOP_SHIFT, LSCAN_MAX_SHIFT);
+
    for (size_t bit = -1; mask_iter(&b->livein, &bit);)
       lscan_grow_range(bit, li, b->first);
 
@@ -1306,13 +2942,13 @@ static void lscan_walk_cfg(jit_func_t *f, jit_cfg_t *cfg, int bi,
       jit_ir_t *ir = &(f->irbuf[i]);
 
       if (ir->result != JIT_REG_INVALID)
-         lscan_grow_range(ir->result, li, i);
+         lscan_add_use(ir->result, li, i, weight);
 
       if (ir->arg1.kind == JIT_VALUE_REG || ir->arg1.kind == JIT_ADDR_REG)
-         lscan_grow_range(ir->arg1.reg, li, i);
+         lscan_add_use(ir->arg1.reg, li, i, weight);
 
       if (ir->arg2.kind == JIT_VALUE_REG || ir->arg2.kind == JIT_ADDR_REG)
-         lscan_grow_range(ir->arg2.reg, li, i);
+         lscan_add_use(ir->arg2.reg, li, i, weight);
    }
 
    for (size_t bit = -1; mask_iter(&b->liveout, &bit); )
@@ -1320,8 +2956,26 @@ static void lscan_walk_cfg(jit_func_t *f, jit_cfg_t *cfg, int bi,
 
    for (int i = 0; i < b->out.count; i++) {
       const int next = jit_get_edge(&(b->out), i);
-      lscan_walk_cfg(f, cfg, next, li, visited);
+      lscan_walk_cfg(f, cfg, next, li, visited, depth);
+   }
+}
+
+static void lscan_loop_depth(jit_cfg_t *cfg, int *depth)
+{
+   dom_info_t di;
+   dom_compute(cfg, &di);
+
+   loop_list_t loops = AINIT;
+   loop_find_all(cfg, &di, &loops);
+
+   for (int i = 0; i < loops.count; i++) {
+      for (size_t bit = -1; mask_iter(&(loops.items[i].body), &bit);)
+         depth[bit]++;
+      mask_free(&(loops.items[i].body));
    }
+
+   ACLEAR(loops);
+   dom_free(&di);
 }
 
 static int lscan_interval_cmp(const void *a, const void *b)
@@ -1346,7 +3000,32 @@ static inline void lscan_shift_active(lscan_interval_t **active, unsigned to,
       memmove(active + to, active + from, count * sizeof(lscan_interval_t *));
 }
 
-int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
+static bool lscan_cheaper(const lscan_interval_t *a, const lscan_interval_t *b)
+{
+   // Prefer to spill the interval with the fewest weighted uses and
+   // break ties by spilling the one that ends furthest away
+   if (a->weight != b->weight)
+      return a->weight < b->weight;
+   else
+      return a->last > b->last;
+}
+
+static int lscan_choose_reg(const lscan_interval_t *this, uint32_t freeregs,
+                            uint32_t callmask)
+{
+   // Intervals live across a call should use callee-saved registers
+   // and other intervals should leave those free where possible
+   const uint32_t prefer =
+      freeregs & (this->crosscall ? callmask : ~callmask);
+
+   const int bit = __builtin_ffsl(prefer ?: freeregs) - 1;
+   assert(bit >= 0);
+   assert(freeregs & (1 << bit));
+   return bit;
+}
+
+int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask,
+                 uint64_t callmask)
 {
    //
    // Massimiliano Poletto and Vivek Sarkar
@@ -1354,6 +3033,10 @@ int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
    // ACM Trans. Program. Lang. Syst., Vol. 21, 5 (sep 1999), 895--913
    // https://doi.org/10.1145/330249.330250
    //
+   // Extended with spill weights based on loop depth, register hints
+   // to coalesce moves, and a preference for callee-saved registers
+   // for intervals that are live across calls.
+   //
 
    jit_cfg_t *cfg = jit_get_cfg(f);
 
@@ -1363,18 +3046,53 @@ int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
       li[i].reg = i;
       li[i].first = UINT_MAX;
       li[i].last = 0;
+      li[i].weight = 0;
+      li[i].hint = JIT_REG_INVALID;
+      li[i].crosscall = false;
       slots[i] = UINT_MAX;
    }
 
+   int *depth LOCAL = xcalloc_array(cfg->nblocks, sizeof(int));
+   lscan_loop_depth(cfg, depth);
+
    bit_mask_t visited;
    mask_init(&visited, cfg->nblocks);
-   lscan_walk_cfg(f, cfg, 0, li, &visited);
+   lscan_walk_cfg(f, cfg, 0, li, &visited, depth);
    mask_free(&visited);
 
    jit_free_cfg(f);
 
+   // A register can be coalesced with the source of the move that
+   // starts its interval but not with that of any later move
+   for (int i = 0; i < f->nregs; i++) {
+      if (li[i].first == UINT_MAX)
+         continue;
+
+      jit_ir_t *ir = &(f->irbuf[li[i].first]);
+      if (ir->op == J_MOV && ir->result == i
+          && ir->arg1.kind == JIT_VALUE_REG)
+         li[i].hint = ir->arg1.reg;
+   }
+
+   // Number of calls before each position to find intervals that are
+   // live across a call site
+   unsigned *ncalls LOCAL = xmalloc_array(f->nirs + 1, sizeof(unsigned));
+   ncalls[0] = 0;
+   for (int i = 0; i < f->nirs; i++)
+      ncalls[i + 1] = ncalls[i] + lscan_is_call(&(f->irbuf[i]));
+
+   for (int i = 0; i < f->nregs; i++) {
+      if (li[i].first < li[i].last)
+         li[i].crosscall = ncalls[li[i].last] > ncalls[li[i].first + 1];
+   }
+
    qsort(li, f->nregs, sizeof(lscan_interval_t), lscan_interval_cmp);
 
+   lscan_interval_t **map LOCAL =
+      xmalloc_array(f->nregs, sizeof(lscan_interval_t *));
+   for (int i = 0; i < f->nregs; i++)
+      map[li[i].reg] = &(li[i]);
+
    const int Rint = 32 - __builtin_popcountl(badmask & 0xffffffff);
    uint32_t freeregs = ~(badmask & 0xffffffff);
 
@@ -1383,6 +3101,9 @@ int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
    unsigned nactive = 0, next_spill = STACK_BASE;
 
    for (int i = 0; i < f->nregs; i++) {
+      if (li[i].first == UINT_MAX)
+         break;   // Remaining registers are never used
+
       // Expire old intervals
       int expire = 0;
       for (; expire < nactive; expire++) {
@@ -1398,15 +3119,51 @@ int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
       lscan_shift_active(active, 0, expire, nactive - expire);
       nactive -= expire;
 
-      const lscan_interval_t *this = &li[i];
+      lscan_interval_t *this = &li[i];
+
+      // If this interval is defined by a move from an interval that
+      // ends at the same instruction then reuse its register so the
+      // backend can elide the move
+      int coalesce = -1;
+      if (this->hint != JIT_REG_INVALID) {
+         const lscan_interval_t *src = map[this->hint];
+         jit_ir_t *ir = &(f->irbuf[this->first]);
+         if (src->last == this->first && slots[src->reg] < STACK_BASE
+             && ir->op == J_MOV && ir->result == this->reg
+             && ir->arg1.kind == JIT_VALUE_REG
+             && ir->arg1.reg == this->hint) {
+            for (int j = 0; j < nactive; j++) {
+               if (active[j] == src) {
+                  coalesce = j;
+                  break;
+               }
+            }
+         }
+      }
 
       bool allocated = false;
-      if (nactive == Rint) {
-         // Spill at interval
-         const lscan_interval_t *spill = active[nactive - 1];
-         if (spill->last > this->last) {
+      if (coalesce != -1) {
+         slots[this->reg] = slots[this->hint];
+         lscan_shift_active(active, coalesce, coalesce + 1,
+                            nactive - coalesce - 1);
+         nactive--;
+         allocated = true;
+      }
+      else if (nactive == Rint) {
+         // Spill the active interval with the lowest weight if that is
+         // cheaper than spilling this interval
+         int victim = -1;
+         for (int j = 0; j < nactive; j++) {
+            if (victim == -1 || lscan_cheaper(active[j], active[victim]))
+               victim = j;
+         }
+
+         const lscan_interval_t *spill = active[victim];
+         if (lscan_cheaper(spill, this)) {
             slots[this->reg] = slots[spill->reg];
             slots[spill->reg] = next_spill++;
+            lscan_shift_active(active, victim, victim + 1,
+                               nactive - victim - 1);
             nactive--;
             allocated = true;
          }
@@ -1414,9 +3171,7 @@ int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask)
             slots[this->reg] = next_spill++;
       }
       else {
-         const int bit = __builtin_ffsl(freeregs) - 1;
-         assert(bit >= 0);
-         assert(freeregs & (1 << bit));
+         const int bit = lscan_choose_reg(this, freeregs, callmask);
          freeregs &= ~(1 << bit);
          slots[this->reg] = bit;
          allocated = true;
@@ -238,6 +238,11 @@ typedef struct _jit_anchor jit_anchor_t;
 typedef void (*jit_entry_fn_t)(jit_func_t *, jit_anchor_t *,
                                jit_scalar_t *, tlab_t *);
 
+// Continues execution at a loop header from interpreter state
+typedef void (*jit_osr_fn_t)(jit_func_t *, jit_anchor_t *, jit_scalar_t *,
+                             tlab_t *, jit_scalar_t *, unsigned char *,
+                             int32_t);
+
 typedef struct {
    unsigned count;
    unsigned max;
@@ -303,7 +308,10 @@ typedef struct _jit_func {
    bool            owns_cpool;
    jit_handle_t    handle;
    unsigned        hotness;
+   bool            queued;
    jit_tier_t     *next_tier;
+   jit_osr_fn_t    osr_entry;
+   jit_label_t     osr_target;
    jit_cfg_t      *cfg;
    ffi_spec_t      spec;
    ident_t         module;
@@ -344,14 +352,16 @@ typedef struct {
 typedef struct _code_cache code_cache_t;
 typedef struct _code_span code_span_t;
 typedef struct _patch_list patch_list_t;
+typedef struct _export_list export_list_t;
 
 typedef struct {
    code_span_t  *span;
    jit_func_t   *func;
    uint8_t      *wptr;
    ihash_t      *labels;
-   patch_list_t *patches;
-   bool          overflow;
+   patch_list_t  *patches;
+   export_list_t *exports;
+   bool           overflow;
 } code_blob_t;
 
 typedef struct _pack_writer pack_writer_t;
@@ -375,9 +385,11 @@ void jit_hexdump(const unsigned char *data, size_t sz, int blocksz,
 void **jit_get_privdata_ptr(jit_t *j, jit_func_t *f);
 bool jit_has_runtime(jit_t *j);
 void jit_tier_up(jit_func_t *f);
+void jit_tier_up_osr(jit_func_t *f, jit_label_t target);
 jit_thread_local_t *jit_thread_local(void);
 void jit_fill_irbuf(jit_func_t *f);
-int32_t *jit_get_cover_ptr(jit_t *j, jit_value_t addr);
+void *jit_get_cover_ptr(jit_t *j, jit_value_t addr);
+unsigned jit_get_cover_bits(jit_t *j);
 object_t *jit_get_locus(jit_value_t value);
 jit_entry_fn_t jit_bind_intrinsic(ident_t name);
 jit_thread_local_t *jit_attach_thread(jit_anchor_t *anchor);
@@ -396,13 +408,17 @@ void jit_do_cprop(jit_func_t *f);
 void jit_do_dce(jit_func_t *f);
 void jit_delete_nops(jit_func_t *f);
 void jit_do_mem2reg(jit_func_t *f);
+void jit_do_inline(jit_func_t *f);
+void jit_do_vrp(jit_func_t *f);
+void jit_do_licm(jit_func_t *f);
 
 typedef unsigned phys_slot_t;
 #define INT_BASE   0
 #define FLOAT_BASE 32
 #define STACK_BASE 100
 
-int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask);
+int jit_do_lscan(jit_func_t *f, phys_slot_t *slots, uint64_t badmask,
+                 uint64_t callmask);
 
 code_cache_t *code_cache_new(void);
 void code_cache_free(code_cache_t *code);
@@ -414,6 +430,7 @@ code_blob_t *code_blob_new(code_cache_t *code, ident_t name, size_t hint);
 void code_blob_emit(code_blob_t *blob, const uint8_t *bytes, size_t len);
 void code_blob_align(code_blob_t *blob, unsigned align);
 void code_blob_finalise(code_blob_t *blob, jit_entry_fn_t *entry);
+void code_blob_export(code_blob_t *blob, ident_t name, jit_entry_fn_t *entry);
 void code_blob_mark(code_blob_t *blob, jit_label_t label);
 void code_blob_patch(code_blob_t *blob, jit_label_t label, code_patch_fn_t fn);
 void code_load_object(code_blob_t *blob, const void *data, size_t size);
@@ -125,12 +125,10 @@ static const x86_operand_t __R8  = REG(16);
 static const x86_operand_t __R9  = REG(17);
 static const x86_operand_t __R10 = REG(18);
 static const x86_operand_t __R11 = REG(19);
-#if 0
 static const x86_operand_t __R12 = REG(20);
 static const x86_operand_t __R13 = REG(21);
 static const x86_operand_t __R14 = REG(22);
 static const x86_operand_t __R15 = REG(23);
-#endif
 
 static const x86_operand_t __XMM0 = XMM(0);
 static const x86_operand_t __XMM1 = XMM(1);
@@ -384,10 +382,14 @@ static void asm_lea(code_blob_t *blob, x86_operand_t dst, x86_operand_t src)
       x86_opcode(&insn, 0x8d);
       if (is_imm8(src.addr.off)) {
          x86_modrm(&insn, 1, dst.reg, src.addr.reg);
+         if ((src.addr.reg & 7) == 4)
+            x86_sib(&insn, 0, 4, src.addr.reg);   // RSP or R12 base
          x86_imm8(&insn, src.addr.off);
       }
       else {
          x86_modrm(&insn, 2, dst.reg, src.addr.reg);
+         if ((src.addr.reg & 7) == 4)
+            x86_sib(&insn, 0, 4, src.addr.reg);
          x86_imm32(&insn, src.addr.off);
       }
       break;
@@ -1601,6 +1603,10 @@ static void jit_x86_xor(code_blob_t *blob, jit_ir_t *ir,
 static void jit_x86_mov(code_blob_t *blob, jit_ir_t *ir,
                         const phys_slot_t *slots)
 {
+   if (ir->arg1.kind == JIT_VALUE_REG
+       && slots[ir->arg1.reg] == slots[ir->result])
+      return;   // Coalesced by register allocator
+
    x86_operand_t src = jit_x86_get(blob, __EAX, ir->arg1, slots);
    jit_x86_put(blob, ir->result, src, slots);
 }
@@ -2238,10 +2244,19 @@ static void jit_x86_cgen(jit_t *j, jit_handle_t handle, void *context)
 
    blob->func = f;
 
-   const uint64_t allowmask = (1 << __R10.reg) | (1 << __R11.reg);
+   const uint64_t callmask = (1 << __R12.reg) | (1 << __R13.reg)
+      | (1 << __R14.reg) | (1 << __R15.reg);
+   const uint64_t allowmask = (1 << __R10.reg) | (1 << __R11.reg) | callmask;
 
    phys_slot_t *slots LOCAL = xmalloc_array(f->nregs, sizeof(phys_slot_t));
-   const int spills = jit_do_lscan(f, slots, ~allowmask);
+   const int spills = jit_do_lscan(f, slots, ~allowmask, callmask);
+
+   // Only save callee-saved registers that are actually allocated
+   uint64_t usedmask = 0;
+   for (int i = 0; i < f->nregs; i++) {
+      if (slots[i] < FLOAT_BASE)
+         usedmask |= UINT64_C(1) << slots[i];
+   }
 
    PUSH(__EBP);
    MOV(__EBP, __ESP, __QWORD);
@@ -2284,13 +2299,14 @@ static void jit_x86_cgen(jit_t *j, jit_handle_t handle, void *context)
    MOV(ADDR(__EBP, -40), __EDI, __QWORD);
    MOV(ADDR(__EBP, -48), __ESI, __QWORD);
 #endif
-#if 0
-   // Not currently used
-   MOV(ADDR(__EBP, -56), __R12, __QWORD);
-   MOV(ADDR(__EBP, -64), __R13, __QWORD);
-   MOV(ADDR(__EBP, -72), __R14, __QWORD);
-   MOV(ADDR(__EBP, -80), __R15, __QWORD);
-#endif
+   if (usedmask & (1 << __R12.reg))
+      MOV(ADDR(__EBP, -56), __R12, __QWORD);
+   if (usedmask & (1 << __R13.reg))
+      MOV(ADDR(__EBP, -64), __R13, __QWORD);
+   if (usedmask & (1 << __R14.reg))
+      MOV(ADDR(__EBP, -72), __R14, __QWORD);
+   if (usedmask & (1 << __R15.reg))
+      MOV(ADDR(__EBP, -80), __R15, __QWORD);
 
    XOR(FLAGS_REG, FLAGS_REG, __DWORD);
 
@@ -2321,12 +2337,14 @@ static void jit_x86_cgen(jit_t *j, jit_handle_t handle, void *context)
    MOV(__EDI, ADDR(__EBP, -40), __QWORD);
    MOV(__ESI, ADDR(__EBP, -48), __QWORD);
 #endif
-#if 0
-   MOV(__R12, ADDR(__EBP, -56), __QWORD);
-   MOV(__R13, ADDR(__EBP, -64), __QWORD);
-   MOV(__R14, ADDR(__EBP, -72), __QWORD);
-   MOV(__R15, ADDR(__EBP, -80), __QWORD);
-#endif
+   if (usedmask & (1 << __R12.reg))
+      MOV(__R12, ADDR(__EBP, -56), __QWORD);
+   if (usedmask & (1 << __R13.reg))
+      MOV(__R13, ADDR(__EBP, -64), __QWORD);
+   if (usedmask & (1 << __R14.reg))
+      MOV(__R14, ADDR(__EBP, -72), __QWORD);
+   if (usedmask & (1 << __R15.reg))
+      MOV(__R15, ADDR(__EBP, -80), __QWORD);
 
    LEAVE();
    RET();
@@ -34,6 +34,7 @@ typedef union {
 typedef struct {
    void *(*init)(jit_t *);
    void (*cgen)(jit_t *, jit_handle_t, void *);
+   void (*cgen_batch)(jit_t *, const jit_handle_t *, int, void *);
    void (*cleanup)(void *);
 } jit_plugin_t;
 
@@ -71,7 +72,8 @@ void jit_register_native_plugin(jit_t *j);
 void jit_interrupt(jit_t *j, jit_irq_fn_t fn, void *ctx);
 void jit_check_interrupt(jit_t *j);
 void jit_reset(jit_t *j);
-int32_t *jit_get_cover_mem(jit_t *j, int mintags);
+void jit_set_cover_bits(jit_t *j, unsigned bits);
+void *jit_get_cover_mem(jit_t *j, int mintags);
 
 void *jit_mspace_alloc(size_t size) RETURNS_NONNULL;
 jit_stack_trace_t *jit_stack_trace(void);
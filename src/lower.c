@@ -1039,6 +1039,35 @@ static vcode_reg_t lower_scalar_type_left(lower_unit_t *lu, type_t type)
    return left_reg;
 }
 
+static bool lower_is_two_state(type_t type)
+{
+   // Scalar logic types mapped to '0' and '1' in two-state mode: the
+   // position of '0' is the same in both
+   if (!opt_get_int(OPT_TWO_STATE))
+      return false;
+
+   switch (is_well_known(type_ident(type_base_recur(type)))) {
+   case W_IEEE_ULOGIC:
+   case W_NVC_VERILOG_LOGIC:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static vcode_reg_t lower_scalar_default(lower_unit_t *lu, type_t type)
+{
+   // Logic types start at '0' rather than a metavalue in two-state
+   // mode as long as that is within the range of the subtype
+   int64_t low, high;
+   if (lower_is_two_state(type)
+       && folded_bounds(range_of(type, 0), &low, &high)
+       && low <= 2 && high >= 2)
+      return emit_const(lower_type(type), 2);
+
+   return lower_scalar_type_left(lu, type);
+}
+
 static void lower_check_scalar_bounds(lower_unit_t *lu, vcode_reg_t value,
                                       type_t type, tree_t where, tree_t hint)
 {
@@ -5162,7 +5191,7 @@ static vcode_reg_t lower_expr(lower_unit_t *lu, tree_t expr, expr_ctx_t ctx)
 static vcode_reg_t lower_nested_default_value(lower_unit_t *lu, type_t type)
 {
    if (type_is_scalar(type))
-      return lower_scalar_type_left(lu, type);
+      return lower_scalar_default(lu, type);
    else if (type_is_array(type)) {
       assert(type_const_bounds(type));
       type_t elem = type_elem_recur(type);
@@ -5202,7 +5231,7 @@ static vcode_reg_t lower_default_value(lower_unit_t *lu, type_t type,
                                        vcode_reg_t hint_reg)
 {
    if (type_is_scalar(type))
-      return lower_scalar_type_left(lu, type);
+      return lower_scalar_default(lu, type);
    else if (type_is_array(type)) {
       assert(!type_is_unconstrained(type));
 
@@ -7664,7 +7693,7 @@ static void lower_sub_signals(lower_unit_t *lu, type_t type, type_t var_type,
       vcode_reg_t locus = lower_debug_locus(where);
 
       if (init_reg == VCODE_INVALID_REG)
-         init_reg = lower_scalar_type_left(lu, type);
+         init_reg = lower_scalar_default(lu, type);
 
       lower_check_scalar_bounds(lu, init_reg, type, where, where);
 
@@ -7674,6 +7703,9 @@ static void lower_sub_signals(lower_unit_t *lu, type_t type, type_t var_type,
       if (wk == W_IEEE_ULOGIC || wk == W_IEEE_LOGIC)
          flags |= SIG_F_STD_LOGIC;
 
+      if (lower_is_two_state(type))
+         flags |= SIG_F_TWO_STATE;
+
       vcode_reg_t flags_reg = emit_const(voffset, flags);
       vcode_reg_t sig = emit_init_signal(vtype, len_reg, size_reg, init_reg,
                                          flags_reg, locus, null_reg);
@@ -7697,7 +7729,7 @@ static void lower_sub_signals(lower_unit_t *lu, type_t type, type_t var_type,
       vcode_reg_t locus = lower_debug_locus(where);
 
       if (init_reg == VCODE_INVALID_REG)
-         init_reg = lower_scalar_type_left(lu, type_elem_recur(type));
+         init_reg = lower_scalar_default(lu, type_elem_recur(type));
       else {
          lower_check_array_sizes(lu, type, init_type, bounds_reg,
                                  init_reg, locus);
@@ -7711,6 +7743,9 @@ static void lower_sub_signals(lower_unit_t *lu, type_t type, type_t var_type,
       if (wk == W_IEEE_ULOGIC_VECTOR || wk == W_IEEE_LOGIC_VECTOR)
          flags |= SIG_F_STD_LOGIC;
 
+      if (lower_is_two_state(type_elem_recur(type)))
+         flags |= SIG_F_TWO_STATE;
+
       vcode_reg_t flags_reg = emit_const(voffset, flags);
       vcode_reg_t sig = emit_init_signal(vtype, len_reg, size_reg, init_reg,
                                          flags_reg, locus, null_reg);
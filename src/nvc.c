@@ -28,10 +28,13 @@
 #include "rt/assert.h"
 #include "rt/model.h"
 #include "rt/mspace.h"
+#include "rt/profile.h"
 #include "rt/rt.h"
 #include "rt/shell.h"
 #include "rt/wave.h"
 #include "scan.h"
+#include "sdf/sdf-phase.h"
+#include "sdf/sdf-util.h"
 #include "server.h"
 #include "thread.h"
 #include "vhpi/vhpi-util.h"
@@ -315,7 +318,9 @@ static void parse_cover_options(const char *str, cover_mask_t *mask,
       { "count-from-to-z",       COVER_MASK_TOGGLE_COUNT_FROM_TO_Z      },
       { "include-mems",          COVER_MASK_TOGGLE_INCLUDE_MEMS         },
       { "exclude-unreachable",   COVER_MASK_EXCLUDE_UNREACHABLE         },
-      { "fsm-no-default-enums",  COVER_MASK_FSM_NO_DEFAULT_ENUMS        }
+      { "fsm-no-default-enums",  COVER_MASK_FSM_NO_DEFAULT_ENUMS        },
+      { "byte-counters",         COVER_MASK_BYTE_COUNTERS               },
+      { "bit-counters",          COVER_MASK_BIT_COUNTERS                }
    };
 
    for (const char *start = str; ; str++) {
@@ -373,6 +378,7 @@ static int elaborate(int argc, char **argv, cmd_state_t *state)
       { "no-save",         no_argument,       0, 'N' },
       { "jit",             no_argument,       0, 'j' },
       { "no-collapse",     no_argument,       0, 'C' },
+      { "two-state",       no_argument,       0, 'T' },
       { 0, 0, 0, 0 }
    };
 
@@ -410,6 +416,9 @@ static int elaborate(int argc, char **argv, cmd_state_t *state)
       case 'C':
          opt_set_int(OPT_NO_COLLAPSE, 1);
          break;
+      case 'T':
+         opt_set_int(OPT_TWO_STATE, 1);
+         break;
       case 'j':
          use_jit = true;
          break;
@@ -455,9 +464,27 @@ static int elaborate(int argc, char **argv, cmd_state_t *state)
          cover_load_spec_file(cover, cover_spec_file);
    }
 
+   sdf_file_t *sdf = NULL;
    if (sdf_args != NULL) {
-      // TODO: Pass min-max spec to underlying sdf_parse somehow
-      analyse_file(sdf_args, NULL, NULL);
+      sdf_flags_t min_max_spec = S_F_TYP_VALUES;
+      if (strncmp(sdf_args, "min:", 4) == 0) {
+         min_max_spec = S_F_MIN_VALUES;
+         sdf_args += 4;
+      }
+      else if (strncmp(sdf_args, "typ:", 4) == 0)
+         sdf_args += 4;
+      else if (strncmp(sdf_args, "max:", 4) == 0) {
+         min_max_spec = S_F_MAX_VALUES;
+         sdf_args += 4;
+      }
+
+      input_from_file(sdf_args);
+
+      sdf = sdf_parse(sdf_args, min_max_spec);
+      if (error_count() > 0)
+         return EXIT_FAILURE;
+
+      progress("loading SDF file %s", sdf_args);
    }
 
    if (state->registry != NULL) {
@@ -478,7 +505,14 @@ static int elaborate(int argc, char **argv, cmd_state_t *state)
 
    jit_enable_runtime(state->jit, false);
 
-   tree_t top = elab(obj, state->jit, state->registry, cover, NULL);
+   if (cover != NULL)
+      jit_set_cover_bits(state->jit, cover_counter_bits(cover));
+
+   tree_t top = elab(obj, state->jit, state->registry, cover, sdf);
+
+   if (sdf != NULL)
+      sdf_file_free(sdf);
+
    if (top == NULL)
       return EXIT_FAILURE;
 
@@ -599,6 +633,49 @@ static void parse_exit_severity(const char *str)
    set_status_severity(s);
 }
 
+static int parse_stats_options(const char *str)
+{
+   static const struct {
+      const char *name;
+      int         mask;
+   } options[] = {
+      { "summary",  STATS_SUMMARY  },
+      { "activity", STATS_ACTIVITY },
+      { "delta",    STATS_DELTA    },
+   };
+
+   int mask = STATS_SUMMARY;
+   for (const char *start = str; ; str++) {
+      if (*str == ',' || *str == '\0') {
+         int pos = 0;
+         for (; pos < ARRAY_LEN(options); pos++) {
+            if (strlen(options[pos].name) == str - start
+                && !strncmp(options[pos].name, start, str - start))
+               break;
+         }
+
+         if (pos == ARRAY_LEN(options)) {
+            diag_t *d = diag_new(DIAG_FATAL, NULL);
+            diag_printf(d, "unknown statistics type '%.*s'",
+                        (int)(str - start), start);
+            diag_hint(d, NULL, "valid statistics types are: summary, "
+                      "activity, and delta");
+            diag_emit(d);
+            fatal_exit(EXIT_FAILURE);
+         }
+
+         mask |= options[pos].mask;
+
+         if (*str == '\0')
+            break;
+
+         start = str + 1;
+      }
+   }
+
+   return mask;
+}
+
 static int parse_stop_delta(const char *str)
 {
    const int ival = parse_int(str);
@@ -661,9 +738,9 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
 {
    static struct option long_options[] = {
       { "trace",         no_argument,       0, 't' },
-      { "profile",       no_argument,       0, 'p' },   // DEPRECATED 1.14
+      { "profile",       optional_argument, 0, 'p' },
       { "stop-time",     required_argument, 0, 's' },
-      { "stats",         no_argument,       0, 'S' },
+      { "stats",         optional_argument, 0, 'S' },
       { "wave",          optional_argument, 0, 'w' },
       { "stop-delta",    required_argument, 0, 'd' },
       { "format",        required_argument, 0, 'f' },
@@ -685,6 +762,7 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
    const char   *wave_fname = NULL;
    const char   *gtkw_fname = NULL;
    const char   *vhpi_plugins = NULL;
+   const char   *profile_fname = NULL;
 
    static bool have_run = false;
    if (have_run)
@@ -709,7 +787,10 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
          opt_set_int(OPT_RT_TRACE, 1);
          break;
       case 'p':
-         warnf("the $bold$--profile$$ option is deprecated and has no effect");
+         if (optarg == NULL)
+            profile_fname = "";
+         else
+            profile_fname = optarg;
          break;
       case 'T':
          opt_set_str(OPT_VHPI_TRACE, "1");
@@ -730,7 +811,10 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
             fatal("invalid waveform format: %s", optarg);
          break;
       case 'S':
-         opt_set_int(OPT_RT_STATS, 1);
+         if (optarg == NULL)
+            opt_set_int(OPT_RT_STATS, STATS_SUMMARY);
+         else
+            opt_set_int(OPT_RT_STATS, parse_stats_options(optarg));
          break;
       case 'w':
          if (optarg == NULL)
@@ -819,6 +903,10 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
    else if (gtkw_fname != NULL)
       warnf("$bold$--gtkw$$ option has no effect without $bold$--wave$$");
 
+   char *profile_tmp LOCAL = NULL;
+   if (profile_fname != NULL && *profile_fname == '\0')
+      profile_fname = profile_tmp = xasprintf("%s.folded", top_level_orig);
+
    if (opt_get_size(OPT_HEAP_SIZE) < 0x100000)
       warnf("recommended heap size is at least 1M");
 
@@ -863,8 +951,14 @@ static int run_cmd(int argc, char **argv, cmd_state_t *state)
    if (dumper != NULL)
       wave_dumper_restart(dumper, model, state->jit);
 
+   if (profile_fname != NULL)
+      profile_start();
+
    model_run(model, stop_time);
 
+   if (profile_fname != NULL)
+      profile_stop(profile_fname);
+
    set_ctrl_c_handler(NULL, NULL);
 
    const int rc = model_exit_status(model);
@@ -1525,7 +1619,7 @@ static int coverage_cmd(int argc, char **argv, cmd_state_t *state)
 
    if (rpt_file && cover) {
       progress("Generating code coverage report.");
-      cover_report(rpt_file, cover, item_limit);
+      cover_report(rpt_file, cover, item_limit, false);
    }
 
    if (export_file && cover) {
@@ -1606,15 +1700,54 @@ static int gui_cmd(int argc, char **argv, cmd_state_t *state)
 }
 #endif
 
+typedef struct {
+   cover_data_t *left;
+   cover_data_t *right;
+} merge_pair_t;
+
+static void merge_pair_cb(void *context, void *arg)
+{
+   merge_pair_t *pair = arg;
+   cover_merge_data(pair->left, pair->right);
+}
+
+static void reduce_coverage(cover_data_t **dbs, int count, workq_t *wq)
+{
+   // Merge adjacent pairs in parallel until only dbs[0] remains: the
+   // order of the inputs is preserved and scope and item names are
+   // unique so the result is identical to merging each in turn
+   merge_pair_t *pairs LOCAL =
+      xmalloc_array(count / 2 + 1, sizeof(merge_pair_t));
+
+   for (int stride = 1; stride < count; stride *= 2) {
+      int npairs = 0;
+      for (int i = 0; i + stride < count; i += 2 * stride) {
+         pairs[npairs] = (merge_pair_t){ dbs[i], dbs[i + stride] };
+         workq_do(wq, merge_pair_cb, &(pairs[npairs++]));
+      }
+
+      workq_start(wq);
+      workq_drain(wq);
+   }
+}
+
 static cover_data_t *merge_coverage_files(int argc, int next_cmd, char **argv,
-                                          cover_mask_t rpt_mask)
+                                          cover_mask_t rpt_mask, int jobs)
 {
    // Merge all input coverage databases given on command line
 
    if (optind == next_cmd)
       fatal("no input coverage database specified");
 
-   cover_data_t *cover = NULL;
+   // Files must be read in order on this thread as the location file
+   // table is written to the output database.  By default each file
+   // is merged as it is read to minimise memory usage but with more
+   // than one job batches of databases are merged in parallel.
+   cover_data_t **batch LOCAL = xmalloc_array(MAX(jobs, 1),
+                                              sizeof(cover_data_t *));
+   int nbatch = 0;
+
+   workq_t *wq = workq_new(NULL);
 
    for (int i = optind; i < next_cmd; i++) {
       fbuf_t *f = fbuf_open(argv[i], FBUF_IN, FBUF_CS_NONE);
@@ -1624,14 +1757,25 @@ static cover_data_t *merge_coverage_files(int argc, int next_cmd, char **argv,
       progress("loading input coverage database %s", argv[i]);
 
       if (i == optind)
-         cover = cover_read_items(f, rpt_mask);
+         batch[nbatch++] = cover_read_items(f, rpt_mask);
+      else if (jobs <= 1)
+         cover_merge_items(f, batch[0]);
       else
-         cover_merge_items(f, cover);
+         batch[nbatch++] = cover_read_items(f, 0);
 
       fbuf_close(f, NULL);
+
+      if (nbatch == jobs) {
+         reduce_coverage(batch, nbatch, wq);
+         nbatch = 1;
+      }
    }
 
-   return cover;
+   reduce_coverage(batch, nbatch, wq);
+
+   workq_free(wq);
+
+   return batch[0];
 }
 
 static int cover_export_cmd(int argc, char **argv, cmd_state_t *state)
@@ -1696,7 +1840,7 @@ static int cover_export_cmd(int argc, char **argv, cmd_state_t *state)
 
    cover_data_t *cover;
    if (looks_like_file)
-      cover = merge_coverage_files(argc, next_cmd, argv, 0);
+      cover = merge_coverage_files(argc, next_cmd, argv, 0, 1);
    else {
       set_top_level(argv, next_cmd);
 
@@ -1746,6 +1890,7 @@ static int cover_report_cmd(int argc, char **argv, cmd_state_t *state)
       { "dont-print",   required_argument, 0, 'd' },
       { "item-limit",   required_argument, 0, 'l' },
       { "verbose",      no_argument,       0, 'V' },
+      { "incremental",  no_argument,       0, 'i' },
       { 0, 0, 0, 0 }
    };
 
@@ -1756,6 +1901,7 @@ static int cover_report_cmd(int argc, char **argv, cmd_state_t *state)
    const char *spec = ":Vo:";
    cover_mask_t rpt_mask = 0;
    int item_limit = 5000;
+   bool incremental = false;
 
    while ((c = getopt_long(next_cmd, argv, spec, long_options, &index)) != -1) {
       switch (c) {
@@ -1778,6 +1924,9 @@ static int cover_report_cmd(int argc, char **argv, cmd_state_t *state)
       case 'V':
          opt_set_int(OPT_VERBOSE, 1);
          break;
+      case 'i':
+         incremental = true;
+         break;
       case '?':
          bad_option("coverage report", argv);
       case ':':
@@ -1792,7 +1941,8 @@ static int cover_report_cmd(int argc, char **argv, cmd_state_t *state)
 
    progress("initialising");
 
-   cover_data_t *cover = merge_coverage_files(argc, next_cmd, argv, rpt_mask);
+   cover_data_t *cover =
+      merge_coverage_files(argc, next_cmd, argv, rpt_mask, 1);
 
    if (exclude_file && cover) {
       progress("loading exclude file %s", exclude_file);
@@ -1800,7 +1950,7 @@ static int cover_report_cmd(int argc, char **argv, cmd_state_t *state)
    }
 
    progress("generating code coverage report");
-   cover_report(outdir, cover, item_limit);
+   cover_report(outdir, cover, item_limit, incremental);
 
    argc -= next_cmd - 1;
    argv += next_cmd - 1;
@@ -1813,14 +1963,15 @@ static int cover_merge_cmd(int argc, char **argv, cmd_state_t *state)
    static struct option long_options[] = {
       { "output",       required_argument, 0, 'o' },
       { "verbose",      no_argument,       0, 'V' },
+      { "jobs",         required_argument, 0, 'j' },
       { 0, 0, 0, 0 }
    };
 
    const int next_cmd = scan_cmd(2, argc, argv);
 
    const char *out_db = NULL;
-   int c, index;
-   const char *spec = ":Vo:";
+   int c, index, jobs = 1;
+   const char *spec = ":Vo:j:";
 
    while ((c = getopt_long(next_cmd, argv, spec, long_options, &index)) != -1) {
       switch (c) {
@@ -1830,6 +1981,9 @@ static int cover_merge_cmd(int argc, char **argv, cmd_state_t *state)
       case 'V':
          opt_set_int(OPT_VERBOSE, 1);
          break;
+      case 'j':
+         jobs = parse_int(optarg);
+         break;
       case '?':
          bad_option("coverage merge", argv);
       case ':':
@@ -1844,7 +1998,7 @@ static int cover_merge_cmd(int argc, char **argv, cmd_state_t *state)
 
    progress("initialising");
 
-   cover_data_t *cover = merge_coverage_files(argc, next_cmd, argv, 0);
+   cover_data_t *cover = merge_coverage_files(argc, next_cmd, argv, 0, jobs);
 
    progress("saving merged coverage database to %s", out_db);
 
@@ -1955,6 +2109,8 @@ static void usage(void)
           "     --no-collapse\tDo not collapse multiple signals into one\n"
           "     --no-save\t\tDo not save the elaborated design to disk\n"
           " -O0, -O1, -O2, -O3\tSet optimisation level (default is -O2)\n"
+          "     --two-state\tInitialise logic types to '0' instead of a "
+          "metavalue\n"
           " -V, --verbose\t\tPrint resource usage at each step\n"
           "\n"
           "Run options:\n"
@@ -1966,8 +2122,11 @@ static void usage(void)
           "     --ieee-warnings=\tEnable ('on') or disable ('off') warnings\n"
           "                     \tfrom IEEE packages\n"
           "     --include=GLOB\tInclude signals matching GLOB in wave dump\n"
+          "     --profile[=FILE]\tWrite folded stack samples to FILE\n"
           "     --shuffle\t\tRun processes in random order\n"
-          "     --stats\t\tPrint time and memory usage at end of run\n"
+          "     --stats[=LIST]\tPrint time and memory usage at end of run\n"
+          "                  \t"
+          "LIST may also include activity and delta\n"
           "     --stop-delta=N\tStop after N delta cycles (default %d)\n"
           "     --stop-time=T\tStop after simulation time T (e.g. 5ns)\n"
           "     --trace\t\tTrace simulation events\n"
@@ -1984,9 +2143,11 @@ static void usage(void)
           "     --dont-print=\tExcluded specified items from coverage report\n"
           "                  \t"
           "Argument is a list of: covered, uncovered, excluded\n"
+          "     --incremental\tOnly regenerate pages whose coverage changed\n"
           " -o, --output=DIR\tPlace generated HTML files in DIR\n"
           "\n"
           "Coverage merge options:\n"
+          " -j, --jobs=N\t\tMerge batches of N databases in parallel\n"
           " -o, --output=FILE\tOutput database file name\n"
           "\n"
           "Coverage export options:\n"
@@ -158,19 +158,23 @@ void set_default_options(void)
    opt_set_int(OPT_JIT_THRESHOLD, get_int_env("NVC_JIT_THRESHOLD", 100));
    opt_set_str(OPT_ASM_VERBOSE, getenv("NVC_ASM_VERBOSE"));
    opt_set_int(OPT_JIT_ASYNC, get_int_env("NVC_JIT_ASYNC", 1));
+   opt_set_int(OPT_JIT_THREADS, get_int_env("NVC_JIT_THREADS", 2));
    opt_set_int(OPT_PERF_MAP, get_int_env("NVC_PERF_MAP", 0));
    opt_set_str(OPT_LIB_VERBOSE, getenv("NVC_LIB_VERBOSE"));
    opt_set_str(OPT_PSL_VERBOSE, getenv("NVC_PSL_VERBOSE"));
    opt_set_int(OPT_PSL_COMMENTS, 0);
    opt_set_int(OPT_NO_COLLAPSE, 0);
+   opt_set_int(OPT_TWO_STATE, 0);
    opt_set_int(OPT_COVER_VERBOSE, get_int_env("NVC_COVER_VERBOSE", 0));
    opt_set_int(OPT_COVER_TIMESTAMP, get_int_env("NVC_COVER_TIMESTAMP", -1));
    opt_set_str(OPT_COVER_VERSION, getenv("NVC_COVER_VERSION"));
    opt_set_int(OPT_DRIVER_VERBOSE, get_int_env("NVC_DRIVER_VERBOSE", 0));
    opt_set_int(OPT_JIT_INTRINSICS, get_int_env("NVC_JIT_INTRINSICS", 1));
-   opt_set_int(OPT_VECTOR_INTRINSICS, get_int_env("NVC_VECTOR_INTRINSICS", 1));
+   opt_set_int(OPT_VECTOR_INTRINSICS, get_int_env("NVC_VECTOR_INTRINSICS", 2));
    opt_set_int(OPT_SHUFFLE_PROCS, 0);
    opt_set_int(OPT_VHPI_DEBUG, 0);
    opt_set_int(OPT_SERVER_PORT, 8888);
    opt_set_int(OPT_STDERR_LEVEL, DIAG_DEBUG);
+   opt_set_int(OPT_JIT_INLINE, get_int_env("NVC_JIT_INLINE", 1));
+   opt_set_int(OPT_PACKED_VALUES, get_int_env("NVC_PACKED_VALUES", 0));
 }
@@ -53,6 +53,7 @@ typedef enum {
    OPT_JIT_THRESHOLD,
    OPT_ASM_VERBOSE,
    OPT_JIT_ASYNC,
+   OPT_JIT_THREADS,
    OPT_PERF_MAP,
    OPT_LIB_VERBOSE,
    OPT_PSL_VERBOSE,
@@ -68,6 +69,9 @@ typedef enum {
    OPT_VHPI_DEBUG,
    OPT_SERVER_PORT,
    OPT_STDERR_LEVEL,
+   OPT_JIT_INLINE,
+   OPT_PACKED_VALUES,
+   OPT_TWO_STATE,
 
    OPT_LAST_NAME
 } opt_name_t;
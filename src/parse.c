@@ -90,7 +90,7 @@ static nametab_t     *nametab = NULL;
 static bool           bootstrapping = false;
 static tree_list_t    pragmas = AINIT;
 
-extern loc_t yylloc;
+extern __thread loc_t yylloc;
 
 #define scan(...) _scan(1, __VA_ARGS__, -1)
 #define expect(...) _expect(1, __VA_ARGS__, -1)
@@ -265,7 +265,7 @@ static token_t peek_nth(int n)
          next = (tokenq_head + 1) & (tokenq_sz - 1);
       }
 
-      extern yylval_t yylval;
+      extern __thread yylval_t yylval;
 
       tokenq[tokenq_head].token = token;
       tokenq[tokenq_head].lval  = yylval;
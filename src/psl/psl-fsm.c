@@ -19,6 +19,7 @@
 #include "array.h"
 #include "common.h"
 #include "diag.h"
+#include "hash.h"
 #include "ident.h"
 #include "mask.h"
 #include "psl/psl-fsm.h"
@@ -30,6 +31,9 @@
 #include <stdlib.h>
 #include <inttypes.h>
 
+#define DFA_MAX_STATES   64
+#define DFA_MAX_OUTCOMES 256
+
 #define CANNOT_HANDLE(p) do {                                   \
       fatal_at(psl_loc(p), "cannot handle PSL kind %s in %s",   \
                psl_kind_str(psl_kind(p)),  __FUNCTION__);       \
@@ -331,6 +335,10 @@ psl_fsm_t *psl_fsm_new(psl_node_t p)
 
 void psl_fsm_free(psl_fsm_t *fsm)
 {
+   for (int i = 0; i < fsm->dfa_count; i++)
+      free(fsm->dfa[i].trans);
+
+   free(fsm->dfa);
    free(fsm);
 }
 
@@ -396,3 +404,160 @@ bool psl_fsm_repeating(psl_fsm_t *fsm)
    return fsm->kind == FSM_COVER || fsm->kind == FSM_ALWAYS
       || fsm->kind == FSM_NEVER;
 }
+
+typedef A(uint64_t) outcome_list_t;
+
+static void add_outcome(outcome_list_t *list, uint64_t mask)
+{
+   for (int i = 0; i < list->count; i++) {
+      if (list->items[i] == mask)
+         return;
+   }
+
+   APUSH(*list, mask);
+}
+
+static bool nfa_outcomes(fsm_state_t *state, bool repeating, int depth,
+                         outcome_list_t *out)
+{
+   // Collect every set of states that may be entered on the next cycle
+   // when the property is in this state, treating each guard as
+   // independent of the others
+   if (depth > DFA_MAX_STATES)
+      return false;
+
+   const uint64_t self =
+      (state->initial && repeating) ? UINT64_C(1) << state->id : 0;
+
+   bool have_default = false;
+   for (fsm_edge_t *e = state->edges; e; e = e->next) {
+      have_default |= e->guard == NULL;
+
+      if (e->kind == EDGE_EPSILON) {
+         outcome_list_t sub = AINIT;
+         const bool ok = nfa_outcomes(e->dest, repeating, depth + 1, &sub);
+
+         for (int i = 0; i < sub.count; i++)
+            add_outcome(out, self | sub.items[i]);
+
+         ACLEAR(sub);
+
+         if (!ok)
+            return false;
+      }
+      else
+         add_outcome(out, self | (UINT64_C(1) << e->dest->id));
+   }
+
+   if (!have_default)
+      add_outcome(out, self);   // No guard matched
+
+   return out->count <= DFA_MAX_OUTCOMES;
+}
+
+static int dfa_add_state(psl_fsm_t *fsm, ihash_t *map, uint64_t mask,
+                         fsm_state_t **nfa)
+{
+   void *id = ihash_get(map, mask);
+   if (id != NULL)
+      return (uintptr_t)id - 1;
+   else if (fsm->dfa_count == DFA_MAX_STATES)
+      return -1;
+
+   dfa_state_t *d = &(fsm->dfa[fsm->dfa_count]);
+   d->mask = mask;
+
+   for (int i = 0; i < fsm->next_id; i++) {
+      if (mask & (UINT64_C(1) << i))
+         d->strong |= nfa[i]->strong;
+   }
+
+   ihash_put(map, mask, (void *)(uintptr_t)(++fsm->dfa_count));
+   return fsm->dfa_count - 1;
+}
+
+bool psl_fsm_determinise(psl_fsm_t *fsm)
+{
+   // Subset construction where each DFA state corresponds to a set of
+   // active NFA states: gives up and leaves the NFA unchanged if the
+   // number of states grows too large
+   assert(fsm->dfa == NULL);
+
+   if (fsm->next_id >= 64)
+      return false;
+
+   const bool repeating = psl_fsm_repeating(fsm);
+
+   fsm_state_t **nfa LOCAL = xcalloc_array(fsm->next_id, sizeof(fsm_state_t *));
+   outcome_list_t *outcomes LOCAL =
+      xcalloc_array(fsm->next_id, sizeof(outcome_list_t));
+
+   bool ok = true;
+   for (fsm_state_t *s = fsm->states; s; s = s->next) {
+      nfa[s->id] = s;
+      ok = ok && nfa_outcomes(s, repeating, 0, &(outcomes[s->id]));
+   }
+
+   fsm->dfa = xcalloc_array(DFA_MAX_STATES, sizeof(dfa_state_t));
+   fsm->dfa_count = 0;
+
+   ihash_t *map = ihash_new(DFA_MAX_STATES * 2);
+
+   // The runtime always starts in state zero
+   assert(nfa[0] != NULL && nfa[0]->initial);
+   dfa_add_state(fsm, map, 1, nfa);
+
+   for (int i = 0; ok && i < fsm->dfa_count; i++) {
+      const uint64_t mask = fsm->dfa[i].mask;
+
+      outcome_list_t next = AINIT;
+      add_outcome(&next, 0);
+
+      for (int j = 0; ok && j < fsm->next_id; j++) {
+         if (!(mask & (UINT64_C(1) << j)))
+            continue;
+
+         outcome_list_t product = AINIT;
+         for (int k = 0; k < next.count; k++) {
+            for (int l = 0; l < outcomes[j].count; l++)
+               add_outcome(&product, next.items[k] | outcomes[j].items[l]);
+         }
+
+         ACLEAR(next);
+         next = product;
+
+         ok = next.count <= DFA_MAX_OUTCOMES;
+      }
+
+      dfa_trans_t *trans = xmalloc_array(next.count, sizeof(dfa_trans_t));
+      for (int j = 0; ok && j < next.count; j++) {
+         trans[j].mask = next.items[j];
+         if (next.items[j] == 0)
+            trans[j].dest = -1;   // No states active
+         else if ((trans[j].dest = dfa_add_state(fsm, map, next.items[j],
+                                                 nfa)) < 0)
+            ok = false;
+      }
+
+      fsm->dfa[i].trans  = trans;
+      fsm->dfa[i].ntrans = next.count;
+
+      ACLEAR(next);
+   }
+
+   for (int i = 0; i < fsm->next_id; i++)
+      ACLEAR(outcomes[i]);
+
+   ihash_free(map);
+
+   if (!ok) {
+      for (int i = 0; i < fsm->dfa_count; i++)
+         free(fsm->dfa[i].trans);
+
+      free(fsm->dfa);
+      fsm->dfa = NULL;
+      fsm->dfa_count = 0;
+   }
+
+   return ok;
+}
@@ -47,17 +47,32 @@ typedef enum {
    FSM_BARE, FSM_ALWAYS, FSM_NEVER, FSM_COVER
 } fsm_kind_t;
 
+typedef struct {
+   uint64_t  mask;
+   int       dest;
+} dfa_trans_t;
+
+typedef struct {
+   uint64_t     mask;
+   dfa_trans_t *trans;
+   unsigned     ntrans;
+   bool         strong;
+} dfa_state_t;
+
 typedef struct {
    fsm_state_t  *states;
    fsm_state_t **tail;
    psl_node_t    src;
    unsigned      next_id;
    fsm_kind_t    kind;
+   dfa_state_t  *dfa;
+   unsigned      dfa_count;
 } psl_fsm_t;
 
 psl_fsm_t *psl_fsm_new(psl_node_t p);
 void psl_fsm_free(psl_fsm_t *fsm);
 void psl_fsm_dump(psl_fsm_t *fsm, const char *fname);
 bool psl_fsm_repeating(psl_fsm_t *fsm);
+bool psl_fsm_determinise(psl_fsm_t *fsm);
 
 #endif  // _PSL_FSM_H
@@ -31,6 +31,16 @@
 #include <assert.h>
 #include <stdlib.h>
 
+typedef struct {
+   lower_unit_t  *lu;
+   psl_fsm_t     *fsm;
+   cover_data_t  *cover;
+   cover_scope_t *cscope;
+   cover_item_t  *item;
+   vcode_block_t *state_bb;
+   vcode_var_t   *next_vars;
+} psl_lower_ctx_t;
+
 static void psl_wait_cb(tree_t t, void *ctx)
 {
    lower_unit_t *lu = ctx;
@@ -68,12 +78,11 @@ static vcode_reg_t psl_assert_severity(void)
    return emit_const(vtype_int(0, 3), 2);
 }
 
-static void psl_lower_cover(lower_unit_t *lu, psl_node_t p, cover_data_t *cover,
-                            cover_scope_t *cscope)
+static void psl_lower_cover(psl_lower_ctx_t *ctx, psl_node_t p)
 {
    if (psl_has_message(p)) {
       tree_t m = psl_message(p);
-      vcode_reg_t msg_reg = lower_rvalue(lu, m);
+      vcode_reg_t msg_reg = lower_rvalue(ctx->lu, m);
 
       vcode_type_t voffset = vtype_offset();
       vcode_reg_t count_reg = emit_const(voffset, type_width(tree_type(m)));
@@ -84,19 +93,28 @@ static void psl_lower_cover(lower_unit_t *lu, psl_node_t p, cover_data_t *cover,
       emit_report(msg_reg, count_reg, severity_reg, locus);
    }
 
-   if (!cover_enabled(cover, COVER_MASK_FUNCTIONAL))
+   if (!cover_enabled(ctx->cover, COVER_MASK_FUNCTIONAL))
       return;
 
-   cover_item_t *item = cover_add_items_for(cover, cscope, psl_to_object(p),
-                                            COV_ITEM_FUNCTIONAL);
-   if (item == NULL)
+   // The accepting state may be lowered more than once when the state
+   // machine was converted to a DFA
+   if (ctx->item == NULL)
+      ctx->item = cover_add_items_for(ctx->cover, ctx->cscope,
+                                      psl_to_object(p), COV_ITEM_FUNCTIONAL);
+   if (ctx->item == NULL)
       return;
 
-   emit_cover_stmt(item->tag);
+   emit_cover_stmt(ctx->item->tag);
 }
 
-static void psl_enter_state(fsm_state_t *state)
+static void psl_enter_state(psl_lower_ctx_t *ctx, fsm_state_t *state)
 {
+   if (ctx->next_vars != NULL) {
+      // Record the NFA state which is mapped to a DFA state later
+      emit_store(emit_const(vtype_bool(), 1), ctx->next_vars[state->id]);
+      return;
+   }
+
    vcode_reg_t strong_reg = VCODE_INVALID_REG;
    if (state->strong)
       strong_reg = emit_const(vtype_bool(), 1);
@@ -105,17 +123,31 @@ static void psl_enter_state(fsm_state_t *state)
    emit_enter_state(emit_const(vint32, state->id), strong_reg);
 }
 
-static void psl_lower_state(lower_unit_t *lu, psl_fsm_t *fsm,
-                            fsm_state_t *state, vcode_block_t *state_bb,
-                            cover_data_t *cover, cover_scope_t *cscope)
+static void psl_lower_state(psl_lower_ctx_t *ctx, fsm_state_t *state);
+
+static void psl_lower_epsilon(psl_lower_ctx_t *ctx, fsm_state_t *dest,
+                              vcode_block_t pass_bb)
 {
+   if (ctx->next_vars == NULL)
+      emit_jump(ctx->state_bb[dest->id]);
+   else {
+      // Each DFA state has its own copy of the code for the NFA states
+      psl_lower_state(ctx, dest);
+      emit_jump(pass_bb);
+   }
+}
+
+static void psl_lower_state(psl_lower_ctx_t *ctx, fsm_state_t *state)
+{
+   psl_fsm_t *fsm = ctx->fsm;
+
    emit_comment("Property state %d", state->id);
 
    if (state->initial && psl_fsm_repeating(fsm))
-      psl_enter_state(state);
+      psl_enter_state(ctx, state);
 
    if (state->accept && fsm->kind == FSM_COVER)
-      psl_lower_cover(lu, fsm->src, cover, cscope);
+      psl_lower_cover(ctx, fsm->src);
    else if (state->accept && fsm->kind == FSM_NEVER) {
       vcode_reg_t severity_reg = psl_assert_severity();
       vcode_reg_t false_reg = emit_const(vtype_bool(), 0);
@@ -132,15 +164,15 @@ static void psl_lower_state(lower_unit_t *lu, psl_fsm_t *fsm,
          vcode_block_t enter_bb = emit_block();
          vcode_block_t skip_bb = emit_block();
 
-         vcode_reg_t guard_reg = psl_lower_boolean(lu, e->guard);
+         vcode_reg_t guard_reg = psl_lower_boolean(ctx->lu, e->guard);
          emit_cond(guard_reg, enter_bb, skip_bb);
 
          vcode_select_block(enter_bb);
 
          if (e->kind == EDGE_EPSILON)
-            emit_jump(state_bb[e->dest->id]);
+            psl_lower_epsilon(ctx, e->dest, pass_bb);
          else {
-            psl_enter_state(e->dest);
+            psl_enter_state(ctx, e->dest);
             emit_jump(pass_bb);
          }
 
@@ -160,11 +192,11 @@ static void psl_lower_state(lower_unit_t *lu, psl_fsm_t *fsm,
       }
       else if (e->kind == EDGE_EPSILON) {
          assert(e->next == NULL);
-         emit_jump(state_bb[e->dest->id]);
+         psl_lower_epsilon(ctx, e->dest, pass_bb);
       }
       else {
          assert(e->next == NULL);
-         psl_enter_state(e->dest);
+         psl_enter_state(ctx, e->dest);
          emit_jump(pass_bb);
       }
    }
@@ -174,7 +206,81 @@ static void psl_lower_state(lower_unit_t *lu, psl_fsm_t *fsm,
 
    vcode_select_block(pass_bb);
 
-   emit_return(VCODE_INVALID_REG);
+   // The DFA state continues with the next NFA state
+   if (ctx->next_vars == NULL)
+      emit_return(VCODE_INVALID_REG);
+}
+
+static void psl_lower_dfa_state(psl_lower_ctx_t *ctx, dfa_state_t *d,
+                                fsm_state_t **nfa)
+{
+   psl_fsm_t *fsm = ctx->fsm;
+
+   emit_comment("Property DFA state %d", (int)(d - fsm->dfa));
+
+   uint64_t entered = 0;
+   for (int i = 0; i < d->ntrans; i++)
+      entered |= d->trans[i].mask;
+
+   vcode_reg_t false_reg = emit_const(vtype_bool(), 0);
+   for (int i = 0; i < fsm->next_id; i++) {
+      if (entered & (UINT64_C(1) << i))
+         emit_store(false_reg, ctx->next_vars[i]);
+   }
+
+   // Evaluate each active NFA state in the same order as the runtime
+   // would otherwise call them
+   for (int i = 0; i < fsm->next_id; i++) {
+      if (d->mask & (UINT64_C(1) << i))
+         psl_lower_state(ctx, nfa[i]);
+   }
+
+   vcode_type_t vmask = vtype_int(0, INT64_MAX);
+   vcode_reg_t zero_reg = emit_const(vmask, 0);
+
+   vcode_reg_t mask_reg = zero_reg;
+   for (int i = 0; i < fsm->next_id; i++) {
+      if (entered & (UINT64_C(1) << i)) {
+         vcode_reg_t bit_reg = emit_const(vmask, UINT64_C(1) << i);
+         vcode_reg_t test_reg = emit_load(ctx->next_vars[i]);
+         vcode_reg_t select_reg = emit_select(test_reg, bit_reg, zero_reg);
+         mask_reg = emit_add(mask_reg, select_reg);
+      }
+   }
+
+   vcode_block_t *trans_bb LOCAL =
+      xmalloc_array(d->ntrans, sizeof(vcode_block_t));
+   vcode_reg_t *trans_masks LOCAL =
+      xmalloc_array(d->ntrans, sizeof(vcode_reg_t));
+
+   for (int i = 0; i < d->ntrans; i++) {
+      trans_bb[i] = emit_block();
+      trans_masks[i] = emit_const(vmask, d->trans[i].mask);
+   }
+
+   vcode_block_t unreachable_bb = emit_block();
+
+   emit_case(mask_reg, unreachable_bb, trans_masks, trans_bb, d->ntrans);
+
+   vcode_type_t vint32 = vtype_int(INT32_MIN, INT32_MAX);
+
+   for (int i = 0; i < d->ntrans; i++) {
+      vcode_select_block(trans_bb[i]);
+
+      const int dest = d->trans[i].dest;
+      if (dest >= 0) {
+         vcode_reg_t strong_reg = VCODE_INVALID_REG;
+         if (fsm->dfa[dest].strong)
+            strong_reg = emit_const(vtype_bool(), 1);
+
+         emit_enter_state(emit_const(vint32, dest), strong_reg);
+      }
+
+      emit_return(VCODE_INVALID_REG);
+   }
+
+   vcode_select_block(unreachable_bb);
+   emit_unreachable(VCODE_INVALID_REG);
 }
 
 void psl_lower_directive(unit_registry_t *ur, lower_unit_t *parent,
@@ -193,6 +299,11 @@ void psl_lower_directive(unit_registry_t *ur, lower_unit_t *parent,
       psl_fsm_dump(fsm, fname);
    }
 
+   // Each clock is a single call with one active DFA state rather than
+   // a call for every active NFA state
+   const bool use_dfa = psl_fsm_determinise(fsm);
+   const int nstates = use_dfa ? fsm->dfa_count : fsm->next_id;
+
    vcode_unit_t context = get_vcode(parent);
 
    ident_t prefix = vcode_unit_name(context);
@@ -228,37 +339,78 @@ void psl_lower_directive(unit_registry_t *ur, lower_unit_t *parent,
 
    emit_comment("Reset property");
 
-   build_wait(clk_expr, psl_wait_cb, lu);
-
+   // The trigger must be set before the wait so the runtime can group
+   // properties that share the same clock
    vcode_reg_t trigger_ptr = emit_var_upref(hops, trigger_var);
    vcode_reg_t trigger_reg = emit_load_indirect(trigger_ptr);
    emit_add_trigger(trigger_reg);
 
-   emit_return(emit_const(vint32, fsm->next_id));
+   build_wait(clk_expr, psl_wait_cb, lu);
+
+   emit_return(emit_const(vint32, nstates));
 
    vcode_select_block(case_bb);
 
    vcode_block_t *state_bb LOCAL =
-      xmalloc_array(fsm->next_id, sizeof(vcode_block_t));
+      xmalloc_array(nstates, sizeof(vcode_block_t));
    vcode_reg_t *state_ids LOCAL =
-      xmalloc_array(fsm->next_id, sizeof(vcode_reg_t));
+      xmalloc_array(nstates, sizeof(vcode_reg_t));
 
-   for (int i = 0; i < fsm->next_id; i++) {
+   for (int i = 0; i < nstates; i++) {
       state_bb[i] = emit_block();
       state_ids[i] = emit_const(vint32, i);
    }
 
-   emit_case(state_reg, abort_bb, state_ids, state_bb, fsm->next_id);
+   emit_case(state_reg, abort_bb, state_ids, state_bb, nstates);
+
+   psl_lower_ctx_t ctx = {
+      .lu       = lu,
+      .fsm      = fsm,
+      .cover    = cover,
+      .cscope   = cscope,
+      .state_bb = state_bb,
+   };
+
+   fsm_state_t **nfa LOCAL =
+      xmalloc_array(fsm->next_id, sizeof(fsm_state_t *));
 
    bool strong = false;
    int pos = 0;
    for (fsm_state_t *s = fsm->states; s; s = s->next) {
-      vcode_select_block(state_bb[pos++]);
-      psl_lower_state(lu, fsm, s, state_bb, cover, cscope);
+      if (!use_dfa) {
+         vcode_select_block(state_bb[pos]);
+         psl_lower_state(&ctx, s);
+      }
+      nfa[pos++] = s;
       strong |= s->strong;
    }
    assert(pos == fsm->next_id);
 
+   if (use_dfa) {
+      vcode_type_t vbool = vtype_bool();
+      vcode_var_t *next_vars LOCAL =
+         xmalloc_array(fsm->next_id, sizeof(vcode_var_t));
+
+      for (int i = 0; i < fsm->next_id; i++) {
+         ident_t name = ident_uniq("next_state");
+         next_vars[i] = emit_var(vbool, vbool, name, VAR_TEMP);
+      }
+
+      ctx.next_vars = next_vars;
+
+      for (int i = 0; i < fsm->dfa_count; i++) {
+         vcode_select_block(state_bb[i]);
+         psl_lower_dfa_state(&ctx, &(fsm->dfa[i]), nfa);
+      }
+
+      // The NFA lowering always creates the coverage item even if the
+      // accepting state can never be reached
+      if (fsm->kind == FSM_COVER && ctx.item == NULL
+          && cover_enabled(cover, COVER_MASK_FUNCTIONAL))
+         ctx.item = cover_add_items_for(cover, cscope, psl_to_object(p),
+                                        COV_ITEM_FUNCTIONAL);
+   }
+
    vcode_select_block(abort_bb);
 
    if (strong) {
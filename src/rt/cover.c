@@ -51,74 +51,69 @@ enum std_ulogic {
 // Runtime handling
 ///////////////////////////////////////////////////////////////////////////////
 
-static inline void increment_counter(int32_t *ptr)
-{
-   *ptr = saturate_add(*ptr, 1);
-}
-
-static inline void cover_toggle_check_0_1(uint8_t old, uint8_t new,
-                                          int32_t *toggle_01, int32_t *toggle_10)
+static inline void cover_toggle_check_0_1(rt_model_t *m, uint8_t old,
+                                          uint8_t new, int32_t toggle_01)
 {
    if (old == _0 && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 }
 
-static inline void cover_toggle_check_0_1_u(uint8_t old, uint8_t new,
-                                            int32_t *toggle_01, int32_t *toggle_10)
+static inline void cover_toggle_check_0_1_u(rt_model_t *m, uint8_t old,
+                                            uint8_t new, int32_t toggle_01)
 {
    if (old == _0 && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 
    else if (old == _U && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _U && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 }
 
-static inline void cover_toggle_check_0_1_z(uint8_t old, uint8_t new,
-                                            int32_t *toggle_01, int32_t *toggle_10)
+static inline void cover_toggle_check_0_1_z(rt_model_t *m, uint8_t old,
+                                            uint8_t new, int32_t toggle_01)
 {
    if (old == _0 && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 
    else if (old == _0 && new == _Z)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _Z && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _Z)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
    else if (old == _Z && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 }
 
-static inline void cover_toggle_check_0_1_u_z(uint8_t old, uint8_t new,
-                                              int32_t *toggle_01, int32_t *toggle_10)
+static inline void cover_toggle_check_0_1_u_z(rt_model_t *m, uint8_t old,
+                                              uint8_t new, int32_t toggle_01)
 {
 
    if (old == _0 && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 
    else if (old == _U && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _U && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 
    else if (old == _0 && new == _Z)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _Z && new == _1)
-      increment_counter(toggle_01);
+      increment_cover_counter(m, toggle_01);
    else if (old == _1 && new == _Z)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
    else if (old == _Z && new == _0)
-      increment_counter(toggle_10);
+      increment_cover_counter(m, toggle_01 + 1);
 }
 
 #ifdef COVER_DEBUG_CALLBACK
@@ -152,15 +147,11 @@ static inline void cover_toggle_check_0_1_u_z(uint8_t old, uint8_t new,
       uint32_t s_size = s->shared.size;                                       \
       rt_model_t *m = get_model();                                            \
       const int32_t tag = (uintptr_t)user;                                    \
-      int32_t *toggle_01 = get_cover_counter(m, tag);                         \
-      int32_t *toggle_10 = toggle_01 + 1;                                     \
       COVER_TGL_CB_MSG(s)                                                     \
       for (int i = 0; i < s_size; i++) {                                      \
          uint8_t new = ((uint8_t*)signal_value(s))[i];                        \
          uint8_t old = ((uint8_t*)signal_last_value(s))[i];                   \
-         check_fnc(old, new, toggle_01, toggle_10);                           \
-         toggle_01 += 2;                                                      \
-         toggle_10 += 2;                                                      \
+         check_fnc(m, old, new, tag + 2 * i);                                 \
       }                                                                       \
       COVER_TGL_SIGNAL_DETAILS(s, s_size)                                     \
    }                                                                          \
@@ -204,18 +195,13 @@ void x_cover_setup_toggle_cb(sig_shared_t *ss, int32_t tag)
    cover_mask_t op_mask = get_coverage(m)->mask;
 
    if (is_constant_input(s)) {
-      int32_t *toggle_01 = get_cover_counter(m, tag);
-      int32_t *toggle_10 = toggle_01 + 1;
-
       // Each std_logic bit encoded as single byte. There are two run-time
       // counters for each std_logic bit
       for (int i = 0; i < s->shared.size; i++) {
          // Remember constant driver in run-time data.
          // Unreachable mask not available at run-time.
-         *toggle_01 = COV_FLAG_UNREACHABLE;
-         *toggle_10 = COV_FLAG_UNREACHABLE;
-         toggle_01 += 2;
-         toggle_10 += 2;
+         set_cover_counter(m, tag + 2 * i, COV_FLAG_UNREACHABLE);
+         set_cover_counter(m, tag + 2 * i + 1, COV_FLAG_UNREACHABLE);
       }
       return;
    }
@@ -246,9 +232,7 @@ static void cover_state_cb(uint64_t now, rt_signal_t *s, rt_watch_t *w, void *us
    FOR_ALL_SIZES(size, READ_STATE);
 
    rt_model_t *m = get_model();
-   int32_t *mask = get_cover_counter(m, ((uintptr_t)user) + offset);
-
-   increment_counter(mask);
+   increment_cover_counter(m, ((uintptr_t)user) + offset);
 }
 
 void x_cover_setup_state_cb(sig_shared_t *ss, int64_t low, int32_t tag)
@@ -256,11 +240,9 @@ void x_cover_setup_state_cb(sig_shared_t *ss, int64_t low, int32_t tag)
    rt_signal_t *s = container_of(ss, rt_signal_t, shared);
    rt_model_t *m = get_model();
 
-   int32_t *mask = get_cover_counter(m, tag);
-
    // TYPE'left is a default value of enum type that does not
    // cause an event. First tag needs to be flagged as covered manually.
-   *mask = 1;
+   set_cover_counter(m, tag, 1);
 
    model_set_event_cb(m, s, cover_state_cb, (void *)(uintptr_t)(tag - low), false);
 }
@@ -22,6 +22,7 @@
 #include "rt/rt.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
@@ -346,6 +347,195 @@ int64_t x_file_read(void **_fp, void *data, int64_t size, int64_t count)
    return actual;
 }
 
+#define READ_MEM_X 16
+#define READ_MEM_Z 17
+
+static int read_mem_digit(char ch, int radix)
+{
+   switch (ch) {
+   case '0' ... '9':
+      return ch - '0' < radix ? ch - '0' : -1;
+   case 'a' ... 'f':
+      return radix == 16 ? ch - 'a' + 10 : -1;
+   case 'A' ... 'F':
+      return radix == 16 ? ch - 'A' + 10 : -1;
+   case 'x':
+   case 'X':
+      return READ_MEM_X;
+   case 'z':
+   case 'Z':
+   case '?':
+      return READ_MEM_Z;
+   default:
+      return -1;
+   }
+}
+
+static void read_mem_word(const char *what, const char *fname, int line,
+                          const char *tok, const char *end, int radix,
+                          uint8_t *word, int64_t width, const uint8_t *enc)
+{
+   const int bits = radix == 16 ? 4 : 1;
+
+   // Fill the word from the least significant element which is last in
+   // storage order and truncate any extra leading digits
+   int64_t pos = width - 1;
+   for (const char *p = end - 1; p >= tok; p--) {
+      if (*p == '_')
+         continue;
+
+      const int digit = read_mem_digit(*p, radix);
+      if (digit < 0)
+         jit_msg(NULL, DIAG_FATAL, "%s: invalid character '%c' in %s "
+                 "line %d", what, *p, fname, line);
+
+      for (int i = 0; i < bits && pos >= 0; i++, pos--) {
+         switch (digit) {
+         case READ_MEM_X: word[pos] = enc[READ_MEM_ENC_X]; break;
+         case READ_MEM_Z: word[pos] = enc[READ_MEM_ENC_Z]; break;
+         default: word[pos] = enc[(digit >> i) & 1]; break;
+         }
+      }
+   }
+
+   // Leading X or Z digits extend to the left like Verilog literals
+   uint8_t pad = enc[READ_MEM_ENC_0];
+   switch (read_mem_digit(*tok, radix)) {
+   case READ_MEM_X: pad = enc[READ_MEM_ENC_X]; break;
+   case READ_MEM_Z: pad = enc[READ_MEM_ENC_Z]; break;
+   }
+
+   for (; pos >= 0; pos--)
+      word[pos] = pad;
+}
+
+void read_mem_file(const char *what, const char *fname, int radix,
+                   uint8_t *mem, int64_t width, int64_t depth,
+                   int64_t start, int64_t finish, const uint8_t *enc)
+{
+   assert(radix == 2 || radix == 16);
+
+   if (start < 0 || start >= depth || finish < 0 || finish >= depth)
+      jit_msg(NULL, DIAG_FATAL, "%s: address range %"PRIi64" to %"PRIi64
+              " is outside memory bounds 0 to %"PRIi64, what, start,
+              finish, depth - 1);
+
+   const int fd = open(fname, O_RDONLY);
+   if (fd < 0)
+      jit_msg(NULL, DIAG_FATAL, "%s: cannot open %s: %s", what, fname,
+              strerror(errno));
+
+   file_info_t info;
+   if (!get_handle_info(fd, &info) || info.type != FILE_REGULAR) {
+      close(fd);
+      jit_msg(NULL, DIAG_FATAL, "%s: %s is not a regular file", what, fname);
+   }
+
+   // Parse the mapped file directly into the destination storage rather
+   // than going through the buffered file I/O used by TEXTIO
+   const char *data = NULL;
+   if (info.size > 0)
+      data = map_file(fd, info.size);
+
+   close(fd);
+
+   const int64_t low = MIN(start, finish), high = MAX(start, finish);
+   const int64_t step = start <= finish ? 1 : -1;
+
+   const char *p = data, *end = data + info.size;
+   int64_t addr = start;
+   int line = 1;
+   while (p < end) {
+      if (*p == '\n') {
+         line++;
+         p++;
+      }
+      else if (isspace_iso88591(*p))
+         p++;
+      else if (*p == '/' && p + 1 < end && p[1] == '/') {
+         while (p < end && *p != '\n')
+            p++;
+      }
+      else if (*p == '/' && p + 1 < end && p[1] == '*') {
+         for (p += 2; p < end && !(*p == '*' && p + 1 < end && p[1] == '/');
+              p++) {
+            if (*p == '\n')
+               line++;
+         }
+         p = MIN(p + 2, end);
+      }
+      else if (*p == '@') {
+         // Addresses are always hexadecimal
+         const char *tok = ++p;
+         for (addr = 0; p < end && !isspace_iso88591(*p); p++) {
+            if (*p == '_')
+               continue;
+
+            const int digit = read_mem_digit(*p, 16);
+            if (digit < 0 || digit >= READ_MEM_X)
+               jit_msg(NULL, DIAG_FATAL, "%s: invalid address in %s "
+                       "line %d", what, fname, line);
+
+            addr = addr * 16 + digit;
+         }
+
+         if (p == tok || addr < low || addr > high)
+            jit_msg(NULL, DIAG_FATAL, "%s: address in %s line %d is "
+                    "outside the range %"PRIi64" to %"PRIi64, what, fname,
+                    line, low, high);
+      }
+      else {
+         const char *tok = p;
+         while (p < end && !isspace_iso88591(*p) && *p != '/')
+            p++;
+
+         if (p == tok)
+            jit_msg(NULL, DIAG_FATAL, "%s: invalid character '%c' in %s "
+                    "line %d", what, *p, fname, line);
+
+         if (addr < low || addr > high) {
+            jit_msg(NULL, DIAG_WARN, "%s: %s contains more words than the "
+                    "range %"PRIi64" to %"PRIi64, what, fname, low, high);
+            break;
+         }
+
+         read_mem_word(what, fname, line, tok, p, radix,
+                       mem + addr * width, width, enc);
+         addr += step;
+      }
+   }
+
+   if (data != NULL)
+      unmap_file((void *)data, info.size);
+}
+
+DLLEXPORT
+void _nvc_read_mem(jit_scalar_t *args)
+{
+   const uint8_t *name_ptr = args[2].pointer;
+   const int64_t name_len = ffi_array_length(args[4].integer);
+   uint8_t *mem = args[5].pointer;
+   const int64_t mem_len = ffi_array_length(args[7].integer);
+   const int64_t width = args[8].integer;
+   const int radix = args[9].integer;
+
+   // Encoding of '0', '1', 'X', and 'Z' as STD_ULOGIC
+   static const uint8_t enc[] = { 2, 3, 1, 4 };
+
+   const char *what = radix == 16 ? "READ_MEM_HEX" : "READ_MEM_BIN";
+
+   if (mem_len % width != 0)
+      jit_msg(NULL, DIAG_FATAL, "%s: memory length %"PRIi64" is not a "
+              "multiple of the word width %"PRIi64, what, mem_len, width);
+
+   const int64_t depth = mem_len / width;
+   if (depth == 0)
+      return;
+
+   char *fname LOCAL = null_terminate(name_ptr, name_len);
+   read_mem_file(what, fname, radix, mem, width, depth, 0, depth - 1, enc);
+}
+
 void _file_io_init(void)
 {
    // Dummy function to force linking
@@ -57,9 +57,13 @@ typedef enum {
    EVENT_PROCESS,
 } event_kind_t;
 
-#define MEMBLOCK_LINE_SZ 64
-#define MEMBLOCK_PAGE_SZ 0x800000
-#define TRIGGER_TAB_SIZE 64
+#define MEMBLOCK_LINE_SZ   64
+#define MEMBLOCK_PAGE_SZ   0x800000
+#define TRIGGER_TAB_SIZE   64
+#define DELTA_HIST_BUCKETS 16
+#define MAX_DELTA_STORMS   8
+#define STORM_MAX_PROCS    4
+#define STORM_MIN_DELTAS   16
 
 typedef struct _memblock {
    memblock_t *chain;
@@ -82,6 +86,29 @@ typedef struct {
    void       *arg;
 } defer_task_t;
 
+typedef struct {
+   uint64_t   when;
+   unsigned   deltas;
+   unsigned   nprocs;
+   rt_proc_t *procs[STORM_MAX_PROCS];
+} delta_storm_t;
+
+typedef struct {
+   uint64_t      steps[DELTA_HIST_BUCKETS];    // Time steps by delta cycles
+   uint64_t      cycles[DELTA_HIST_BUCKETS];   // Cycles by processes run
+   unsigned      nstorms;
+   delta_storm_t storms[MAX_DELTA_STORMS];     // Sorted worst first
+   delta_storm_t current;
+} delta_stats_t;
+
+typedef struct {
+   uint64_t *runs;           // Indexed by process ID
+   uint64_t *transactions;   // Indexed by signal ID
+   uint64_t *events;         // Indexed by signal ID
+   unsigned  n_procs;
+   unsigned  n_signals;
+} rt_activity_t;
+
 typedef struct {
    defer_task_t *tasks;
    unsigned      count;
@@ -103,9 +130,13 @@ typedef struct _rt_model {
    bool               next_is_delta;
    bool               force_stop;
    unsigned           n_signals;
+   unsigned           n_procs;
+   rt_activity_t     *activity;
+   delta_stats_t      deltas;
    heap_t            *eventq_heap;
    ihash_t           *res_memo;
    rt_watch_t        *watches;
+   hash_t            *prop_groups;
    deferq_t           procq;
    deferq_t           delta_procq;
    deferq_t           driverq;
@@ -116,6 +147,8 @@ typedef struct _rt_model {
    heap_t            *effective_heap;
    rt_callback_t     *global_cbs[RT_LAST_EVENT];
    cover_data_t      *cover;
+   unsigned           cover_bits;
+   ihash_t           *cover_flags;
    nvc_rusage_t       ready_rusage;
    nvc_lock_t         memlock;
    memblock_t        *memblocks;
@@ -123,6 +156,7 @@ typedef struct _rt_model {
    ptr_list_t         eventsigs;
    bool               shuffle;
    bool               liveness;
+   bool               packed_values;
    rt_trigger_t      *triggertab[TRIGGER_TAB_SIZE];
 } rt_model_t;
 
@@ -132,6 +166,7 @@ typedef struct _rt_model {
 #define WAVEFORM_CHUNK  256
 #define PENDING_MIN     4
 #define MAX_RANK        UINT8_MAX
+#define ACTIVITY_TOP_N  10
 
 #define TRACE(...) do {                                 \
       if (unlikely(__trace_on))                         \
@@ -156,6 +191,7 @@ static rt_nexus_t *clone_nexus(rt_model_t *m, rt_nexus_t *old, int offset);
 static void update_implicit_signal(rt_model_t *m, rt_implicit_t *imp);
 static void async_run_process(rt_model_t *m, void *arg);
 static void async_update_property(rt_model_t *m, void *arg);
+static void async_update_prop_group(rt_model_t *m, void *arg);
 static void async_update_driver(rt_model_t *m, void *arg);
 static void async_fast_driver(rt_model_t *m, void *arg);
 static void async_fast_all_drivers(rt_model_t *m, void *arg);
@@ -341,7 +377,8 @@ static model_thread_t *model_thread(rt_model_t *m)
 
    return m->threads[my_id];
 #else
-   assert(thread_id() == 0);
+   // Only one thread may run the model at a time but it need not be the
+   // main thread: the shell can run the simulation in the background
    return m->threads[0];
 #endif
 }
@@ -483,6 +520,7 @@ static void scope_for_block(rt_model_t *m, tree_t block, rt_scope_t *parent)
             p->where     = t;
             p->name      = ident_prefix(path, ident_downcase(name), ':');
             p->handle    = jit_lazy_compile(m->jit, sym);
+            p->id        = m->n_procs++;
             p->scope     = s;
             p->privdata  = mptr_new(m->mspace, "process privdata");
 
@@ -504,6 +542,7 @@ static void scope_for_block(rt_model_t *m, tree_t block, rt_scope_t *parent)
             p->where     = t;
             p->name      = ident_prefix(path, ident_downcase(name), ':');
             p->handle    = jit_lazy_compile(m->jit, sym);
+            p->id        = m->n_procs++;
             p->scope     = s;
             p->privdata  = mptr_new(m->mspace, "process privdata");
 
@@ -566,6 +605,7 @@ rt_model_t *model_new(tree_t top, jit_t *jit)
    m->effective_heap = heap_new(64);
 
    m->can_create_delta = true;
+   m->packed_values    = opt_get_int(OPT_PACKED_VALUES);
 
    m->root = xcalloc(sizeof(rt_scope_t));
    m->root->kind     = SCOPE_ROOT;
@@ -699,8 +739,114 @@ static void cleanup_scope(rt_model_t *m, rt_scope_t *scope)
    free(scope);
 }
 
+typedef struct {
+   ident_t  name;
+   uint64_t count;
+} activity_row_t;
+
+typedef A(activity_row_t) activity_list_t;
+
+static void collect_activity(rt_model_t *m, rt_scope_t *s,
+                             activity_list_t *procs, activity_list_t *trans,
+                             activity_list_t *events)
+{
+   rt_activity_t *a = m->activity;
+
+   list_foreach(rt_proc_t *, p, s->procs) {
+      if (p->id < a->n_procs && a->runs[p->id] > 0) {
+         activity_row_t row = { p->name, a->runs[p->id] };
+         APUSH(*procs, row);
+      }
+   }
+
+   list_foreach(rt_signal_t *, sig, s->signals) {
+      if (sig->id >= a->n_signals)
+         continue;
+
+      ident_t name = ident_prefix(s->name, tree_ident(sig->where), '.');
+
+      if (a->transactions[sig->id] > 0) {
+         activity_row_t row = { name, a->transactions[sig->id] };
+         APUSH(*trans, row);
+      }
+
+      if (a->events[sig->id] > 0) {
+         activity_row_t row = { name, a->events[sig->id] };
+         APUSH(*events, row);
+      }
+   }
+
+   for (int i = 0; i < s->children.count; i++)
+      collect_activity(m, s->children.items[i], procs, trans, events);
+}
+
+static int activity_row_cmp(const void *a, const void *b)
+{
+   const activity_row_t *ra = a, *rb = b;
+   if (ra->count > rb->count)
+      return -1;
+   else if (ra->count < rb->count)
+      return 1;
+   else
+      return ident_compare(ra->name, rb->name);
+}
+
+static void print_activity_table(const char *title, activity_list_t *list)
+{
+   if (list->count == 0)
+      return;
+
+   qsort(list->items, list->count, sizeof(activity_row_t), activity_row_cmp);
+
+   uint64_t total = 0;
+   for (int i = 0; i < list->count; i++)
+      total += list->items[i].count;
+
+   printf("\n%-58s %12s %6s\n", title, "Count", "%");
+
+   const int nrows = MIN(list->count, ACTIVITY_TOP_N);
+   for (int i = 0; i < nrows; i++) {
+      const activity_row_t *row = &(list->items[i]);
+      printf("%-58s %12"PRIu64" %5.1f%%\n", istr(row->name), row->count,
+             100.0 * row->count / total);
+   }
+
+   if (list->count > nrows)
+      printf("... and %d more\n", list->count - nrows);
+}
+
+static void print_activity(rt_model_t *m)
+{
+   activity_list_t procs = AINIT, trans = AINIT, events = AINIT;
+   collect_activity(m, m->root, &procs, &trans, &events);
+
+   notef("top %d most active processes and signals", ACTIVITY_TOP_N);
+
+   print_activity_table("Process runs", &procs);
+   print_activity_table("Signal transactions", &trans);
+   print_activity_table("Signal events", &events);
+
+   fflush(stdout);
+
+   ACLEAR(procs);
+   ACLEAR(trans);
+   ACLEAR(events);
+}
+
 void model_free(rt_model_t *m)
 {
+   if (m->activity != NULL)
+      print_activity(m);
+
+   if (opt_get_int(OPT_RT_STATS) & STATS_DELTA) {
+      LOCAL_TEXT_BUF tb = tb_new();
+      model_delta_report(m, tb);
+
+      notef("delta cycle statistics");
+      fputs(tb_get(tb), stdout);
+      fflush(stdout);
+   }
+
    if (opt_get_int(OPT_RT_STATS)) {
       nvc_rusage_t ru;
       nvc_rusage(&ru);
@@ -739,6 +885,18 @@ void model_free(rt_model_t *m)
       free(it);
    }
 
+   if (m->prop_groups != NULL) {
+      const void *key;
+      void *value;
+      for (hash_iter_t it = HASH_BEGIN;
+           hash_iter(m->prop_groups, &it, &key, &value); ) {
+         rt_prop_group_t *g = value;
+         ACLEAR(g->members);
+         free(g);
+      }
+      hash_free(m->prop_groups);
+   }
+
    for (int i = 0; i < RT_LAST_EVENT; i++) {
       for (rt_callback_t *it = m->global_cbs[i], *tmp; it; it = tmp) {
          tmp = it->next;
@@ -752,12 +910,23 @@ void model_free(rt_model_t *m)
       free(mb);
    }
 
+   if (m->activity != NULL) {
+      free(m->activity->runs);
+      free(m->activity->transactions);
+      free(m->activity->events);
+      free(m->activity);
+   }
+
    heap_free(m->effective_heap);
    heap_free(m->driving_heap);
    heap_free(m->eventq_heap);
    hash_free(m->scopes);
    ihash_free(m->res_memo);
    list_free(&m->eventsigs);
+
+   if (m->cover_flags != NULL)
+      ihash_free(m->cover_flags);
+
    free(m);
 }
 
@@ -950,6 +1119,39 @@ static void reset_process(rt_model_t *m, rt_proc_t *proc)
    deltaq_insert_proc(m, 0, proc);
 }
 
+static rt_wakeable_t *property_group(rt_model_t *m, rt_prop_t *prop)
+{
+   if (prop->group != NULL)
+      return &(prop->group->wakeable);
+   else if (prop->wakeable.trigger == NULL)
+      return &(prop->wakeable);
+
+   // Properties with the same clock share a trigger and are sensitive
+   // to the same signals so one wakeup can evaluate all of them
+   if (m->prop_groups == NULL)
+      m->prop_groups = hash_new(64);
+
+   rt_prop_group_t *g = hash_get(m->prop_groups, prop->wakeable.trigger);
+   if (g == NULL) {
+      g = xcalloc(sizeof(rt_prop_group_t));
+      g->wakeable.kind      = W_PROP_GROUP;
+      g->wakeable.pending   = false;
+      g->wakeable.postponed = true;
+      g->wakeable.delayed   = false;
+      g->wakeable.trigger   = prop->wakeable.trigger;
+
+      hash_put(m->prop_groups, g->wakeable.trigger, g);
+   }
+
+   TRACE("property %s joins group for trigger %p", istr(prop->name),
+         g->wakeable.trigger);
+
+   APUSH(g->members, prop);
+   prop->group = g;
+
+   return &(g->wakeable);
+}
+
 static void reset_property(rt_model_t *m, rt_prop_t *prop)
 {
    TRACE("reset property %s", istr(prop->name));
@@ -982,8 +1184,44 @@ static void reset_property(rt_model_t *m, rt_prop_t *prop)
    thread->active_scope = NULL;
 
    // Run the property in the first time step
-   prop->wakeable.pending = true;
-   deferq_do(&m->postponedq, async_update_property, prop);
+   rt_prop_group_t *g = prop->group;
+   if (g == NULL) {
+      prop->wakeable.pending = true;
+      deferq_do(&m->postponedq, async_update_property, prop);
+   }
+   else if (!g->wakeable.pending) {
+      g->wakeable.pending = true;
+      deferq_do(&m->postponedq, async_update_prop_group, g);
+   }
+}
+
+static void reset_activity(rt_model_t *m)
+{
+   // Process and signal IDs are dense so the counters can be stored in
+   // flat arrays rather than bloating the hot structures
+   if (m->activity == NULL)
+      m->activity = xcalloc(sizeof(rt_activity_t));
+   else {
+      free(m->activity->runs);
+      free(m->activity->transactions);
+      free(m->activity->events);
+   }
+
+   rt_activity_t *a = m->activity;
+   a->n_procs      = m->n_procs;
+   a->n_signals    = m->n_signals;
+   a->runs         = xcalloc_array(MAX(a->n_procs, 1), sizeof(uint64_t));
+   a->transactions = xcalloc_array(MAX(a->n_signals, 1), sizeof(uint64_t));
+   a->events       = xcalloc_array(MAX(a->n_signals, 1), sizeof(uint64_t));
+}
+
+static inline void count_transaction(rt_model_t *m, rt_nexus_t *n)
+{
+   if (unlikely(m->activity != NULL)) {
+      const uint32_t id = n->signal->id;
+      if (id < m->activity->n_signals)
+         m->activity->transactions[id]++;
+   }
 }
 
 static void run_process(rt_model_t *m, rt_proc_t *proc)
@@ -991,6 +1229,9 @@ static void run_process(rt_model_t *m, rt_proc_t *proc)
    TRACE("run %sprocess %s", *mptr_get(proc->privdata) ? "" :  "stateless ",
          istr(proc->name));
 
+   if (unlikely(m->activity != NULL) && proc->id < m->activity->n_procs)
+      m->activity->runs[proc->id]++;
+
    model_thread_t *thread = model_thread(m);
    assert(thread->tlab != NULL);
 
@@ -1154,11 +1395,57 @@ static inline void *nexus_driving(rt_nexus_t *n)
    return n->signal->shared.data + n->offset + 2*n->signal->shared.size;
 }
 
+static inline size_t value_size(rt_nexus_t *n)
+{
+   if (n->flags & NET_F_PACKED)
+      return (n->width + 1) / 2;
+   else
+      return n->width * n->size;
+}
+
+static void pack_values(uint8_t *dst, const uint8_t *src, int count)
+{
+   // Two four-bit elements per byte with the first element in the low
+   // nibble: the shifts assume a little-endian host
+   int i = 0;
+   for (; i + 8 <= count; i += 8, dst += 4) {
+      uint64_t x;
+      memcpy(&x, src + i, sizeof(x));
+      x = (x | (x >> 4)) & UINT64_C(0x00ff00ff00ff00ff);
+      x = (x | (x >> 8)) & UINT64_C(0x0000ffff0000ffff);
+      x = (x | (x >> 16)) & UINT64_C(0x00000000ffffffff);
+
+      const uint32_t x32 = x;
+      memcpy(dst, &x32, sizeof(x32));
+   }
+
+   for (; i < count; i += 2)
+      *dst++ = src[i] | (i + 1 < count ? src[i + 1] << 4 : 0);
+}
+
+static void unpack_values(uint8_t *dst, const uint8_t *src, int count)
+{
+   int i = 0;
+   for (; i + 8 <= count; i += 8, src += 4) {
+      uint32_t x32;
+      memcpy(&x32, src, sizeof(x32));
+
+      uint64_t x = x32;
+      x = (x | (x << 16)) & UINT64_C(0x0000ffff0000ffff);
+      x = (x | (x << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+      x = (x | (x << 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+      memcpy(dst + i, &x, sizeof(x));
+   }
+
+   for (; i < count; i++)
+      dst[i] = (src[(i % 8) / 2] >> ((i & 1) * 4)) & 0xf;
+}
+
 static rt_value_t alloc_value(rt_model_t *m, rt_nexus_t *n)
 {
    rt_value_t result = {};
 
-   const size_t valuesz = n->size * n->width;
+   const size_t valuesz = value_size(n);
    if (valuesz > sizeof(rt_value_t)) {
       if (n->free_value != NULL) {
          result.ext = n->free_value;
@@ -1173,7 +1460,7 @@ static rt_value_t alloc_value(rt_model_t *m, rt_nexus_t *n)
 
 static void free_value(rt_nexus_t *n, rt_value_t v)
 {
-   const size_t valuesz = n->width * n->size;
+   const size_t valuesz = value_size(n);
    if (valuesz > sizeof(rt_value_t)) {
       *(void **)v.ext = n->free_value;
       n->free_value = v.ext;
@@ -1193,17 +1480,51 @@ static void *local_alloc(size_t size)
 
 static inline uint8_t *value_ptr(rt_nexus_t *n, rt_value_t *v)
 {
-   const size_t valuesz = n->width * n->size;
-   if (valuesz <= sizeof(rt_value_t))
-      return v->bytes;
+   const size_t valuesz = value_size(n);
+   return valuesz <= sizeof(rt_value_t) ? v->bytes : v->ext;
+}
+
+static inline uint8_t packed_elem(const uint8_t *p, int i)
+{
+   return (p[i / 2] >> ((i & 1) * 4)) & 0xf;
+}
+
+static uint8_t *unpacked_value(rt_nexus_t *n, rt_value_t *v)
+{
+   uint8_t *bytes = value_ptr(n, v);
+
+   if (n->flags & NET_F_PACKED) {
+      // Callers expect one byte per element
+      uint8_t *unpacked = local_alloc(n->width);
+      unpack_values(unpacked, bytes, n->width);
+      return unpacked;
+   }
    else
-      return v->ext;
+      return bytes;
+}
+
+static inline bool source_packed(rt_nexus_t *nexus, rt_source_t *src)
+{
+   return (nexus->flags & NET_F_PACKED) && src->tag == SOURCE_DRIVER;
+}
+
+static inline uint8_t source_elem(const uint8_t *p, bool packed, int i)
+{
+   return packed ? packed_elem(p, i) : p[i];
 }
 
 static void copy_value_ptr(rt_nexus_t *n, rt_value_t *v, const void *p)
 {
-   const size_t valuesz = n->width * n->size;
-   if (valuesz <= sizeof(rt_value_t)) {
+   const size_t valuesz = value_size(n);
+   if (n->flags & NET_F_PACKED) {
+      if (valuesz <= sizeof(rt_value_t)) {
+         v->qword = 0;
+         pack_values(v->bytes, p, n->width);
+      }
+      else
+         pack_values(v->ext, p, n->width);
+   }
+   else if (valuesz <= sizeof(rt_value_t)) {
 #if __SANITIZE_ADDRESS__
       memcpy(v->bytes, p, valuesz);
 #else
@@ -1233,7 +1554,9 @@ static inline bool cmp_bytes(const void *a, const void *b, size_t size)
 
 static inline bool cmp_values(rt_nexus_t *n, rt_value_t a, rt_value_t b)
 {
-   const size_t valuesz = n->width * n->size;
+   // Packed values can be compared directly as the unused high nibble
+   // of an odd-length value is always zero
+   const size_t valuesz = value_size(n);
    if (valuesz <= sizeof(rt_value_t))
       return a.qword == b.qword;
    else
@@ -1503,9 +1826,47 @@ static void add_conversion_input(rt_conv_func_t *cf, rt_nexus_t *in)
    cf->inputs[cf->ninputs++] = in;
 }
 
+static void split_packed_value(rt_nexus_t *nexus, rt_value_t *v_new,
+                               rt_value_t *v_old, int offset)
+{
+   // Elements are not byte aligned in general so unpack the old value
+   // and repack both halves
+   const int oldwidth = offset + nexus->width;
+   const int oldsz = (oldwidth + 1) / 2;
+   const int newsz = (nexus->width + 1) / 2;
+   const int splitsz = (offset + 1) / 2;
+
+   uint8_t *old = oldsz > sizeof(rt_value_t) ? v_old->ext : v_old->bytes;
+   uint8_t *unpacked = local_alloc(oldwidth);
+   unpack_values(unpacked, old, oldwidth);
+
+   if (newsz > sizeof(rt_value_t)) {
+      v_new->ext = static_alloc(get_model(), newsz);
+      pack_values(v_new->ext, unpacked + offset, nexus->width);
+   }
+   else {
+      v_new->qword = 0;
+      pack_values(v_new->bytes, unpacked + offset, nexus->width);
+   }
+
+   if (splitsz <= sizeof(rt_value_t)) {
+      // Any external memory backing the old value is lost here but as
+      // in split_value this can only happen a bounded number of times
+      v_old->qword = 0;
+      pack_values(v_old->bytes, unpacked, offset);
+   }
+   else
+      pack_values(old, unpacked, offset);   // Clears the unused nibble
+}
+
 static void split_value(rt_nexus_t *nexus, rt_value_t *v_new,
                         rt_value_t *v_old, int offset)
 {
+   if (nexus->flags & NET_F_PACKED) {
+      split_packed_value(nexus, v_new, v_old, offset);
+      return;
+   }
+
    const int split = offset * nexus->size;
    const int oldsz = (offset + nexus->width) * nexus->size;
    const int newsz = nexus->width * nexus->size;
@@ -1742,6 +2103,7 @@ static void setup_signal(rt_model_t *m, rt_signal_t *s, tree_t where,
    rt_scope_t *parent = model_thread(m)->active_scope;
 
    s->where   = where;
+   s->id      = m->n_signals++;
    s->n_nexus = 1;
    s->offset  = offset;
    s->parent  = parent;
@@ -1762,10 +2124,13 @@ static void setup_signal(rt_model_t *m, rt_signal_t *s, tree_t where,
    s->nexus.event_delta  = DELTA_CYCLE_MAX;
    s->nexus.last_event   = TIME_HIGH;
 
+   // Elements of STD_ULOGIC fit in four bits so pending driver values
+   // can be stored two to a byte
+   if (m->packed_values && (flags & SIG_F_STD_LOGIC) && size == 1)
+      s->nexus.flags |= NET_F_PACKED;
+
    *m->nexus_tail = &(s->nexus);
    m->nexus_tail = &(s->nexus.chain);
-
-   m->n_signals++;
 }
 
 static void copy_sub_signal_sources(rt_scope_t *scope, void *buf, int stride)
@@ -1781,7 +2146,11 @@ static void copy_sub_signal_sources(rt_scope_t *scope, void *buf, int stride)
             if (data == NULL)
                continue;
 
-            memcpy(buf + s->offset + (o++ * stride), data, n->size * n->width);
+            void *dst = buf + s->offset + (o++ * stride);
+            if (source_packed(n, src))
+               unpack_values(dst, data, n->width);
+            else
+               memcpy(dst, data, n->size * n->width);
          }
       }
    }
@@ -1852,6 +2221,8 @@ static void *convert_effective(rt_conv_func_t *cf)
 
 static void *source_value(rt_nexus_t *nexus, rt_source_t *src)
 {
+   // The value of a driver is packed if the nexus has NET_F_PACKED set
+   // and must be read with source_elem
    switch (src->tag) {
    case SOURCE_DRIVER:
       if (unlikely(src->disconnected))
@@ -1887,16 +2258,20 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull,
 {
    if ((nexus->flags & NET_F_R_IDENT) && nonnull == 1) {
       // Resolution function behaves like identity for a single driver
-      return source_value(nexus, s0);
+      if (source_packed(nexus, s0))
+         return unpacked_value(nexus, &(s0->u.driver.waveforms.value));
+      else
+         return source_value(nexus, s0);
    }
    else if ((r->flags & R_MEMO) && nonnull == 1) {
       // Resolution function has been memoised so do a table lookup
 
       void *resolved = local_alloc(nexus->width * nexus->size);
-      char *p0 = source_value(nexus, s0);
+      const uint8_t *p0 = source_value(nexus, s0);
+      const bool packed0 = source_packed(nexus, s0);
 
       for (int j = 0; j < nexus->width; j++) {
-         const int index = ((uint8_t *)p0)[j];
+         const int index = source_elem(p0, packed0, j);
          ((int8_t *)resolved)[j] = r->tab1[index];
       }
 
@@ -1907,14 +2282,20 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull,
 
       void *resolved = local_alloc(nexus->width * nexus->size);
 
-      char *p0 = source_value(nexus, s0), *p1 = NULL;
-      for (rt_source_t *s1 = s0->chain_input;
-           s1 && (p1 = source_value(nexus, s1)) == NULL;
+      const uint8_t *p0 = source_value(nexus, s0), *p1 = NULL;
+      rt_source_t *s1 = s0->chain_input;
+      for (; s1 && (p1 = source_value(nexus, s1)) == NULL;
            s1 = s1->chain_input)
          ;
 
-      for (int j = 0; j < nexus->width; j++)
-         ((int8_t *)resolved)[j] = r->tab2[(int)p0[j]][(int)p1[j]];
+      const bool packed0 = source_packed(nexus, s0);
+      const bool packed1 = source_packed(nexus, s1);
+
+      for (int j = 0; j < nexus->width; j++) {
+         const int i0 = source_elem(p0, packed0, j);
+         const int i1 = source_elem(p1, packed1, j);
+         ((int8_t *)resolved)[j] = r->tab2[i0][i1];
+      }
 
       return resolved;
    }
@@ -1945,6 +2326,30 @@ static void *call_resolution(rt_nexus_t *nexus, res_memo_t *r, int nonnull,
       m->force_stop = true;
       return nexus_effective(nexus);   // Dummy result
    }
+   else if (nexus->flags & NET_F_PACKED) {
+      // Read each element of the packed driver values in place
+      void *resolved = local_alloc(nexus->width);
+      rt_model_t *m = get_model();
+
+      for (int j = 0; j < nexus->width; j++) {
+         uint8_t vals[nonnull];
+         unsigned o = 0;
+         for (rt_source_t *s = s0; s; s = s->chain_input) {
+            const uint8_t *data = source_value(nexus, s);
+            if (data != NULL)
+               vals[o++] = source_elem(data, source_packed(nexus, s), j);
+         }
+         assert(o == nonnull);
+
+         jit_scalar_t result;
+         if (!jit_try_call(m->jit, r->closure.handle, &result,
+                           r->closure.context, vals, r->ileft, nonnull))
+            m->force_stop = true;
+         ((uint8_t *)resolved)[j] = result.integer;
+      }
+
+      return resolved;
+   }
    else {
       void *resolved = local_alloc(nexus->width * nexus->size);
       rt_model_t *m = get_model();
@@ -2026,7 +2431,7 @@ static void *calculate_driving_value(rt_model_t *m, rt_nexus_t *n)
          // If S is driving-value forced, the driving value of S is
          // unchanged from its previous value; no further steps are
          // required.
-         return value_ptr(n, &(s->u.pseudo.value));
+         return unpacked_value(n, &(s->u.pseudo.value));
       }
       else if (s->tag == SOURCE_DEPOSIT) {
          // If a driving-value deposit is scheduled for S or for a
@@ -2035,7 +2440,7 @@ static void *calculate_driving_value(rt_model_t *m, rt_nexus_t *n)
          // driving deposit value for the signal of which S is a
          // subelement, as appropriate.
          s->disconnected = 1;
-         return value_ptr(n, &(s->u.pseudo.value));
+         return unpacked_value(n, &(s->u.pseudo.value));
       }
       else if (unlikely(s->tag == SOURCE_IMPLICIT)) {
          // At least one of the inputs is active so schedule an update
@@ -2065,7 +2470,7 @@ static void *calculate_driving_value(rt_model_t *m, rt_nexus_t *n)
          // signal, then the driving value of S is the current value of
          // that driver.
          assert(!s0->disconnected);
-         return value_ptr(n, &(s0->u.driver.waveforms.value));
+         return unpacked_value(n, &(s0->u.driver.waveforms.value));
 
       case SOURCE_PORT:
          // If S has one source that is a port and S is not a resolved
@@ -2206,6 +2611,10 @@ static void reset_coverage(rt_model_t *m)
       return;
 
    m->cover = cover_read_items(f, 0);
+   m->cover_bits = cover_counter_bits(m->cover);
+
+   // Must match the counter layout used when the design was elaborated
+   jit_set_cover_bits(m->jit, m->cover_bits);
 
    // Pre-allocate coverage counters
    const int n_tags = cover_count_items(m->cover);
@@ -2219,9 +2628,31 @@ static void emit_coverage(rt_model_t *m)
    if (m->cover != NULL) {
       const int n_tags = cover_count_items(m->cover);
 
-      const int32_t *counts = jit_get_cover_mem(m->jit, n_tags);
+      const void *mem = jit_get_cover_mem(m->jit, n_tags);
       fbuf_t *covdb = cover_open_lib_file(m->top, FBUF_OUT, true);
-      cover_dump_items(m->cover, covdb, COV_DUMP_RUNTIME, counts);
+
+      if (m->cover_bits == 32)
+         cover_dump_items(m->cover, covdb, COV_DUMP_RUNTIME, mem);
+      else {
+         // Expand packed counters to the format expected by the
+         // coverage database
+         int32_t *counts LOCAL = xmalloc_array(n_tags, sizeof(int32_t));
+         for (int i = 0; i < n_tags; i++) {
+            void *flags = NULL;
+            if (m->cover_flags != NULL)
+               flags = ihash_get(m->cover_flags, i);
+
+            if (flags != NULL)
+               counts[i] = (uintptr_t)flags;
+            else if (m->cover_bits == 8)
+               counts[i] = ((const uint8_t *)mem)[i];
+            else
+               counts[i] = (((const uint8_t *)mem)[i / 8] >> (i % 8)) & 1;
+         }
+
+         cover_dump_items(m->cover, covdb, COV_DUMP_RUNTIME, counts);
+      }
+
       fbuf_close(covdb, NULL);
    }
 }
@@ -2370,6 +2801,37 @@ static void check_undriven_std_logic(rt_nexus_t *n)
    n->signal->shared.flags &= ~SIG_F_STD_LOGIC;
 }
 
+static void check_two_state(rt_signal_t *s, const unsigned char *values,
+                            int count)
+{
+   // The values '0', '1', 'L', and 'H' of STD_ULOGIC and '0' and '1' of
+   // the Verilog logic type all have bit one set
+   int pos = 0;
+   for (; pos < count && (values[pos] & 2); pos++);
+
+   if (pos == count)
+      return;
+
+   type_t type = tree_type(s->where);
+   if (type_is_array(type))
+      type = type_elem_recur(type);
+
+   tree_t lit = type_enum_literal(type_base_recur(type), values[pos]);
+
+   LOCAL_TEXT_BUF sig_name = signal_full_name(s);
+
+   diag_t *d = diag_new(DIAG_WARN, tree_loc(s->where));
+   diag_printf(d, "%s%s assigned metavalue %s",
+               s->n_nexus > 1 ? "sub-element of signal " : "signal ",
+               tb_get(sig_name), istr(tree_ident(lit)));
+   diag_hint(d, NULL, "the design was elaborated with $bold$--two-state$$ "
+             "which assumes metavalues do not occur after initialisation");
+   diag_emit(d);
+
+   // Prevent multiple warnings for the same signal
+   s->shared.flags &= ~SIG_F_TWO_STATE;
+}
+
 void model_reset(rt_model_t *m)
 {
    MODEL_ENTRY(m);
@@ -2382,6 +2844,9 @@ void model_reset(rt_model_t *m)
    if (m->force_stop)
       return;   // Error in intialisation
 
+   if (opt_get_int(OPT_RT_STATS) & STATS_ACTIVITY)
+      reset_activity(m);
+
 #if TRACE_SIGNALS > 0
    if (__trace_on)
       dump_signals(m, m->root);
@@ -2550,6 +3015,8 @@ static inline bool insert_transaction(rt_model_t *m, rt_nexus_t *nexus,
                                       rt_source_t *source, waveform_t *w,
                                       uint64_t when, uint64_t reject)
 {
+   count_transaction(m, nexus);
+
    waveform_t *last = &(source->u.driver.waveforms);
    waveform_t *it   = last->next;
    while (it != NULL && it->when < when) {
@@ -2598,6 +3065,8 @@ static void sched_driver(rt_model_t *m, rt_nexus_t *nexus, uint64_t after,
       w->when = m->now;
       assert(w->next == NULL);
 
+      count_transaction(m, nexus);
+
       rt_signal_t *signal = nexus->signal;
       rt_source_t *d0 = &(signal->nexus.sources);
 
@@ -2632,8 +3101,9 @@ static void sched_driver(rt_model_t *m, rt_nexus_t *nexus, uint64_t after,
          w0->next  = NULL;
          w0->value = alloc_value(m, nexus);
 
+         // Copy the raw bytes to avoid repacking a packed value
          const uint8_t *prev = value_ptr(nexus, &(d->u.driver.waveforms.value));
-         copy_value_ptr(nexus, &w0->value, prev);
+         memcpy(value_ptr(nexus, &w0->value), prev, value_size(nexus));
 
          assert(d->u.driver.waveforms.next == NULL);
          d->u.driver.waveforms.next = w0;
@@ -2724,6 +3194,17 @@ static void async_update_property(rt_model_t *m, void *arg)
    update_property(m, prop);
 }
 
+static void async_update_prop_group(rt_model_t *m, void *arg)
+{
+   rt_prop_group_t *g = arg;
+
+   assert(g->wakeable.pending);
+   g->wakeable.pending = false;
+
+   for (int i = 0; i < g->members.count; i++)
+      update_property(m, g->members.items[i]);
+}
+
 static bool heap_delete_proc_cb(uint64_t key, void *value, void *search)
 {
    if (pointer_tag(value) != EVENT_PROCESS)
@@ -2846,6 +3327,15 @@ static void wakeup_one(rt_model_t *m, rt_wakeable_t *obj)
          deferq_do(dq, async_transfer_signal, t);
       }
       break;
+
+   case W_PROP_GROUP:
+      {
+         rt_prop_group_t *g = container_of(obj, rt_prop_group_t, wakeable);
+         TRACE("wakeup %d properties sharing trigger %p", g->members.count,
+               obj->trigger);
+         deferq_do(dq, async_update_prop_group, g);
+      }
+      break;
    }
 
    set_pending(obj);
@@ -2859,6 +3349,9 @@ static void notify_event(rt_model_t *m, rt_nexus_t *n)
    n->last_event = m->now;
    n->event_delta = m->iteration;
 
+   if (unlikely(m->activity != NULL) && n->signal->id < m->activity->n_signals)
+      m->activity->events[n->signal->id]++;
+
    if (n->flags & NET_F_CACHE_EVENT)
       n->signal->shared.flags |= SIG_F_EVENT_FLAG;
 
@@ -3128,18 +3621,23 @@ static void update_implicit_signal(rt_model_t *m, rt_implicit_t *imp)
    }
 }
 
-static void iteration_limit_proc_cb(void *fn, void *arg, void *extra)
+static rt_proc_t *deferred_proc(void *fn, void *arg)
 {
-   diag_t *d = extra;
-   rt_proc_t *proc = NULL;
-
    if (fn == async_run_process)
-      proc = arg;
+      return arg;
    else if (fn == async_transfer_signal) {
       rt_transfer_t *t = arg;
-      proc = t->proc;
+      return t->proc;
    }
+   else
+      return NULL;
+}
 
+static void iteration_limit_proc_cb(void *fn, void *arg, void *extra)
+{
+   diag_t *d = extra;
+
+   rt_proc_t *proc = deferred_proc(fn, arg);
    if (proc == NULL)
       return;
 
@@ -3185,6 +3683,130 @@ static void reached_iteration_limit(rt_model_t *m)
    m->force_stop = true;
 }
 
+static inline int delta_hist_bucket(unsigned n)
+{
+   // Bucket zero is exactly zero and bucket N covers [2^(N-1), 2^N)
+   if (n == 0)
+      return 0;
+   else
+      return MIN(32 - __builtin_clz(n), DELTA_HIST_BUCKETS - 1);
+}
+
+static void storm_proc_cb(void *fn, void *arg, void *extra)
+{
+   delta_storm_t *storm = extra;
+
+   rt_proc_t *proc = deferred_proc(fn, arg);
+   if (proc == NULL)
+      return;
+
+   for (int i = 0; i < storm->nprocs; i++) {
+      if (storm->procs[i] == proc)
+         return;
+   }
+
+   if (storm->nprocs < STORM_MAX_PROCS)
+      storm->procs[storm->nprocs++] = proc;
+}
+
+static void capture_delta_storm(rt_model_t *m)
+{
+   delta_stats_t *ds = &(m->deltas);
+
+   // Only remember the processes active in time steps which could be
+   // one of the worst seen so far
+   unsigned threshold = STORM_MIN_DELTAS;
+   if (ds->nstorms == MAX_DELTA_STORMS)
+      threshold = MAX(threshold, ds->storms[MAX_DELTA_STORMS - 1].deltas);
+
+   if (m->iteration < threshold)
+      return;
+
+   ds->current.when   = m->now;
+   ds->current.nprocs = 0;
+   deferq_scan(&m->procq, storm_proc_cb, &(ds->current));
+}
+
+static void end_delta_storm(rt_model_t *m)
+{
+   delta_stats_t *ds = &(m->deltas);
+
+   ds->steps[delta_hist_bucket(m->iteration)]++;
+
+   if (m->iteration < STORM_MIN_DELTAS)
+      return;
+   else if (ds->nstorms == MAX_DELTA_STORMS
+            && ds->storms[MAX_DELTA_STORMS - 1].deltas >= m->iteration)
+      return;
+
+   int pos = MIN(ds->nstorms, MAX_DELTA_STORMS - 1);
+   for (; pos > 0 && ds->storms[pos - 1].deltas < m->iteration; pos--)
+      ds->storms[pos] = ds->storms[pos - 1];
+
+   delta_storm_t *storm = &(ds->storms[pos]);
+   storm->when   = m->now;
+   storm->deltas = m->iteration;
+   storm->nprocs = 0;
+
+   if (ds->current.when == m->now) {
+      storm->nprocs = ds->current.nprocs;
+      memcpy(storm->procs, ds->current.procs,
+             ds->current.nprocs * sizeof(rt_proc_t *));
+   }
+
+   if (ds->nstorms < MAX_DELTA_STORMS)
+      ds->nstorms++;
+}
+
+static void print_delta_histogram(text_buf_t *tb, const char *title,
+                                  const uint64_t *hist)
+{
+   int last = DELTA_HIST_BUCKETS - 1;
+   for (; last > 0 && hist[last] == 0; last--)
+      ;
+
+   tb_printf(tb, "%s:\n", title);
+
+   for (int i = 0; i <= last; i++) {
+      char range[32];
+      if (i == 0)
+         checked_sprintf(range, sizeof(range), "0");
+      else if (i == 1)
+         checked_sprintf(range, sizeof(range), "1");
+      else if (i == DELTA_HIST_BUCKETS - 1)
+         checked_sprintf(range, sizeof(range), ">=%u", 1u << (i - 1));
+      else
+         checked_sprintf(range, sizeof(range), "%u-%u",
+                         1u << (i - 1), (1u << i) - 1);
+
+      tb_printf(tb, "  %-12s %12"PRIu64"\n", range, hist[i]);
+   }
+}
+
+void model_delta_report(rt_model_t *m, text_buf_t *tb)
+{
+   delta_stats_t *ds = &(m->deltas);
+
+   print_delta_histogram(tb, "Delta cycles per time step", ds->steps);
+   print_delta_histogram(tb, "Processes run per cycle", ds->cycles);
+
+   if (ds->nstorms == 0)
+      return;
+
+   tb_printf(tb, "Time steps with the most delta cycles:\n");
+
+   for (int i = 0; i < ds->nstorms; i++) {
+      const delta_storm_t *storm = &(ds->storms[i]);
+      tb_printf(tb, "  %-12s %12u", trace_time(storm->when), storm->deltas);
+
+      for (int j = 0; j < storm->nprocs; j++)
+         tb_printf(tb, "%s%s", j == 0 ? "  " : ", ",
+                   istr(storm->procs[j]->name));
+
+      tb_append(tb, '\n');
+   }
+}
+
 static void sync_event_cache(rt_model_t *m)
 {
    list_foreach(rt_signal_t *, s, m->eventsigs) {
@@ -3297,6 +3919,11 @@ static void model_cycle(rt_model_t *m)
    if (m->shuffle)
       deferq_shuffle(&m->procq);
 
+   m->deltas.cycles[delta_hist_bucket(m->procq.count)]++;
+
+   if (m->iteration > 0)
+      capture_delta_storm(m);
+
    // Run all non-postponed processes and event callbacks
    deferq_run(m, &m->procq);
 
@@ -3314,6 +3941,8 @@ static void model_cycle(rt_model_t *m)
       global_event(m, RT_END_TIME_STEP);
 
       m->can_create_delta = true;
+
+      end_delta_storm(m);
    }
    else if (m->stop_delta > 0 && m->iteration == m->stop_delta)
       reached_iteration_limit(m);
@@ -3686,17 +4315,77 @@ void get_forcing_value(rt_signal_t *s, uint8_t *value)
       }
       assert(s != NULL);
 
-      memcpy(p, s->u.pseudo.value.bytes, n->width * n->size);
+      // May be called from the shell outside of the model thread
+      rt_value_t *v = &(s->u.pseudo.value);
+      const size_t valuesz = value_size(n);
+      const void *src = valuesz <= sizeof(rt_value_t) ? v->bytes : v->ext;
+      if (n->flags & NET_F_PACKED)
+         unpack_values(p, src, n->width);
+      else
+         memcpy(p, src, valuesz);
       p += n->width * n->size;
    }
    assert(p == value + s->shared.size);
 }
 
-int32_t *get_cover_counter(rt_model_t *m, int32_t tag)
+void increment_cover_counter(rt_model_t *m, int32_t tag)
 {
    assert(tag >= 0);
    assert(m->cover != NULL);
-   return jit_get_cover_mem(m->jit, tag + 1) + tag;
+
+   void *mem = jit_get_cover_mem(m->jit, tag + 1);
+
+   switch (m->cover_bits) {
+   case 1:
+      *((uint8_t *)mem + tag / 8) |= 1 << (tag % 8);
+      break;
+   case 8:
+      {
+         uint8_t *ptr = (uint8_t *)mem + tag;
+         *ptr = saturate_add(*ptr, 1);
+      }
+      break;
+   default:
+      {
+         int32_t *ptr = (int32_t *)mem + tag;
+         *ptr = saturate_add(*ptr, 1);
+      }
+      break;
+   }
+}
+
+void set_cover_counter(rt_model_t *m, int32_t tag, int32_t value)
+{
+   assert(tag >= 0);
+   assert(m->cover != NULL);
+
+   void *mem = jit_get_cover_mem(m->jit, tag + 1);
+
+   switch (m->cover_bits) {
+   case 1:
+      if (value == 0 || value == 1) {
+         uint8_t *ptr = (uint8_t *)mem + tag / 8;
+         *ptr = (*ptr & ~(1 << (tag % 8))) | (value << (tag % 8));
+         return;
+      }
+      break;
+   case 8:
+      if (value >= 0 && value <= UINT8_MAX) {
+         *((uint8_t *)mem + tag) = value;
+         return;
+      }
+      break;
+   default:
+      *((int32_t *)mem + tag) = value;
+      return;
+   }
+
+   // Values such as flags which do not fit in a packed counter are
+   // kept separately and merged back in when the counters are dumped
+   if (m->cover_flags == NULL)
+      m->cover_flags = ihash_new(64);
+
+   ihash_put(m->cover_flags, tag, (void *)(uintptr_t)(uint32_t)value);
 }
 
 static rt_trigger_t *new_trigger(rt_model_t *m, trigger_kind_t kind,
@@ -3828,6 +4517,11 @@ void x_sched_waveform_s(sig_shared_t *ss, uint32_t offset, uint64_t scalar,
    check_postponed(after, proc);
    check_reject_limit(s, after, reject);
 
+   if (unlikely(ss->flags & SIG_F_TWO_STATE)) {
+      const unsigned char byte = scalar;
+      check_two_state(s, &byte, 1);
+   }
+
    rt_model_t *m = get_model();
    rt_nexus_t *n = split_nexus(m, s, offset, 1);
 
@@ -3850,6 +4544,9 @@ void x_sched_waveform(sig_shared_t *ss, uint32_t offset, void *values,
    check_postponed(after, proc);
    check_reject_limit(s, after, reject);
 
+   if (unlikely(ss->flags & SIG_F_TWO_STATE))
+      check_two_state(s, values, count);
+
    rt_model_t *m = get_model();
    rt_nexus_t *n = split_nexus(m, s, offset, count);
    char *vptr = values;
@@ -3971,6 +4668,10 @@ void x_sched_event(sig_shared_t *ss, uint32_t offset, int32_t count)
    rt_wakeable_t *obj = get_active_wakeable();
 
    rt_model_t *m = get_model();
+
+   if (obj->kind == W_PROPERTY)
+      obj = property_group(m, container_of(obj, rt_prop_t, wakeable));
+
    rt_nexus_t *n = split_nexus(m, s, offset, count);
    for (; count > 0; n = n->chain) {
       sched_event(m, n, obj);
@@ -4277,13 +4978,14 @@ void *x_driving_value(sig_shared_t *ss, uint32_t offset, int32_t count)
          jit_msg(NULL, DIAG_FATAL, "process %s does not contain a driver "
                  "for %s", istr(proc->name), istr(tree_ident(s->where)));
 
-      const uint8_t *driving;
       if (n->flags & NET_F_FAST_DRIVER)
-         driving = nexus_effective(n);
+         memcpy(p, nexus_effective(n), n->width * n->size);
+      else if (n->flags & NET_F_PACKED)
+         unpack_values(p, value_ptr(n, &(src->u.driver.waveforms.value)),
+                       n->width);
       else
-         driving = value_ptr(n, &(src->u.driver.waveforms.value));
-
-      memcpy(p, driving, n->width * n->size);
+         memcpy(p, value_ptr(n, &(src->u.driver.waveforms.value)),
+                n->width * n->size);
       p += n->width * n->size;
 
       count -= n->width;
@@ -4432,6 +5134,7 @@ void x_process_init(jit_handle_t handle, tree_t where)
    p->where     = where;
    p->name      = name;
    p->handle    = handle;
+   p->id        = m->n_procs++;
    p->scope     = s;
    p->privdata  = mptr_new(m->mspace, "process privdata");
 
@@ -32,6 +32,7 @@ int64_t model_next_time(rt_model_t *m);
 void model_stop(rt_model_t *m);
 void model_interrupt(rt_model_t *m);
 int model_exit_status(rt_model_t *m);
+void model_delta_report(rt_model_t *m, text_buf_t *tb);
 
 void model_set_global_cb(rt_model_t *m, rt_event_t event, rt_event_fn_t fn,
                          void *user);
@@ -66,6 +67,7 @@ void deposit_signal(rt_model_t *m, rt_signal_t *s, const void *values,
 rt_watch_t *find_watch(rt_nexus_t *n, sig_event_fn_t fn);
 void get_forcing_value(rt_signal_t *s, uint8_t *value);
 
-int32_t *get_cover_counter(rt_model_t *m, int32_t tag);
+void increment_cover_counter(rt_model_t *m, int32_t tag);
+void set_cover_counter(rt_model_t *m, int32_t tag, int32_t value);
 
 #endif  // _RT_MODEL_H
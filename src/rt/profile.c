@@ -0,0 +1,313 @@
+//
+//  Copyright (C) 2024  Nick Gasson
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "util.h"
+#include "array.h"
+#include "debug.h"
+#include "diag.h"
+#include "hash.h"
+#include "ident.h"
+#include "rt/profile.h"
+#include "thread.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __MINGW32__
+#include "cpustate.h"
+
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#define SAMPLE_HZ    1000
+#define MAX_DEPTH    24
+#define TABLE_SIZE   32768
+
+#if defined __x86_64__
+#define FP_REG 5
+#elif defined __aarch64__
+#define FP_REG 29
+#endif
+
+typedef struct {
+   uint32_t  hash;
+   uint32_t  count;
+   unsigned  depth;
+   uintptr_t pcs[MAX_DEPTH];
+} stack_sample_t;
+
+typedef struct {
+   char     *text;
+   unsigned  count;
+} folded_stack_t;
+
+typedef struct {
+   stack_sample_t   *table;
+   unsigned          nstacks;
+   int               thread;
+   uintptr_t         stack_top;
+   unsigned          dropped;
+   unsigned          other;
+   unsigned          total;
+#ifndef __MINGW32__
+   struct sigaction  old_action;
+#endif
+} profile_state_t;
+
+static profile_state_t *state = NULL;
+
+#ifndef __MINGW32__
+
+static uint32_t hash_stack(const uintptr_t *pcs, unsigned depth)
+{
+   uint32_t hash = 2166136261u;
+   for (unsigned i = 0; i < depth; i++) {
+      hash ^= (uint32_t)((uint64_t)pcs[i] ^ ((uint64_t)pcs[i] >> 32));
+      hash *= 16777619u;
+   }
+
+   return hash;
+}
+
+static unsigned walk_frames(const struct cpu_state *cpu, uintptr_t *pcs)
+{
+   unsigned depth = 0;
+   pcs[depth++] = cpu->pc;
+
+#ifdef FP_REG
+   // Follow the frame pointer chain which is only reliable when the
+   // runtime and generated code are built with frame pointers enabled:
+   // stop as soon as a link points outside this thread's stack
+   uintptr_t fp = cpu->regs[FP_REG], limit = cpu->sp;
+   while (depth < MAX_DEPTH) {
+      if (fp < limit || fp >= state->stack_top - 2 * sizeof(uintptr_t))
+         break;
+      else if (fp & (sizeof(uintptr_t) - 1))
+         break;
+
+      const uintptr_t *frame = (uintptr_t *)fp;
+      if (frame[1] == 0)
+         break;
+
+      pcs[depth++] = frame[1];
+      limit = fp + 2 * sizeof(uintptr_t);
+      fp = frame[0];
+   }
+#endif
+
+   return depth;
+}
+
+static void profile_signal_handler(int sig, siginfo_t *info, void *context)
+{
+   const int saved_errno = errno;
+
+   if (state == NULL)
+      goto out;
+
+   state->total++;
+
+   if (!thread_attached() || thread_id() != state->thread) {
+      state->other++;
+      goto out;
+   }
+
+   struct cpu_state cpu;
+   fill_cpu_state(&cpu, (ucontext_t *)context);
+
+   uintptr_t pcs[MAX_DEPTH];
+   const unsigned depth = walk_frames(&cpu, pcs);
+   const uint32_t hash = hash_stack(pcs, depth);
+
+   for (int slot = hash & (TABLE_SIZE - 1), probes = 0;
+        probes < TABLE_SIZE / 2;
+        slot = (slot + 1) & (TABLE_SIZE - 1), probes++) {
+      stack_sample_t *s = &(state->table[slot]);
+      if (s->count == 0) {
+         s->hash  = hash;
+         s->depth = depth;
+         s->count = 1;
+         memcpy(s->pcs, pcs, depth * sizeof(uintptr_t));
+         state->nstacks++;
+         goto out;
+      }
+      else if (s->hash == hash && s->depth == depth
+               && memcmp(s->pcs, pcs, depth * sizeof(uintptr_t)) == 0) {
+         s->count++;
+         goto out;
+      }
+   }
+
+   state->dropped++;
+
+ out:
+   errno = saved_errno;
+}
+
+typedef A(char *) name_list_t;
+
+static const char *frame_name(ihash_t *names, name_list_t *list, uintptr_t pc)
+{
+   const char *name = ihash_get(names, pc);
+   if (name != NULL)
+      return name;
+
+   const debug_frame_t *f = debug_lookup_frame(pc);
+
+   LOCAL_TEXT_BUF tb = tb_new();
+   if (f->symbol != NULL)
+      tb_cat(tb, f->symbol);
+   else if (f->vhdl_unit != NULL)
+      tb_istr(tb, f->vhdl_unit);
+   else if (f->module != NULL)
+      tb_printf(tb, "%s+0x%"PRIxPTR, f->module, pc);
+   else
+      tb_printf(tb, "0x%"PRIxPTR, pc);
+
+   if (f->srcfile != NULL && f->lineno > 0)
+      tb_printf(tb, "[%s:%u]", f->srcfile, f->lineno);
+
+   // Separators have special meaning in the folded stack format
+   tb_replace(tb, ';', ':');
+   tb_replace(tb, ' ', '_');
+
+   char *copy = tb_claim(tb);
+   ihash_put(names, pc, copy);
+   APUSH(*list, copy);
+   return copy;
+}
+
+static void write_folded(FILE *f, const char *text, unsigned count)
+{
+   if (count > 0)
+      fprintf(f, "%s %u\n", text, count);
+}
+
+#endif  // __MINGW32__
+
+void profile_start(void)
+{
+#ifdef __MINGW32__
+   warnf("profiling is not supported on this platform");
+#else
+   assert(state == NULL);
+
+   uintptr_t here = (uintptr_t)&here;
+
+   state = xcalloc(sizeof(profile_state_t));
+   state->table     = xcalloc_array(TABLE_SIZE, sizeof(stack_sample_t));
+   state->thread    = thread_id();
+   state->stack_top = here;
+
+   struct sigaction sa = {};
+   sa.sa_sigaction = profile_signal_handler;
+   sa.sa_flags = SA_RESTART | SA_SIGINFO;
+   sigemptyset(&sa.sa_mask);
+
+   if (sigaction(SIGPROF, &sa, &state->old_action) != 0)
+      fatal_errno("sigaction");
+
+   const struct itimerval it = {
+      .it_interval = { 0, 1000000 / SAMPLE_HZ },
+      .it_value    = { 0, 1000000 / SAMPLE_HZ },
+   };
+
+   if (setitimer(ITIMER_PROF, &it, NULL) != 0)
+      fatal_errno("setitimer");
+#endif
+}
+
+void profile_stop(const char *fname)
+{
+#ifndef __MINGW32__
+   if (state == NULL)
+      return;
+
+   const struct itimerval it = {};
+   if (setitimer(ITIMER_PROF, &it, NULL) != 0)
+      fatal_errno("setitimer");
+
+   if (sigaction(SIGPROF, &state->old_action, NULL) != 0)
+      fatal_errno("sigaction");
+
+   profile_state_t *s = state;
+   state = NULL;
+
+   FILE *f = fopen(fname, "w");
+   if (f == NULL)
+      fatal_errno("cannot create %s", fname);
+
+   ihash_t *names = ihash_new(256);
+   name_list_t list = AINIT;
+   shash_t *merged = shash_new(256);
+   A(folded_stack_t) stacks = AINIT;
+
+   // Several distinct return addresses usually resolve to the same
+   // function so merge identical folded stacks before writing them
+   LOCAL_TEXT_BUF tb = tb_new();
+   for (int i = 0; i < TABLE_SIZE; i++) {
+      const stack_sample_t *ss = &(s->table[i]);
+      if (ss->count == 0)
+         continue;
+
+      tb_rewind(tb);
+      for (int j = ss->depth - 1; j >= 0; j--) {
+         // Return addresses point after the call instruction
+         const uintptr_t pc = j == 0 ? ss->pcs[j] : ss->pcs[j] - 1;
+         tb_cat(tb, frame_name(names, &list, pc));
+         if (j > 0)
+            tb_append(tb, ';');
+      }
+
+      void *idx = shash_get(merged, tb_get(tb));
+      if (idx != NULL)
+         stacks.items[(uintptr_t)idx - 1].count += ss->count;
+      else {
+         folded_stack_t fs = { xstrdup(tb_get(tb)), ss->count };
+         APUSH(stacks, fs);
+         shash_put(merged, fs.text, (void *)(uintptr_t)stacks.count);
+      }
+   }
+
+   for (int i = 0; i < stacks.count; i++) {
+      write_folded(f, stacks.items[i].text, stacks.items[i].count);
+      free(stacks.items[i].text);
+   }
+
+   write_folded(f, "[other threads]", s->other);
+   write_folded(f, "[dropped]", s->dropped);
+
+   fclose(f);
+
+   notef("wrote %u profile samples to %s", s->total, fname);
+
+   ACLEAR(stacks);
+   shash_free(merged);
+   ihash_free(names);
+
+   for (int i = 0; i < list.count; i++)
+      free(list.items[i]);
+   ACLEAR(list);
+
+   free(s->table);
+   free(s);
+#endif
+}
@@ -59,7 +59,7 @@ typedef enum {
 #define NET_F_CACHE_EVENT  (1 << 2)
 #define NET_F_R_IDENT      (1 << 3)
 #define NET_F_PENDING      (1 << 4)
-// Unused                  (1 << 5)
+#define NET_F_PACKED       (1 << 5)
 #define NET_F_FAST_DRIVER  (1 << 6)
 #define NET_F_EFFECTIVE    (1 << 7)
 typedef uint8_t net_flags_t;
@@ -69,6 +69,7 @@ typedef uint8_t net_flags_t;
 #define SIG_F_CACHE_EVENT  (1 << 10)
 #define SIG_F_EVENT_FLAG   (1 << 11)
 #define SIG_F_REGISTER     (1 << 12)
+#define SIG_F_TWO_STATE    (1 << 13)
 typedef uint32_t sig_flags_t;
 
 typedef enum {
@@ -76,6 +77,10 @@ typedef enum {
    SIGNAL_REGISTER
 } rt_signal_kind_t;
 
+#define STATS_SUMMARY   (1 << 0)
+#define STATS_ACTIVITY  (1 << 1)
+#define STATS_DELTA     (1 << 2)
+
 typedef enum {
    RT_END_OF_INITIALISATION,
    RT_START_OF_SIMULATION,
@@ -92,6 +97,16 @@ typedef enum {
 typedef uint16_t delta_cycle_t;
 #define DELTA_CYCLE_MAX UINT16_MAX
 
+// Order of values in the encoding table passed to read_mem_file
+#define READ_MEM_ENC_0 0
+#define READ_MEM_ENC_1 1
+#define READ_MEM_ENC_X 2
+#define READ_MEM_ENC_Z 3
+
+void read_mem_file(const char *what, const char *fname, int radix,
+                   uint8_t *mem, int64_t width, int64_t depth,
+                   int64_t start, int64_t finish, const uint8_t *enc);
+
 void _std_standard_init(void);
 void _std_env_init(void);
 void _std_reflection_init(void);
@@ -26,9 +26,11 @@
 #include "printer.h"
 #include "rt/assert.h"
 #include "rt/model.h"
+#include "rt/mspace.h"
 #include "rt/structs.h"
 #include "scan.h"
 #include "shell.h"
+#include "thread.h"
 #include "tree.h"
 #include "type.h"
 
@@ -105,8 +107,23 @@ typedef struct _tcl_shell {
    shell_handler_t  handler;
    bool             quit;
    char            *datadir;
+   nvc_thread_t    *worker;
+   uint64_t         stop_time;
+   bool             async_active;
+   bool             async_cb;
+   diag_consumer_t  async_consumer;
+   void            *async_consumer_ctx;
+   nvc_lock_t       pause_lock;
+   nvc_cond_t       pause_cond;
+   bool             pause_req;
+   bool             paused;
+   bool             async_done;
 } tcl_shell_t;
 
+#define SHELL_PAUSE(sh)                                         \
+   __attribute__((cleanup(shell_resume), unused))               \
+   tcl_shell_t *UNIQUE(__pause) = shell_pause(sh);
+
 static __thread tcl_shell_t *rl_shell = NULL;
 
 __attribute__((format(printf, 2, 3)))
@@ -165,11 +182,94 @@ static bool shell_has_model(tcl_shell_t *sh)
    return true;
 }
 
+static void shell_update_now(tcl_shell_t *sh);
+
+static void shell_join_async(tcl_shell_t *sh)
+{
+   assert(sh->worker != NULL);
+
+   thread_join(sh->worker);
+   sh->worker = NULL;
+
+   sh->async_active = false;
+   sh->pause_req = false;
+   sh->async_done = false;
+
+   shell_update_now(sh);
+}
+
+static bool shell_async_done(tcl_shell_t *sh)
+{
+   SCOPED_LOCK(sh->pause_lock);
+   return sh->async_done;
+}
+
+static void shell_stop_async(tcl_shell_t *sh)
+{
+   if (sh->worker == NULL)
+      return;
+
+   // The model is about to be discarded so it does not matter that it
+   // cannot be resumed after this
+   model_stop(sh->model);
+
+   {
+      SCOPED_LOCK(sh->pause_lock);
+      sh->pause_req = false;
+      nvc_cond_notify_all(&sh->pause_cond);
+   }
+
+   shell_join_async(sh);
+}
+
+static tcl_shell_t *shell_pause(tcl_shell_t *sh)
+{
+   if (sh->worker == NULL)
+      return NULL;
+
+   // Ask the worker to park itself at the start of the next time step
+   // and wait until it has either done so or finished the run
+   bool done;
+   {
+      SCOPED_LOCK(sh->pause_lock);
+
+      sh->pause_req = true;
+
+      while (!sh->paused && !sh->async_done)
+         nvc_cond_wait(&sh->pause_cond, &sh->pause_lock);
+
+      if ((done = sh->async_done))
+         sh->pause_req = false;
+   }
+
+   if (done) {
+      shell_join_async(sh);
+      return NULL;
+   }
+
+   shell_update_now(sh);
+   return sh;
+}
+
+static void shell_resume(tcl_shell_t **psh)
+{
+   if (*psh != NULL) {
+      tcl_shell_t *sh = *psh;
+      SCOPED_LOCK(sh->pause_lock);
+
+      assert(sh->paused);
+      sh->pause_req = false;
+      nvc_cond_notify_all(&sh->pause_cond);
+   }
+}
+
 static void shell_clear_model(tcl_shell_t *sh)
 {
    if (sh->model == NULL)
       return;
 
+   shell_stop_async(sh);
+
    model_free(sh->model);
    hash_free(sh->namemap);
 
@@ -333,6 +433,8 @@ static int shell_cmd_restart(ClientData cd, Tcl_Interp *interp,
    if (!shell_has_model(sh))
       return TCL_ERROR;
 
+   shell_stop_async(sh);
+
    model_free(sh->model);
    sh->model = NULL;
 
@@ -359,7 +461,72 @@ static int shell_cmd_restart(ClientData cd, Tcl_Interp *interp,
 }
 
 static const char run_help[] =
-   "Start or resume the simulation";
+   "Start or resume the simulation\n"
+   "\n"
+   "Syntax:\n"
+   "  run [-async] [<time> <units>]\n"
+   "\n"
+   "Options:\n"
+   "  -async\tRun in the background and return immediately. Commands\n"
+   "\t\tsuch as examine and force pause the simulation at the next\n"
+   "\t\ttime step while they execute.\n"
+   "\n"
+   "Examples:\n"
+   "  run 100 ns\n"
+   "  run -async\n";
+
+static void shell_async_time_step(rt_model_t *m, void *user)
+{
+   tcl_shell_t *sh = user;
+
+   if (!sh->async_active) {
+      sh->async_cb = false;
+      return;   // Left over from a previous background run
+   }
+
+   {
+      SCOPED_LOCK(sh->pause_lock);
+
+      if (sh->pause_req) {
+         sh->paused = true;
+         nvc_cond_notify_all(&sh->pause_cond);
+
+         while (sh->pause_req)
+            nvc_cond_wait(&sh->pause_cond, &sh->pause_lock);
+
+         sh->paused = false;
+      }
+   }
+
+   model_set_global_cb(m, RT_NEXT_TIME_STEP, shell_async_time_step, sh);
+}
+
+static void *shell_run_thread(void *arg)
+{
+   tcl_shell_t *sh = arg;
+
+   mspace_stack_limit(MSPACE_CURRENT_FRAME);
+
+   // The diagnostic consumer is per-thread so install the one from the
+   // shell thread to forward reports raised by the simulation
+   diag_set_consumer(sh->async_consumer, sh->async_consumer_ctx);
+
+   // The callback re-registers itself at each time step and may still
+   // be pending from an earlier background run
+   if (!sh->async_cb) {
+      model_set_global_cb(sh->model, RT_NEXT_TIME_STEP,
+                          shell_async_time_step, sh);
+      sh->async_cb = true;
+   }
+
+   model_run(sh->model, sh->stop_time);
+
+   SCOPED_LOCK(sh->pause_lock);
+   sh->async_done = true;
+   nvc_cond_notify_all(&sh->pause_cond);
+
+   return NULL;
+}
 
 static int shell_cmd_run(ClientData cd, Tcl_Interp *interp,
                          int objc, Tcl_Obj *const objv[])
@@ -369,17 +536,29 @@ static int shell_cmd_run(ClientData cd, Tcl_Interp *interp,
 
    if (!shell_has_model(sh))
       return TCL_ERROR;
-   else if (sim_running)
+   else if (sh->worker != NULL && shell_async_done(sh))
+      shell_join_async(sh);
+
+   if (sim_running || sh->worker != NULL)
       return tcl_error(sh, "simulation already running");
 
+   bool async = false;
+   int pos = 1;
+   for (const char *opt; (opt = next_option(&pos, objc, objv)); ) {
+      if (strcmp(opt, "-async") == 0)
+         async = true;
+      else
+         goto usage;
+   }
+
    uint64_t stop_time = UINT64_MAX;
-   if (objc == 3) {
+   if (objc - pos == 2) {
       Tcl_WideInt base;
-      int error = Tcl_GetWideIntFromObj(interp, objv[1], &base);
+      int error = Tcl_GetWideIntFromObj(interp, objv[pos], &base);
       if (error != TCL_OK || base <= 0)
          return tcl_error(sh, "invalid time");
 
-      const char *unit = Tcl_GetString(objv[2]);
+      const char *unit = Tcl_GetString(objv[pos + 1]);
 
       uint64_t mult;
       if      (strcmp(unit, "fs") == 0) mult = 1;
@@ -392,9 +571,21 @@ static int shell_cmd_run(ClientData cd, Tcl_Interp *interp,
 
       stop_time = model_now(sh->model, NULL) + (base * mult);
    }
-   else if (objc != 1)
-      return tcl_error(sh, "usage: $bold$run [time units]$$");
+   else if (objc != pos)
+      goto usage;
 
+   if (async) {
+#ifdef USE_EMUTLS
+      return tcl_error(sh, "background simulation is not supported on "
+                       "this platform");
+#else
+      sh->stop_time = stop_time;
+      sh->async_active = true;
+      sh->async_consumer = diag_get_consumer(&sh->async_consumer_ctx);
+      sh->worker = thread_create(shell_run_thread, sh, "simulation");
+      return TCL_OK;
+#endif
+   }
 
    sim_running = true;
    model_run(sh->model, stop_time);
@@ -403,6 +594,9 @@ static int shell_cmd_run(ClientData cd, Tcl_Interp *interp,
    shell_update_now(sh);
 
    return TCL_OK;
+
+ usage:
+   return tcl_error(sh, "usage: $bold$run [-async] [time units]$$");
 }
 
 static const char find_help[] =
@@ -634,6 +828,8 @@ static int shell_cmd_examine(ClientData cd, Tcl_Interp *interp,
    if (!shell_has_model(sh))
       return TCL_ERROR;
 
+   SHELL_PAUSE(sh);
+
    print_flags_t flags = 0;
    int pos = 1;
    for (const char *opt; (opt = next_option(&pos, objc, objv)); ) {
@@ -782,6 +978,8 @@ static int shell_cmd_force(ClientData cd, Tcl_Interp *interp,
    else if (objc != 3 && objc != 1)
       return syntax_error(sh, objv);
 
+   SHELL_PAUSE(sh);
+
    if (objc == 1) {
       for (int i = 0; i < sh->nsignals; i++) {
          shell_signal_t *ss = &(sh->signals[i]);
@@ -858,6 +1056,8 @@ static int shell_cmd_noforce(ClientData cd, Tcl_Interp *interp,
    else if (objc == 1)
       return syntax_error(sh, objv);
 
+   SHELL_PAUSE(sh);
+
    for (int i = 1; i < objc; i++) {
       const char *signame = Tcl_GetString(objv[i]);
       if (strcmp(signame, "*") == 0) {
@@ -902,10 +1102,12 @@ static int shell_cmd_add(ClientData cd, Tcl_Interp *interp,
    char **globs LOCAL = NULL;
 
    if (objc < 3 || strcmp(Tcl_GetString(objv[1]), "wave") != 0)
-      goto usage;
+      return syntax_error(sh, objv);
    else if (!shell_has_model(sh))
       return TCL_ERROR;
 
+   SHELL_PAUSE(sh);
+
    int pos = 2;
    for (const char *opt; (opt = next_option(&pos, objc, objv)); ) {
       if (strcmp(opt, "-recursive") == 0 || strcmp(opt, "-r") == 0) {
@@ -1026,6 +1228,36 @@ static int shell_cmd_exit(ClientData cd, Tcl_Interp *interp,
    return syntax_error(sh, objv);
 }
 
+static const char deltas_help[] =
+   "Report delta cycle statistics for the current simulation\n"
+   "\n"
+   "Prints a histogram of the number of delta cycles in each time step\n"
+   "and the number of processes run in each cycle, followed by the time\n"
+   "steps with the most delta cycles and the processes active at the\n"
+   "end of each.\n"
+   "\n"
+   "Syntax:\n"
+   "  deltas\n";
+
+static int shell_cmd_deltas(ClientData cd, Tcl_Interp *interp,
+                            int objc, Tcl_Obj *const objv[])
+{
+   tcl_shell_t *sh = cd;
+
+   if (!shell_has_model(sh))
+      return TCL_ERROR;
+   else if (objc != 1)
+      return syntax_error(sh, objv);
+
+   SHELL_PAUSE(sh);
+
+   LOCAL_TEXT_BUF tb = tb_new();
+   model_delta_report(sh->model, tb);
+
+   shell_printf(sh, "%s", tb_get(tb));
+   return TCL_OK;
+}
+
 static const char help_help[] =
    "Display list of commands or detailed help\n"
    "\n"
@@ -1288,6 +1520,7 @@ tcl_shell_t *shell_new(jit_factory_t make_jit, unit_registry_t *registry)
    shell_add_cmd(sh, "noforce", shell_cmd_noforce, noforce_help);
    shell_add_cmd(sh, "echo", shell_cmd_echo, echo_help);
    shell_add_cmd(sh, "describe", shell_cmd_describe, describe_help);
+   shell_add_cmd(sh, "deltas", shell_cmd_deltas, deltas_help);
 
    qsort(sh->cmds, sh->ncmds, sizeof(shell_cmd_t), compare_shell_cmd);
 
@@ -1297,6 +1530,7 @@ tcl_shell_t *shell_new(jit_factory_t make_jit, unit_registry_t *registry)
 void shell_free(tcl_shell_t *sh)
 {
    if (sh->model != NULL) {
+      shell_stop_async(sh);
       model_free(sh->model);
       hash_free(sh->namemap);
       free(sh->signals);
@@ -32,7 +32,7 @@ typedef A(rt_scope_t *) scope_list_t;
 typedef A(rt_prop_t *) prop_list_t;
 
 typedef enum {
-   W_PROC, W_WATCH, W_IMPLICIT, W_PROPERTY, W_TRANSFER,
+   W_PROC, W_WATCH, W_IMPLICIT, W_PROPERTY, W_TRANSFER, W_PROP_GROUP,
 } wakeable_kind_t;
 
 typedef uint32_t wakeup_gen_t;
@@ -66,6 +66,7 @@ typedef struct _rt_proc {
    tree_t         where;
    ident_t        name;
    jit_handle_t   handle;
+   uint32_t       id;
    tlab_t        *tlab;
    rt_scope_t    *scope;
    mptr_t         privdata;
@@ -73,17 +74,25 @@ typedef struct _rt_proc {
 
 STATIC_ASSERT(sizeof(rt_proc_t) <= 128);
 
+typedef struct _rt_prop_group rt_prop_group_t;
+
 typedef struct _rt_prop {
-   rt_wakeable_t  wakeable;
-   psl_node_t     where;
-   ident_t        name;
-   jit_handle_t   handle;
-   rt_scope_t    *scope;
-   bit_mask_t     state;
-   bit_mask_t     newstate;
-   bool           strong;
+   rt_wakeable_t    wakeable;
+   psl_node_t       where;
+   ident_t          name;
+   jit_handle_t     handle;
+   rt_scope_t      *scope;
+   bit_mask_t       state;
+   bit_mask_t       newstate;
+   bool             strong;
+   rt_prop_group_t *group;
 } rt_prop_t;
 
+struct _rt_prop_group {
+   rt_wakeable_t  wakeable;
+   prop_list_t    members;
+};
+
 typedef union {
    uint8_t   bytes[8];
    uint64_t  qword;
@@ -214,6 +223,7 @@ typedef struct _rt_signal {
    nvc_lock_t    lock;
    uint32_t      offset;
    uint32_t      n_nexus;
+   uint32_t      id;
    rt_nexus_t    nexus;
    sig_shared_t  shared;
 } rt_signal_t;
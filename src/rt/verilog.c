@@ -19,6 +19,7 @@
 #include "jit/jit.h"
 #include "jit/jit-ffi.h"
 #include "rt/model.h"
+#include "rt/rt.h"
 #include "vlog/vlog-number.h"
 
 #include <assert.h>
@@ -134,6 +135,38 @@ void __nvc_sys_write(jit_scalar_t *args)
    fflush(stdout);
 }
 
+static void verilog_readmem(const char *what, int radix, jit_scalar_t *args)
+{
+   unsigned namelen, width;
+   const char *name = next_arg(&args, &namelen);
+   uint8_t *mem = (uint8_t *)next_arg(&args, &width);
+
+   const int64_t start = args[0].integer;
+   const int64_t finish = args[1].integer;
+
+   // Encoding of 0, 1, X, and Z as T_LOGIC
+   static const uint8_t enc[] = { 2, 3, 0, 1 };
+
+   // The destination is a single word until memories are supported
+   const int64_t depth = 1;
+
+   char *fname LOCAL = null_terminate((const uint8_t *)name, namelen);
+   read_mem_file(what, fname, radix, mem, width, depth,
+                 start < 0 ? 0 : start, finish < 0 ? depth - 1 : finish, enc);
+}
+
+DLLEXPORT
+void __nvc_sys_readmemh(jit_scalar_t *args)
+{
+   verilog_readmem("$readmemh", 16, args + 2);
+}
+
+DLLEXPORT
+void __nvc_sys_readmemb(jit_scalar_t *args)
+{
+   verilog_readmem("$readmemb", 2, args + 2);
+}
+
 void _verilog_init(void)
 {
    // Dummy function to force linking
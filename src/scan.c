@@ -38,17 +38,17 @@ typedef struct {
 
 typedef A(cond_state_t) cond_stack_t;
 
-static const char   *file_start;
-static size_t        file_sz;
-static const char   *read_ptr;
-static hdl_kind_t    src_kind;
-static file_ref_t    file_ref = FILE_INVALID;
-static int           colno;
-static int           lineno;
-static int           lookahead;
-static int           pperrors;
-static cond_stack_t  cond_stack;
-static shash_t      *pp_defines;
+static __thread const char   *file_start;
+static __thread size_t        file_sz;
+static __thread const char   *read_ptr;
+static __thread hdl_kind_t    src_kind;
+static __thread file_ref_t    file_ref = FILE_INVALID;
+static __thread int           colno;
+static __thread int           lineno;
+static __thread int           lookahead;
+static __thread int           pperrors;
+static __thread cond_stack_t  cond_stack;
+static shash_t               *pp_defines;
 
 extern int yylex(void);
 
@@ -57,8 +57,8 @@ extern void reset_scanner(void);
 static bool pp_cond_analysis_expr(void);
 static void pp_defines_init();
 
-yylval_t yylval;
-loc_t yylloc;
+__thread yylval_t yylval;
+__thread loc_t yylloc;
 
 void input_from_buffer(const char *buf, size_t len, hdl_kind_t kind)
 {
@@ -90,6 +90,18 @@ void input_from_buffer(const char *buf, size_t len, hdl_kind_t kind)
    }
 }
 
+void input_from_chunk(const char *buf, size_t len, hdl_kind_t kind,
+                      const loc_t *origin)
+{
+   // Scan part of a larger buffer with locations relative to the start
+   // of the original file
+   input_from_buffer(buf, len, kind);
+
+   file_ref = origin->file_ref;
+   lineno   = origin->first_line;
+   colno    = origin->first_column;
+}
+
 void input_from_file(const char *file)
 {
    // TODO: need a more sophisticated mechanism to determine HDL type
@@ -153,6 +165,12 @@ hdl_kind_t source_kind(void)
    return src_kind;
 }
 
+const char *source_buffer(size_t *len)
+{
+   *len = file_sz;
+   return file_start;
+}
+
 int get_next_char(char *b, int max_buffer)
 {
    const ptrdiff_t navail = file_start + file_sz - read_ptr;
@@ -184,7 +202,6 @@ void begin_token(char *tok, int length)
 
    const int last_col = first_col + length - 1;
 
-   extern loc_t yylloc;
    yylloc = get_loc(lineno, first_col, lineno, last_col, file_ref);
 }
 
@@ -193,7 +210,7 @@ const char *token_str(token_t tok)
    if (tok == tEOF)
       return "end of file";
    else if (tok < 128) {
-      static char buf[2];
+      static __thread char buf[2];
       buf[0] = tok;
       return buf;
    }
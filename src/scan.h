@@ -41,7 +41,10 @@ typedef int token_t;
 
 void input_from_file(const char *file);
 void input_from_buffer(const char *buf, size_t len, hdl_kind_t hdl);
+void input_from_chunk(const char *buf, size_t len, hdl_kind_t kind,
+                      const loc_t *origin);
 hdl_kind_t source_kind(void);
+const char *source_buffer(size_t *len);
 token_t processed_yylex(void);
 const char *token_str(token_t tok);
 void free_token(token_t tok, yylval_t *lval);
@@ -16,24 +16,28 @@
 //
 
 #include "util.h"
+#include "array.h"
 #include "diag.h"
 #include "ident.h"
 #include "scan.h"
+#include "thread.h"
 #include "sdf/sdf-phase.h"
 #include "sdf/sdf-util.h"
 
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <stdio.h>
 #include <math.h>
 
 // Lexer symbols
-extern yylval_t yylval;
-extern loc_t yylloc;
+extern __thread yylval_t yylval;
+extern __thread loc_t yylloc;
 
-// Global state, currently parsed file
-static sdf_file_t *sdf_file = NULL;
+// Per-thread state, currently parsed file
+static __thread sdf_file_t *sdf_file = NULL;
+static __thread sdf_cell_t *sdf_cell = NULL;
 
 ///////////////////////////////////////////////////////////////////////////////
 // TODO: The common parser functions and macros are copy-paste from VLOG parser.
@@ -72,7 +76,7 @@ typedef struct {
    loc_t       old_start_loc;
 } rule_state_t;
 
-static parse_state_t state;
+static __thread parse_state_t state;
 
 #define scan(...) _scan(1, __VA_ARGS__, -1)
 #define expect(...) _expect(1, __VA_ARGS__, -1)
@@ -128,7 +132,7 @@ static token_t peek_nth(int n)
       int next = (state.tokenq_head + 1) & (TOKENQ_SIZE - 1);
       assert(next != state.tokenq_tail);
 
-      extern yylval_t yylval;
+      extern __thread yylval_t yylval;
 
       state.tokenq[state.tokenq_head].token = token;
       state.tokenq[state.tokenq_head].lval  = yylval;
@@ -481,7 +485,7 @@ static void p_scalar_node(void)
    }
 }
 
-static void p_port_instance(void)
+static ident_t p_port_instance(void)
 {
    // port_instance ::=
    //       port
@@ -508,7 +512,7 @@ static void p_port_instance(void)
 
    BEGIN("port instance");
 
-   p_hierarchical_identifier();
+   ident_t id = p_hierarchical_identifier();
 
    if (optional(tLSQUARE)) {
       p_integer();
@@ -518,17 +522,19 @@ static void p_port_instance(void)
 
       consume(tRSQUARE);
    }
+
+   return id;
 }
 
 static void p_port_or_scalar_constant(void)
 {
    if (scan(tINT, tSCALARONE, tSCALARZERO))
-      return p_scalar_constant();
-
-   return p_port_instance();
+      p_scalar_constant();
+   else
+      p_port_instance();
 }
 
-static void p_port_edge(void)
+static ident_t p_port_edge(sdf_flags_t *flags)
 {
    // port_edge ::=
    //       ( edge_identifier port_instance )
@@ -538,14 +544,20 @@ static void p_port_edge(void)
    consume(tLPAREN);
 
    // TODO: Implement other edge identifier types!
-   one_of(tPOSEDGE, tNEGEDGE);
+   const sdf_flags_t edge =
+      one_of(tPOSEDGE, tNEGEDGE) == tPOSEDGE ? S_F_POSEDGE : S_F_NEGEDGE;
 
-   p_port_instance();
+   if (flags != NULL)
+      *flags |= edge;
+
+   ident_t id = p_port_instance();
 
    consume(tRPAREN);
+
+   return id;
 }
 
-static void p_port_spec(void)
+static ident_t p_port_spec(sdf_flags_t *flags)
 {
    // port_spec ::=
    //          port_instance
@@ -554,7 +566,7 @@ static void p_port_spec(void)
    BEGIN("port spec");
 
    if (scan(tLPAREN))
-      return p_port_edge();
+      return p_port_edge(flags);
 
    return p_port_instance();
 }
@@ -1015,7 +1027,17 @@ static void p_value(void)
    consume(tRPAREN);
 }
 
-static void p_signed_real_number_or_rtripple(void)
+static int64_t scale_value(double value, sdf_flags_t which)
+{
+   // Entries not selected by the min/typ/max specification are dropped
+   // here so later stages never need to consult the mask
+   if (!(sdf_file->min_max_spec & which))
+      return SDF_NO_VALUE;
+
+   return llround(value * sdf_file->unit_mult);
+}
+
+static sdf_value_t p_signed_real_number_or_rtripple(void)
 {
    // signed_real_number ::=
    //       [ sign ] real_number
@@ -1035,25 +1057,27 @@ static void p_signed_real_number_or_rtripple(void)
    if (scan(tCOLON) || peek_nth(2) == tCOLON || peek_nth(3) == tCOLON)
       is_rtripple = true;
 
+   sdf_value_t value = { SDF_NO_VALUE, SDF_NO_VALUE, SDF_NO_VALUE };
+
    if (is_rtripple) {
       bool number_present = false;
 
       if (not_at_token(tCOLON)) {
-         p_signed_real_number();
+         value.min = scale_value(p_signed_real_number(), S_F_MIN_VALUES);
          number_present = true;
       }
 
       consume(tCOLON);
 
       if (not_at_token(tCOLON)) {
-         p_signed_real_number();
+         value.typ = scale_value(p_signed_real_number(), S_F_TYP_VALUES);
          number_present = true;
       }
 
       consume(tCOLON);
 
       if (not_at_token(tRPAREN)) {
-         p_signed_real_number();
+         value.max = scale_value(p_signed_real_number(), S_F_MAX_VALUES);
          number_present = true;
       }
 
@@ -1061,13 +1085,18 @@ static void p_signed_real_number_or_rtripple(void)
          parse_error(&state.last_loc,
                      "'rtripple' shall have at least one number specified");
 
-      return;
+      return value;
    }
 
-   p_signed_real_number();
+   const double number = p_signed_real_number();
+   value.min = scale_value(number, S_F_MIN_VALUES);
+   value.typ = scale_value(number, S_F_TYP_VALUES);
+   value.max = scale_value(number, S_F_MAX_VALUES);
+
+   return value;
 }
 
-static void p_rvalue(void)
+static sdf_value_t p_rvalue(void)
 {
    // rvalue ::=
    //       ( [ signed_real_number ] )
@@ -1077,10 +1106,13 @@ static void p_rvalue(void)
 
    consume(tLPAREN);
 
+   sdf_value_t value = { SDF_NO_VALUE, SDF_NO_VALUE, SDF_NO_VALUE };
    if (not_at_token(tRPAREN))
-      p_signed_real_number_or_rtripple();
+      value = p_signed_real_number_or_rtripple();
 
    consume(tRPAREN);
+
+   return value;
 }
 
 static void p_name(void)
@@ -1232,7 +1264,7 @@ static void p_skew_constraint(void)
    consume(tLPAREN);
    consume(tSKEWCONSTR);
 
-   p_port_spec();
+   p_port_spec(NULL);
    p_value();
 
    consume(tRPAREN);
@@ -1249,7 +1281,7 @@ static void p_arrival_env(void)
    consume(tARRIVAL);
 
    if (scan(tLPAREN))
-      p_port_edge();
+      p_port_edge(NULL);
    p_port_instance();
 
    for (int i = 0; i < 4; i++)
@@ -1269,7 +1301,7 @@ static void p_departure_env(void)
    consume(tDEPARTURE);
 
    if (scan(tLPAREN))
-      p_port_edge();
+      p_port_edge(NULL);
 
    p_port_instance();
 
@@ -1371,7 +1403,7 @@ static void p_te_spec(void)
    consume(tRPAREN);
 }
 
-static void p_delval(void)
+static sdf_value_t p_delval(void)
 {
    // delval ::=
    //       rvalue
@@ -1384,21 +1416,24 @@ static void p_delval(void)
    if (peek_nth(2) == tLPAREN) {
       consume(tLPAREN);
 
-      if (scan(tLPAREN))
-         p_rvalue();
+      // Only the delay itself is kept: the optional pulse rejection
+      // and error limits are parsed but not stored
+      sdf_value_t value = p_rvalue();
       if (scan(tLPAREN))
          p_rvalue();
       if (scan(tLPAREN))
          p_rvalue();
 
       consume(tRPAREN);
+
+      return value;
    }
    // Single rvalue in delval
    else
-      p_rvalue();
+      return p_rvalue();
 }
 
-static void p_delval_list(void)
+static void p_delval_list(sdf_delay_t *delay)
 {
    // delval_list ::=
    //          delval
@@ -1410,8 +1445,13 @@ static void p_delval_list(void)
 
    BEGIN("delval list");
 
-   while (scan(tLPAREN))
-      p_delval();
+   while (scan(tLPAREN)) {
+      sdf_value_t value = p_delval();
+      if (delay != NULL) {
+         APUSH(sdf_cell->values, value);
+         delay->nvalues++;
+      }
+   }
 
    //   if (sdf_values(delay) > 12)
    //   parse_error(&state.last_loc,
@@ -1430,7 +1470,7 @@ static void p_lbl_def(sdf_flags_t flag)
    p_identifier();
 
    // Reuse delay for current label. Delvals are both "value" for these
-   p_delval_list();
+   p_delval_list(NULL);
 
    consume(tRPAREN);
 }
@@ -1490,14 +1530,12 @@ static void p_port_tchk(void)
          p_qstring();
 
       p_timing_check_condition();
-      p_port_spec();
+      p_port_spec(NULL);
 
       consume(tRPAREN);
-
-      return;
    }
-
-   return p_port_spec();
+   else
+      p_port_spec(NULL);
 }
 
 static void p_nochange_timing_check(void)
@@ -1790,7 +1828,18 @@ static void p_retain_def(void)
    return;
 }
 
-static void p_iopath_def(void)
+static sdf_delay_t begin_delay(sdf_delay_kind_t kind, sdf_flags_t flag)
+{
+   sdf_delay_t delay = {
+      .kind  = kind,
+      .flags = flag,
+      .first = sdf_cell->values.count,
+   };
+
+   return delay;
+}
+
+static void p_iopath_def(sdf_flags_t flag)
 {
    // iopath_def ::=
    //       ( IOPATH port_spec port_instance { retain_def } delval_list )
@@ -1800,18 +1849,22 @@ static void p_iopath_def(void)
    consume(tLPAREN);
    consume(tIOPATH);
 
-   p_port_spec();
-   p_port_instance();
+   sdf_delay_t delay = begin_delay(S_DELAY_IOPATH, flag);
+
+   delay.from = p_port_spec(&delay.flags);
+   delay.to = p_port_instance();
 
    if (peek_nth(2) == tRETAIN)
       p_retain_def();
 
-   p_delval_list();
+   p_delval_list(&delay);
+
+   APUSH(sdf_cell->delays, delay);
 
    consume(tRPAREN);
 }
 
-static void p_condelse_def(void)
+static void p_condelse_def(sdf_flags_t flag)
 {
    // condelse_def ::=
    //       ( CONDELSE iopath_def )
@@ -1821,12 +1874,12 @@ static void p_condelse_def(void)
    consume(tLPAREN);
    consume(tSDFCONDELSE);
 
-   p_iopath_def();
+   p_iopath_def(flag);
 
    consume(tRPAREN);
 }
 
-static void p_cond_def(void)
+static void p_cond_def(sdf_flags_t flag)
 {
    // cond_def ::=
    //       ( COND [ qstring ] conditional_port_expr iopath_def )
@@ -1841,12 +1894,12 @@ static void p_cond_def(void)
 
    p_conditional_port_expr();
 
-   p_iopath_def();
+   p_iopath_def(flag);
 
    consume(tRPAREN);
 }
 
-static void p_port_def(void)
+static void p_port_def(sdf_flags_t flag)
 {
    // port_def ::=
    //       ( PORT port_instance delval_list )
@@ -1856,14 +1909,18 @@ static void p_port_def(void)
    consume(tLPAREN);
    consume(tPORT);
 
-   p_port_instance();
+   sdf_delay_t delay = begin_delay(S_DELAY_PORT, flag);
+
+   delay.to = p_port_instance();
+
+   p_delval_list(&delay);
 
-   p_delval_list();
+   APUSH(sdf_cell->delays, delay);
 
    consume(tRPAREN);
 }
 
-static void p_interconnect_def(void)
+static void p_interconnect_def(sdf_flags_t flag)
 {
    // interconnect_def ::=
    //       ( INTERCONNECT port_instance port_instance delval_list )
@@ -1873,15 +1930,19 @@ static void p_interconnect_def(void)
    consume(tLPAREN);
    consume(tINTERCONNECT);
 
-   p_port_instance();
-   p_port_instance();
+   sdf_delay_t delay = begin_delay(S_DELAY_INTERCONNECT, flag);
+
+   delay.from = p_port_instance();
+   delay.to = p_port_instance();
+
+   p_delval_list(&delay);
 
-   p_delval_list();
+   APUSH(sdf_cell->delays, delay);
 
    consume(tRPAREN);
 }
 
-static void p_netdelay_def(void)
+static void p_netdelay_def(sdf_flags_t flag)
 {
    // netdelay_def ::=
    //       ( NETDELAY net_spec delval_list )
@@ -1891,14 +1952,18 @@ static void p_netdelay_def(void)
    consume(tLPAREN);
    consume(tNETDELAY);
 
-   p_port_spec();
+   sdf_delay_t delay = begin_delay(S_DELAY_NETDELAY, flag);
 
-   p_delval_list();
+   delay.to = p_port_spec(&delay.flags);
+
+   p_delval_list(&delay);
+
+   APUSH(sdf_cell->delays, delay);
 
    consume(tRPAREN);
 }
 
-static void p_device_def(void)
+static void p_device_def(sdf_flags_t flag)
 {
    // device_def ::=
    //       ( DEVICE [ port_instance ] delval_list )
@@ -1908,10 +1973,14 @@ static void p_device_def(void)
    consume(tLPAREN);
    consume(tDEVICE);
 
+   sdf_delay_t delay = begin_delay(S_DELAY_DEVICE, flag);
+
    if (scan(tID))
-      p_port_instance();
+      delay.to = p_port_instance();
 
-   p_delval_list();
+   p_delval_list(&delay);
+
+   APUSH(sdf_cell->delays, delay);
 
    consume(tRPAREN);
 }
@@ -1929,25 +1998,25 @@ static void p_deldef_list(sdf_flags_t flag)
 
       switch (tok) {
       case tIOPATH:
-         p_iopath_def();
+         p_iopath_def(flag);
          break;
       case tSDFCOND:
-         p_cond_def();
+         p_cond_def(flag);
          break;
       case tSDFCONDELSE:
-         p_condelse_def();
+         p_condelse_def(flag);
          break;
       case tPORT:
-         p_port_def();
+         p_port_def(flag);
          break;
       case tINTERCONNECT:
-         p_interconnect_def();
+         p_interconnect_def(flag);
          break;
       case tNETDELAY:
-         p_netdelay_def();
+         p_netdelay_def(flag);
          break;
       default: // tDEVICE
-         p_device_def();
+         p_device_def(flag);
       }
 
       tok = peek_nth(2);
@@ -2036,12 +2105,15 @@ static void p_cell(void)
    consume(tLPAREN);
    consume(tCELLTYPE);
 
-   p_qstring();
+   ident_t celltype = p_qstring();
 
    consume(tRPAREN);
 
    // cell_instance
-   p_cell_instance();
+   ident_t instance = p_cell_instance();
+
+   // Cells with equal instance (or celltype for wildcards) are merged
+   sdf_cell = sdf_get_cell(sdf_file, celltype, instance);
 
    // { timing_spec }
    int tok = peek_nth(2);
@@ -2065,6 +2137,8 @@ static void p_cell(void)
       tok = peek_nth(2);
    }
 
+   sdf_cell = NULL;
+
    consume(tRPAREN);
 }
 
@@ -2281,7 +2355,207 @@ static void p_sdf_header(void)
       p_timescale();
 }
 
-static sdf_file_t *p_delay_file(const char *file, sdf_flags_t min_max_spec)
+///////////////////////////////////////////////////////////////////////////////
+// Parallel parsing of cells
+///////////////////////////////////////////////////////////////////////////////
+
+// Files smaller than two chunks are parsed on a single thread
+#define SDF_CHUNK_SIZE (1 << 20)
+
+typedef struct {
+   const char *start;
+   size_t      len;
+   loc_t       origin;
+   sdf_file_t *result;
+} sdf_chunk_t;
+
+typedef A(sdf_chunk_t) chunk_list_t;
+
+typedef struct {
+   size_t       header_len;
+   chunk_list_t cells;
+   sdf_chunk_t  trailer;
+} sdf_split_t;
+
+static bool is_cell_keyword(const char *p, const char *end)
+{
+   while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+      p++;
+
+   if (end - p < 4 || strncasecmp(p, "cell", 4) != 0)
+      return false;
+   else if (p + 4 == end)
+      return true;
+
+   const char next = p[4];
+   return !isalnum_iso88591(next) && next != '_' && next != '$';
+}
+
+static bool split_cells(const char *buf, size_t len, file_ref_t file_ref,
+                        sdf_split_t *split)
+{
+   // Find the top-level CELL entries without tokenising the file so
+   // that groups of whole cells can be parsed on separate threads.
+   // Anything unusual is left to the serial parser to report.
+   const char *const end = buf + len;
+   const char *first = NULL, *last = NULL, *chunk = NULL;
+   int depth = 0, line = 1, column = 0, last_line = 0, last_column = 0;
+
+   for (const char *p = buf; p < end; p++, column++) {
+      switch (*p) {
+      case '\n':
+         line++;
+         column = -1;
+         break;
+
+      case '"':
+         {
+            const char *q = p + 1;
+            while (q < end && *q != '"' && *q != '\n')
+               q++;
+
+            if (q < end && *q == '"') {
+               column += q - p;
+               p = q;
+            }
+         }
+         break;
+
+      case '/':
+         if (p + 1 < end && p[1] == '/') {
+            for (; p + 1 < end && p[1] != '\n'; p++, column++)
+               ;
+         }
+         else if (p + 1 < end && p[1] == '*') {
+            for (p += 2, column += 2;
+                 p + 1 < end && (p[0] != '*' || p[1] != '/'); p++) {
+               if (*p == '\n') {
+                  line++;
+                  column = 0;
+               }
+               else
+                  column++;
+            }
+
+            if (p + 1 >= end)
+               goto fallback;
+
+            p++;
+            column++;
+         }
+         break;
+
+      case '(':
+         if (++depth != 2)
+            break;
+         else if (!is_cell_keyword(p + 1, end)) {
+            if (first != NULL)
+               goto fallback;   // Not a cell after the first cell
+            break;
+         }
+         else if (first == NULL)
+            first = p;
+
+         if (chunk == NULL || p - chunk >= SDF_CHUNK_SIZE) {
+            if (chunk != NULL)
+               ATOP(split->cells).len = p - chunk;
+
+            sdf_chunk_t new = {
+               .start  = p,
+               .origin = get_loc(line, column, line, column, file_ref),
+            };
+            APUSH(split->cells, new);
+
+            chunk = p;
+         }
+         break;
+
+      case ')':
+         if (--depth < 0)
+            goto fallback;
+         else if (depth == 1 && first != NULL) {
+            last = p + 1;
+            last_line = line;
+            last_column = column + 1;
+         }
+         break;
+      }
+   }
+
+   if (depth != 0 || split->cells.count < 2)
+      goto fallback;
+
+   ATOP(split->cells).len = last - chunk;
+
+   split->header_len = first - buf;
+   split->trailer.start = last;
+   split->trailer.len = end - last;
+   split->trailer.origin =
+      get_loc(last_line, last_column, last_line, last_column, file_ref);
+
+   return true;
+
+ fallback:
+   ACLEAR(split->cells);
+   return false;
+}
+
+static void parse_chunk_cb(void *context, void *arg)
+{
+   const sdf_file_t *header = context;
+   sdf_chunk_t *chunk = arg;
+
+   // May run on the main thread if there are no worker threads
+   sdf_file_t *const saved_file = sdf_file;
+   const parse_state_t saved_state = state;
+
+   sdf_file = chunk->result = sdf_file_new(1024, 16);
+
+   sdf_file->std          = header->std;
+   sdf_file->unit_mult    = header->unit_mult;
+   sdf_file->hchar        = header->hchar;
+   sdf_file->hchar_other  = header->hchar_other;
+   sdf_file->min_max_spec = header->min_max_spec;
+
+   input_from_chunk(chunk->start, chunk->len, SOURCE_SDF, &chunk->origin);
+   scan_as_sdf();
+
+   state.hint_str  = "delay file";
+   state.start_loc = LOC_INVALID;
+   state.n_correct = RECOVER_THRESH;
+
+   while (peek_nth(2) == tCELL)
+      p_cell();
+
+   if (peek() != tEOF)
+      consume(tRPAREN);
+
+   sdf_file = saved_file;
+   state = saved_state;
+}
+
+static void parse_cells_parallel(sdf_split_t *split)
+{
+   workq_t *wq = workq_new(sdf_file);
+
+   for (int i = 0; i < split->cells.count; i++)
+      workq_do(wq, parse_chunk_cb, &(split->cells.items[i]));
+
+   workq_start(wq);
+   workq_drain(wq);
+   workq_free(wq);
+
+   // Merge in file order so delays for the same cell keep their order
+   for (int i = 0; i < split->cells.count; i++)
+      sdf_file_merge(sdf_file, split->cells.items[i].result);
+
+   input_from_chunk(split->trailer.start, split->trailer.len, SOURCE_SDF,
+                    &split->trailer.origin);
+   scan_as_sdf();
+}
+
+static sdf_file_t *p_delay_file(const char *file, sdf_flags_t min_max_spec,
+                                sdf_split_t *split)
 {
    // delay_file ::=
    //       ( DELAYFILE sdf_header cell { cell } )
@@ -2298,8 +2572,12 @@ static sdf_file_t *p_delay_file(const char *file, sdf_flags_t min_max_spec)
 
    p_sdf_header();
 
-   while (peek_nth(2) == tCELL)
-      p_cell();
+   if (split != NULL)
+      parse_cells_parallel(split);
+   else {
+      while (peek_nth(2) == tCELL)
+         p_cell();
+   }
 
    consume(tRPAREN);
 
@@ -2319,7 +2597,21 @@ sdf_file_t *sdf_parse(const char *file, sdf_flags_t min_max_spec)
    if (peek() == tEOF)
       return NULL;
 
-   return p_delay_file(file, min_max_spec);
+   size_t len;
+   const char *buf = source_buffer(&len);
+
+   sdf_split_t split = {};
+   if (!split_cells(buf, len, yylloc.file_ref, &split))
+      return p_delay_file(file, min_max_spec, NULL);
+
+   // Only the header is parsed on this thread before the cells are
+   // handed out to workers
+   input_from_buffer(buf, split.header_len, SOURCE_SDF);
+   scan_as_sdf();
+
+   sdf_file_t *result = p_delay_file(file, min_max_spec, &split);
+   ACLEAR(split.cells);
+   return result;
 }
 
 void reset_sdf_parser(void)
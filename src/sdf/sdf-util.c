@@ -16,7 +16,9 @@
 //
 
 #include "util.h"
+#include "array.h"
 #include "hash.h"
+#include "ident.h"
 #include "sdf/sdf-util.h"
 
 #include <stdlib.h>
@@ -31,10 +33,115 @@ sdf_file_t *sdf_file_new(int exp_hier_cells, int exp_wild_cells)
    return sdf_file;
 }
 
+static void sdf_free_cells(hash_t *map)
+{
+   const void *key;
+   void *value;
+   hash_iter_t it = HASH_BEGIN;
+   while (hash_iter(map, &it, &key, &value)) {
+      sdf_cell_t *cell = value;
+      ACLEAR(cell->delays);
+      ACLEAR(cell->values);
+      free(cell);
+   }
+}
+
 void sdf_file_free(sdf_file_t *sdf_file)
 {
+   sdf_free_cells(sdf_file->name_map);
+   sdf_free_cells(sdf_file->hier_map);
+
    hash_free(sdf_file->name_map);
    hash_free(sdf_file->hier_map);
 
    free(sdf_file);
 }
+
+static void sdf_merge_cells(hash_t *to, hash_t *from)
+{
+   const void *key;
+   void *value;
+   hash_iter_t it = HASH_BEGIN;
+   while (hash_iter(from, &it, &key, &value)) {
+      sdf_cell_t *cell = value, *exist = hash_get(to, key);
+      if (exist == NULL) {
+         hash_put(to, key, cell);
+         continue;
+      }
+
+      const unsigned base = exist->values.count;
+      for (int i = 0; i < cell->delays.count; i++) {
+         sdf_delay_t d = cell->delays.items[i];
+         d.first += base;
+         APUSH(exist->delays, d);
+      }
+
+      for (int i = 0; i < cell->values.count; i++)
+         APUSH(exist->values, cell->values.items[i]);
+
+      ACLEAR(cell->delays);
+      ACLEAR(cell->values);
+      free(cell);
+   }
+}
+
+void sdf_file_merge(sdf_file_t *sdf_file, sdf_file_t *other)
+{
+   // Cells from other are appended after any existing entries for the
+   // same key and other is freed
+   sdf_merge_cells(sdf_file->hier_map, other->hier_map);
+   sdf_merge_cells(sdf_file->name_map, other->name_map);
+
+   hash_free(other->name_map);
+   hash_free(other->hier_map);
+
+   free(other);
+}
+
+static ident_t sdf_strip_quotes(ident_t id)
+{
+   // The CELLTYPE qstring is stored including the quotes
+   const size_t len = ident_len(id);
+   if (len < 2 || ident_char(id, 0) != '"' || ident_char(id, len - 1) != '"')
+      return id;
+
+   char *tmp LOCAL = xstrndup(istr(id) + 1, len - 2);
+   return ident_new(tmp);
+}
+
+sdf_cell_t *sdf_get_cell(sdf_file_t *sdf, ident_t celltype, ident_t instance)
+{
+   celltype = sdf_strip_quotes(celltype);
+
+   hash_t *map = sdf->hier_map;
+   ident_t key = instance;
+
+   if (instance == NULL)
+      key = celltype;
+   else if (instance == ident_new("*")) {
+      map = sdf->name_map;
+      key = celltype;
+   }
+
+   sdf_cell_t *cell = hash_get(map, key);
+   if (cell == NULL) {
+      cell = xcalloc(sizeof(sdf_cell_t));
+      cell->celltype = celltype;
+      cell->instance = instance;
+
+      hash_put(map, key, cell);
+   }
+
+   return cell;
+}
+
+sdf_cell_t *sdf_find_cell(sdf_file_t *sdf, ident_t celltype, ident_t hier)
+{
+   celltype = sdf_strip_quotes(celltype);
+
+   sdf_cell_t *cell = hash_get(sdf->hier_map, hier ?: celltype);
+   if (cell != NULL)
+      return cell;
+
+   return hash_get(sdf->name_map, celltype);
+}
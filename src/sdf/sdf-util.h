@@ -19,6 +19,7 @@
 #define _SDF_UTIL_H
 
 #include "prim.h"
+#include "array.h"
 
 //
 // SDF standard revisions
@@ -120,6 +121,45 @@ typedef enum {
    S_BINARY_EXPR_NONE
 } sdf_binary_expr_kind_t;
 
+typedef enum {
+   S_DELAY_IOPATH,
+   S_DELAY_PORT,
+   S_DELAY_INTERCONNECT,
+   S_DELAY_NETDELAY,
+   S_DELAY_DEVICE
+} sdf_delay_kind_t;
+
+// Marks a missing or filtered out entry of a triple
+#define SDF_NO_VALUE INT64_MIN
+
+typedef struct {
+   int64_t min;
+   int64_t typ;
+   int64_t max;
+} sdf_value_t;
+
+// One delay definition from a DELAY timing specification. The values
+// for each delval are stored contiguously in the owning cell's value
+// table starting at "first" and are converted into fs.
+typedef struct {
+   sdf_delay_kind_t kind;
+   sdf_flags_t      flags;
+   ident_t          from;
+   ident_t          to;
+   unsigned         first;
+   unsigned         nvalues;
+} sdf_delay_t;
+
+typedef A(sdf_delay_t) sdf_delay_array_t;
+typedef A(sdf_value_t) sdf_value_array_t;
+
+typedef struct {
+   ident_t           celltype;
+   ident_t           instance;
+   sdf_delay_array_t delays;
+   sdf_value_array_t values;
+} sdf_cell_t;
+
 struct _sdf_file {
    // SDF standard
    sdf_std_t   std;
@@ -132,6 +172,7 @@ struct _sdf_file {
    char        hchar_other;
 
    // hier_map: Hierarchy -> Cell map
+   //           (cells with empty INSTANCE are keyed by celltype)
    // name_map: Cell name -> Cell map (for wildcards)
    // Each cell is placed in only one of these two hash tables.
    // Duplicities are prevented by looking up cells in the hash tables before
@@ -156,5 +197,9 @@ struct _sdf_file {
 
 sdf_file_t *sdf_file_new(int exp_hier_cells, int exp_wild_cells);
 void sdf_file_free(sdf_file_t *sdf);
+void sdf_file_merge(sdf_file_t *sdf, sdf_file_t *other);
+
+sdf_cell_t *sdf_get_cell(sdf_file_t *sdf, ident_t celltype, ident_t instance);
+sdf_cell_t *sdf_find_cell(sdf_file_t *sdf, ident_t celltype, ident_t hier);
 
 #endif  // _SDF_UTIL_H
@@ -16,6 +16,7 @@
 //
 
 #include "util.h"
+#include "array.h"
 #include "hash.h"
 #include "ident.h"
 #include "jit/jit.h"
@@ -89,6 +90,7 @@ typedef struct _web_socket {
    size_t        rx_wptr;
    size_t        rx_rptr;
    uint8_t      *rx_buf;
+   nvc_lock_t    tx_lock;
 } web_socket_t;
 
 typedef struct _packet_buf {
@@ -116,11 +118,28 @@ typedef struct _debug_server {
    tree_t                top;
    packet_buf_t         *packetbuf;
    const char           *init_cmd;
+   nvc_lock_t            lock;
 } debug_server_t;
 
+typedef struct {
+   ident_t  path;
+   char    *pending;
+   char    *last;
+} wave_slot_t;
+
 typedef struct {
    debug_server_t  server;
    web_socket_t   *websocket;
+   hash_t         *wavemap;
+   A(wave_slot_t)  waves;
+   A(uint32_t)     dirty;
+   uint64_t        dirty_time;
+   uint64_t        window;
+   uint64_t        last_time;
+   uint64_t        min_interval;
+   uint64_t        last_stamp;
+   uint64_t        step_time;
+   bool            step_pending;
 } http_server_t;
 
 typedef struct {
@@ -169,6 +188,8 @@ static void ws_queue_buf(web_socket_t *ws, const void *data, size_t size)
 
 static void ws_send(web_socket_t *ws, int opcode, const void *data, size_t size)
 {
+   SCOPED_LOCK(ws->tx_lock);
+
    const uint8_t size0 = (size < 126 ? size : (size <= UINT16_MAX ? 126 : 127));
 
    const uint8_t header[2] = {
@@ -231,6 +252,8 @@ void ws_send_ping(web_socket_t *ws, const void *data, size_t size)
 
 void ws_flush(web_socket_t *ws)
 {
+   SCOPED_LOCK(ws->tx_lock);
+
    while (ws->tx_wptr != ws->tx_rptr) {
       const size_t chunksz = ws->tx_wptr - ws->tx_rptr;
       const ssize_t nbytes =
@@ -604,12 +627,32 @@ static void send_file(int fd, const char *file, const char *mime)
 }
 #endif
 
+static uint64_t unpack_be(const uint8_t *data, int nbytes)
+{
+   uint64_t value = 0;
+   for (int i = 0; i < nbytes; i++)
+      value = (value << 8) | data[i];
+   return value;
+}
+
+static void sync_wave_state(http_server_t *http);
+
 static void handle_text_frame(web_socket_t *ws, const char *text, void *context)
 {
    debug_server_t *server = context;
+   http_server_t *http = container_of(server, http_server_t, server);
 
    const char *result = NULL;
-   if (shell_eval(server->shell, text, &result) && *result != '\0')
+   const bool ok = shell_eval(server->shell, text, &result);
+
+   // Anything still held back by the rate limit must reach the client
+   // before control returns to it
+   if (http->websocket != NULL) {
+      SCOPED_LOCK(server->lock);
+      sync_wave_state(http);
+   }
+
+   if (ok && *result != '\0')
       ws_send_text(ws, result);
 }
 
@@ -623,11 +666,25 @@ static void handle_binary_frame(web_socket_t *ws, const void *data,
       return;
    }
 
-   const c2s_opcode_t op = *(const uint8_t *)data;
+   const uint8_t *bytes = data;
+   const c2s_opcode_t op = bytes[0];
    switch (op) {
    case C2S_SHUTDOWN:
       server->shutdown = true;
       break;
+   case C2S_SET_UPDATE_RATE:
+      {
+         if (length != 13) {
+            server_log(LOG_ERROR, "malformed update rate packet");
+            break;
+         }
+
+         http_server_t *http = container_of(server, http_server_t, server);
+         SCOPED_LOCK(server->lock);
+         http->window = unpack_be(bytes + 1, 8);
+         http->min_interval = unpack_be(bytes + 9, 4) * 1000;
+      }
+      break;
    default:
       server_log(LOG_ERROR, "unhandled client to server opcode %02x", op);
       break;
@@ -638,6 +695,8 @@ static void kill_http_connection(http_server_t *http)
 {
    diag_set_consumer(NULL, NULL);
 
+   SCOPED_LOCK(http->server.lock);
+
    closesocket(http->websocket->sock);
 
    ws_free(http->websocket);
@@ -648,6 +707,9 @@ static void tunnel_diag(diag_t *d, void *context)
 {
    http_server_t *http = container_of(context, http_server_t, server);
 
+   // May be called from the simulation thread during a background run
+   SCOPED_LOCK(http->server.lock);
+
    if (http->websocket != NULL) {
       ws_send_text(http->websocket, diag_get_text(d));
    }
@@ -658,12 +720,18 @@ static void tunnel_diag(diag_t *d, void *context)
 static void tunnel_output(const char *buf, size_t nchars, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
+
+   if (http->websocket == NULL)
+      return;
+
    ws_send(http->websocket, WS_OPCODE_TEXT_FRAME, buf, nchars);
 }
 
 static void tunnel_backchannel(const char *buf, size_t nchars, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
 
    packet_buf_t *pb = fresh_packet_buffer(&(http->server));
    pb_pack_u8(pb, S2C_BACKCHANNEL);
@@ -672,12 +740,125 @@ static void tunnel_backchannel(const char *buf, size_t nchars, void *user)
    ws_send_packet(http->websocket, pb);
 }
 
+static void reset_waves(http_server_t *http)
+{
+   for (int i = 0; i < http->waves.count; i++) {
+      free(http->waves.items[i].pending);
+      free(http->waves.items[i].last);
+   }
+
+   ACLEAR(http->waves);
+   ACLEAR(http->dirty);
+
+   if (http->wavemap != NULL) {
+      hash_free(http->wavemap);
+      http->wavemap = NULL;
+   }
+
+   http->last_time = 0;
+   http->last_stamp = 0;
+   http->step_pending = false;
+}
+
+static void flush_signal_updates(http_server_t *http)
+{
+   if (http->dirty.count == 0)
+      return;
+
+   packet_buf_t *pb = fresh_packet_buffer(&(http->server));
+   pb_pack_u8(pb, S2C_SIGNAL_UPDATE);
+   pb_pack_u64(pb, http->dirty_time);
+
+   const size_t countpos = pb->wptr;
+   pb_pack_u32(pb, 0);
+
+   // Only send signals whose value differs from what the client last
+   // saw: a glitch that returns to the old value within one window is
+   // not interesting to the waveform viewer
+   uint32_t count = 0;
+   for (int i = 0; i < http->dirty.count; i++) {
+      const uint32_t id = http->dirty.items[i];
+      wave_slot_t *w = AREF(http->waves, id);
+      assert(w->pending != NULL);
+
+      if (w->last == NULL || strcmp(w->last, w->pending) != 0) {
+         pb_pack_u32(pb, id);
+         pb_pack_str(pb, w->pending);
+         count++;
+      }
+
+      free(w->last);
+      w->last = w->pending;
+      w->pending = NULL;
+   }
+
+   ACLEAR(http->dirty);
+
+   if (count > 0) {
+      const size_t wptr = pb->wptr;
+      pb->wptr = countpos;
+      pb_pack_u32(pb, count);
+      pb->wptr = wptr;
+
+      ws_send_packet(http->websocket, pb);
+   }
+}
+
+static void send_time_step(http_server_t *http, uint64_t now)
+{
+   packet_buf_t *pb = fresh_packet_buffer(&(http->server));
+   pb_pack_u8(pb, S2C_NEXT_TIME_STEP);
+   pb_pack_u64(pb, now);
+   ws_send_packet(http->websocket, pb);
+
+   http->last_time = now;
+   http->last_stamp = get_timestamp_us();
+   http->step_pending = false;
+}
+
+static bool should_flush_updates(http_server_t *http, uint64_t now)
+{
+   if (http->window > 0 && now - http->last_time < http->window)
+      return false;
+   else if (http->min_interval > 0
+            && get_timestamp_us() - http->last_stamp < http->min_interval)
+      return false;
+   else
+      return true;
+}
+
+static void sync_wave_state(http_server_t *http)
+{
+   flush_signal_updates(http);
+
+   if (http->step_pending)
+      send_time_step(http, http->step_time);
+}
+
 static void add_wave_handler(ident_t path, const char *enc, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
+
+   if (http->wavemap == NULL)
+      http->wavemap = hash_new(128);
+
+   uint32_t id = (uintptr_t)hash_get(http->wavemap, path);
+   if (id == 0) {
+      wave_slot_t slot = { .path = path };
+      APUSH(http->waves, slot);
+
+      hash_put(http->wavemap, path, (void *)(uintptr_t)http->waves.count);
+      id = http->waves.count;
+   }
+
+   wave_slot_t *w = AREF(http->waves, id - 1);
+   free(w->last);
+   w->last = xstrdup(enc);
 
    packet_buf_t *pb = fresh_packet_buffer(&(http->server));
    pb_pack_u8(pb, S2C_ADD_WAVE);
+   pb_pack_u32(pb, id - 1);
    pb_pack_ident(pb, path);
    pb_pack_str(pb, enc);
    ws_send_packet(http->websocket, pb);
@@ -687,17 +868,29 @@ static void signal_update_handler(ident_t path, uint64_t now, rt_signal_t *s,
                                   const char *enc, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
 
-   packet_buf_t *pb = fresh_packet_buffer(&(http->server));
-   pb_pack_u8(pb, S2C_SIGNAL_UPDATE);
-   pb_pack_ident(pb, path);
-   pb_pack_str(pb, enc);
-   ws_send_packet(http->websocket, pb);
+   if (http->wavemap == NULL)
+      return;
+
+   const uint32_t id = (uintptr_t)hash_get(http->wavemap, path);
+   if (id == 0)
+      return;   // Added by a previous connection
+
+   wave_slot_t *w = AREF(http->waves, id - 1);
+   if (w->pending == NULL)
+      APUSH(http->dirty, id - 1);
+   else
+      free(w->pending);
+
+   w->pending = xstrdup(enc);
+   http->dirty_time = now;
 }
 
 static void start_sim_handler(ident_t top, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
 
    packet_buf_t *pb = fresh_packet_buffer(&(http->server));
    pb_pack_u8(pb, S2C_START_SIM);
@@ -708,6 +901,20 @@ static void start_sim_handler(ident_t top, void *user)
 static void restart_sim_handler(void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
+
+   // Signal IDs remain valid across a restart but the client discards
+   // all the values it has seen
+   for (int i = 0; i < http->waves.count; i++) {
+      wave_slot_t *w = &(http->waves.items[i]);
+      free(w->pending);
+      free(w->last);
+      w->pending = w->last = NULL;
+   }
+
+   ACLEAR(http->dirty);
+   http->last_time = 0;
+   http->step_pending = false;
 
    packet_buf_t *pb = fresh_packet_buffer(&(http->server));
    pb_pack_u8(pb, S2C_RESTART_SIM);
@@ -717,6 +924,9 @@ static void restart_sim_handler(void *user)
 static void quit_sim_handler(void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
+
+   reset_waves(http);
 
    packet_buf_t *pb = fresh_packet_buffer(&(http->server));
    pb_pack_u8(pb, S2C_QUIT_SIM);
@@ -726,11 +936,19 @@ static void quit_sim_handler(void *user)
 static void next_time_step_handler(uint64_t now, void *user)
 {
    http_server_t *http = container_of(user, http_server_t, server);
+   SCOPED_LOCK(http->server.lock);
 
-   packet_buf_t *pb = fresh_packet_buffer(&(http->server));
-   pb_pack_u8(pb, S2C_NEXT_TIME_STEP);
-   pb_pack_u64(pb, now);
-   ws_send_packet(http->websocket, pb);
+   if (http->websocket == NULL)
+      return;   // Connection closed during background run
+
+   if (should_flush_updates(http, now)) {
+      flush_signal_updates(http);
+      send_time_step(http, now);
+   }
+   else {
+      http->step_pending = true;
+      http->step_time = now;
+   }
 }
 
 static void open_websocket(http_server_t *http, int fd)
@@ -747,7 +965,15 @@ static void open_websocket(http_server_t *http, int fd)
       .context      = &(http->server)
    };
 
-   http->websocket = ws_new(fd, &handler, false);
+   {
+      SCOPED_LOCK(http->server.lock);
+
+      http->websocket = ws_new(fd, &handler, false);
+
+      reset_waves(http);
+      http->window = 0;
+      http->min_interval = 0;
+   }
 
    diag_set_consumer(tunnel_diag, &(http->server));
 
@@ -758,6 +984,8 @@ static void open_websocket(http_server_t *http, int fd)
       shell_reset(http->server.shell, http->server.top);
 
    if (http->server.init_cmd != NULL) {
+      SCOPED_LOCK(http->server.lock);
+
       packet_buf_t *pb = fresh_packet_buffer(&(http->server));
       pb_pack_u8(pb, S2C_INIT_CMD);
       pb_pack_str(pb, http->server.init_cmd);
@@ -1020,6 +1248,8 @@ static int http_fill_fd_set(debug_server_t *server, fd_set *rfd, fd_set *wfd)
 
    FD_SET(http->websocket->sock, rfd);
 
+   SCOPED_LOCK(http->websocket->tx_lock);
+
    if (http->websocket->tx_wptr != http->websocket->tx_rptr)
       FD_SET(http->websocket->sock, wfd);
 
@@ -1061,6 +1291,7 @@ static void http_server_free(debug_server_t *server)
 {
    http_server_t *http = container_of(server, http_server_t, server);
    assert(http->websocket == NULL);
+   reset_waves(http);
    free(http);
 }
 
@@ -27,8 +27,19 @@ typedef struct _web_socket web_socket_t;
 
 typedef enum {
    C2S_SHUTDOWN = 0x00,
+   C2S_SET_UPDATE_RATE = 0x01,
 } c2s_opcode_t;
 
+// C2S_SET_UPDATE_RATE carries a 64-bit simulation time window in
+// femtoseconds followed by a 32-bit minimum wall-clock interval in
+// milliseconds.  Signal updates and time steps are held back until both
+// have elapsed since the last frame sent.
+//
+// S2C_ADD_WAVE assigns a 32-bit ID to each signal path which is used
+// instead of the path in S2C_SIGNAL_UPDATE frames.  Each such frame
+// carries the 64-bit time followed by a 32-bit count of (ID, value)
+// pairs for every signal that changed since the previous frame.
+
 typedef enum {
    S2C_ADD_WAVE = 0x00,
    S2C_SIGNAL_UPDATE = 0x01,
@@ -133,7 +133,7 @@ typedef struct {
    int                parked;
 } __attribute__((aligned(64))) parking_bay_t;
 
-typedef bool (*park_fn_t)(parking_bay_t *, void *);
+typedef bool (*park_fn_t)(parking_bay_t *, void *, void *);
 typedef void (*unpark_fn_t)(parking_bay_t *, void *);
 
 typedef struct {
@@ -655,13 +655,13 @@ static inline parking_bay_t *parking_bay_for(void *cookie)
    return &(parking_bays[mix_bits_64(cookie) % PARKING_BAYS]);
 }
 
-static void thread_park(void *cookie, park_fn_t fn)
+static void thread_park(void *cookie, park_fn_t fn, void *arg)
 {
    parking_bay_t *bay = parking_bay_for(cookie);
 
    platform_mutex_lock(&(bay->mutex));
    {
-      if ((*fn)(bay, cookie)) {
+      if ((*fn)(bay, cookie, arg)) {
          bay->parked++;
          platform_cond_wait(&(bay->cond), &(bay->mutex));
          assert(bay->parked > 0);
@@ -699,7 +699,7 @@ void spin_wait(void)
 #endif
 }
 
-static bool lock_park_cb(parking_bay_t *bay, void *cookie)
+static bool lock_park_cb(parking_bay_t *bay, void *cookie, void *arg)
 {
    nvc_lock_t *lock = cookie;
 
@@ -745,7 +745,7 @@ void nvc_lock(nvc_lock_t *lock)
          atomic_cas(lock, IS_LOCKED, IS_LOCKED | HAS_PARKED);
 
          LOCK_EVENT(parks, 1);
-         thread_park(lock, lock_park_cb);
+         thread_park(lock, lock_park_cb, NULL);
 
          if ((state = relaxed_load(lock)) & IS_LOCKED) {
             // Someone else grabbed the lock before our thread was unparked
@@ -801,6 +801,40 @@ void __scoped_unlock(nvc_lock_t **plock)
    nvc_unlock(*plock);
 }
 
+static bool cond_park_cb(parking_bay_t *bay, void *cookie, void *arg)
+{
+   nvc_cond_t *cond = cookie;
+
+   // This is called with the park mutex held: only sleep if there has
+   // been no notification since the waiter released its lock
+   return relaxed_load(cond) == *(nvc_cond_t *)arg;
+}
+
+static void cond_unpark_cb(parking_bay_t *bay, void *cookie)
+{
+   // Bump the generation with the park mutex held so a waiter cannot
+   // miss it between the check in cond_park_cb and going to sleep
+   nvc_cond_t *cond = cookie;
+   atomic_add(cond, 1);
+}
+
+void nvc_cond_wait(nvc_cond_t *cond, nvc_lock_t *lock)
+{
+   assert_lock_held(lock);
+
+   nvc_cond_t generation = relaxed_load(cond);
+
+   nvc_unlock(lock);
+   thread_park(cond, cond_park_cb, &generation);
+   nvc_lock(lock);
+}
+
+void nvc_cond_notify_all(nvc_cond_t *cond)
+{
+   thread_unpark(cond, cond_unpark_cb);
+}
+
+
 static void push_bot(threadq_t *tq, const task_t *tasks, size_t count)
 {
    const abp_idx_t bot = relaxed_load(&tq->bot);
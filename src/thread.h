@@ -88,6 +88,11 @@ void __scoped_unlock(nvc_lock_t **plock);
    nvc_lock_t *UNIQUE(__lock) = &(lock);                \
    nvc_lock(&(lock));
 
+typedef int32_t nvc_cond_t;
+
+void nvc_cond_wait(nvc_cond_t *cond, nvc_lock_t *lock);
+void nvc_cond_notify_all(nvc_cond_t *cond);
+
 typedef struct _workq workq_t;
 
 typedef void (*task_fn_t)(void *, void *);
@@ -396,6 +396,13 @@ static void vlog_dump_gate_inst(vlog_node_t v, int indent)
    print_syntax(");\n");
 }
 
+static void vlog_dump_gate_group(vlog_node_t v, int indent)
+{
+   const int nstmts = vlog_stmts(v);
+   for (int i = 0; i < nstmts; i++)
+      vlog_dump(vlog_stmt(v, i), indent);
+}
+
 static void vlog_dump_mod_inst(vlog_node_t v, int indent)
 {
    tab(indent);
@@ -524,6 +531,9 @@ void vlog_dump(vlog_node_t v, int indent)
    case V_GATE_INST:
       vlog_dump_gate_inst(v, indent);
       break;
+   case V_GATE_GROUP:
+      vlog_dump_gate_group(v, indent);
+      break;
    case V_MOD_INST:
       vlog_dump_mod_inst(v, indent);
       break;
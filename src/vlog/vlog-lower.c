@@ -37,6 +37,9 @@
                vlog_kind_str(vlog_kind(v)), __FUNCTION__);              \
    } while (0)
 
+#define UDP_NO_CHANGE 4
+#define UDP_TABLE_MAX 16384
+
 #define PUSH_DEBUG_INFO(v)                               \
    __attribute__((cleanup(emit_debug_info), unused))     \
    const loc_t _old_loc = *vcode_last_loc();             \
@@ -758,13 +761,89 @@ static void vlog_lower_procedural_assign(lower_unit_t *lu, vlog_node_t v)
    }
 }
 
+static void vlog_lower_readmem(lower_unit_t *lu, vlog_node_t v, ident_t func)
+{
+   vlog_node_t target = vlog_param(v, 1);
+
+   vcode_reg_t target_reg = vlog_lower_lvalue(lu, target);
+   vcode_reg_t value_reg = vlog_lower_rvalue(lu, target);
+
+   vcode_reg_t count_reg, nets_reg;
+   if (vcode_reg_kind(target_reg) == VCODE_TYPE_UARRAY) {
+      nets_reg = emit_unwrap(target_reg);
+      count_reg = emit_uarray_len(target_reg, 0);
+   }
+   else {
+      nets_reg = target_reg;
+      count_reg = emit_const(vtype_offset(), 1);
+   }
+
+   // Memories are not yet supported so the whole variable is loaded as
+   // a single word: copy the current value as the file need not
+   // contain every address
+   vcode_reg_t resize_reg = vlog_lower_resize(lu, value_reg, count_reg);
+
+   vcode_type_t vlogic = vlog_logic_type();
+   vcode_reg_t mem_reg = emit_alloc(vlogic, vlogic, count_reg);
+   emit_copy(mem_reg, emit_unwrap(resize_reg), count_reg);
+
+   vcode_type_t voffset = vtype_offset();
+   vcode_reg_t one_reg = emit_const(voffset, 1);
+
+   vcode_dim_t dims[1] = {
+      { .left  = emit_const(voffset, 0),
+        .right = emit_sub(count_reg, one_reg),
+        .dir   = emit_const(vtype_bool(), RANGE_TO) }
+   };
+
+   vcode_type_t vint64 = vtype_int(INT64_MIN, INT64_MAX);
+   vcode_reg_t start_reg = emit_const(vint64, -1), finish_reg = start_reg;
+
+   const int nparams = vlog_params(v);
+   if (nparams > 2) {
+      vcode_reg_t p2_reg = vlog_lower_rvalue(lu, vlog_param(v, 2));
+      start_reg = vlog_lower_to_integer(lu, p2_reg);
+   }
+
+   if (nparams > 3) {
+      vcode_reg_t p3_reg = vlog_lower_rvalue(lu, vlog_param(v, 3));
+      finish_reg = vlog_lower_to_integer(lu, p3_reg);
+   }
+
+   vcode_reg_t file_reg = vlog_lower_rvalue(lu, vlog_param(v, 0));
+
+   vcode_reg_t args[] = {
+      vlog_helper_package(),
+      vlog_lower_wrap(lu, file_reg),
+      emit_wrap(mem_reg, dims, 1),
+      start_reg,
+      finish_reg
+   };
+   emit_fcall(func, VCODE_INVALID_TYPE, VCODE_INVALID_TYPE,
+              args, ARRAY_LEN(args));
+
+   emit_deposit_signal(nets_reg, count_reg, mem_reg);
+
+   // Delay one delta cycle to see the update
+
+   vcode_type_t vtime = vtype_time();
+   vcode_reg_t zero_time_reg = emit_const(vtime, 0);
+
+   vcode_block_t resume_bb = emit_block();
+   emit_wait(resume_bb, zero_time_reg);
+
+   vcode_select_block(resume_bb);
+}
+
 static void vlog_lower_systask(lower_unit_t *lu, vlog_node_t v)
 {
    const v_systask_kind_t kind = vlog_subkind(v);
    static const char *fns[] = {
       "NVC.VERILOG.SYS_DISPLAY(S)",
       "NVC.VERILOG.SYS_WRITE(S)",
-      "NVC.VERILOG.SYS_FINISH"
+      "NVC.VERILOG.SYS_FINISH",
+      "NVC.VERILOG.SYS_READMEMH(S" T_PACKED_LOGIC T_INT64 T_INT64 ")",
+      "NVC.VERILOG.SYS_READMEMB(S" T_PACKED_LOGIC T_INT64 T_INT64 ")",
    };
    assert(kind < ARRAY_LEN(fns));
 
@@ -796,6 +875,11 @@ static void vlog_lower_systask(lower_unit_t *lu, vlog_node_t v)
       }
       break;
 
+   case V_SYS_READMEMH:
+   case V_SYS_READMEMB:
+      vlog_lower_readmem(lu, v, ident_new(fns[kind]));
+      break;
+
    default:
       CANNOT_HANDLE(v);
    }
@@ -1140,6 +1224,202 @@ static void vlog_lower_gate_inst(unit_registry_t *ur, lower_unit_t *parent,
    unit_registry_finalise(ur, lu);
 }
 
+static vcode_reg_t vlog_lower_gate_logic(vlog_gate_kind_t kind,
+                                         const vcode_reg_t *inputs,
+                                         int ninputs)
+{
+   vcode_type_t vlogic = vlog_logic_type();
+   vcode_reg_t logic0_reg = emit_const(vlogic, LOGIC_0);
+   vcode_reg_t logic1_reg = emit_const(vlogic, LOGIC_1);
+   vcode_reg_t logicX_reg = emit_const(vlogic, LOGIC_X);
+
+   switch (kind) {
+   case V_GATE_NOT:
+      {
+         vcode_reg_t in_reg = inputs[ninputs - 1];
+         vcode_reg_t is0_reg = emit_cmp(VCODE_CMP_EQ, in_reg, logic0_reg);
+         vcode_reg_t is1_reg = emit_cmp(VCODE_CMP_EQ, in_reg, logic1_reg);
+         vcode_reg_t sel_reg = emit_select(is1_reg, logic0_reg, logicX_reg);
+         return emit_select(is0_reg, logic1_reg, sel_reg);
+      }
+
+   case V_GATE_AND:
+   case V_GATE_NAND:
+   case V_GATE_OR:
+   case V_GATE_NOR:
+      {
+         // The output is the controlling value if any input has that
+         // value, otherwise X unless every input is the other value
+         const bool is_and = kind == V_GATE_AND || kind == V_GATE_NAND;
+         vcode_reg_t ctrl_reg = is_and ? logic0_reg : logic1_reg;
+         vcode_reg_t other_reg = is_and ? logic1_reg : logic0_reg;
+
+         vcode_reg_t any_reg = VCODE_INVALID_REG, all_reg = VCODE_INVALID_REG;
+         for (int i = 0; i < ninputs; i++) {
+            vcode_reg_t c_reg = emit_cmp(VCODE_CMP_EQ, inputs[i], ctrl_reg);
+            vcode_reg_t o_reg = emit_cmp(VCODE_CMP_EQ, inputs[i], other_reg);
+            any_reg = i == 0 ? c_reg : emit_or(any_reg, c_reg);
+            all_reg = i == 0 ? o_reg : emit_and(all_reg, o_reg);
+         }
+
+         if (kind == V_GATE_NAND || kind == V_GATE_NOR) {
+            vcode_reg_t tmp_reg = ctrl_reg;
+            ctrl_reg = other_reg;
+            other_reg = tmp_reg;
+         }
+
+         vcode_reg_t sel_reg = emit_select(all_reg, other_reg, logicX_reg);
+         return emit_select(any_reg, ctrl_reg, sel_reg);
+      }
+
+   case V_GATE_XOR:
+   case V_GATE_XNOR:
+      {
+         vcode_reg_t unknown_reg = VCODE_INVALID_REG;
+         vcode_reg_t parity_reg = VCODE_INVALID_REG;
+         for (int i = 0; i < ninputs; i++) {
+            vcode_reg_t u_reg = emit_cmp(VCODE_CMP_LT, inputs[i], logic0_reg);
+            vcode_reg_t p_reg = emit_cmp(VCODE_CMP_EQ, inputs[i], logic1_reg);
+            unknown_reg = i == 0 ? u_reg : emit_or(unknown_reg, u_reg);
+            parity_reg = i == 0 ? p_reg : emit_xor(parity_reg, p_reg);
+         }
+
+         if (kind == V_GATE_XNOR)
+            parity_reg = emit_not(parity_reg);
+
+         vcode_reg_t sel_reg = emit_select(parity_reg, logic1_reg, logic0_reg);
+         return emit_select(unknown_reg, logicX_reg, sel_reg);
+      }
+
+   default:
+      fatal_trace("cannot lower gate kind %d in group", kind);
+   }
+}
+
+static void vlog_lower_gate_group(unit_registry_t *ur, lower_unit_t *parent,
+                                  vlog_node_t group)
+{
+   vcode_unit_t context = get_vcode(parent);
+
+   ident_t name = ident_prefix(vcode_unit_name(context),
+                               vlog_ident(group), '.');
+   vcode_unit_t vu = emit_process(name, vlog_to_object(group), context);
+
+   vcode_block_t start_bb = emit_block();
+   assert(start_bb == 1);
+
+   lower_unit_t *lu = lower_unit_new(ur, parent, vu, NULL, NULL);
+   unit_registry_put(ur, lu);
+
+   vcode_type_t voffset = vtype_offset();
+   vcode_type_t vlogic = vlog_logic_type();
+   vcode_type_t vtime = vtype_time();
+
+   const int ngates = vlog_stmts(group);
+
+   // The gates were sorted into levels by vlog_simp so a net driven by
+   // an earlier gate in the group can be read from its result register
+   // and is never an external input
+   hash_t *internal = hash_new(ngates * 2);
+   hset_t *sensitive = hset_new(ngates * 2);
+
+   vcode_var_t *last_vars LOCAL = xmalloc_array(ngates, sizeof(vcode_var_t));
+
+   vcode_reg_t one_reg = emit_const(voffset, 1);
+   vcode_reg_t logicZ_reg = emit_const(vlogic, LOGIC_Z);
+
+   for (int i = 0; i < ngates; i++) {
+      vlog_node_t g = vlog_stmt(group, i);
+      vlog_node_t target = vlog_target(g);
+
+      vlog_lower_driver(lu, target);
+      hash_put(internal, vlog_ref(target), (void *)(intptr_t)(i + 1));
+
+      // Gates never drive Z so this forces the first evaluation to
+      // update the output
+      last_vars[i] = emit_var(vlogic, vlogic, vlog_ident(g), 0);
+      emit_store(logicZ_reg, last_vars[i]);
+   }
+
+   for (int i = 0; i < ngates; i++) {
+      vlog_node_t g = vlog_stmt(group, i);
+
+      const int nparams = vlog_params(g);
+      for (int j = 0; j < nparams; j++) {
+         vlog_node_t p = vlog_param(g, j);
+         if (vlog_kind(p) == V_REF) {
+            if (hash_get(internal, vlog_ref(p)) != NULL)
+               continue;
+            else if (hset_contains(sensitive, vlog_ref(p)))
+               continue;
+
+            hset_insert(sensitive, vlog_ref(p));
+         }
+
+         vcode_reg_t nets_reg = vlog_lower_lvalue(lu, p);
+         emit_sched_event(nets_reg, one_reg);
+      }
+   }
+
+   emit_return(VCODE_INVALID_REG);
+
+   vcode_select_block(start_bb);
+
+   one_reg = emit_const(voffset, 1);
+   vcode_reg_t zero_reg = emit_const(vtime, 0);
+
+   vcode_reg_t *results LOCAL = xmalloc_array(ngates, sizeof(vcode_reg_t));
+
+   for (int i = 0; i < ngates; i++) {
+      vlog_node_t g = vlog_stmt(group, i);
+
+      const int nparams = vlog_params(g);
+      vcode_reg_t *inputs LOCAL = xmalloc_array(nparams, sizeof(vcode_reg_t));
+      for (int j = 0; j < nparams; j++) {
+         vlog_node_t p = vlog_param(g, j);
+
+         void *ptr = NULL;
+         if (vlog_kind(p) == V_REF)
+            ptr = hash_get(internal, vlog_ref(p));
+
+         if (ptr != NULL) {
+            assert((intptr_t)ptr - 1 < i);
+            inputs[j] = results[(intptr_t)ptr - 1];
+         }
+         else
+            inputs[j] = vlog_lower_to_logic(lu, vlog_lower_rvalue(lu, p));
+      }
+
+      results[i] = vlog_lower_gate_logic(vlog_subkind(g), inputs, nparams);
+
+      // Only schedule a transaction when the output changes
+      vcode_block_t update_bb = emit_block();
+      vcode_block_t next_bb = emit_block();
+
+      vcode_reg_t last_reg = emit_load(last_vars[i]);
+      vcode_reg_t changed_reg = emit_cmp(VCODE_CMP_NEQ, results[i], last_reg);
+      emit_cond(changed_reg, update_bb, next_bb);
+
+      vcode_select_block(update_bb);
+
+      emit_store(results[i], last_vars[i]);
+
+      vcode_reg_t value_reg = vlog_lower_to_net_value(lu, results[i]);
+      vcode_reg_t nets_reg = vlog_lower_lvalue(lu, vlog_target(g));
+      emit_sched_waveform(nets_reg, one_reg, value_reg, zero_reg, zero_reg);
+      emit_jump(next_bb);
+
+      vcode_select_block(next_bb);
+   }
+
+   emit_wait(start_bb, VCODE_INVALID_REG);
+
+   hash_free(internal);
+   hset_free(sensitive);
+
+   unit_registry_finalise(ur, lu);
+}
+
 static void vlog_lower_concurrent(unit_registry_t *ur, lower_unit_t *parent,
                                   vlog_node_t scope)
 {
@@ -1159,6 +1439,9 @@ static void vlog_lower_concurrent(unit_registry_t *ur, lower_unit_t *parent,
       case V_GATE_INST:
          vlog_lower_gate_inst(ur, parent, s);
          break;
+      case V_GATE_GROUP:
+         vlog_lower_gate_group(ur, parent, s);
+         break;
       case V_MOD_INST:
          break;
       default:
@@ -1167,6 +1450,378 @@ static void vlog_lower_concurrent(unit_registry_t *ur, lower_unit_t *parent,
    }
 }
 
+static bool vlog_udp_is_edge(char sym)
+{
+   switch (sym) {
+   case '(':
+   case '*':
+   case 'r': case 'R':
+   case 'f': case 'F':
+   case 'p': case 'P':
+   case 'n': case 'N':
+      return true;
+   default:
+      return false;
+   }
+}
+
+static bool vlog_udp_level_match(char sym, int level)
+{
+   switch (sym) {
+   case '0': return level == 0;
+   case '1': return level == 1;
+   case 'x': case 'X': return level == 2;
+   case 'b': case 'B': return level != 2;
+   case '?': return true;
+   default: return false;
+   }
+}
+
+static bool vlog_udp_edge_match(const char *sym, int prev, int level)
+{
+   switch (sym[0]) {
+   case '(':
+      return vlog_udp_level_match(sym[1], prev)
+         && vlog_udp_level_match(sym[2], level);
+   case '*':
+      return true;
+   case 'r': case 'R':
+      return prev == 0 && level == 1;
+   case 'f': case 'F':
+      return prev == 1 && level == 0;
+   case 'p': case 'P':
+      return (prev == 0 && level != 0) || (prev == 2 && level == 1);
+   case 'n': case 'N':
+      return (prev == 1 && level != 1) || (prev == 2 && level == 0);
+   default:
+      return false;
+   }
+}
+
+static int vlog_udp_lookup(vlog_node_t table, int ninputs, const int *levels,
+                           int state, int edge, int prev)
+{
+   // Levels are 0, 1, or 2 for X and the result is the first matching
+   // entry in the table
+   const vlog_udp_kind_t kind = vlog_subkind(table);
+
+   const int nentries = vlog_params(table);
+   for (int i = 0; i < nentries; i++) {
+      const char *sp = vlog_text(vlog_param(table, i));
+
+      bool match = true;
+      for (int j = 0; j < ninputs; j++) {
+         if (vlog_udp_is_edge(*sp)) {
+            match &= edge == j && vlog_udp_edge_match(sp, prev, levels[j]);
+            sp += (*sp == '(') ? 4 : 1;
+         }
+         else
+            match &= vlog_udp_level_match(*sp++, levels[j]);
+      }
+
+      assert(sp[0] == ':');
+      sp++;
+
+      if (kind == V_UDP_SEQ) {
+         match &= vlog_udp_level_match(*sp, state);
+         assert(sp[1] == ':');
+         sp += 2;
+      }
+
+      if (!match)
+         continue;
+
+      switch (*sp) {
+      case '0': return LOGIC_0;
+      case '1': return LOGIC_1;
+      case 'x': case 'X': return LOGIC_X;
+      default: return UDP_NO_CHANGE;
+      }
+   }
+
+   return kind == V_UDP_SEQ ? UDP_NO_CHANGE : LOGIC_X;
+}
+
+static bool vlog_udp_input_has_edge(vlog_node_t table, int input)
+{
+   const int nentries = vlog_params(table);
+   for (int i = 0; i < nentries; i++) {
+      const char *sp = vlog_text(vlog_param(table, i));
+      for (int k = 0; k < input; k++)
+         sp += (*sp == '(') ? 4 : 1;
+
+      if (vlog_udp_is_edge(*sp))
+         return true;
+   }
+
+   return false;
+}
+
+static vcode_reg_t vlog_lower_udp_map(void)
+{
+   // Maps a logic value to the level used to index the table
+   vcode_type_t vlevel = vtype_int(0, 2);
+
+   vcode_reg_t map[4];
+   map[LOGIC_X] = map[LOGIC_Z] = emit_const(vlevel, 2);
+   map[LOGIC_0] = emit_const(vlevel, 0);
+   map[LOGIC_1] = emit_const(vlevel, 1);
+
+   vcode_type_t vmap = vtype_carray(ARRAY_LEN(map), vlevel, vlevel);
+   return emit_address_of(emit_const_array(vmap, map, ARRAY_LEN(map)));
+}
+
+static vcode_reg_t vlog_lower_udp_level(vcode_reg_t map_reg, vcode_reg_t reg)
+{
+   vcode_type_t voffset = vtype_offset();
+   vcode_reg_t off_reg = emit_cast(voffset, voffset, reg);
+   vcode_reg_t level_reg = emit_load_indirect(emit_array_ref(map_reg, off_reg));
+   return emit_cast(voffset, voffset, level_reg);
+}
+
+static vcode_reg_t vlog_lower_udp_table(lower_unit_t *lu, vlog_node_t table,
+                                        const vcode_reg_t *in_regs,
+                                        const vcode_reg_t *in_nets,
+                                        int ninputs, vcode_reg_t cur_reg)
+{
+   const bool seq = vlog_subkind(table) == V_UDP_SEQ;
+
+   // Only inputs which appear with an edge in some entry need to be
+   // checked for events
+   int *edges LOCAL = xmalloc_array(ninputs, sizeof(int));
+   int nedges = 0;
+   for (int j = 0; j < ninputs; j++) {
+      if (vlog_udp_input_has_edge(table, j))
+         edges[nedges++] = j;
+   }
+
+   // The table is indexed by the level of each input, then the current
+   // state, then the first input with an event and its previous level
+   int64_t size = seq ? 3 * (1 + 3 * nedges) : 1;
+   for (int j = 0; j < ninputs; j++) {
+      if ((size *= 3) > UDP_TABLE_MAX)
+         return VCODE_INVALID_REG;
+   }
+
+   vcode_type_t voffset = vtype_offset();
+   vcode_type_t ventry = vtype_int(0, UDP_NO_CHANGE);
+
+   vcode_reg_t *entries LOCAL = xmalloc_array(size, sizeof(vcode_reg_t));
+   int *levels LOCAL = xmalloc_array(ninputs, sizeof(int));
+
+   for (int i = 0; i < size; i++) {
+      int rem = i;
+      for (int j = 0; j < ninputs; j++, rem /= 3)
+         levels[j] = rem % 3;
+
+      const int state = rem % 3, code = rem / 3;
+      const int edge = code == 0 ? -1 : edges[(code - 1) / 3];
+      const int prev = code == 0 ? 0 : (code - 1) % 3;
+
+      const int value =
+         vlog_udp_lookup(table, ninputs, levels, state, edge, prev);
+      entries[i] = emit_const(ventry, value);
+   }
+
+   vcode_type_t vtable = vtype_carray(size, ventry, ventry);
+   vcode_reg_t table_reg = emit_const_array(vtable, entries, size);
+
+   vcode_reg_t map_reg = vlog_lower_udp_map();
+
+   vcode_reg_t one_reg = emit_const(voffset, 1);
+   vcode_reg_t three_reg = emit_const(voffset, 3);
+   vcode_reg_t index_reg = emit_const(voffset, 0);
+
+   if (seq) {
+      for (int k = nedges - 1; k >= 0; k--) {
+         vcode_reg_t nets_reg = in_nets[edges[k]];
+         vcode_reg_t event_reg = emit_event_flag(nets_reg, one_reg);
+         vcode_reg_t last_reg = emit_load_indirect(emit_last_value(nets_reg));
+         vcode_reg_t logic_reg = vlog_lower_to_logic(lu, last_reg);
+         vcode_reg_t prev_reg = vlog_lower_udp_level(map_reg, logic_reg);
+         vcode_reg_t base_reg = emit_const(voffset, 1 + 3 * k);
+         vcode_reg_t code_reg = emit_add(prev_reg, base_reg);
+         index_reg = emit_select(event_reg, code_reg, index_reg);
+      }
+
+      vcode_reg_t state_reg = vlog_lower_udp_level(map_reg, cur_reg);
+      index_reg = emit_add(emit_mul(index_reg, three_reg), state_reg);
+   }
+
+   for (int j = ninputs - 1; j >= 0; j--) {
+      vcode_reg_t level_reg = vlog_lower_udp_level(map_reg, in_regs[j]);
+      index_reg = emit_add(emit_mul(index_reg, three_reg), level_reg);
+   }
+
+   vcode_reg_t ptr_reg = emit_array_ref(emit_address_of(table_reg), index_reg);
+   return emit_load_indirect(ptr_reg);
+}
+
+static vcode_reg_t vlog_lower_udp_match(const char *sp, vcode_reg_t index_reg,
+                                        bool edge)
+{
+   // Test a level, or the previous and current level for an edge,
+   // against the set accepted by the symbol using the same matching as
+   // the full table
+   vcode_type_t vbool = vtype_bool();
+
+   const int count = edge ? 9 : 3;
+   vcode_reg_t entries[9];
+   int nmatch = 0;
+   for (int i = 0; i < count; i++) {
+      const bool match = edge
+         ? vlog_udp_edge_match(sp, i / 3, i % 3)
+         : vlog_udp_level_match(*sp, i);
+      entries[i] = emit_const(vbool, match);
+      nmatch += match;
+   }
+
+   if (nmatch == count)
+      return VCODE_INVALID_REG;   // Matches any level
+
+   vcode_type_t vset = vtype_carray(count, vbool, vbool);
+   vcode_reg_t set_reg = emit_address_of(emit_const_array(vset, entries, count));
+   return emit_load_indirect(emit_array_ref(set_reg, index_reg));
+}
+
+static void vlog_lower_udp_rows(lower_unit_t *lu, vlog_node_t table,
+                                const vcode_reg_t *in_regs,
+                                const vcode_reg_t *in_nets,
+                                int ninputs, vcode_reg_t cur_reg,
+                                vcode_var_t result_var, vcode_block_t start_bb,
+                                vcode_block_t wait_bb)
+{
+   const vlog_udp_kind_t kind = vlog_subkind(table);
+
+   vcode_type_t voffset = vtype_offset();
+   vcode_type_t vlogic = vlog_logic_type();
+
+   vcode_reg_t one_reg = emit_const(voffset, 1);
+   vcode_reg_t three_reg = emit_const(voffset, 3);
+   vcode_reg_t logicX_reg = emit_const(vlogic, LOGIC_X);
+
+   vcode_reg_t level_map[127];
+   level_map['0'] = emit_const(vlogic, LOGIC_0);
+   level_map['1'] = emit_const(vlogic, LOGIC_1);
+   level_map['x'] = level_map['X'] = logicX_reg;
+
+   vcode_reg_t map_reg = vlog_lower_udp_map();
+
+   // The level of each input and the index of the previous and current
+   // level for inputs which appear with an edge in some entry
+   vcode_reg_t *levels LOCAL = xmalloc_array(ninputs, sizeof(vcode_reg_t));
+   vcode_reg_t *trans LOCAL = xmalloc_array(ninputs, sizeof(vcode_reg_t));
+   for (int j = 0; j < ninputs; j++) {
+      levels[j] = vlog_lower_udp_level(map_reg, in_regs[j]);
+
+      if (vlog_udp_input_has_edge(table, j)) {
+         vcode_reg_t last_reg =
+            emit_load_indirect(emit_last_value(in_nets[j]));
+         vcode_reg_t logic_reg = vlog_lower_to_logic(lu, last_reg);
+         vcode_reg_t prev_reg = vlog_lower_udp_level(map_reg, logic_reg);
+         trans[j] = emit_add(emit_mul(prev_reg, three_reg), levels[j]);
+      }
+      else
+         trans[j] = VCODE_INVALID_REG;
+   }
+
+   vcode_reg_t state_reg = VCODE_INVALID_REG;
+   if (kind == V_UDP_SEQ)
+      state_reg = vlog_lower_udp_level(map_reg, cur_reg);
+
+   vcode_block_t test_bb = vcode_active_block();
+
+   const int nentries = vlog_params(table);
+   for (int i = 0; i < nentries; i++) {
+      vlog_node_t entry = vlog_param(table, i);
+      assert(vlog_kind(entry) == V_UDP_ENTRY);
+
+      vcode_block_t hit_bb = emit_block();
+
+      const char *spec = vlog_text(entry), *sp = spec;
+      emit_comment("%s", spec);
+
+      vcode_reg_t and_reg = VCODE_INVALID_REG;
+
+      for (int j = 0; j < ninputs; j++) {
+         vcode_reg_t cmp_reg;
+         if (vlog_udp_is_edge(*sp)) {
+            assert(trans[j] != VCODE_INVALID_REG);
+            cmp_reg = emit_event_flag(in_nets[j], one_reg);
+
+            vcode_reg_t match_reg = vlog_lower_udp_match(sp, trans[j], true);
+            if (match_reg != VCODE_INVALID_REG)
+               cmp_reg = emit_and(cmp_reg, match_reg);
+
+            sp += (*sp == '(') ? 4 : 1;
+         }
+         else
+            cmp_reg = vlog_lower_udp_match(sp++, levels[j], false);
+
+         if (and_reg == VCODE_INVALID_REG)
+            and_reg = cmp_reg;
+         else if (cmp_reg != VCODE_INVALID_REG)
+            and_reg = emit_and(and_reg, cmp_reg);
+      }
+
+      assert(sp[0] == ':');
+      sp++;
+
+      if (kind == V_UDP_SEQ) {
+         vcode_reg_t cmp_reg = vlog_lower_udp_match(sp, state_reg, false);
+
+         if (and_reg == VCODE_INVALID_REG)
+            and_reg = cmp_reg;
+         else if (cmp_reg != VCODE_INVALID_REG)
+            and_reg = emit_and(and_reg, cmp_reg);
+
+         assert(sp[1] == ':');
+         sp += 2;
+      }
+
+      if (and_reg == VCODE_INVALID_REG)
+         emit_jump(hit_bb);
+      else {
+         test_bb = emit_block();
+         emit_cond(and_reg, hit_bb, test_bb);
+      }
+
+      vcode_select_block(hit_bb);
+
+      switch (*sp) {
+      case '0':
+      case '1':
+      case 'x':
+      case 'X':
+         emit_store(level_map[(int)*sp], result_var);
+         emit_jump(wait_bb);
+         break;
+      case '-':
+         // No change, skip assignment to output
+         emit_wait(start_bb, VCODE_INVALID_REG);
+         break;
+      default:
+         CANNOT_HANDLE(entry);
+      }
+
+      vcode_select_block(test_bb);
+
+      if (and_reg == VCODE_INVALID_REG)
+         break;   // Matches every input so later entries are unreachable
+   }
+
+   vcode_select_block(test_bb);
+
+   if (!vcode_block_finished()) {
+      if (kind == V_UDP_SEQ)
+         emit_wait(start_bb, VCODE_INVALID_REG);   // Skip assignment
+      else {
+         emit_store(logicX_reg, result_var);
+         emit_jump(wait_bb);
+      }
+   }
+}
+
 static void vlog_lower_udp(unit_registry_t *ur, lower_unit_t *parent,
                            vlog_node_t udp)
 {
@@ -1242,14 +1897,6 @@ static void vlog_lower_udp(unit_registry_t *ur, lower_unit_t *parent,
    {
       vcode_reg_t one_reg = emit_const(voffset, 1);
       vcode_reg_t zero_reg = emit_const(vtime, 0);
-      vcode_reg_t logic0_reg = emit_const(vlogic, LOGIC_0);
-      vcode_reg_t logic1_reg = emit_const(vlogic, LOGIC_1);
-      vcode_reg_t logicX_reg = emit_const(vlogic, LOGIC_X);
-
-      vcode_reg_t level_map[127];
-      level_map['0'] = logic0_reg;
-      level_map['1'] = logic1_reg;
-      level_map['x'] = level_map['X'] = logicX_reg;
 
       vcode_reg_t *in_regs LOCAL =
          xmalloc_array(nports - 1, sizeof(vcode_reg_t));
@@ -1264,152 +1911,40 @@ static void vlog_lower_udp(unit_registry_t *ur, lower_unit_t *parent,
          in_nets[i - 1] = nets_reg;
       }
 
-      vcode_block_t test_bb = start_bb;
-
-      const int nentries = vlog_params(table);
-      for (int i = 0; i < nentries; i++) {
-         vlog_node_t entry = vlog_param(table, i);
-         assert(vlog_kind(entry) == V_UDP_ENTRY);
-
-         vcode_block_t hit_bb = emit_block();
-
-         const char *spec = vlog_text(entry), *sp = spec;
-         emit_comment("%s", spec);
-
-         vcode_reg_t and_reg = VCODE_INVALID_REG;
-
-         for (int j = 0; j < nports - 1; j++, sp++) {
-            vcode_reg_t cmp_reg = VCODE_INVALID_REG;
-            switch (*sp) {
-            case '0':
-            case '1':
-            case 'x':
-            case 'X':
-               cmp_reg = emit_cmp(VCODE_CMP_EQ, in_regs[j],
-                                  level_map[(unsigned)*sp]);
-               break;
-            case '*':
-               cmp_reg = emit_event_flag(in_nets[j], one_reg);
-               break;
-            case 'b':
-               {
-                  vcode_reg_t is0_reg =
-                     emit_cmp(VCODE_CMP_EQ, in_regs[j], logic0_reg);
-                  vcode_reg_t is1_reg =
-                     emit_cmp(VCODE_CMP_EQ, in_regs[j], logic1_reg);
-                  cmp_reg = emit_and(is0_reg, is1_reg);
-               }
-               break;
-            case '?':
-               break;
-            case '(':
-               {
-                  cmp_reg = emit_event_flag(in_nets[j], one_reg);
-
-                  if (sp[1] != '?') {
-                     vcode_reg_t last_reg =
-                        emit_load_indirect(emit_last_value(in_nets[j]));
-                     vcode_reg_t logic_reg = vlog_lower_to_logic(lu, last_reg);
-                     vcode_reg_t eq_reg = emit_cmp(VCODE_CMP_EQ, logic_reg,
-                                                   level_map[(unsigned)sp[1]]);
-                     cmp_reg = emit_and(cmp_reg, eq_reg);
-                  }
-
-                  if (sp[2] != '?') {
-                     vcode_reg_t eq_reg = emit_cmp(VCODE_CMP_EQ, in_regs[j],
-                                                   level_map[(unsigned)sp[2]]);
-                     cmp_reg = emit_and(cmp_reg, eq_reg);
-                  }
-
-                  sp += 3;
-               }
-               break;
-
-            default:
-               CANNOT_HANDLE(entry);
-            }
-
-            if (and_reg == VCODE_INVALID_REG)
-               and_reg = cmp_reg;
-            else if (cmp_reg != VCODE_INVALID_REG)
-               and_reg = emit_and(and_reg, cmp_reg);
-         }
-
-         assert(sp[0] == ':');
-         sp++;
+      vcode_reg_t cur_reg = VCODE_INVALID_REG;
+      if (kind == V_UDP_SEQ) {
+         vcode_reg_t out_reg =
+            emit_load_indirect(emit_var_upref(hops, out_var));
+         cur_reg = emit_load_indirect(emit_resolved(out_reg));
+      }
 
+      // Evaluate the whole table with a single load when it is small
+      // enough to enumerate every combination of inputs
+      vcode_reg_t entry_reg = vlog_lower_udp_table(lu, table, in_regs,
+                                                   in_nets, nports - 1,
+                                                   cur_reg);
+      if (entry_reg == VCODE_INVALID_REG)
+         vlog_lower_udp_rows(lu, table, in_regs, in_nets, nports - 1,
+                             cur_reg, result_var, start_bb, wait_bb);
+      else {
          if (kind == V_UDP_SEQ) {
-            vcode_reg_t out_reg =
-               emit_load_indirect(emit_var_upref(hops, out_var));
-            vcode_reg_t cur_reg = emit_load_indirect(emit_resolved(out_reg));
-
-            vcode_reg_t cmp_reg = VCODE_INVALID_REG;
-            switch (*sp) {
-            case '0':
-            case '1':
-            case 'x':
-            case 'X':
-               cmp_reg = emit_cmp(VCODE_CMP_EQ, cur_reg,
-                                  level_map[(unsigned)*sp]);
-               break;
-            case '?':
-               break;
-            default:
-               CANNOT_HANDLE(entry);
-            }
-
-            if (and_reg == VCODE_INVALID_REG)
-               and_reg = cmp_reg;
-            else if (cmp_reg != VCODE_INVALID_REG)
-               and_reg = emit_and(and_reg, cmp_reg);
-
-            assert(sp[1] == ':');
-            sp += 2;
-         }
+            vcode_block_t skip_bb = emit_block();
+            vcode_block_t store_bb = emit_block();
 
-         if (and_reg == VCODE_INVALID_REG) {
-            emit_jump(hit_bb);
-            break;
-         }
-         else {
-            test_bb = emit_block();
-            emit_cond(and_reg, hit_bb, test_bb);
-         }
+            vcode_reg_t nochange_reg =
+               emit_const(vcode_reg_type(entry_reg), UDP_NO_CHANGE);
+            vcode_reg_t same_reg =
+               emit_cmp(VCODE_CMP_EQ, entry_reg, nochange_reg);
+            emit_cond(same_reg, skip_bb, store_bb);
+
+            vcode_select_block(skip_bb);
+            emit_wait(start_bb, VCODE_INVALID_REG);   // Skip assignment
 
-         vcode_select_block(hit_bb);
-
-         vcode_reg_t drive_reg;
-         switch (*sp) {
-         case '0':
-         case '1':
-         case 'x':
-         case 'X':
-            drive_reg = level_map[(int)*sp];
-            break;
-         case '-':
-            // No change, skip assignment to output
-            drive_reg = VCODE_INVALID_REG;
-            emit_wait(start_bb, VCODE_INVALID_REG);
-            vcode_select_block(test_bb);
-            continue;
-         default: CANNOT_HANDLE(entry);
+            vcode_select_block(store_bb);
          }
 
-         emit_store(drive_reg, result_var);
+         emit_store(emit_cast(vlogic, vlogic, entry_reg), result_var);
          emit_jump(wait_bb);
-
-         vcode_select_block(test_bb);
-      }
-
-      vcode_select_block(test_bb);
-
-      if (!vcode_block_finished()) {
-         if (kind == V_UDP_SEQ)
-            emit_wait(start_bb, VCODE_INVALID_REG);   // Skip assignment
-         else {
-            emit_store(logicX_reg, result_var);
-            emit_jump(wait_bb);
-         }
       }
 
       vcode_select_block(wait_bb);
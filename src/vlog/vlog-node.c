@@ -138,6 +138,9 @@ static const imask_t has_map[V_LAST_NODE_KIND] = {
 
    // V_STRUCT_DECL
    (I_IDENT | I_DECLS),
+
+   // V_GATE_GROUP
+   (I_IDENT | I_STMTS),
 };
 
 static const char *kind_text_map[V_LAST_NODE_KIND] = {
@@ -150,7 +153,7 @@ static const char *kind_text_map[V_LAST_NODE_KIND] = {
    "V_MOD_INST",   "V_BIT_SELECT",  "V_SYSFUNC",       "V_FOREVER",
    "V_SPECIFY",    "V_PRIMITIVE",   "V_UDP_TABLE",     "V_UDP_ENTRY",
    "V_DATA_TYPE",  "V_TYPE_DECL",   "V_ENUM_DECL",     "V_ENUM_NAME",
-   "V_UNION_DECL", "V_STRUCT_DECL",
+   "V_UNION_DECL", "V_STRUCT_DECL", "V_GATE_GROUP",
 };
 
 static const change_allowed_t change_allowed[] = {
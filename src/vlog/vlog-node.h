@@ -36,6 +36,8 @@ typedef enum {
    V_SYS_DISPLAY,
    V_SYS_WRITE,
    V_SYS_FINISH,
+   V_SYS_READMEMH,
+   V_SYS_READMEMB,
 } v_systask_kind_t;
 
 typedef enum {
@@ -92,6 +94,7 @@ typedef enum {
    V_ENUM_NAME,
    V_UNION_DECL,
    V_STRUCT_DECL,
+   V_GATE_GROUP,
 
    V_LAST_NODE_KIND
 } vlog_kind_t;
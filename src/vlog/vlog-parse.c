@@ -63,7 +63,7 @@ typedef struct {
 
 static parse_state_t state;
 
-extern loc_t yylloc;
+extern __thread loc_t yylloc;
 
 #define scan(...) _scan(1, __VA_ARGS__, -1)
 #define expect(...) _expect(1, __VA_ARGS__, -1)
@@ -130,7 +130,7 @@ static token_t peek_nth(int n)
       int next = (state.tokenq_head + 1) & (TOKENQ_SIZE - 1);
       assert(next != state.tokenq_tail);
 
-      extern yylval_t yylval;
+      extern __thread yylval_t yylval;
 
       state.tokenq[state.tokenq_head].token = token;
       state.tokenq[state.tokenq_head].lval  = yylval;
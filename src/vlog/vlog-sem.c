@@ -301,15 +301,37 @@ static void vlog_check_seq_block(vlog_node_t block)
       vlog_check(vlog_stmt(block, i));
 }
 
+static void vlog_check_readmem(vlog_node_t call)
+{
+   const int nparams = vlog_params(call);
+   if (nparams < 2 || nparams > 4) {
+      error_at(vlog_loc(call), "%s expects between 2 and 4 arguments",
+               istr(vlog_ident(call)));
+      return;
+   }
+
+   vlog_node_t file = vlog_param(call, 0);
+   if (vlog_kind(file) != V_STRING)
+      error_at(vlog_loc(file), "file name must be a string literal");
+
+   vlog_node_t mem = vlog_param(call, 1);
+   if (vlog_kind(mem) != V_REF)
+      error_at(vlog_loc(mem), "expected name of memory to load");
+   else
+      vlog_check_variable_target(mem);
+}
+
 static void vlog_check_systask(vlog_node_t call)
 {
    const well_known_t name = is_well_known(vlog_ident(call));
 
    v_systask_kind_t kind;
    switch (name) {
-   case W_DOLLAR_DISPLAY: kind = V_SYS_DISPLAY; break;
-   case W_DOLLAR_FINISH:  kind = V_SYS_FINISH; break;
-   case W_DOLLAR_WRITE:   kind = V_SYS_WRITE; break;
+   case W_DOLLAR_DISPLAY:  kind = V_SYS_DISPLAY; break;
+   case W_DOLLAR_FINISH:   kind = V_SYS_FINISH; break;
+   case W_DOLLAR_WRITE:    kind = V_SYS_WRITE; break;
+   case W_DOLLAR_READMEMH: kind = V_SYS_READMEMH; break;
+   case W_DOLLAR_READMEMB: kind = V_SYS_READMEMB; break;
    default:
       error_at(vlog_loc(call), "system task %s not recognised",
                istr(vlog_ident(call)));
@@ -321,6 +343,9 @@ static void vlog_check_systask(vlog_node_t call)
    const int nparams = vlog_params(call);
    for (int i = 0; i < nparams; i++)
       vlog_check(vlog_param(call, i));
+
+   if (kind == V_SYS_READMEMH || kind == V_SYS_READMEMB)
+      vlog_check_readmem(call);
 }
 
 static void vlog_check_sysfunc(vlog_node_t call)
@@ -16,7 +16,9 @@
 //
 
 #include "util.h"
+#include "array.h"
 #include "diag.h"
+#include "hash.h"
 #include "ident.h"
 #include "vlog/vlog-node.h"
 #include "vlog/vlog-number.h"
@@ -27,6 +29,10 @@
 #include <string.h>
 #include <stdlib.h>
 
+#define GATE_GROUP_MAX 128
+
+typedef A(vlog_node_t) node_list_t;
+
 static vlog_node_t simp_net_decl(vlog_node_t decl, vlog_node_t mod)
 {
    const vlog_net_kind_t kind = vlog_subkind(decl);
@@ -92,8 +98,243 @@ static vlog_node_t vlog_simp_cb(vlog_node_t v, void *context)
    }
 }
 
+static void simp_add_driver(hash_t *drivers, vlog_node_t decl, int count)
+{
+   const uintptr_t cur = (uintptr_t)hash_get(drivers, decl);
+   hash_put(drivers, decl, (void *)(cur + count));
+}
+
+static void simp_shared_net_cb(vlog_node_t v, void *context)
+{
+   if (vlog_has_ref(v))
+      simp_add_driver(context, vlog_ref(v), 2);
+}
+
+static bool simp_is_private_net(hash_t *drivers, vlog_node_t v)
+{
+   // A net which is only driven by a single gate and is not visible
+   // outside the module can be evaluated directly inside a group
+   if (vlog_kind(v) != V_REF || !vlog_has_ref(v))
+      return false;
+
+   vlog_node_t decl = vlog_ref(v);
+   if (vlog_kind(decl) != V_NET_DECL || vlog_dimensions(decl) > 0)
+      return false;
+
+   return (uintptr_t)hash_get(drivers, decl) == 1;
+}
+
+static bool simp_can_group(vlog_node_t g, hash_t *drivers)
+{
+   switch (vlog_subkind(g)) {
+   case V_GATE_AND:
+   case V_GATE_NAND:
+   case V_GATE_OR:
+   case V_GATE_NOR:
+   case V_GATE_XOR:
+   case V_GATE_XNOR:
+   case V_GATE_NOT:
+      break;
+   default:
+      return false;
+   }
+
+   const int nparams = vlog_params(g);
+   for (int i = 0; i < nparams; i++) {
+      if (vlog_kind(vlog_param(g, i)) == V_STRENGTH)
+         return false;
+   }
+
+   return simp_is_private_net(drivers, vlog_target(g));
+}
+
+static int simp_find_root(int *parent, int n)
+{
+   while (parent[n] != n)
+      n = parent[n] = parent[parent[n]];
+   return n;
+}
+
+static vlog_node_t simp_remove_grouped_cb(vlog_node_t v, void *context)
+{
+   hset_t *grouped = context;
+   return hset_contains(grouped, v) ? NULL : v;
+}
+
+static void simp_gate_groups(vlog_node_t mod)
+{
+   hash_t *drivers = hash_new(256);
+
+   const int ndecls = vlog_decls(mod);
+   for (int i = 0; i < ndecls; i++) {
+      vlog_node_t d = vlog_decl(mod, i);
+      if (vlog_kind(d) == V_PORT_DECL && vlog_has_ref(d))
+         simp_add_driver(drivers, vlog_ref(d), 2);
+   }
+
+   const int nstmts = vlog_stmts(mod);
+   for (int i = 0; i < nstmts; i++) {
+      vlog_node_t s = vlog_stmt(mod, i);
+      switch (vlog_kind(s)) {
+      case V_GATE_INST:
+         {
+            vlog_node_t target = vlog_target(s);
+            if (vlog_kind(target) == V_REF && vlog_has_ref(target))
+               simp_add_driver(drivers, vlog_ref(target), 1);
+            else
+               vlog_visit_only(target, simp_shared_net_cb, drivers, V_REF);
+         }
+         break;
+      case V_ASSIGN:
+         vlog_visit_only(vlog_target(s), simp_shared_net_cb, drivers, V_REF);
+         break;
+      case V_MOD_INST:
+         vlog_visit_only(s, simp_shared_net_cb, drivers, V_REF);
+         break;
+      default:
+         break;
+      }
+   }
+
+   node_list_t gates = AINIT;
+   for (int i = 0; i < nstmts; i++) {
+      vlog_node_t s = vlog_stmt(mod, i);
+      if (vlog_kind(s) == V_GATE_INST && simp_can_group(s, drivers))
+         APUSH(gates, s);
+   }
+
+   if (gates.count < 2) {
+      ACLEAR(gates);
+      hash_free(drivers);
+      return;
+   }
+
+   // Sort the gates into levels where every gate comes after all the
+   // gates driving its inputs: gates in combinational loops are left
+   // as separate processes
+   ihash_t *producer = ihash_new(gates.count * 2);
+   for (int i = 0; i < gates.count; i++) {
+      vlog_node_t decl = vlog_ref(vlog_target(gates.items[i]));
+      ihash_put(producer, (uintptr_t)decl, (void *)(intptr_t)(i + 1));
+   }
+
+   int *indegree LOCAL = xcalloc_array(gates.count, sizeof(int));
+   int *first LOCAL = xcalloc_array(gates.count + 1, sizeof(int));
+   A(int) inputs = AINIT;
+
+   for (int i = 0; i < gates.count; i++) {
+      const int nparams = vlog_params(gates.items[i]);
+      for (int j = 0; j < nparams; j++) {
+         vlog_node_t p = vlog_param(gates.items[i], j);
+         if (vlog_kind(p) != V_REF || !vlog_has_ref(p))
+            continue;
+
+         void *ptr = ihash_get(producer, (uintptr_t)vlog_ref(p));
+         if (ptr == NULL)
+            continue;
+
+         const int from = (intptr_t)ptr - 1;
+         first[from + 1]++;
+         indegree[i]++;
+
+         // Remember the edge as a pair of (from, to)
+         APUSH(inputs, from);
+         APUSH(inputs, i);
+      }
+   }
+
+   for (int i = 0; i < gates.count; i++)
+      first[i + 1] += first[i];
+
+   int *edges LOCAL = xmalloc_array(MAX(first[gates.count], 1), sizeof(int));
+
+   // Gates connected by nets which are private to the module form a
+   // single group as long as it does not grow too large
+   int *root LOCAL = xmalloc_array(gates.count, sizeof(int));
+   int *chunk LOCAL = xmalloc_array(gates.count, sizeof(int));
+   for (int i = 0; i < gates.count; i++) {
+      root[i] = i;
+      chunk[i] = -1;
+   }
+
+   int *fill LOCAL = xcalloc_array(gates.count, sizeof(int));
+   for (int i = 0; i < inputs.count; i += 2) {
+      const int from = inputs.items[i], to = inputs.items[i + 1];
+      edges[first[from] + fill[from]++] = to;
+
+      const int r1 = simp_find_root(root, from);
+      const int r2 = simp_find_root(root, to);
+      root[r1] = r2;
+   }
+   ACLEAR(inputs);
+
+   int *queue LOCAL = xmalloc_array(gates.count, sizeof(int));
+   int head = 0, tail = 0;
+   for (int i = 0; i < gates.count; i++) {
+      if (indegree[i] == 0)
+         queue[tail++] = i;
+   }
+
+   A(node_list_t) groups = AINIT;
+
+   while (head < tail) {
+      const int g = queue[head++];
+      const int r = simp_find_root(root, g);
+
+      // Gates are visited in level order so a group which is full can
+      // be closed and its outputs become inputs of the next group
+      int gid = chunk[r];
+      if (gid == -1 || groups.items[gid].count == GATE_GROUP_MAX) {
+         gid = chunk[r] = groups.count;
+         APUSH(groups, (node_list_t)AINIT);
+      }
+
+      APUSH(groups.items[gid], gates.items[g]);
+
+      for (int k = first[g]; k < first[g + 1]; k++) {
+         if (--indegree[edges[k]] == 0)
+            queue[tail++] = edges[k];
+      }
+   }
+
+   hset_t *grouped = hset_new(gates.count * 2);
+
+   for (int i = 0; i < groups.count; i++) {
+      node_list_t *list = &(groups.items[i]);
+      for (int j = 0; list->count > 1 && j < list->count; j++)
+         hset_insert(grouped, list->items[j]);
+   }
+
+   vlog_rewrite(mod, simp_remove_grouped_cb, grouped);
+
+   for (int i = 0; i < groups.count; i++) {
+      node_list_t *list = &(groups.items[i]);
+      if (list->count > 1) {
+         vlog_node_t v = vlog_new(V_GATE_GROUP);
+         vlog_set_loc(v, vlog_loc(list->items[0]));
+         vlog_set_ident(v, ident_uniq("#gates"));
+
+         for (int j = 0; j < list->count; j++)
+            vlog_add_stmt(v, list->items[j]);
+
+         vlog_add_stmt(mod, v);
+      }
+
+      ACLEAR(*list);
+   }
+
+   ACLEAR(groups);
+   hset_free(grouped);
+   ihash_free(producer);
+   ACLEAR(gates);
+   hash_free(drivers);
+}
+
 void vlog_simp(vlog_node_t mod)
 {
    assert(is_top_level(mod));
    vlog_rewrite(mod, vlog_simp_cb, mod);
+
+   if (vlog_kind(mod) == V_MODULE)
+      simp_gate_groups(mod);
 }
@@ -538,6 +538,7 @@ EXTRA_DIST += \
 	test/perf/binarytrees.vhd \
 	test/perf/dyn_agg.vhd \
 	test/perf/grind.vhd \
+	test/perf/loops.vhd \
 	test/perf/math_real.vhd \
 	test/perf/numeric_std.vhd \
 	test/perf/simple.vhd \
@@ -2096,6 +2097,8 @@ EXTRA_DIST += \
 	test/sem/vhdl2008.vhd \
 	test/sem/vital1.vhd \
 	test/sem/wait.vhd \
+	test/shell/async1.vhd \
+	test/shell/deltas1.vhd \
 	test/shell/describe1.vhd \
 	test/shell/examine1.vhd \
 	test/shell/force1.vhd \
@@ -0,0 +1,71 @@
+package loops is
+    procedure test_crc32;
+    procedure test_matmul;
+end package;
+
+package body loops is
+
+    type byte_array is array (natural range <>) of integer range 0 to 255;
+
+    function crc32 (data : byte_array) return bit_vector is
+        constant POLY : bit_vector(31 downto 0) := X"EDB88320";
+        variable crc  : bit_vector(31 downto 0) := (others => '1');
+        variable byte : bit_vector(7 downto 0);
+    begin
+        for i in data'range loop
+            for b in 0 to 7 loop
+                byte(b) := bit'val((data(i) / 2 ** b) mod 2);
+            end loop;
+            for b in 0 to 7 loop
+                if (crc(0) xor byte(b)) = '1' then
+                    crc := ('0' & crc(31 downto 1)) xor POLY;
+                else
+                    crc := '0' & crc(31 downto 1);
+                end if;
+            end loop;
+        end loop;
+        return not crc;
+    end function;
+
+    procedure test_crc32 is
+        variable data : byte_array(0 to 255);
+    begin
+        for i in data'range loop
+            data(i) := i;
+        end loop;
+        assert crc32(data) = X"29058C73";
+    end procedure;
+
+    ---------------------------------------------------------------------------
+
+    type matrix is array (natural range <>, natural range <>) of integer;
+
+    procedure matmul (a, b : in matrix; c : out matrix) is
+        variable sum : integer;
+    begin
+        for i in a'range(1) loop
+            for j in b'range(2) loop
+                sum := 0;
+                for k in a'range(2) loop
+                    sum := sum + a(i, k) * b(k, j);
+                end loop;
+                c(i, j) := sum;
+            end loop;
+        end loop;
+    end procedure;
+
+    procedure test_matmul is
+        constant N : integer := 16;
+        variable a, b, c : matrix(0 to N - 1, 0 to N - 1);
+    begin
+        for i in 0 to N - 1 loop
+            for j in 0 to N - 1 loop
+                a(i, j) := i + j;
+                b(i, j) := i - j;
+            end loop;
+        end loop;
+        matmul(a, b, c);
+        assert c(3, 5) = 760;
+    end procedure;
+
+end package body;
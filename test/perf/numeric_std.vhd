@@ -11,6 +11,11 @@ package numeric_std_perf is
     procedure test_sub_signed;
     procedure test_add_one;
     procedure test_add_zero;
+    procedure test_compare;
+    procedure test_shift;
+    procedure test_to_integer;
+    procedure test_div_unsigned;
+    procedure test_div_signed;
 end package;
 
 library ieee;
@@ -169,4 +174,83 @@ package body numeric_std_perf is
         end loop;
         assert accum = X"0";
     end procedure;
+
+    procedure test_compare is
+        constant WIDTH : integer := 32;
+        constant ITERS : integer := 500;
+        variable u     : unsigned(WIDTH - 1 downto 0) := (others => '0');
+        variable s     : signed(WIDTH - 1 downto 0) := (others => '0');
+        variable count : natural;
+    begin
+        for i in 1 to ITERS loop
+            u := to_unsigned(i, WIDTH);
+            s := to_signed(-i, WIDTH);
+            if u < to_unsigned(ITERS / 2, WIDTH) then
+                count := count + 1;
+            end if;
+            if s > to_signed(-ITERS / 2, WIDTH) then
+                count := count + 1;
+            end if;
+        end loop;
+        assert count = ITERS - 2;
+    end procedure;
+
+    procedure test_shift is
+        constant WIDTH : integer := 64;
+        constant ITERS : integer := 500;
+        variable u     : unsigned(WIDTH - 1 downto 0) := (0 => '1', others => '0');
+        variable s     : signed(WIDTH - 1 downto 0) := (WIDTH - 1 => '1', others => '0');
+    begin
+        for i in 1 to ITERS loop
+            u := rotate_left(shift_left(u, 1), WIDTH - 1);
+            s := shift_right(rotate_right(s, WIDTH), 0);
+        end loop;
+        assert u = (0 => '1', WIDTH - 1 downto 1 => '0');
+        assert s(WIDTH - 1) = '1';
+    end procedure;
+
+    procedure test_to_integer is
+        constant WIDTH : integer := 24;
+        constant ITERS : integer := 500;
+        variable u     : unsigned(WIDTH - 1 downto 0);
+        variable s     : signed(WIDTH - 1 downto 0);
+        variable sum   : integer := 0;
+    begin
+        for i in 1 to ITERS loop
+            u := to_unsigned(i, WIDTH);
+            s := to_signed(-i, WIDTH);
+            sum := sum + to_integer(u) + to_integer(s);
+        end loop;
+        assert sum = 0;
+    end procedure;
+
+    procedure test_div_unsigned is
+        constant WIDTH : integer := 32;
+        constant ITERS : integer := 500;
+        variable u     : unsigned(WIDTH - 1 downto 0);
+        variable q, r  : unsigned(WIDTH - 1 downto 0);
+        constant ten   : unsigned(WIDTH - 1 downto 0) := to_unsigned(10, WIDTH);
+    begin
+        for i in 1 to ITERS loop
+            u := to_unsigned(i * 7919, WIDTH);
+            q := u / ten;
+            r := u mod ten;
+            assert resize(q * ten, WIDTH) + r = u;
+        end loop;
+    end procedure;
+
+    procedure test_div_signed is
+        constant WIDTH : integer := 32;
+        constant ITERS : integer := 500;
+        variable s     : signed(WIDTH - 1 downto 0);
+        variable q, r  : signed(WIDTH - 1 downto 0);
+        constant seven : signed(WIDTH - 1 downto 0) := to_signed(-7, WIDTH);
+    begin
+        for i in 1 to ITERS loop
+            s := to_signed(i * 7919, WIDTH);
+            q := s / seven;
+            r := s rem seven;
+            assert resize(q * seven, WIDTH) + r = s;
+        end loop;
+    end procedure;
 end package body;
@@ -0,0 +1,48 @@
+-- Compare run time and memory usage with NVC_PACKED_VALUES set to 0
+-- and 1: each bus has one driver with a long queue of pending
+-- transactions and a second resolved driver
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity packed_values is
+end entity;
+
+architecture tb of packed_values is
+
+    constant C_BUSES : natural := 256;
+    constant C_WIDTH : natural := 64;
+    constant C_QUEUE : natural := 32;
+
+    type t_bus_array is
+        array (0 to C_BUSES - 1) of std_logic_vector(C_WIDTH - 1 downto 0);
+
+    signal buses : t_bus_array;
+
+begin
+
+    driver: process
+        variable v : std_logic_vector(C_WIDTH - 1 downto 0);
+    begin
+        for j in 1 to 200 loop
+            for i in 0 to C_BUSES - 1 loop
+                v := (others => '0');
+                for k in 0 to C_QUEUE - 1 loop
+                    v((i + j + k) mod C_WIDTH) := '1';
+                    buses(i) <= transport v after k * 1 ns;
+                end loop;
+            end loop;
+
+            wait for C_QUEUE * 1 ns;
+        end loop;
+
+        wait;
+    end process;
+
+    pull: process
+    begin
+        buses <= (others => (others => 'L'));
+        wait;
+    end process;
+
+end architecture;
@@ -1,3 +1,7 @@
+-- The wide vector tests compare the intrinsic variants by running
+-- jitperf with NVC_VECTOR_INTRINSICS set to 0 (scalar), 1 (SSE4.1 or
+-- NEON), or 2 (AVX2, the default)
+
 package std_logic_perf is
     procedure test_to_x01;
     procedure test_and;
@@ -5,10 +9,19 @@ package std_logic_perf is
     procedure test_xor;
     procedure test_equal;
     procedure test_not_equal;
+    procedure test_wide_and;
+    procedure test_wide_nand;
+    procedure test_wide_nor;
+    procedure test_wide_xnor;
+    procedure test_wide_not;
+    procedure test_wide_to_x01;
+    procedure test_wide_to_01;
+    procedure test_wide_std_match;
 end package;
 
 library ieee;
 use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
 
 package body std_logic_perf is
 
@@ -82,4 +95,103 @@ package body std_logic_perf is
         end loop;
         assert count = 0;
     end procedure;
+
+    procedure test_wide_and is
+        constant ITERS : integer := 1000;
+        variable x, y  : std_logic_vector(4095 downto 0);
+    begin
+        y := (others => '1');
+        for i in 1 to ITERS loop
+            x(i rem 4096) := '1';
+            x := x and y;
+        end loop;
+        assert x(999) = '1';
+    end procedure;
+
+    procedure test_wide_nand is
+        constant ITERS : integer := 1000;
+        variable x, y  : std_logic_vector(4095 downto 0);
+    begin
+        x := (others => '0');
+        y := (others => '1');
+        for i in 1 to ITERS loop
+            x := x nand y;
+        end loop;
+        assert x(0) = '0';
+    end procedure;
+
+    procedure test_wide_nor is
+        constant ITERS : integer := 1000;
+        variable x, y  : std_logic_vector(4095 downto 0);
+    begin
+        x := (others => '0');
+        y := (others => 'L');
+        for i in 1 to ITERS loop
+            x := x nor y;
+        end loop;
+        assert x(0) = '0';
+    end procedure;
+
+    procedure test_wide_xnor is
+        constant ITERS : integer := 1000;
+        variable x, y  : std_logic_vector(4095 downto 0);
+    begin
+        x := (others => '0');
+        y := (others => '0');
+        for i in 1 to ITERS loop
+            x := x xnor y;
+        end loop;
+        assert x(0) = '0';
+    end procedure;
+
+    procedure test_wide_not is
+        constant ITERS : integer := 1000;
+        variable x     : std_logic_vector(4095 downto 0);
+    begin
+        x := (others => 'H');
+        for i in 1 to ITERS loop
+            x := not x;
+        end loop;
+        assert x(0) = '1';
+    end procedure;
+
+    procedure test_wide_to_x01 is
+        constant ITERS : integer := 1000;
+        variable x     : std_logic_vector(4095 downto 0);
+    begin
+        x := (others => 'H');
+        for i in 1 to ITERS loop
+            x(i rem 4096) := 'L';
+            x := to_x01(x);
+        end loop;
+        assert x(4095) = '1';
+    end procedure;
+
+    procedure test_wide_to_01 is
+        constant ITERS : integer := 1000;
+        variable x, y  : unsigned(4095 downto 0);
+    begin
+        x := (others => 'H');
+        for i in 1 to ITERS loop
+            x(i rem 4096) := 'L';
+            y := to_01(x);
+        end loop;
+        assert y(999) = '0';
+    end procedure;
+
+    procedure test_wide_std_match is
+        constant ITERS : integer := 1000;
+        variable x, y  : std_logic_vector(4095 downto 0);
+        variable count : natural;
+    begin
+        x := (others => '1');
+        y := (others => '-');
+        for i in 1 to ITERS loop
+            y(i rem 4096) := 'H';
+            if std_match(x, y) then
+                count := count + 1;
+            end if;
+        end loop;
+        assert count = ITERS;
+    end procedure;
 end package body;
@@ -0,0 +1,16 @@
+entity dfa1 is
+end entity;
+
+architecture test of dfa1 is
+    signal clk, a, b : bit;
+
+    default clock is clk'event and clk = '1';
+begin
+
+    small: assert always a -> next[2] b;   -- Converted to a DFA
+
+    many: assert always a -> next[40] b;   -- Too many DFA states
+
+    long: assert always a -> next[70] b;   -- Too many NFA states
+
+end architecture;
@@ -0,0 +1,31 @@
+entity cover24 is
+end entity;
+
+architecture test of cover24 is
+
+    signal cnt : integer := 0;
+
+begin
+
+    process
+    begin
+        wait for 1 ns;
+        if cnt < 300 then
+            cnt <= cnt + 1;
+        else
+            wait;
+        end if;
+    end process;
+
+    process (cnt)
+    begin
+        l_if_1: if cnt mod 100 = 0 then
+            report "CNT = " & integer'image(cnt);
+        end if;
+
+        l_if_2: if cnt > 1000 then
+            report "not reached";
+        end if;
+    end process;
+
+end architecture;
@@ -0,0 +1,38 @@
+set -xe
+
+pwd
+which nvc
+
+nvc -a $TESTDIR/regress/cover26.vhd -e --cover=statement,branch cover26 -r
+
+nvc --cover-report --incremental -o html work/_WORK.COVER26.elab.covdb \
+    2>&1 | tee out.txt
+
+total=$(sed -n 's/.*Regenerated \([0-9]*\) of \([0-9]*\).*/\2/p' out.txt)
+grep "Regenerated $total of $total hierarchy pages" out.txt
+
+sleep 1
+touch stamp
+
+# Nothing changed so no pages should be rewritten
+nvc --cover-report --incremental -o html work/_WORK.COVER26.elab.covdb \
+    2>&1 | tee out.txt
+
+grep "Regenerated 0 of $total hierarchy pages" out.txt
+find html/hier -name '*.html' -newer stamp > changed.txt
+[ ! -s changed.txt ]
+
+sleep 1
+touch stamp
+
+# Only the page for U2 and the summary in its parent change
+nvc -e --cover=statement,branch -gG=2 cover26 -r
+
+nvc --cover-report --incremental -o html work/_WORK.COVER26.elab.covdb \
+    2>&1 | tee out.txt
+
+find html/hier -name '*.html' -newer stamp | tee changed.txt
+grep -i "u2\.html" changed.txt
+! grep -i "u1" changed.txt
+grep -E "Regenerated [1-9][0-9]* of $total hierarchy pages" out.txt
+! grep "Regenerated $total of" out.txt
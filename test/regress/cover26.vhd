@@ -0,0 +1,35 @@
+entity cover26_sub is
+    port ( x : in integer );
+end entity;
+
+architecture test of cover26_sub is
+begin
+
+    process (x) is
+        variable v : integer;
+    begin
+        if x > 1 then
+            v := 1;
+        else
+            v := 2;
+        end if;
+    end process;
+
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity cover26 is
+    generic ( G : integer := 1 );
+end entity;
+
+architecture test of cover26 is
+    signal a, b : integer := 0;
+begin
+
+    u1: entity work.cover26_sub port map (a);
+    u2: entity work.cover26_sub port map (b);
+
+    b <= G;
+
+end architecture;
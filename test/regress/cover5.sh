@@ -29,3 +29,10 @@ if [ ! -f html/index.html ]; then
 fi
 
 diff -u $TESTDIR/regress/gold/cover5.txt out.txt
+
+# Merging batches in parallel must give an identical database
+nvc --cover-merge --jobs=1 -o DB_J1.covdb DB1.covdb DB2.covdb DB3.covdb DB4.covdb
+nvc --cover-merge --jobs=2 -o DB_J2.covdb DB1.covdb DB2.covdb DB3.covdb DB4.covdb
+nvc --cover-merge --jobs=3 -o DB_J3.covdb DB1.covdb DB2.covdb DB3.covdb DB4.covdb
+cmp DB_J1.covdb DB_J2.covdb
+cmp DB_J1.covdb DB_J3.covdb
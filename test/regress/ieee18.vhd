@@ -0,0 +1,101 @@
+entity ieee18 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+architecture test of ieee18 is
+begin
+
+    -- Corner cases for numeric_std relational, shift, division and
+    -- conversion intrinsics
+    process is
+        variable u4  : unsigned(3 downto 0);
+        variable u8  : unsigned(7 downto 0);
+        variable s4  : signed(3 downto 0);
+        variable s8  : signed(7 downto 0);
+        variable u70 : unsigned(69 downto 0);
+        variable s1  : signed(0 downto 0);
+    begin
+        -- Relational operators with different lengths
+        u4 := "1010";
+        u8 := "00001010";
+        assert u4 = u8;
+        assert not (u4 /= u8);
+        assert u4 <= u8 and u4 >= u8;
+        u8 := "00010000";
+        assert u4 < u8 and u8 > u4;
+        assert not (u4 >= u8);
+        u8 := "0000101H";
+        assert u4 < u8;
+
+        s4 := "1010";                   -- -6
+        s8 := "11111010";               -- -6
+        assert s4 = s8;
+        s8 := "00000001";
+        assert s4 < s8 and s8 > s4;
+        s8 := "10000000";               -- -128
+        assert s8 < s4 and s4 > s8;
+        assert s8 /= s4;
+
+        -- Shifts and rotates
+        u8 := "10010110";
+        assert shift_left(u8, 3) = "10110000";
+        assert shift_right(u8, 3) = "00010010";
+        assert shift_left(u8, 100) = "00000000";
+        assert rotate_left(u8, 3) = "10110100";
+        assert rotate_right(u8, 3) = "11010010";
+        assert rotate_left(u8, 11) = rotate_left(u8, 3);
+        s8 := "10010110";
+        assert shift_right(s8, 3) = "11110010";
+        assert shift_right(s8, 100) = "11111111";
+        assert shift_right(s8, 0) = s8;
+        s1 := "1";
+        assert shift_right(s1, 5) = "1";
+
+        -- Conversions to integer
+        assert to_integer(unsigned'("1111111111111111111111111111111")) = integer'high;
+        assert to_integer(signed'("10000000000000000000000000000000")) = integer'low;
+        assert to_integer(signed'("1111111111111111111111111111111111110")) = -2;
+        u70 := (others => '0');
+        u70(5 downto 0) := "101010";
+        assert to_integer(u70) = 42;
+
+        -- Division
+        u8 := to_unsigned(200, 8);
+        u4 := to_unsigned(7, 4);
+        assert u8 / u4 = to_unsigned(28, 8);
+        assert u8 mod u4 = to_unsigned(4, 4);
+        assert u8 rem u4 = to_unsigned(4, 4);
+        s8 := to_signed(-100, 8);
+        s4 := to_signed(7, 4);
+        assert s8 / s4 = to_signed(-14, 8);
+        assert s8 rem s4 = to_signed(-2, 4);
+        assert s8 mod s4 = to_signed(5, 4);
+        s4 := to_signed(-7, 4);
+        assert s8 / s4 = to_signed(14, 8);
+        assert s8 rem s4 = to_signed(-2, 4);
+        assert s8 mod s4 = to_signed(-2, 4);
+        s8 := to_signed(100, 8);
+        assert s8 mod s4 = to_signed(-5, 4);
+        s8 := to_signed(-128, 8);
+        s4 := to_signed(-1, 4);
+        assert s8 / s4 = to_signed(-128, 8);
+        u70 := (69 => '1', others => '0');
+        assert u70 / to_unsigned(2, 8) = shift_right(u70, 1);
+        assert u70 mod to_unsigned(3, 8) = to_unsigned(2, 8);
+
+        -- String conversions
+        assert to_hstring(std_ulogic_vector'("101011110")) = "15E";
+        assert to_hstring(std_ulogic_vector'("ZZZZ0001X")) = "ZXX";
+        assert to_hstring(std_ulogic_vector'("Z0001")) = "Z1";
+        assert to_ostring(std_ulogic_vector'("11101")) = "35";
+        assert to_hstring(signed'("10111")) = "F7";
+        assert to_hstring(unsigned'("10111")) = "17";
+        assert to_ostring(signed'("1101")) = "75";
+
+        wait;
+    end process;
+
+end architecture;
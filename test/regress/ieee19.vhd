@@ -0,0 +1,145 @@
+entity ieee19 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+architecture test of ieee19 is
+
+    constant values : std_ulogic_vector(0 to 8) := "UX01ZWLH-";
+
+    -- Deterministic pseudo-random vector covering all nine values
+    function make_vector (len, seed : natural) return std_ulogic_vector is
+        variable r : std_ulogic_vector(1 to len);
+        variable s : natural := seed;
+    begin
+        for i in r'range loop
+            s := (s * 37 + 11) mod 9973;
+            r(i) := values(s mod 9);
+        end loop;
+        return r;
+    end function;
+
+    -- Compare the vectorised std_logic_1164 and numeric_std intrinsics
+    -- against the scalar operators element by element
+    procedure check (len, seed : natural) is
+        constant a : std_ulogic_vector(1 to len) := make_vector(len, seed);
+        constant b : std_ulogic_vector(1 to len) := make_vector(len, seed * 7);
+        variable r : std_ulogic_vector(1 to len);
+        variable m : std_ulogic_vector(1 to len);
+        variable u : unsigned(1 to len);
+        variable match, all01 : boolean;
+    begin
+        r := a and b;
+        for i in r'range loop
+            assert r(i) = (a(i) and b(i)) report "and" severity failure;
+        end loop;
+
+        r := a or b;
+        for i in r'range loop
+            assert r(i) = (a(i) or b(i)) report "or" severity failure;
+        end loop;
+
+        r := a xor b;
+        for i in r'range loop
+            assert r(i) = (a(i) xor b(i)) report "xor" severity failure;
+        end loop;
+
+        r := a nand b;
+        for i in r'range loop
+            assert r(i) = (a(i) nand b(i)) report "nand" severity failure;
+        end loop;
+
+        r := a nor b;
+        for i in r'range loop
+            assert r(i) = (a(i) nor b(i)) report "nor" severity failure;
+        end loop;
+
+        r := a xnor b;
+        for i in r'range loop
+            assert r(i) = (a(i) xnor b(i)) report "xnor" severity failure;
+        end loop;
+
+        r := not a;
+        for i in r'range loop
+            assert r(i) = (not a(i)) report "not" severity failure;
+        end loop;
+
+        r := to_x01(a);
+        for i in r'range loop
+            assert r(i) = to_x01(a(i)) report "to_x01" severity failure;
+        end loop;
+
+        match := true;
+        for i in a'range loop
+            match := match and a(i) = b(i);
+        end loop;
+        assert (a = b) = match report "=" severity failure;
+        assert a = a report "= self" severity failure;
+
+        match := true;
+        for i in a'range loop
+            match := match and std_match(a(i), b(i));
+        end loop;
+        assert std_match(a, b) = match report "std_match" severity failure;
+
+        -- Mostly matching with a mismatch or don't care in the tail
+        for i in m'range loop
+            case a(i) is
+                when 'L' => m(i) := '0';
+                when 'H' => m(i) := '1';
+                when '0' | '1' => m(i) := a(i);
+                when others => m(i) := '-';
+            end case;
+        end loop;
+        assert std_match(a, m) report "std_match tail" severity failure;
+        m(len) := 'U';
+        assert std_match(a, m) = (a(len) = '-')
+            report "std_match last" severity failure;
+
+        u := to_01(unsigned(a), 'X');
+        all01 := true;
+        for i in a'range loop
+            all01 := all01 and (a(i) = '0' or a(i) = '1' or a(i) = 'L'
+                                or a(i) = 'H');
+        end loop;
+        for i in u'range loop
+            if not all01 then
+                assert u(i) = 'X' report "to_01 xmap" severity failure;
+            else
+                assert u(i) = to_x01(a(i)) report "to_01" severity failure;
+            end if;
+        end loop;
+
+        -- Input without metavalues is returned unchanged
+        all01 := true;
+        for i in 1 to len - 1 loop
+            all01 := all01 and m(i) /= '-';
+        end loop;
+        u := to_01(unsigned(m(1 to len - 1) & '1'));
+        for i in 1 to len - 1 loop
+            if all01 then
+                assert u(i) = m(i) report "to_01 all" severity failure;
+            else
+                assert u(i) = '0' report "to_01 dc" severity failure;
+            end if;
+        end loop;
+    end procedure;
+
+begin
+
+    process is
+    begin
+        for seed in 1 to 3 loop
+            for len in 1 to 100 loop
+                check(len, seed);
+            end loop;
+
+            check(1000 + seed, seed);   -- Many full vectors plus a tail
+        end loop;
+
+        wait;
+    end process;
+
+end architecture;
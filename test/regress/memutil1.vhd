@@ -0,0 +1,48 @@
+entity memutil1 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+library nvc;
+use nvc.mem_util.all;
+
+use std.textio.all;
+
+architecture test of memutil1 is
+begin
+
+    process is
+        file f : text;
+        variable l : line;
+        variable mem : std_ulogic_vector(0 to 31) := (others => 'U');
+    begin
+        file_open(f, "mem.hex", WRITE_MODE);
+        write(l, string'("// Comment"));
+        writeline(f, l);
+        write(l, string'("a5 1_f"));
+        writeline(f, l);
+        write(l, string'("@3 x0"));
+        writeline(f, l);
+        file_close(f);
+
+        read_mem_hex("mem.hex", mem, 8);
+        assert mem(0 to 7) = "10100101";
+        assert mem(8 to 15) = "00011111";
+        assert mem(16 to 23) = "UUUUUUUU";
+        assert mem(24 to 31) = "XXXX0000";
+
+        file_open(f, "mem.bin", WRITE_MODE);
+        write(l, string'("1z /* Comment */ 0101"));
+        writeline(f, l);
+        file_close(f);
+
+        read_mem_bin("mem.bin", mem, 4);
+        assert mem(0 to 3) = "001Z";
+        assert mem(4 to 7) = "0101";
+        assert mem(8 to 15) = "00011111";
+
+        wait;
+    end process;
+
+end architecture;
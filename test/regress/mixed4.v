@@ -0,0 +1,32 @@
+primitive mux2(o, s, a, b);
+   output o;
+   input  s, a, b;
+
+   table
+   // s  a  b  :  o  ;
+      0  0  ?  :  0  ;
+      0  1  ?  :  1  ;
+      1  ?  0  :  0  ;
+      1  ?  1  :  1  ;
+      x  0  0  :  0  ;
+      x  1  1  :  1  ;
+   endtable
+
+endprimitive
+
+primitive dffr(q, cp, d, rn);
+   output q;
+   input  cp, d, rn;
+   reg	  q;
+
+   table
+   // cp  d  rn  :  q  :  q  ;
+      ?   ?  0   :  ?  :  0  ;
+      r   0  1   :  ?  :  0  ;
+      r   1  1   :  ?  :  1  ;
+      n   ?  1   :  ?  :  -  ;
+      ?   *  b   :  ?  :  -  ;
+      ?   ?  r   :  ?  :  -  ;
+   endtable
+
+endprimitive
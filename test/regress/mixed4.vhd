@@ -0,0 +1,78 @@
+entity mixed4 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+architecture test of mixed4 is
+    component mux2 is
+	port ( o : out std_logic;
+	       s, a, b : in std_logic );
+    end component;
+
+    component dffr is
+	port ( q : out std_logic;
+	       cp, d, rn : in std_logic );
+    end component;
+
+    signal o, s, a, b : std_logic := '0';
+    signal q, cp, d, rn : std_logic := '0';
+begin
+
+    u1: component mux2
+	port map ( o, s, a, b );
+
+    u2: component dffr
+	port map ( q, cp, d, rn );
+
+    check: process is
+    begin
+	a <= '1';
+	wait for 1 ns;
+	assert o = '1';
+	s <= '1';
+	wait for 1 ns;
+	assert o = '0';
+	s <= 'X';
+	wait for 1 ns;
+	assert o = 'X';
+	b <= '1';
+	wait for 1 ns;
+	assert o = '1';
+	s <= 'Z';                       -- Treated as X
+	wait for 1 ns;
+	assert o = '1';
+
+	assert q = '0';
+	rn <= '1';
+	wait for 1 ns;
+	assert q = '0';
+	d <= '1';
+	wait for 1 ns;
+	assert q = '0';
+	cp <= '1';
+	wait for 1 ns;
+	assert q = '1';
+	d <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	cp <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	cp <= '1';
+	wait for 1 ns;
+	assert q = '0';
+	d <= '1';
+	cp <= '0';
+	wait for 1 ns;
+	cp <= '1';
+	wait for 1 ns;
+	assert q = '1';
+	rn <= '0';
+	wait for 1 ns;
+	assert q = '0';
+
+	wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,18 @@
+module readmem(ok);
+  output ok;
+  reg    ok;
+  reg [15:0] r;
+  reg [3:0]  b;
+
+  initial begin
+    ok = 0;
+    r = 0;
+    b = 4'b1111;
+    #1 $readmemh("mixed5.hex", r);
+    $readmemb("mixed5.bin", b, 0, 0);
+    if (r === 16'h12a5)
+      if (b === 4'b00z1)
+        ok = 1;
+  end
+
+endmodule // readmem
@@ -0,0 +1,41 @@
+entity mixed5 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+use std.textio.all;
+
+architecture test of mixed5 is
+    component readmem is
+	port ( ok : out std_logic );
+    end component;
+
+    signal ok : std_logic;
+begin
+
+    uut: component readmem
+	port map ( ok );
+
+    check: process is
+	file f : text;
+	variable l : line;
+    begin
+	file_open(f, "mixed5.hex", WRITE_MODE);
+	write(l, string'("// Comment"));
+	writeline(f, l);
+	write(l, string'("12_a5"));
+	writeline(f, l);
+	file_close(f);
+
+	file_open(f, "mixed5.bin", WRITE_MODE);
+	write(l, string'("@0 0z1"));
+	writeline(f, l);
+	file_close(f);
+
+	wait until ok = '1' for 1 ms;
+	assert ok = '1';
+	wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,42 @@
+// Both primitives have too many inputs to be compiled to a single
+// lookup table and are evaluated row by row
+
+primitive and9(o, a, b, c, d, e, f, g, h, i);
+   output o;
+   input  a, b, c, d, e, f, g, h, i;
+
+   table
+   // a  b  c  d  e  f  g  h  i  :  o  ;
+      1  1  1  1  1  1  1  1  1  :  1  ;
+      0  ?  ?  ?  ?  ?  ?  ?  ?  :  0  ;
+      ?  0  ?  ?  ?  ?  ?  ?  ?  :  0  ;
+      ?  ?  0  ?  ?  ?  ?  ?  ?  :  0  ;
+      ?  ?  ?  0  ?  ?  ?  ?  ?  :  0  ;
+      ?  ?  ?  ?  0  ?  ?  ?  ?  :  0  ;
+      ?  ?  ?  ?  ?  0  ?  ?  ?  :  0  ;
+      ?  ?  ?  ?  ?  ?  0  ?  ?  :  0  ;
+      ?  ?  ?  ?  ?  ?  ?  0  ?  :  0  ;
+      ?  ?  ?  ?  ?  ?  ?  ?  0  :  0  ;
+   endtable
+
+endprimitive
+
+primitive ddr(q, cp, d, rn, en, t1, t2, t3);
+   output q;
+   input  cp, d, rn, en, t1, t2, t3;
+   reg	  q;
+
+   table
+   // cp  d  rn  en  t1  t2  t3  :  q  :  q  ;
+      ?   ?  0   ?   ?   ?   ?   :  ?  :  0  ;
+      r   0  1   1   B   b   ?   :  ?  :  0  ;
+      r   1  1   1   B   b   ?   :  ?  :  1  ;
+      f   0  1   1   B   b   ?   :  ?  :  0  ;
+      f   1  1   1   B   b   ?   :  ?  :  1  ;
+      p   ?  1   1   ?   ?   ?   :  ?  :  x  ;
+      n   ?  1   1   ?   ?   ?   :  ?  :  x  ;
+      *   ?  1   0   ?   ?   ?   :  ?  :  -  ;
+      ?   *  1   ?   ?   ?   ?   :  ?  :  -  ;
+   endtable
+
+endprimitive
@@ -0,0 +1,115 @@
+entity mixed6 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+architecture test of mixed6 is
+    component and9 is
+	port ( o : out std_logic;
+	       a, b, c, d, e, f, g, h, i : in std_logic );
+    end component;
+
+    component ddr is
+	port ( q : out std_logic;
+	       cp, d, rn, en, t1, t2, t3 : in std_logic );
+    end component;
+
+    signal o : std_logic;
+    signal ins : std_logic_vector(1 to 9) := (others => '1');
+    signal q, cp, d, rn, en, t1, t2, t3 : std_logic := '0';
+begin
+
+    u1: component and9
+	port map ( o, ins(1), ins(2), ins(3), ins(4), ins(5), ins(6),
+		   ins(7), ins(8), ins(9) );
+
+    u2: component ddr
+	port map ( q, cp, d, rn, en, t1, t2, t3 );
+
+    check: process is
+    begin
+	wait for 1 ns;
+	assert o = '1';
+	ins(5) <= '0';
+	wait for 1 ns;
+	assert o = '0';
+	ins(5) <= 'X';
+	wait for 1 ns;
+	assert o = 'X';                 -- No matching row
+	ins(5) <= '1';
+	ins(9) <= 'Z';                  -- Treated as X
+	wait for 1 ns;
+	assert o = 'X';
+	ins(1) <= '0';
+	wait for 1 ns;
+	assert o = '0';
+
+	assert q = '0';
+	rn <= '1';
+	wait for 1 ns;
+	assert q = '0';
+	d <= '1';
+	en <= '1';
+	wait for 1 ns;
+	assert q = '0';
+	cp <= '1';                      -- Rising edge
+	wait for 1 ns;
+	assert q = '1';
+	d <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	cp <= '0';                      -- Falling edge
+	wait for 1 ns;
+	assert q = '0';
+	en <= '0';
+	d <= '1';
+	wait for 1 ns;
+	cp <= '1';                      -- Disabled
+	wait for 1 ns;
+	assert q = '0';
+	en <= '1';
+	wait for 1 ns;
+	cp <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	t1 <= 'X';                      -- Does not match B
+	wait for 1 ns;
+	cp <= '1';
+	wait for 1 ns;
+	assert q = 'X';
+	t1 <= '1';
+	wait for 1 ns;
+	cp <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	t2 <= 'X';                      -- Does not match b
+	wait for 1 ns;
+	cp <= '1';
+	wait for 1 ns;
+	assert q = 'X';
+	t2 <= '0';
+	wait for 1 ns;
+	cp <= '0';
+	wait for 1 ns;
+	assert q = '1';
+	cp <= 'X';                      -- Positive edge from 0 to X
+	wait for 1 ns;
+	assert q = 'X';
+	rn <= '0';
+	wait for 1 ns;
+	assert q = '0';
+	rn <= '1';
+	wait for 1 ns;
+	cp <= '0';                      -- Negative edge from X to 0
+	wait for 1 ns;
+	assert q = 'X';
+	t3 <= 'X';
+	rn <= '0';
+	wait for 1 ns;
+	assert q = '0';
+
+	wait;
+    end process;
+
+end architecture;
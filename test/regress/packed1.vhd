@@ -0,0 +1,103 @@
+-- Run with NVC_PACKED_VALUES=1 to store driver values four bits per
+-- element
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity packed1 is
+end entity;
+
+architecture test of packed1 is
+    signal narrow   : std_logic_vector(2 downto 0);
+    signal wide     : std_logic_vector(36 downto 0);
+    signal res2     : std_logic_vector(18 downto 0);
+    signal res3     : std_logic_vector(4 downto 0);
+    signal unres    : std_ulogic_vector(10 downto 0);
+    signal forced   : std_logic_vector(12 downto 0);
+begin
+
+    p1: process is
+    begin
+        narrow <= "UX0";
+        wide <= (others => 'Z');
+        res2 <= (others => 'Z');
+        res3 <= "ZZZZZ";
+        wait for 1 ns;
+        narrow <= "1HL";
+        wide <= "01XZWLH-U" & "01XZWLH-U" & "01XZWLH-U" & "01XZWLH-U" & "0";
+        res2 <= "0000000001111111111";
+        res3 <= "0Z1ZL";
+        wait for 1 ns;
+        -- Drive only part of the vector to split the nexus
+        wide(20 downto 3) <= (others => '1');
+        res2(10 downto 0) <= (others => 'Z');
+        wait;
+    end process;
+
+    p2: process is
+    begin
+        res2 <= (others => 'Z');
+        res3 <= "ZZZZZ";
+        wait for 1 ns;
+        res2 <= "0101010101010101010";
+        res3 <= "1Z0ZH";
+        wait for 1 ns;
+        assert res2'driving_value = "0101010101010101010";
+        wait;
+    end process;
+
+    p3: process is
+    begin
+        res3 <= "ZZZZZ";
+        wait for 1 ns;
+        res3 <= "ZZZ1Z";
+        wait;
+    end process;
+
+    p4: process is
+    begin
+        unres <= "UX01ZWLH-01";
+        wait for 1 ns;
+        unres <= "10HL-WZ10XU";
+        wait for 0 ns;
+        assert unres'driving_value = "10HL-WZ10XU";
+        wait;
+    end process;
+
+    forced <= "0101011110000";
+
+    check: process is
+    begin
+        wait for 500 ps;
+        assert narrow = "UX0";
+        assert wide = (36 downto 0 => 'Z');
+        assert res2 = (18 downto 0 => 'Z');
+        assert res3 = "ZZZZZ";
+        assert unres = "UX01ZWLH-01";
+        assert forced = "0101011110000";
+
+        wait for 1 ns;
+        assert narrow = "1HL";
+        assert wide = "01XZWLH-U01XZWLH-U01XZWLH-U01XZWLH-U0";
+        assert res2 = "0X0X0X0X01X1X1X1X1X";
+        assert res3 = "XZX1W" report to_string(res3);
+        assert unres = "10HL-WZ10XU";
+
+        forced <= force "ZZZZZZZZZ0001";
+        wait for 0 ns;
+        assert forced = "ZZZZZZZZZ0001";
+
+        wait for 1 ns;
+        assert wide(36 downto 21) = "01XZWLH-U01XZWLH";
+        assert wide(20 downto 3) = (20 downto 3 => '1');
+        assert wide(2 downto 0) = "-U0";
+        assert res2 = "0X0X0X0X01010101010";
+        assert forced = "ZZZZZZZZZ0001";
+
+        forced <= release;
+        wait for 0 ns;
+        assert forced = "0101011110000";
+
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,53 @@
+entity psl12 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+architecture test of psl12 is
+    signal clk : std_logic := '0';
+    signal a, b : std_logic := '0';
+
+    default clock is rising_edge(clk);
+
+    procedure pulse (signal clk : out std_logic) is
+    begin
+        wait for 1 ns;
+        clk <= '1';
+        wait for 1 ns;
+        clk <= '0';
+    end procedure;
+begin
+
+    -- Small enough to be converted to a DFA
+    one: assert always a -> next[2] b;
+
+    -- Too many states so stays as an NFA
+    two: assert always a -> next[70] b;
+
+    stim: process is
+    begin
+        pulse(clk);                     -- 1 ns
+        a <= '1';
+        pulse(clk);                     -- 3 ns: both triggered
+        a <= '0';
+        pulse(clk);                     -- 5 ns
+        a <= '1';
+        pulse(clk);                     -- 7 ns: one fails, both triggered
+        a <= '0';
+        pulse(clk);                     -- 9 ns
+        b <= '1';
+        pulse(clk);                     -- 11 ns: one passes
+        b <= '0';
+        for i in 1 to 67 loop
+            pulse(clk);                 -- 13 ns to 145 ns: two fails at 143 ns
+        end loop;
+        b <= '1';
+        pulse(clk);                     -- 147 ns: two passes
+        b <= '0';
+        pulse(clk);
+
+        std.env.finish;
+    end process;
+
+end architecture;
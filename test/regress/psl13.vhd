@@ -0,0 +1,44 @@
+entity psl13 is
+end entity;
+
+library ieee;
+use ieee.std_logic_1164.all;
+
+architecture test of psl13 is
+    signal clk1, clk2 : std_logic := '0';
+    signal x, y : std_logic := '0';
+
+    default clock is rising_edge(clk1);
+begin
+
+    -- All properties in the architecture share a clock and are
+    -- evaluated together in declaration order
+    one: cover {x} report "one";
+    two: cover {x; y} report "two";
+    three: cover {y} report "three";
+    four: assert always y -> next y;    -- Fails at 25 ns
+
+    b: block is
+        default clock is rising_edge(clk2);
+    begin
+        -- Separate group for the second clock
+        five: cover {x; y} report "five";
+        six: assert always x -> next x;     -- Fails at 20 ns
+    end block;
+
+    clk1 <= not clk1 after 5 ns when now < 40 ns;
+    clk2 <= not clk2 after 4 ns when now < 40 ns;
+
+    stim: process is
+    begin
+        wait for 2 ns;
+        x <= '1';
+        wait for 11 ns;
+        x <= '0';
+        y <= '1';
+        wait for 10 ns;
+        y <= '0';
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,36 @@
+entity sdf1_buf is
+    generic ( tpd_a_y : time := 1 ns;
+              tipd_a  : time := 0 ns );
+    port ( a : in bit;
+           y : out bit );
+end entity;
+
+architecture test of sdf1_buf is
+begin
+    y <= a after tpd_a_y + tipd_a;
+end architecture;
+
+-------------------------------------------------------------------------------
+
+entity sdf1 is
+end entity;
+
+architecture test of sdf1 is
+    signal a, y0, y1 : bit;
+begin
+
+    u0: entity work.sdf1_buf port map (a, y0);  -- Annotated by instance
+    u1: entity work.sdf1_buf port map (a, y1);  -- Annotated by cell type
+
+    check: process is
+    begin
+        wait for 1 ns;
+        a <= '1';
+        wait on y0;
+        assert now = 5 ns;              -- 3 ns IOPATH + 1 ns PORT
+        wait on y1;
+        assert now = 6 ns;              -- 5 ns IOPATH
+        wait;
+    end process;
+
+end architecture;
@@ -0,0 +1,44 @@
+set -xe
+
+nvc -a - <<EOF
+entity stats1 is
+end entity;
+
+architecture test of stats1 is
+  signal clk   : bit := '0';
+  signal count : natural := 0;
+begin
+  clkgen: process is
+  begin
+    for i in 1 to 20 loop
+      clk <= not clk;
+      wait for 2 ns;
+      wait for 3 ns;
+    end loop;
+    wait;
+  end process;
+
+  counter: process (clk) is
+  begin
+    if clk = '1' then
+      count <= count + 1;
+    end if;
+  end process;
+end architecture;
+EOF
+
+nvc -e stats1 -r --stats=activity >out 2>&1
+cat out
+
+grep "top .* most active processes and signals" out
+
+# The most active process is listed first
+grep -A1 "Process runs" out | tail -1 | grep -Ei "clkgen +41 "
+grep -A2 "Process runs" out | tail -1 | grep -Ei "counter +21 "
+
+grep -A2 "Signal events" out | grep -Ei "clk +20 "
+grep -A2 "Signal events" out | grep -Ei "count +10 "
+
+! nvc -r --stats=summary,bogus stats1 2>err
+cat err
+grep "unknown statistics type 'bogus'" err
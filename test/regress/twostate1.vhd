@@ -0,0 +1,44 @@
+library ieee;
+use ieee.std_logic_1164.all;
+
+entity twostate1 is
+end entity;
+
+architecture test of twostate1 is
+    subtype t_one is std_ulogic range '1' to '1';
+
+    signal s : std_logic;
+    signal v : std_logic_vector(3 downto 0);
+    signal r : std_logic := 'U';
+    signal t : std_logic;
+    signal u : std_logic_vector(1 to 3);
+    signal w : t_one;                   -- '0' not in range
+begin
+
+    p1: process is
+        variable x : std_ulogic;
+        variable y : std_logic_vector(1 to 2);
+    begin
+        assert s = '0';
+        assert v = "0000";
+        assert x = '0';
+        assert y = "00";
+        assert r = 'U';
+        assert w = '1';
+        s <= '1';
+        v <= "1010";
+        wait for 1 ns;
+        assert s = '1';
+        assert v = "1010";
+        t <= 'X';                       -- Warning
+        u <= "0Z1";                     -- Warning
+        wait for 1 ns;
+        t <= 'Z';                       -- No second warning
+        u <= "ZZ1";
+        wait for 1 ns;
+        assert t = 'Z';
+        assert u = "ZZ1";
+        wait;
+    end process;
+
+end architecture;
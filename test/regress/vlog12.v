@@ -0,0 +1,47 @@
+module vlog12;
+  reg a, b, c;
+  wire s1, c1, s2, c2, co, n1, n2, x1;
+
+  // Full adder and some extra levels of logic built from primitives
+  xor (s1, a, b);
+  and (c1, a, b);
+  xor (s2, s1, c);
+  and (c2, s1, c);
+  or (co, c1, c2);
+  nand (n1, s2, co);
+  nor (n2, s2, co);
+  not (x1, n1);
+
+  initial begin
+    a = 0;
+    b = 0;
+    c = 0;
+    #1 $display("%d %d %d %d %d", s2, co, n1, n2, x1);
+    if (s2 !== 0 || co !== 0 || n1 !== 1 || n2 !== 1 || x1 !== 0)
+      $display("FAILED");
+
+    a = 1;
+    #1 $display("%d %d %d %d %d", s2, co, n1, n2, x1);
+    if (s2 !== 1 || co !== 0 || n1 !== 1 || n2 !== 0 || x1 !== 0)
+      $display("FAILED");
+
+    b = 1;
+    #1 $display("%d %d %d %d %d", s2, co, n1, n2, x1);
+    if (s2 !== 0 || co !== 1 || n1 !== 1 || n2 !== 0 || x1 !== 0)
+      $display("FAILED");
+
+    c = 1;
+    #1 $display("%d %d %d %d %d", s2, co, n1, n2, x1);
+    if (s2 !== 1 || co !== 1 || n1 !== 0 || n2 !== 0 || x1 !== 1)
+      $display("FAILED");
+
+    a = 0;
+    b = 0;
+    #1 $display("%d %d %d %d %d", s2, co, n1, n2, x1);
+    if (s2 !== 1 || co !== 0 || n1 !== 1 || n2 !== 0 || x1 !== 0)
+      $display("FAILED");
+
+    $display("PASSED");
+  end
+
+endmodule // vlog12
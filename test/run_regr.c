@@ -49,6 +49,7 @@
 #include <windows.h>
 #include <fileapi.h>
 #define setenv(x, y, z) _putenv_s((x), (y))
+#define unsetenv(x) _putenv_s((x), "")
 #define realpath(N, R) _fullpath((R), (N), _MAX_PATH)
 #else
 #include <sys/wait.h>
@@ -97,6 +98,8 @@
 #define F_SHUFFLE (1 << 24)
 #define F_NOTBSD  (1 << 25)
 #define F_ARRAYS  (1 << 26)
+#define F_2STATE  (1 << 27)
+#define F_SDF     (1 << 28)
 
 typedef struct test test_t;
 typedef struct param param_t;
@@ -413,6 +416,10 @@ static bool parse_test_list(int argc, char **argv)
             test->flags |= F_SHUFFLE;
          else if (strcmp(opt, "no-collapse") == 0)
             test->flags |= F_NOCOLL;
+         else if (strcmp(opt, "two-state") == 0)
+            test->flags |= F_2STATE;
+         else if (strcmp(opt, "sdf") == 0)
+            test->flags |= F_SDF;
          else if (strcmp(opt, "dump-arrays") == 0)
             test->flags |= F_ARRAYS;
          else if (strncmp(opt, "dump-arrays=", 12) == 0) {
@@ -888,6 +895,13 @@ static bool run_test(test_t *test)
       if (test->flags & F_NOCOLL)
          push_arg(&args, "--no-collapse");
 
+      if (test->flags & F_2STATE)
+         push_arg(&args, "--two-state");
+
+      if (test->flags & F_SDF)
+         push_arg(&args, "--sdf=%s" DIR_SEP "regress" DIR_SEP "%s.sdf",
+                  test_dir, test->name);
+
       if (test->flags & F_COVER) {
          if (test->cover)
             push_arg(&args, "--cover=%s", test->cover);
@@ -1201,6 +1215,11 @@ static bool run_test(test_t *test)
    fclose(outf);
 
  out_chdir:
+   for (param_t *p = test->params; p != NULL; p = p->next) {
+      if (p->kind == P_ENVVAR)
+         unsetenv(p->name);   // Do not leak into the following tests
+   }
+
    if (chdir(cwd) != 0) {
       set_attr(ANSI_FG_RED);
       printf("Failed to switch to %s: %s\n", cwd, strerror(errno));
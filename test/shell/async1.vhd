@@ -0,0 +1,14 @@
+entity async1 is
+end entity;
+
+architecture test of async1 is
+    signal count : natural;
+begin
+
+    process is
+    begin
+        count <= count + 1;
+        wait for 1 ns;
+    end process;
+
+end architecture;
@@ -0,0 +1,17 @@
+entity deltas1 is
+end entity;
+
+architecture test of deltas1 is
+    signal count : natural;
+begin
+
+    storm: process (count) is
+    begin
+        if count mod 32 /= 31 then
+            count <= count + 1;
+        else
+            count <= count + 1 after 1 ns;
+        end if;
+    end process;
+
+end architecture;
@@ -16,8 +16,15 @@
 //
 
 #include "debug.h"
+#include "rt/profile.h"
 #include "test_util.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
 #if defined __clang__
 #pragma clang optimize off
 #elif defined __GNUC__
@@ -72,6 +79,63 @@ START_TEST(test_symbol_name)
 }
 END_TEST
 
+DLLEXPORT
+__attribute__((noinline))
+void profile_busy_loop(void)
+{
+   // Only check the time occasionally so most samples land here
+   // rather than in the C library
+   const clock_t start = clock();
+   volatile unsigned ctr = 0;
+   do {
+      for (int i = 0; i < 1000000; i++)
+         ctr++;
+   } while (clock() - start < CLOCKS_PER_SEC / 5);
+}
+
+START_TEST(test_profile)
+{
+   char tmpl[] = "/tmp/nvc-profile-XXXXXX";
+   int fd = mkstemp(tmpl);
+   fail_if(fd < 0);
+   close(fd);
+
+   profile_start();
+   profile_busy_loop();
+   profile_stop(tmpl);
+
+   FILE *f = fopen(tmpl, "r");
+   fail_if(f == NULL);
+
+   bool found = false;
+   char line[1024];
+   while (fgets(line, sizeof(line), f)) {
+      // Each line is a semicolon separated stack followed by a count
+      char *space = strrchr(line, ' ');
+      fail_if(space == NULL);
+      fail_unless(atoi(space + 1) > 0);
+
+      const char *leaf = strrchr(line, ';');
+      leaf = leaf ? leaf + 1 : line;
+
+      if (strncmp(leaf, "profile_busy_loop", 17) == 0) {
+         found = true;
+
+         // Source location is appended when debug info is available
+         if (leaf[17] == '[')
+            fail_if(strstr(leaf, "test_debug.c:") == NULL);
+         else
+            fail_unless(leaf[17] == ' ');
+      }
+   }
+
+   fclose(f);
+   remove(tmpl);
+
+   fail_unless(found);
+}
+END_TEST
+
 Suite *get_debug_tests(void)
 {
    Suite *s = suite_create("debug");
@@ -79,6 +143,9 @@ Suite *get_debug_tests(void)
    TCase *tc_core = nvc_unit_test();
    tcase_add_test(tc_core, test_capture);
    tcase_add_test(tc_core, test_symbol_name);
+#ifndef __MINGW32__
+   tcase_add_test(tc_core, test_profile);
+#endif
    suite_add_tcase(s, tc_core);
 
    return s;
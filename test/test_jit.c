@@ -21,6 +21,7 @@
 #include "ident.h"
 #include "jit/jit-ffi.h"
 #include "jit/jit-layout.h"
+#include "jit/jit-llvm.h"
 #include "jit/jit-priv.h"
 #include "jit/jit.h"
 #include "mask.h"
@@ -28,6 +29,7 @@
 #include "option.h"
 #include "phase.h"
 #include "scan.h"
+#include "thread.h"
 #include "type.h"
 
 #include <math.h>
@@ -2081,7 +2083,7 @@ START_TEST(test_lscan1)
    jit_func_t *f = jit_get_func(j, h1);
 
    phys_slot_t *slots LOCAL = xmalloc_array(f->nregs, sizeof(phys_slot_t));
-   const int spills = jit_do_lscan(f, slots, ~UINT64_C(0x3));
+   const int spills = jit_do_lscan(f, slots, ~UINT64_C(0x3), 0);
 
    ck_assert_int_eq(spills, 1);
 
@@ -2097,6 +2099,549 @@ START_TEST(test_lscan1)
 }
 END_TEST
 
+START_TEST(test_lscan2)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    MOV    R0, #5      \n"
+      "    MOV    R1, R0      \n"
+      "    ADD    R2, R1, #1  \n"
+      "    $EXIT  #7          \n"
+      "    ADD    R3, R2, R1  \n"
+      "    SEND   #0, R3      \n"
+      "    RET                \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+
+   phys_slot_t *slots LOCAL = xmalloc_array(f->nregs, sizeof(phys_slot_t));
+   const int spills = jit_do_lscan(f, slots, ~UINT64_C(0xf), 0xc);
+
+   ck_assert_int_eq(spills, 0);
+
+   // R1 is coalesced with R0 and R2 is live across the call so
+   // should be assigned a callee-saved register
+   ck_assert_int_eq(slots[0], 0);
+   ck_assert_int_eq(slots[1], 0);
+   ck_assert_int_eq(slots[2], 2);
+   ck_assert_int_eq(slots[3], 1);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_lscan3)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    MOV    R0, #0      \n"
+      "    MOV    R1, #0      \n"
+      "    MOV    R2, #1000   \n"
+      "L1: ADD    R1, R1, R0  \n"
+      "    ADD    R0, R0, #1  \n"
+      "    CMP.LT R0, #10     \n"
+      "    JUMP.T L1          \n"
+      "    ADD    R1, R1, R2  \n"
+      "    SEND   #0, R1      \n"
+      "    RET                \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+
+   phys_slot_t *slots LOCAL = xmalloc_array(f->nregs, sizeof(phys_slot_t));
+   const int spills = jit_do_lscan(f, slots, ~UINT64_C(0x3), 0);
+
+   ck_assert_int_eq(spills, 1);
+
+   // R2 is not used inside the loop so is cheapest to spill
+   ck_assert_int_eq(slots[0], 0);
+   ck_assert_int_eq(slots[1], 1);
+   ck_assert_int_eq(slots[2], STACK_BASE);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_lscan4)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    MOV    R0, #5      \n"
+      "    MOV    R2, #7      \n"
+      "    MOV    R1, R0      \n"
+      "    ADD    R3, R1, R2  \n"
+      "    MOV    R1, R2      \n"
+      "    ADD    R4, R1, R3  \n"
+      "    SEND   #0, R4      \n"
+      "    RET                \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+
+   phys_slot_t *slots LOCAL = xmalloc_array(f->nregs, sizeof(phys_slot_t));
+   const int spills = jit_do_lscan(f, slots, ~UINT64_C(0xf), 0);
+
+   ck_assert_int_eq(spills, 0);
+
+   // R1 is coalesced with the source of its first move even though it
+   // is later assigned from R2
+   ck_assert_int_eq(slots[0], 0);
+   ck_assert_int_eq(slots[1], 0);
+   ck_assert_int_eq(slots[2], 1);
+   ck_assert_int_eq(slots[3], 2);
+   ck_assert_int_eq(slots[4], 1);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_vrp1)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    MOV      R0, #0       \n"
+      "L1: CMP.GT   R0, #7       \n"
+      "    JUMP.T   L3           \n"
+      "    CMP.GE   R0, #0       \n"
+      "    CCMP.LE  R0, #7       \n"
+      "    JUMP.T   L2           \n"
+      "    $EXIT    #0           \n"
+      "L2: ADD.O.32 R0, R0, #1   \n"
+      "    JUMP.F   L1           \n"
+      "    $EXIT    #1           \n"
+      "L3: RET                   \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+   jit_do_vrp(f);
+
+   check_unary(f, 5, J_JUMP, LABEL(7));
+   ck_assert_int_eq(f->irbuf[5].cc, JIT_CC_NONE);
+   check_nullary(f, 6, J_NOP);
+   check_binary(f, 7, J_ADD, REG(0), CONST(1));
+   ck_assert_int_eq(f->irbuf[7].cc, JIT_CC_NONE);
+   check_unary(f, 8, J_JUMP, LABEL(1));
+   ck_assert_int_eq(f->irbuf[8].cc, JIT_CC_NONE);
+   check_nullary(f, 9, J_NOP);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_vrp2)
+{
+   jit_t *j = jit_new(NULL);
+
+   // An unsigned 64-bit load may produce any bit pattern
+   const char *text1 =
+      "    RECV     R0, #0       \n"
+      "    ULOAD.64 R1, [R0]     \n"
+      "    CMP.GE   R1, #0       \n"
+      "    JUMP.T   L1           \n"
+      "    $EXIT    #0           \n"
+      "L1: RET                   \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f1 = jit_get_func(j, h1);
+   jit_do_vrp(f1);
+
+   check_unary(f1, 3, J_JUMP, LABEL(5));
+   ck_assert_int_eq(f1->irbuf[3].cc, JIT_CC_T);
+   check_unary(f1, 4, MACRO_EXIT, CONST(0));
+
+   // The jump after an arithmetic operation that cannot overflow must
+   // not be removed unless it tests the flags
+   const char *text2 =
+      "    RECV     R0, #0       \n"
+      "    CMP.EQ   R0, #0       \n"
+      "    JUMP.T   L2           \n"
+      "    MOV      R1, #5       \n"
+      "    ADD.O.32 R2, R1, #1   \n"
+      "    JUMP     L3           \n"
+      "L2: MOV      R2, #0       \n"
+      "L3: SEND     #0, R2       \n"
+      "    RET                   \n";
+
+   jit_handle_t h2 = jit_assemble(j, ident_new("myfunc2"), text2);
+
+   jit_func_t *f2 = jit_get_func(j, h2);
+   jit_do_vrp(f2);
+
+   check_unary(f2, 5, J_JUMP, LABEL(7));
+   ck_assert_int_eq(f2->irbuf[5].cc, JIT_CC_NONE);
+   check_unary(f2, 6, J_MOV, CONST(0));
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_licm1)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    MOV      R0, #0       \n"
+      "    MOV      R1, #0       \n"
+      "    RECV     R5, #0       \n"
+      "L1: MUL      R2, R0, #4   \n"
+      "    ADD      R3, R5, R2   \n"
+      "    LOAD.32  R4, [R3]     \n"
+      "    ADD      R1, R1, R4   \n"
+      "    LEA      R6, [R5+8]   \n"
+      "    ADD      R7, R6, #1   \n"
+      "    ADD      R1, R1, R7   \n"
+      "    ADD      R0, R0, #1   \n"
+      "    CMP.LT   R0, #10      \n"
+      "    JUMP.T   L1           \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+   jit_do_licm(f);
+
+   // Invariant address calculation moved to the preheader
+   check_unary(f, 3, J_LEA, ADDR(5, 8));
+   check_binary(f, 4, J_ADD, REG(6), CONST(1));
+
+   // Initial value of the strength reduced element pointer
+   check_binary(f, 5, J_MUL, REG(0), CONST(4));
+   check_binary(f, 6, J_ADD, REG(5), REG(8));
+
+   check_binary(f, 7, J_MUL, REG(0), CONST(4));
+   check_unary(f, 8, J_MOV, REG(9));
+   check_nullary(f, 11, J_NOP);
+   check_nullary(f, 12, J_NOP);
+   check_binary(f, 14, J_ADD, REG(0), CONST(1));
+   check_binary(f, 15, J_ADD, REG(9), CONST(4));
+   check_unary(f, 17, J_JUMP, LABEL(7));
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_licm2)
+{
+   jit_t *j = jit_new(NULL);
+
+   // Loop body is laid out before the header and falls through into it
+   const char *text1 =
+      "    MOV      R0, #0       \n"
+      "    MOV      R1, #0       \n"
+      "    RECV     R5, #0       \n"
+      "    JUMP     L2           \n"
+      "L1: LEA      R6, [R5+8]   \n"
+      "    ADD      R1, R1, R6   \n"
+      "    ADD      R0, R0, #1   \n"
+      "L2: CMP.LT   R0, #10      \n"
+      "    JUMP.T   L1           \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   jit_func_t *f = jit_get_func(j, h1);
+   jit_do_licm(f);
+
+   ck_assert_int_eq(f->nirs, 13);
+
+   // Entry edge goes through the preheader but the back edge skips it
+   check_unary(f, 3, J_JUMP, LABEL(8));
+   check_nullary(f, 4, J_NOP);
+   check_unary(f, 7, J_JUMP, LABEL(9));
+   ck_assert_int_eq(f->irbuf[7].cc, JIT_CC_NONE);
+   check_unary(f, 8, J_LEA, ADDR(5, 8));
+   check_binary(f, 9, J_CMP, REG(0), CONST(10));
+   check_unary(f, 10, J_JUMP, LABEL(4));
+
+   tlab_t tlab = jit_null_tlab(j);
+   jit_scalar_t result, p0 = { .integer = 5 };
+   fail_unless(jit_fastcall(j, h1, &result, p0, p0, &tlab));
+
+   ck_assert_int_eq(result.integer, 130);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_inline1)
+{
+   jit_t *j = jit_new(NULL);
+
+   const char *text1 =
+      "    RECV    R0, #0       \n"
+      "    ADD     R1, R0, #1   \n"
+      "    SEND    #0, R1       \n"
+      "    RET                  \n";
+
+   jit_assemble(j, ident_new("leaf"), text1);
+
+   const char *text2 =
+      "    RECV    R0, #0       \n"
+      "    SEND    #0, R0       \n"
+      "    CALL    <leaf>       \n"
+      "    RECV    R1, #0       \n"
+      "    MUL     R2, R1, #2   \n"
+      "    SEND    #0, R2       \n"
+      "    RET                  \n";
+
+   jit_handle_t h2 = jit_assemble(j, ident_new("caller"), text2);
+
+   jit_func_t *f = jit_get_func(j, h2);
+   jit_do_inline(f);
+
+   ck_assert_int_eq(f->nirs, 10);
+   ck_assert_int_eq(f->nregs, 5);
+
+   // Argument copied directly from the register the caller sent
+   check_unary(f, 2, J_MOV, REG(0));
+   check_binary(f, 3, J_ADD, REG(3), CONST(1));
+   check_binary(f, 4, J_SEND, CONST(0), REG(4));
+   check_unary(f, 5, J_JUMP, LABEL(6));
+   check_unary(f, 6, J_RECV, CONST(0));
+   ck_assert_int_eq(f->irbuf[6].target, 1);
+
+   for (int i = 0; i < f->nirs; i++)
+      fail_if(f->irbuf[i].op == J_CALL);
+
+   tlab_t tlab = jit_null_tlab(j);
+   jit_scalar_t result, p0 = { .integer = 5 };
+   fail_unless(jit_fastcall(j, h2, &result, p0, p0, &tlab));
+
+   ck_assert_int_eq(result.integer, 12);
+
+   jit_free(j);
+}
+END_TEST
+
+START_TEST(test_inline2)
+{
+   jit_t *j = jit_new(NULL);
+
+   // Recursive functions are never inlined into themselves
+   const char *text1 =
+      "    RECV    R0, #0       \n"
+      "    CMP.EQ  R0, #0       \n"
+      "    JUMP.T  L1           \n"
+      "    SUB     R1, R0, #1   \n"
+      "    SEND    #0, R1       \n"
+      "    CALL    <rec>        \n"
+      "    RECV    R0, #0       \n"
+      "L1: SEND    #0, R0       \n"
+      "    RET                  \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("rec"), text1);
+
+   jit_func_t *f1 = jit_get_func(j, h1);
+   jit_do_inline(f1);
+
+   ck_assert_int_eq(f1->nirs, 9);
+   check_nullary(f1, 5, J_CALL);
+
+   // Nor are functions that call anything else
+   const char *text2 =
+      "    RECV    R0, #0       \n"
+      "    SEND    #0, R0       \n"
+      "    CALL    <rec>        \n"
+      "    RET                  \n";
+
+   jit_handle_t h2 = jit_assemble(j, ident_new("notleaf"), text2);
+
+   const char *text3 =
+      "    SEND    #0, #3       \n"
+      "    CALL    <notleaf>    \n"
+      "    RET                  \n";
+
+   jit_handle_t h3 = jit_assemble(j, ident_new("caller1"), text3);
+
+   jit_func_t *f3 = jit_get_func(j, h3);
+   jit_do_inline(f3);
+
+   ck_assert_int_eq(f3->nirs, 3);
+   check_unary(f3, 1, J_CALL, (jit_value_t){ .kind = JIT_VALUE_HANDLE,
+                                             .handle = h2 });
+
+   // Or leaf functions larger than the size limit
+   LOCAL_TEXT_BUF tb = tb_new();
+   tb_cat(tb, "    RECV    R0, #0       \n");
+   for (int i = 0; i < 50; i++)
+      tb_cat(tb, "    ADD     R0, R0, #1   \n");
+   tb_cat(tb, "    SEND    #0, R0       \n");
+   tb_cat(tb, "    RET                  \n");
+
+   jit_assemble(j, ident_new("big"), tb_get(tb));
+
+   const char *text4 =
+      "    SEND    #0, #3       \n"
+      "    CALL    <big>        \n"
+      "    RET                  \n";
+
+   jit_handle_t h4 = jit_assemble(j, ident_new("caller2"), text4);
+
+   jit_func_t *f4 = jit_get_func(j, h4);
+   jit_do_inline(f4);
+
+   ck_assert_int_eq(f4->nirs, 3);
+   check_nullary(f4, 1, J_CALL);
+
+   jit_free(j);
+}
+END_TEST
+
+static int osr_entry_calls;
+
+static void osr_test_entry(jit_func_t *f, jit_anchor_t *caller,
+                           jit_scalar_t *args, tlab_t *tlab,
+                           jit_scalar_t *regs, unsigned char *frame,
+                           int32_t flags)
+{
+   // Stands in for compiled code resuming at the loop header of the
+   // function in test_osr1
+   osr_entry_calls++;
+
+   int64_t r0 = regs[0].integer, r1 = regs[1].integer;
+   do {
+      r1 += r0;
+      r0++;
+   } while (r0 < 5000);
+
+   args[0].integer = r1;
+}
+
+static void *osr_test_init(jit_t *j)
+{
+   return NULL;
+}
+
+static void osr_test_cgen(jit_t *j, jit_handle_t handle, void *context)
+{
+   jit_func_t *f = jit_get_func(j, handle);
+   ck_assert_int_eq(atomic_load(&f->osr_target), 2);
+
+   store_release(&f->osr_entry, osr_test_entry);
+}
+
+static void osr_test_cleanup(void *context)
+{
+}
+
+START_TEST(test_osr1)
+{
+   opt_set_int(OPT_JIT_ASYNC, 0);
+
+   jit_t *j = jit_new(NULL);
+
+   const jit_plugin_t plugin = {
+      .init    = osr_test_init,
+      .cgen    = osr_test_cgen,
+      .cleanup = osr_test_cleanup,
+   };
+   jit_add_tier(j, 1000000, &plugin);
+
+   const char *text1 =
+      "    MOV      R0, #0       \n"
+      "    MOV      R1, #0       \n"
+      "L1: ADD      R1, R1, R0   \n"
+      "    ADD      R0, R0, #1   \n"
+      "    CMP.LT   R0, #5000    \n"
+      "    JUMP.T   L1           \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   jit_handle_t h1 = jit_assemble(j, ident_new("myfunc1"), text1);
+
+   tlab_t tlab = jit_null_tlab(j);
+   jit_scalar_t result, p0 = { .integer = 0 };
+   fail_unless(jit_fastcall(j, h1, &result, p0, p0, &tlab));
+
+   ck_assert_int_eq(result.integer, 12497500);
+   ck_assert_int_eq(osr_entry_calls, 1);
+
+   // The next call starts in the interpreter and enters the same
+   // compiled loop once it becomes hot again
+   fail_unless(jit_fastcall(j, h1, &result, p0, p0, &tlab));
+
+   ck_assert_int_eq(result.integer, 12497500);
+   ck_assert_int_eq(osr_entry_calls, 2);
+
+   jit_free(j);
+}
+END_TEST
+
+#ifdef ENABLE_LLVM
+START_TEST(test_llvm_batch)
+{
+   jit_t *j = jit_new(NULL);
+
+   // The re-execute guard compares the entry pointer against the
+   // address of the function itself
+   const char *text1 =
+      "    RECV     R0, #0       \n"
+      "    CMP.EQ   R0, #12345   \n"
+      "    JUMP.F   L1           \n"
+      "    $REEXEC               \n"
+      "L1: MUL      R1, R0, #3   \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   const char *text2 =
+      "    RECV     R0, #0       \n"
+      "    ADD      R1, R0, #1   \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   const char *text3 =
+      "    RECV     R0, #0       \n"
+      "    CMP.EQ   R0, #12345   \n"
+      "    JUMP.F   L1           \n"
+      "    $REEXEC               \n"
+      "L1: SUB      R1, R0, #7   \n"
+      "    SEND     #0, R1       \n"
+      "    RET                   \n";
+
+   const jit_handle_t handles[] = {
+      jit_assemble(j, ident_new("myfunc1"), text1),
+      jit_assemble(j, ident_new("myfunc2"), text2),
+      jit_assemble(j, ident_new("myfunc3"), text3),
+   };
+
+   const jit_plugin_t *plugin = jit_get_llvm_plugin();
+   void *context = (*plugin->init)(j);
+   (*plugin->cgen_batch)(j, handles, ARRAY_LEN(handles), context);
+
+   for (int i = 0; i < ARRAY_LEN(handles); i++) {
+      jit_func_t *f = jit_get_func(j, handles[i]);
+      fail_if(load_acquire(&f->entry) == jit_interp);
+   }
+
+   tlab_t tlab = jit_null_tlab(j);
+   jit_scalar_t result, p0 = { .integer = 5 };
+
+   fail_unless(jit_fastcall(j, handles[0], &result, p0, p0, &tlab));
+   ck_assert_int_eq(result.integer, 15);
+
+   fail_unless(jit_fastcall(j, handles[1], &result, p0, p0, &tlab));
+   ck_assert_int_eq(result.integer, 6);
+
+   fail_unless(jit_fastcall(j, handles[2], &result, p0, p0, &tlab));
+   ck_assert_int_eq(result.integer, -2);
+
+   jit_free(j);
+   (*plugin->cleanup)(context);
+}
+END_TEST
+#endif
+
 Suite *get_jit_tests(void)
 {
    Suite *s = suite_create("jit");
@@ -2155,6 +2700,19 @@ Suite *get_jit_tests(void)
    tcase_add_test(tc, test_cprop2);
    tcase_add_test(tc, test_mem2reg1);
    tcase_add_test(tc, test_lscan1);
+   tcase_add_test(tc, test_lscan2);
+   tcase_add_test(tc, test_lscan3);
+   tcase_add_test(tc, test_lscan4);
+   tcase_add_test(tc, test_vrp1);
+   tcase_add_test(tc, test_vrp2);
+   tcase_add_test(tc, test_licm1);
+   tcase_add_test(tc, test_licm2);
+   tcase_add_test(tc, test_inline1);
+   tcase_add_test(tc, test_inline2);
+   tcase_add_test(tc, test_osr1);
+#ifdef ENABLE_LLVM
+   tcase_add_test(tc, test_llvm_batch);
+#endif
    suite_add_tcase(s, tc);
 
    return s;
@@ -719,6 +719,50 @@ START_TEST(test_barrier)
 }
 END_TEST
 
+typedef struct {
+   nvc_lock_t lock;
+   nvc_cond_t cond;
+   int        turn;
+} pingpong_t;
+
+static void *pingpong_fn(void *__arg)
+{
+   pingpong_t *pp = __arg;
+
+   for (int i = 0; i < 1000; i++) {
+      SCOPED_LOCK(pp->lock);
+
+      while (pp->turn % 2 == 0)
+         nvc_cond_wait(&pp->cond, &pp->lock);
+
+      pp->turn++;
+      nvc_cond_notify_all(&pp->cond);
+   }
+
+   return NULL;
+}
+
+START_TEST(test_cond)
+{
+   pingpong_t pp = {};
+   nvc_thread_t *thread = thread_create(pingpong_fn, &pp, "pingpong");
+
+   for (int i = 0; i < 1000; i++) {
+      SCOPED_LOCK(pp.lock);
+
+      while (pp.turn % 2 == 1)
+         nvc_cond_wait(&pp.cond, &pp.lock);
+
+      pp.turn++;
+      nvc_cond_notify_all(&pp.cond);
+   }
+
+   thread_join(thread);
+
+   ck_assert_int_eq(pp.turn, 2000);
+}
+END_TEST
+
 Suite *get_misc_tests(void)
 {
    Suite *s = suite_create("misc");
@@ -763,6 +807,7 @@ Suite *get_misc_tests(void)
    tcase_add_test(tc_thread, test_stop_world);
 #endif
    tcase_add_test(tc_thread, test_barrier);
+   tcase_add_test(tc_thread, test_cond);
    suite_add_tcase(s, tc_thread);
 
    return s;
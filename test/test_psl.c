@@ -20,6 +20,7 @@
 #include "lib.h"
 #include "option.h"
 #include "phase.h"
+#include "psl/psl-fsm.h"
 #include "psl/psl-node.h"
 #include "psl/psl-phase.h"
 #include "scan.h"
@@ -335,6 +336,57 @@ START_TEST(test_issue1001)
 }
 END_TEST
 
+START_TEST(test_dfa1)
+{
+   set_standard(STD_08);
+
+   input_from_file(TESTDIR "/psl/dfa1.vhd");
+
+   tree_t a = parse_check_and_simplify(T_ENTITY, T_ARCH);
+
+   psl_fsm_t *fsm0 = psl_fsm_new(tree_psl(tree_stmt(a, 0)));
+   ck_assert_int_eq(fsm0->next_id, 5);
+   fail_unless(psl_fsm_determinise(fsm0));
+   ck_assert_int_gt(fsm0->dfa_count, 1);
+   ck_assert_int_le(fsm0->dfa_count, 64);
+
+   // The runtime starts in the DFA state for the initial NFA state
+   ck_assert_int_eq(fsm0->dfa[0].mask, 1);
+
+   for (int i = 0; i < fsm0->dfa_count; i++) {
+      const dfa_state_t *d = &(fsm0->dfa[i]);
+      fail_if(d->strong);
+      fail_unless(d->mask & 1);   // Always restarts every cycle
+
+      for (int j = 0; j < d->ntrans; j++) {
+         fail_unless(d->trans[j].dest < (int)fsm0->dfa_count);
+         fail_unless(d->trans[j].dest >= 0);
+         ck_assert_int_eq(fsm0->dfa[d->trans[j].dest].mask,
+                          d->trans[j].mask);
+      }
+   }
+
+   psl_fsm_free(fsm0);
+
+   // Subset construction gives up when the DFA grows too large
+   psl_fsm_t *fsm1 = psl_fsm_new(tree_psl(tree_stmt(a, 1)));
+   ck_assert_int_eq(fsm1->next_id, 43);
+   fail_if(psl_fsm_determinise(fsm1));
+   ck_assert_ptr_null(fsm1->dfa);
+   ck_assert_int_eq(fsm1->dfa_count, 0);
+   psl_fsm_free(fsm1);
+
+   // Masks cannot represent 64 or more NFA states
+   psl_fsm_t *fsm2 = psl_fsm_new(tree_psl(tree_stmt(a, 2)));
+   ck_assert_int_eq(fsm2->next_id, 73);
+   fail_if(psl_fsm_determinise(fsm2));
+   ck_assert_ptr_null(fsm2->dfa);
+   psl_fsm_free(fsm2);
+
+   fail_if_errors();
+}
+END_TEST
+
 Suite *get_psl_tests(void)
 {
    Suite *s = suite_create("psl");
@@ -348,6 +400,7 @@ Suite *get_psl_tests(void)
    tcase_add_test(tc_core, test_parse5);
    tcase_add_test(tc_core, test_issue910);
    tcase_add_test(tc_core, test_issue1001);
+   tcase_add_test(tc_core, test_dfa1);
    suite_add_tcase(s, tc_core);
 
    return s;
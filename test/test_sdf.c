@@ -21,6 +21,7 @@
 #include "option.h"
 #include "phase.h"
 #include "sdf/sdf-phase.h"
+#include "sdf/sdf-util.h"
 #include "scan.h"
 #include "type.h"
 
@@ -326,6 +327,104 @@ START_TEST(test_parse24)
 }
 END_TEST
 
+START_TEST(test_parse25)
+{
+   input_from_file(TESTDIR "/sdf/parse25.sdf");
+
+   sdf_file_t *file = sdf_parse("dummy.sdf", S_F_MIN_VALUES | S_F_MAX_VALUES);
+   ck_assert_ptr_nonnull(file);
+
+   fail_if_errors();
+
+   sdf_cell_t *c1 = sdf_find_cell(file, ident_new("AND2"),
+                                  ident_new("top.u1"));
+   ck_assert_ptr_nonnull(c1);
+   ck_assert_ptr_eq(c1->celltype, ident_new("AND2"));
+   ck_assert_int_eq(c1->delays.count, 3);
+   ck_assert_int_eq(c1->values.count, 4);
+
+   const sdf_delay_t *d0 = &(c1->delays.items[0]);
+   ck_assert_int_eq(d0->kind, S_DELAY_IOPATH);
+   ck_assert_int_eq(d0->flags, S_F_VALUE_ABSOLUTE | S_F_POSEDGE);
+   ck_assert_ptr_eq(d0->from, ident_new("a"));
+   ck_assert_ptr_eq(d0->to, ident_new("y"));
+   ck_assert_int_eq(d0->first, 0);
+   ck_assert_int_eq(d0->nvalues, 2);
+
+   const sdf_value_t *v0 = &(c1->values.items[0]);
+   ck_assert_int_eq(v0->min, 100000);
+   ck_assert_int_eq(v0->typ, SDF_NO_VALUE);
+   ck_assert_int_eq(v0->max, 300000);
+   ck_assert_int_eq(c1->values.items[1].max, 600000);
+
+   const sdf_delay_t *d1 = &(c1->delays.items[1]);
+   ck_assert_int_eq(d1->kind, S_DELAY_PORT);
+   ck_assert_ptr_null(d1->from);
+   ck_assert_ptr_eq(d1->to, ident_new("b"));
+   ck_assert_int_eq(c1->values.items[d1->first].min, 700000);
+
+   const sdf_delay_t *d2 = &(c1->delays.items[2]);
+   ck_assert_int_eq(d2->kind, S_DELAY_INTERCONNECT);
+   ck_assert_ptr_eq(d2->from, ident_new("top.u0.y"));
+   ck_assert_int_eq(d2->nvalues, 1);
+   ck_assert_int_eq(c1->values.items[d2->first].max, 100000);
+
+   sdf_cell_t *c2 = sdf_find_cell(file, ident_new("BUF"),
+                                  ident_new("top.u2"));
+   ck_assert_ptr_nonnull(c2);
+   ck_assert_int_eq(c2->delays.count, 1);
+   ck_assert_int_eq(c2->delays.items[0].kind, S_DELAY_DEVICE);
+   ck_assert_int_eq(c2->delays.items[0].flags, S_F_VALUE_INCREMENT);
+   ck_assert_int_eq(c2->values.items[0].min, SDF_NO_VALUE);
+   ck_assert_int_eq(c2->values.items[0].max, 150000);
+
+   ck_assert_ptr_null(sdf_find_cell(file, ident_new("OR2"),
+                                    ident_new("top.u3")));
+
+   sdf_file_free(file);
+}
+END_TEST
+
+START_TEST(test_parse26)
+{
+   // Large enough to be split into several chunks parsed in parallel
+   LOCAL_TEXT_BUF tb = tb_new();
+   tb_cat(tb, "(DELAYFILE\n  (SDFVERSION \"3.0\")\n  (TIMESCALE 100 ps)\n");
+
+   const int ncells = 50000, ninsts = 1000;
+   for (int i = 0; i < ncells; i++)
+      tb_printf(tb, "  (CELL (CELLTYPE \"BUF\") (INSTANCE top.u%d)\n"
+                "    (DELAY (ABSOLUTE (IOPATH a y (%d)))))\n", i % ninsts, i);
+
+   tb_cat(tb, ")\n");
+
+   input_from_buffer(tb_get(tb), tb_len(tb), SOURCE_SDF);
+
+   sdf_file_t *file = sdf_parse("dummy.sdf", S_F_MIN_MAX_SPEC_ALL);
+   ck_assert_ptr_nonnull(file);
+
+   fail_if_errors();
+
+   for (int i = 0; i < ninsts; i += 111) {
+      char *name LOCAL = xasprintf("top.u%d", i);
+      sdf_cell_t *c = sdf_find_cell(file, ident_new("BUF"), ident_new(name));
+      ck_assert_ptr_nonnull(c);
+      ck_assert_int_eq(c->delays.count, ncells / ninsts);
+
+      // Delays from each chunk are merged in file order
+      for (int j = 0; j < c->delays.count; j++) {
+         const sdf_delay_t *d = &(c->delays.items[j]);
+         ck_assert_int_eq(d->kind, S_DELAY_IOPATH);
+         ck_assert_int_eq(d->nvalues, 1);
+         ck_assert_int_eq(c->values.items[d->first].typ,
+                          (i + j * ninsts) * INT64_C(100000));
+      }
+   }
+
+   sdf_file_free(file);
+}
+END_TEST
+
 Suite *get_sdf_tests(void)
 {
    Suite *s = suite_create("sdf");
@@ -355,6 +454,8 @@ Suite *get_sdf_tests(void)
    tcase_add_test(tc_core, test_parse22);
    tcase_add_test(tc_core, test_parse23);
    tcase_add_test(tc_core, test_parse24);
+   tcase_add_test(tc_core, test_parse25);
+   tcase_add_test(tc_core, test_parse26);
    suite_add_tcase(s, tc_core);
 
    return s;
@@ -314,14 +314,15 @@ static void wave_binary_frame(web_socket_t *ws, const void *data, size_t len,
       break;
 
    case 2:
-      ck_assert_int_eq(len, 9);
+      ck_assert_int_eq(len, 13);
       ck_assert_int_eq(bytes[0], S2C_ADD_WAVE);
-      ck_assert_int_eq(bytes[1] << 8 | bytes[2], 2);
-      ck_assert_int_eq(bytes[3], '/');
-      ck_assert_int_eq(bytes[4], 'x');
+      ck_assert_mem_eq(bytes + 1, "\x00\x00\x00\x00", 4);
       ck_assert_int_eq(bytes[5] << 8 | bytes[6], 2);
-      ck_assert_int_eq(bytes[7], 'b');
-      ck_assert_int_eq(bytes[8], '0');
+      ck_assert_int_eq(bytes[7], '/');
+      ck_assert_int_eq(bytes[8], 'x');
+      ck_assert_int_eq(bytes[9] << 8 | bytes[10], 2);
+      ck_assert_int_eq(bytes[11], 'b');
+      ck_assert_int_eq(bytes[12], '0');
       break;
 
    case 3:
@@ -331,14 +332,14 @@ static void wave_binary_frame(web_socket_t *ws, const void *data, size_t len,
       break;
 
    case 5:
-      ck_assert_int_eq(len, 9);
+      ck_assert_int_eq(len, 21);
       ck_assert_int_eq(bytes[0], S2C_SIGNAL_UPDATE);
-      ck_assert_int_eq(bytes[1] << 8 | bytes[2], 2);
-      ck_assert_int_eq(bytes[3], '/');
-      ck_assert_int_eq(bytes[4], 'x');
-      ck_assert_int_eq(bytes[5] << 8 | bytes[6], 2);
-      ck_assert_int_eq(bytes[7], 'b');
-      ck_assert_int_eq(bytes[8], '1');
+      ck_assert_mem_eq(bytes + 1, "\x00\x00\x00\x00\x00\x0f\x42\x40", 8);
+      ck_assert_mem_eq(bytes + 9, "\x00\x00\x00\x01", 4);
+      ck_assert_mem_eq(bytes + 13, "\x00\x00\x00\x00", 4);
+      ck_assert_int_eq(bytes[17] << 8 | bytes[18], 2);
+      ck_assert_int_eq(bytes[19], 'b');
+      ck_assert_int_eq(bytes[20], '1');
       break;
 
    case 6:
@@ -401,6 +402,91 @@ START_TEST(test_wave)
 }
 END_TEST
 
+static void wave_rate_binary_frame(web_socket_t *ws, const void *data,
+                                   size_t len, void *context)
+{
+   int *state = context;
+   const uint8_t *bytes = data;
+
+   switch ((*state)++) {
+   case 0:
+      ck_assert_int_eq(bytes[0], S2C_START_SIM);
+      break;
+
+   case 1:
+      ck_assert_int_eq(len, 13);
+      ck_assert_int_eq(bytes[0], S2C_ADD_WAVE);
+      break;
+
+   case 2:
+      // Value at 2 ns is the same as when the wave was added so there
+      // should be no signal update frame
+      ck_assert_int_eq(len, 9);
+      ck_assert_int_eq(bytes[0], S2C_NEXT_TIME_STEP);
+      ck_assert_mem_eq(bytes + 1, "\x00\x00\x00\x00\x00\x1e\x84\x80", 8);
+      break;
+
+   case 3:
+      ck_assert_int_eq(bytes[0], S2C_QUIT_SIM);
+      break;
+
+   default:
+      ck_abort_msg("unexpected call to binary_frame in state %d", *state - 1);
+   }
+}
+
+START_TEST(test_wave_rate)
+{
+   input_from_file(TESTDIR "/shell/wave1.vhd");
+
+   tree_t top = run_elab();
+
+   pid_t pid = fork_server(SERVER_HTTP, top, NULL);
+   int sock = open_connection();
+   websocket_upgrade(sock);
+
+   int state = 0;
+   ws_handler_t handler = {
+      .text_frame = wave_text_frame,
+      .binary_frame = wave_rate_binary_frame,
+      .context = &state
+   };
+   web_socket_t *ws = ws_new(sock, &handler, true);
+
+   static const uint8_t packet[] = {
+      C2S_SET_UPDATE_RATE,
+      0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0x00, 0x00, 0x00, 0x00
+   };
+   ws_send_binary(ws, packet, sizeof(packet));
+
+   ws_send_text(ws, "add wave /x");
+   ws_flush(ws);
+
+   ws_poll(ws);
+
+   ws_send_text(ws, "run 3 ns");
+   ws_flush(ws);
+
+   ws_poll(ws);
+
+   ck_assert_int_eq(state, 3);
+
+   ws_send_text(ws, "quit -sim");
+   ws_flush(ws);
+
+   ws_poll(ws);
+
+   shutdown_server(ws);
+   ws_free(ws);
+
+   ck_assert_int_eq(state, 4);
+
+   close(sock);
+   join_server(pid);
+}
+END_TEST
+
 static void pong_handler(web_socket_t *ws, const void *data, size_t len,
                          void *user)
 {
@@ -603,6 +689,7 @@ Suite *get_server_tests(void)
    tcase_add_test(tc, test_dirty_close);
    tcase_add_test(tc, test_second_connection);
    tcase_add_test(tc, test_wave);
+   tcase_add_test(tc, test_wave_rate);
    tcase_add_test(tc, test_ping);
    tcase_add_test(tc, test_greeting);
    tcase_add_test(tc, test_bad_command);
@@ -508,6 +508,96 @@ START_TEST(test_describe1)
 }
 END_TEST
 
+START_TEST(test_async1)
+{
+   const error_t expect[] = {
+      { LINE_INVALID, "simulation already running" },
+      { -1, NULL }
+   };
+   expect_errors(expect);
+
+   tcl_shell_t *sh = shell_new(jit_new, NULL);
+
+   const char *result = NULL;
+
+   shell_eval(sh, "analyse " TESTDIR "/shell/async1.vhd", &result);
+   ck_assert_str_eq(result, "");
+
+   shell_eval(sh, "elaborate async1", &result);
+   ck_assert_str_eq(result, "");
+
+   fail_unless(shell_eval(sh, "run -async 10 ns", &result));
+   ck_assert_str_eq(result, "");
+
+   // Examine pauses the background simulation at a time step boundary
+   // until the run completes
+   for (int i = 0; i < 100000; i++) {
+      fail_unless(shell_eval(sh, "examine /count", &result));
+      if (strcmp(result, "11") == 0)
+         break;
+
+      ck_assert_int_le(atoi(result), 11);
+   }
+   ck_assert_str_eq(result, "11");
+
+   fail_unless(shell_eval(sh, "run 5 ns", &result));
+
+   fail_unless(shell_eval(sh, "examine /count", &result));
+   ck_assert_str_eq(result, "16");
+
+   fail_unless(shell_eval(sh, "run -async", &result));
+   fail_if(shell_eval(sh, "run -async", &result));
+
+   fail_unless(shell_eval(sh, "restart", &result));
+
+   fail_unless(shell_eval(sh, "examine /count", &result));
+   ck_assert_str_eq(result, "0");
+
+   shell_free(sh);
+
+   check_expected_errors();
+}
+END_TEST
+
+static void deltas1_stdout_handler(const char *buf, size_t nchars, void *ctx)
+{
+   int *state = ctx;
+
+   if (strstr(buf, "Time steps with the most delta cycles") != NULL) {
+      ck_assert_ptr_nonnull(strstr(buf, ":deltas1:storm"));
+      (*state)++;
+   }
+}
+
+START_TEST(test_deltas1)
+{
+   tcl_shell_t *sh = shell_new(jit_new, NULL);
+
+   int state = 0;
+   shell_handler_t handler = {
+      .stdout_write = deltas1_stdout_handler,
+      .context = &state,
+   };
+   shell_set_handler(sh, &handler);
+
+   const char *result = NULL;
+
+   shell_eval(sh, "analyse " TESTDIR "/shell/deltas1.vhd", &result);
+   ck_assert_str_eq(result, "");
+
+   shell_eval(sh, "elaborate deltas1", &result);
+   ck_assert_str_eq(result, "");
+
+   fail_unless(shell_eval(sh, "run 5 ns", &result));
+   fail_unless(shell_eval(sh, "deltas", &result));
+   ck_assert_str_eq(result, "");
+
+   ck_assert_int_eq(state, 1);
+
+   shell_free(sh);
+}
+END_TEST
+
 Suite *get_shell_tests(void)
 {
    Suite *s = suite_create("shell");
@@ -522,6 +612,8 @@ Suite *get_shell_tests(void)
    tcase_add_exit_test(tc, test_exit, 5);
    tcase_add_test(tc, test_echo);
    tcase_add_test(tc, test_describe1);
+   tcase_add_test(tc, test_async1);
+   tcase_add_test(tc, test_deltas1);
    suite_add_tcase(s, tc);
 
    return s;